@@ -23,6 +23,27 @@ extern "C" {
 
 #define	NBR_OF_PRIORITY_LEVELS	(16)
 
+/*	AMS messages received by a transport service whose AmsInterface
+ *	has a single receiver thread are passed to the application
+ *	through lock-free event rings, one per priority level, unless
+ *	the platform provides no memory barrier primitive or rings are
+ *	disabled by defining AMS_NO_EVENT_RINGS.  AMS_EVENT_SPINS, if
+ *	nonzero, is the number of times ams_get_event polls the rings
+ *	before blocking on the events condition variable.		*/
+
+#if defined (__GNUC__) && !defined (AMS_NO_EVENT_RINGS)
+#define	AMS_EVENT_RINGS
+#define	AMS_BARRIER()		__sync_synchronize()
+#endif
+
+#ifndef AMS_EVENT_RING_SIZE
+#define	AMS_EVENT_RING_SIZE	(64)	/*	Must be power of 2.	*/
+#endif
+
+#ifndef AMS_EVENT_SPINS
+#define	AMS_EVENT_SPINS		(0)
+#endif
+
 /*	Flag values for XmitRule structures (message acceptance
  *	relationships).							*/
 
@@ -81,6 +102,24 @@ typedef struct
 
 /*	*	Message reception control structures	*	*	*/
 
+/*	AmsEvtRing is a single-producer/single-consumer queue of AMS
+ *	message events at one priority level.  The producer is the
+ *	receiver thread of one AmsInterface, the consumer is the
+ *	node's event manager thread; each advances only its own index.
+ *	When a ring is full the receiver "spills" further messages of
+ *	that priority into the SAP's amsEvents list, and it keeps
+ *	spilling until the ring is empty and every spilled event has
+ *	been dequeued, so that delivery order is never disturbed.	*/
+
+typedef struct
+{
+	volatile unsigned int	head;		/*	Producer only.	*/
+	volatile unsigned int	tail;		/*	Consumer only.	*/
+	int			spilling;	/*	Producer only.	*/
+	volatile int		spillsPending;	/*	Under llcv lock.*/
+	AmsEvt			*events[AMS_EVENT_RING_SIZE];
+} AmsEvtRing;
+
 /*	AmsInterface is a structure used by the LOCAL node (SAP) to
  *	send and receive AMS messages, using some transport service.	*/
 
@@ -92,6 +131,7 @@ typedef struct amsifst
 	AmsSequence	sequence;
 	char		*ept;		/*	Own endpoint name text.	*/
 	Llcv		eventsQueue;
+	AmsEvtRing	*rings;		/*	By priority; optional.	*/
 	pthread_t	receiver;
 	void		*sap;		/*	e.g., socket FD		*/
 } AmsInterface;
@@ -202,6 +242,8 @@ typedef struct amssapst
 	Llcv		amsEventsCV;		/*	Inbound.	*/
 	AmsInterface	amsTsifs[TS_INDEX_LIMIT + 1];
 	LystElt		lastForPriority[NBR_OF_PRIORITY_LEVELS];
+	volatile int	ringWaiter;		/*	Boolean.	*/
+	int		ringCursor;		/*	Next tsif.	*/
 } AmsSAP;
 
 /*	*	*	AMS event structures	*	*	*	*/
@@ -218,6 +260,7 @@ typedef struct
 	char		*content;
 	unsigned char	priority;
 	unsigned char	flowLabel;
+	AmsEvtRing	*spilledFrom;	/*	Usually NULL.		*/
 } AmsMsg;
 
 typedef struct
@@ -239,6 +282,8 @@ typedef struct
 /*	*	*	Private function prototypes	*	*	*/
 
 extern int	enqueueAmsMsg(AmsSAP *sap, unsigned char *buffer, int length);
+extern int	deliverAmsMsg(AmsInterface *tsif, unsigned char *buffer,
+			int length);
 
 #ifdef __cplusplus
 }
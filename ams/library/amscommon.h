@@ -166,7 +166,11 @@ typedef struct
 } MamsEndpoint;
 
 /*	TransSvc is a structure that encapsulates the machinery for
- *	exchanging messages via some transport service.			*/
+ *	exchanging messages via some transport service.  A transport
+ *	service that can build a message once and then hand it to
+ *	several endpoints may supply a sendAmsBatchFn, which libams
+ *	uses to fan out published and announced messages; otherwise
+ *	sendAmsFn is called once per recipient.				*/
 
 typedef struct tsvcst	*TransSvcP;
 typedef void		(*TsLoadFn)(TransSvcP ts);
@@ -194,6 +198,11 @@ typedef int		(*TsSendAmsFn)(AmsEndpointP endpoint, AmsSapP sap,
 				unsigned char flowLabel,
 				char *header, int headerLen,
 				char *content, int contentLen);
+typedef int		(*TsSendAmsBatchFn)(AmsEndpointP *endpoints,
+				int endpointCount, AmsSapP sap,
+				unsigned char flowLabel,
+				char *header, int headerLen,
+				char *content, int contentLen);
 typedef struct tsvcst
 {
 	char		*name;
@@ -208,6 +217,7 @@ typedef struct tsvcst
 	TsAmsParseFn	parseAmsEndpointFn;
 	TsAmsClearFn	clearAmsEndpointFn;
 	TsSendAmsFn	sendAmsFn;
+	TsSendAmsBatchFn sendAmsBatchFn;	/*	Optional.	*/
 	TsShutdownFn	shutdownFn;
 } TransSvc;
 
@@ -190,7 +190,6 @@ static void	*dgrAmsReceiver(void *parm)
 {
 	AmsInterface	*tsif = (AmsInterface *) parm;
 	Dgr		dgrSap;
-	AmsSAP		*amsSap;
 	char		*buffer;
 	sigset_t	signals;
 	unsigned short	portNbr;
@@ -200,7 +199,6 @@ static void	*dgrAmsReceiver(void *parm)
 	DgrRC		rc;
 
 	dgrSap = (Dgr) (tsif->sap);
-	amsSap = tsif->amsSap;
 	buffer = MTAKE(DGRTS_MAX_MSG_LEN);
 	if (buffer == NULL)
 	{
@@ -237,7 +235,7 @@ static void	*dgrAmsReceiver(void *parm)
 
 		/*	Got an AMS message.				*/
 
-		if (enqueueAmsMsg(amsSap, (unsigned char *) buffer, length) < 0)
+		if (deliverAmsMsg(tsif, (unsigned char *) buffer, length) < 0)
 		{
 			putErrmsg("dgrts discarded AMS message.", NULL);
 		}
@@ -360,6 +358,41 @@ static int	dgrSendMams(MamsEndpoint *ep, MamsInterface *tsif, char *msg,
 	return 0;
 }
 
+static AmsInterface	*dgrAmsTsif(AmsSAP *sap, TransSvc *ts)
+{
+	int		i;
+	AmsInterface	*tsif;
+
+	for (i = 0, tsif = sap->amsTsifs; i < sap->transportServiceCount; i++,
+			tsif++)
+	{
+		if (tsif->ts == ts)
+		{
+			return tsif;	/*	Have found interface.	*/
+		}
+	}
+
+	return NULL;			/*	No match.		*/
+}
+
+static int	dgrBuildAmsMsg(char *buf, char *header, int headerLen,
+			char *content, int contentLen)
+{
+	unsigned short	checksum;
+
+	memcpy(buf, header, headerLen);
+	if (contentLen > 0)
+	{
+		memcpy(buf + headerLen, content, contentLen);
+	}
+
+	checksum = computeAmsChecksum((unsigned char *) buf,
+			headerLen + contentLen);
+	checksum = htons(checksum);
+	memcpy(buf + headerLen + contentLen, (char *) &checksum, 2);
+	return headerLen + contentLen + 2;
+}
+
 static int	dgrSendAms(AmsEndpoint *dp, AmsSAP *sap,
 			unsigned char flowLabel, char *header,
 			int headerLen, char *content, int contentLen)
@@ -367,14 +400,12 @@ static int	dgrSendAms(AmsEndpoint *dp, AmsSAP *sap,
 	static char	dgrAmsBuf[DGRTS_MAX_MSG_LEN];
 	int		len;
 	DgrTsep		*tsep;
-	int		i;
 	AmsInterface	*tsif;
 	Dgr		dgrSap;
-	unsigned short	checksum;
 
 	if (dp == NULL || sap == NULL || header == NULL || headerLen < 0
 	|| contentLen < 0 || (contentLen > 0 && content == NULL)
-	|| (len = (headerLen + contentLen + 2)) > DGRTS_MAX_MSG_LEN)
+	|| (headerLen + contentLen + 2) > DGRTS_MAX_MSG_LEN)
 	{
 		errno = EINVAL;
 		putErrmsg("Can't use DGR to send AMS message.", NULL);
@@ -388,31 +419,15 @@ static int	dgrSendAms(AmsEndpoint *dp, AmsSAP *sap,
 		return 0;
 	}
 
-	for (i = 0, tsif = sap->amsTsifs; i < sap->transportServiceCount; i++,
-			tsif++)
-	{
-		if (tsif->ts == dp->ts)
-		{
-			break;	/*	Have found interface to use.	*/
-		}
-	}
-
-	if (i == sap->transportServiceCount)	/*	No match.	*/
+	tsif = dgrAmsTsif(sap, dp->ts);
+	if (tsif == NULL)
 	{
 		return 0;	/*	Cannot send msg to endpoint.	*/
 	}
 
 	dgrSap = (Dgr) (tsif->sap);
-	memcpy(dgrAmsBuf, header, headerLen);
-	if (contentLen > 0)
-	{
-		memcpy(dgrAmsBuf + headerLen, content, contentLen);
-	}
-
-	checksum = computeAmsChecksum((unsigned char *) dgrAmsBuf,
-			headerLen + contentLen);
-	checksum = htons(checksum);
-	memcpy(dgrAmsBuf + headerLen + contentLen, (char *) &checksum, 2);
+	len = dgrBuildAmsMsg(dgrAmsBuf, header, headerLen, content,
+			contentLen);
 	if (dgr_send(dgrSap, tsep->portNbr, tsep->ipAddress, 0, dgrAmsBuf, len)
 			== DgrFailed)
 	{
@@ -424,6 +439,77 @@ static int	dgrSendAms(AmsEndpoint *dp, AmsSAP *sap,
 	return 0;
 }
 
+/*	dgrSendAmsBatch sends a single AMS message to every endpoint
+ *	in the batch, assembling and checksumming the message only
+ *	once.  DGR provides reliable delivery per destination, so a
+ *	copy must still be handed to dgr_send for each distinct
+ *	address; duplicate addresses are skipped.			*/
+
+static int	dgrSendAmsBatch(AmsEndpoint **endpoints, int endpointCount,
+			AmsSAP *sap, unsigned char flowLabel, char *header,
+			int headerLen, char *content, int contentLen)
+{
+	static char	dgrAmsBuf[DGRTS_MAX_MSG_LEN];
+	int		len;
+	AmsInterface	*tsif;
+	Dgr		dgrSap;
+	int		i;
+	int		j;
+	DgrTsep		*tsep;
+	DgrTsep		*prior;
+
+	if (endpoints == NULL || endpointCount < 1 || sap == NULL
+	|| header == NULL || headerLen < 0
+	|| contentLen < 0 || (contentLen > 0 && content == NULL)
+	|| (headerLen + contentLen + 2) > DGRTS_MAX_MSG_LEN)
+	{
+		errno = EINVAL;
+		putErrmsg("Can't use DGR to send AMS message.", NULL);
+		return -1;
+	}
+
+	tsif = dgrAmsTsif(sap, endpoints[0]->ts);
+	if (tsif == NULL)
+	{
+		return 0;	/*	Cannot send msg to endpoints.	*/
+	}
+
+	dgrSap = (Dgr) (tsif->sap);
+	len = dgrBuildAmsMsg(dgrAmsBuf, header, headerLen, content,
+			contentLen);
+	for (i = 0; i < endpointCount; i++)
+	{
+		tsep = (DgrTsep *) (endpoints[i]->tsep);
+		if (tsep == NULL)	/*	Lost connectivity.	*/
+		{
+			continue;
+		}
+
+		for (j = 0; j < i; j++)
+		{
+			prior = (DgrTsep *) (endpoints[j]->tsep);
+			if (prior && prior->ipAddress == tsep->ipAddress
+			&& prior->portNbr == tsep->portNbr)
+			{
+				break;	/*	Already sent a copy.	*/
+			}
+		}
+
+		if (j < i)
+		{
+			continue;
+		}
+
+		if (dgr_send(dgrSap, tsep->portNbr, tsep->ipAddress, 0,
+				dgrAmsBuf, len) == DgrFailed)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
 static void	dgrShutdown(void *sap)
 {
 	Dgr	dgrSap = (Dgr) sap;
@@ -445,5 +531,6 @@ void	dgrtsLoadTs(TransSvc *ts)
 	ts->parseAmsEndpointFn = dgrParseAmsEndpoint;
 	ts->clearAmsEndpointFn = dgrClearAmsEndpoint;
 	ts->sendAmsFn = dgrSendAms;
+	ts->sendAmsBatchFn = dgrSendAmsBatch;
 	ts->shutdownFn = dgrShutdown;
 }
@@ -69,6 +69,9 @@ static int	enqueueAmsEvent(AmsSAP *sap, AmsEvt *evt, char *ancillaryBlock,
 	Llcv	eventsQueue = sap->amsEventsCV;
 	long	queryNbr;
 	LystElt	elt;
+#ifdef AMS_EVENT_RINGS
+	AmsMsg	*msg;
+#endif
 
 	if (eventsQueue == NULL)
 	{
@@ -138,6 +141,16 @@ static int	enqueueAmsEvent(AmsSAP *sap, AmsEvt *evt, char *ancillaryBlock,
 		}
 	}
 
+#ifdef AMS_EVENT_RINGS
+	if (elt && evt->type == AMS_MSG_EVT)
+	{
+		msg = (AmsMsg *) (evt->value);
+		if (msg->spilledFrom)
+		{
+			msg->spilledFrom->spillsPending++;
+		}
+	}
+#endif
 	llcv_unlock(eventsQueue);
 	if (elt == NULL)
 	{
@@ -215,6 +228,20 @@ static int	enqueueAmsStubEvent(AmsSAP *sap, int eventType, int priority)
 static void	noteEventDequeued(AmsSAP *sap, LystElt elt)
 {
 	int	i;
+#ifdef AMS_EVENT_RINGS
+	AmsEvt	*evt = (AmsEvt *) lyst_data(elt);
+	AmsMsg	*msg;
+
+	if (evt && evt->type == AMS_MSG_EVT)
+	{
+		msg = (AmsMsg *) (evt->value);
+		if (msg->spilledFrom)
+		{
+			msg->spilledFrom->spillsPending--;
+			msg->spilledFrom = NULL;
+		}
+	}
+#endif
 
 	for (i = 0; i < NBR_OF_PRIORITY_LEVELS; i++)
 	{
@@ -226,6 +253,217 @@ static void	noteEventDequeued(AmsSAP *sap, LystElt elt)
 	}
 }
 
+#ifdef AMS_EVENT_RINGS
+static AmsSAP	*sapOfEventsCV(Llcv llcv)
+{
+	return (AmsSAP *) (((char *) llcv) - offsetof(AmsSAP,
+			amsEventsCV_str));
+}
+
+static int	ringsNotEmpty(AmsSAP *sap)
+{
+	int		i;
+	AmsEvtRing	*rings;
+	int		p;
+
+	for (i = 0; i < sap->transportServiceCount; i++)
+	{
+		rings = sap->amsTsifs[i].rings;
+		if (rings == NULL)
+		{
+			continue;
+		}
+
+		for (p = 1; p < NBR_OF_PRIORITY_LEVELS; p++)
+		{
+			if (rings[p].tail != rings[p].head)
+			{
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int	llcv_rings_not_empty(Llcv llcv)
+{
+	return ringsNotEmpty(sapOfEventsCV(llcv));
+}
+
+/*	llcv_events_pending is the condition on which the event manager
+ *	waits for AMS events.  It announces the impending wait before
+ *	checking the rings, so that a receiver thread that adds an
+ *	event to a ring immediately afterwards knows to signal.	*/
+
+static int	llcv_events_pending(Llcv llcv)
+{
+	AmsSAP	*sap = sapOfEventsCV(llcv);
+
+	sap->ringWaiter = 1;
+	AMS_BARRIER();
+	if (lyst_length(llcv->list) > 0 || ringsNotEmpty(sap))
+	{
+		sap->ringWaiter = 0;
+		return 1;
+	}
+
+	return 0;
+}
+
+/*	ringAmsEvent is invoked only by the receiver thread of tsif.
+ *	It returns 1 if the event was added to a ring, 0 if the event
+ *	must be enqueued in the amsEvents list instead.			*/
+
+static int	ringAmsEvent(AmsInterface *tsif, AmsEvt *evt)
+{
+	AmsSAP		*sap = tsif->amsSap;
+	AmsMsg		*msg = (AmsMsg *) (evt->value);
+	AmsEvtRing	*ring;
+
+	if (tsif->rings == NULL || msg->type == AmsMsgReply
+	|| msg->priority < 1 || msg->priority >= NBR_OF_PRIORITY_LEVELS)
+	{
+		return 0;	/*	Must use amsEvents list.	*/
+	}
+
+	ring = tsif->rings + msg->priority;
+	if (ring->spilling)
+	{
+		if (ring->head != ring->tail || ring->spillsPending > 0)
+		{
+			msg->spilledFrom = ring;
+			return 0;	/*	Consumer not caught up.	*/
+		}
+
+		ring->spilling = 0;
+	}
+
+	if (ring->head - ring->tail == AMS_EVENT_RING_SIZE)
+	{
+		ring->spilling = 1;
+		msg->spilledFrom = ring;
+		return 0;		/*	Ring is full.		*/
+	}
+
+	ring->events[ring->head & (AMS_EVENT_RING_SIZE - 1)] = evt;
+	AMS_BARRIER();
+	ring->head++;
+	AMS_BARRIER();
+	if (sap->ringWaiter)
+	{
+		llcv_signal(sap->amsEventsCV, llcv_rings_not_empty);
+	}
+
+	return 1;
+}
+
+/*	takeRingEvent is invoked only by the event manager thread.
+ *	An event in a ring is taken in preference to an event in the
+ *	amsEvents list only if its priority is at least as high (i.e.,
+ *	its priority number is no greater) as that of the first event
+ *	in the list; among rings of equal priority, tsifs are served
+ *	in rotation.							*/
+
+static AmsEvt	*takeRingEvent(AmsSAP *sap)
+{
+	int		count = sap->transportServiceCount;
+	int		limit;
+	int		p;
+	int		i;
+	int		j;
+	AmsEvtRing	*ring;
+	AmsEvt		*evt;
+
+	for (limit = 0; limit < NBR_OF_PRIORITY_LEVELS; limit++)
+	{
+		if (sap->lastForPriority[limit])
+		{
+			break;
+		}
+	}
+
+	for (p = 1; p <= limit && p < NBR_OF_PRIORITY_LEVELS; p++)
+	{
+		for (i = 0; i < count; i++)
+		{
+			j = (sap->ringCursor + i) % count;
+			if (sap->amsTsifs[j].rings == NULL)
+			{
+				continue;
+			}
+
+			ring = sap->amsTsifs[j].rings + p;
+			if (ring->tail == ring->head)
+			{
+				continue;
+			}
+
+			AMS_BARRIER();
+			evt = ring->events[ring->tail & (AMS_EVENT_RING_SIZE - 1)];
+			AMS_BARRIER();
+			ring->tail++;
+			sap->ringCursor = (j + 1) % count;
+			return evt;
+		}
+	}
+
+	return NULL;
+}
+
+/*	pollRings is invoked by the event manager thread, with the
+ *	MIB locked, before it blocks on the events CV.			*/
+
+static AmsEvt	*pollRings(AmsSAP *sap)
+{
+	AmsEvt	*evt;
+	int	i;
+
+	evt = takeRingEvent(sap);
+	if (evt == NULL && AMS_EVENT_SPINS > 0)
+	{
+		UNLOCK_MIB;
+		for (i = 0; i < AMS_EVENT_SPINS; i++)
+		{
+			if (ringsNotEmpty(sap))
+			{
+				break;
+			}
+		}
+
+		LOCK_MIB;
+		evt = takeRingEvent(sap);
+	}
+
+	return evt;
+}
+
+static void	drainRings(AmsInterface *tsif)
+{
+	AmsEvtRing	*ring;
+	int		p;
+
+	if (tsif->rings == NULL)
+	{
+		return;
+	}
+
+	for (p = 0; p < NBR_OF_PRIORITY_LEVELS; p++)
+	{
+		ring = tsif->rings + p;
+		while (ring->tail != ring->head)
+		{
+			oK(ams_recycle_event(ring->events[ring->tail
+					& (AMS_EVENT_RING_SIZE - 1)]));
+			ring->tail++;
+		}
+	}
+
+	MRELEASE(tsif->rings);
+	tsif->rings = NULL;
+}
+#endif
+
 static void	eraseSAP(AmsSAP *sap)
 {
 	/*	Note: MIB must *not* be locked at the time eraseSAP
@@ -281,6 +519,9 @@ static void	eraseSAP(AmsSAP *sap)
 			{
 				MRELEASE(tsif->ept);
 			}
+#ifdef AMS_EVENT_RINGS
+			drainRings(tsif);
+#endif
 //printf("Node '%d' AMS interface removed.\n", sap->role->nbr);
 		}
 	}
@@ -528,7 +769,8 @@ static int	validateAmsMsg(AmsSAP *sap, unsigned char *msgBuffer,
 	return deliveredContentLength;
 }
 
-int	enqueueAmsMsg(AmsSAP *sap, unsigned char *msgBuffer, int length)
+static int	receiveAmsMsg(AmsSAP *sap, AmsInterface *tsif,
+			unsigned char *msgBuffer, int length)
 {
 	unsigned char	*msgContent = msgBuffer + 16;
 	int		deliveredContentLength;
@@ -735,11 +977,39 @@ ted message.", subject->name);
 	}
 
 	evt->type = AMS_MSG_EVT;
+	msg.spilledFrom = NULL;
 	memcpy(evt->value, (char *) &msg, sizeof(AmsMsg));
+#ifdef AMS_EVENT_RINGS
+	if (tsif && ringAmsEvent(tsif, evt))
+	{
+		return 0;
+	}
+#endif
 	return enqueueAmsEvent(sap, evt, msg.content, msg.contextNbr,
 			msg.priority, msg.type);
 }
 
+int	enqueueAmsMsg(AmsSAP *sap, unsigned char *msgBuffer, int length)
+{
+	return receiveAmsMsg(sap, NULL, msgBuffer, length);
+}
+
+/*	deliverAmsMsg may be used instead of enqueueAmsMsg by any
+ *	transport service that receives all AMS messages for a given
+ *	AmsInterface in a single thread.				*/
+
+int	deliverAmsMsg(AmsInterface *tsif, unsigned char *msgBuffer, int length)
+{
+	if (tsif == NULL)
+	{
+		errno = EINVAL;
+		putSysErrmsg(BadParmsMemo, NULL);
+		return -1;
+	}
+
+	return receiveAmsMsg(tsif->amsSap, tsif, msgBuffer, length);
+}
+
 static void	constructMessage(AmsSAP *sap, short subjectNbr, int priority,
 			unsigned char flowLabel, int context, char *content,
 			int contentLength, unsigned char *header,
@@ -3731,6 +4001,15 @@ static int	ams_register2(char *applicationName, char *authorityName,
 		tsif->ts = sap->transportServices[j];
 		tsif->amsSap = sap;
 		tsif->eventsQueue = sap->amsEventsCV;
+#ifdef AMS_EVENT_RINGS
+		tsif->rings = (AmsEvtRing *) MTAKE(NBR_OF_PRIORITY_LEVELS
+				* sizeof(AmsEvtRing));
+		if (tsif->rings == NULL)
+		{
+			putErrmsg(NoMemoryMemo, NULL);
+			return -1;
+		}
+#endif
 		if (tsif->ts->amsInitFn(tsif, amses->epspec) < 0)
 		{
 			putErrmsg("Can't initialize AMS interface.",
@@ -4234,43 +4513,169 @@ static XmitRule	*getXmitRule(AmsSAP *sap, Lyst rules)
 	return NULL;
 }	
 
-static int	receivedMsgAlready(Lyst recipients, int nodeNbr)
+/*	A Fanout accumulates the endpoints of the nodes that are to
+ *	receive copies of one published or announced message.  Copies
+ *	bound for the same transport service at the same priority and
+ *	flow label are handed to that service as a single batch.  The
+ *	recipients bitmap, indexed by unit (cell) number and node
+ *	number, notes every node that has already been sent a copy,
+ *	so checking for duplicates costs one bit test per node.		*/
+
+#define	FANOUT_BATCH_LIMIT	(32)
+#define	RECIPIENT_MAP_BITS	((MAX_UNIT_NBR + 1) * (MAX_NODE_NBR + 1))
+
+typedef struct
 {
-	LystElt	elt;
-	long	longNodeNbr = (long) nodeNbr;
-		// cast to long to avoid warnings on 64-bit
+	AmsSAP		*sap;
+	char		*header;
+	int		headerLength;
+	char		*content;
+	int		contentLength;
+	TransSvc	*ts;		/*	Of pending batch.	*/
+	char		headerByte;	/*	Of pending batch.	*/
+	unsigned char	flowLabel;	/*	Of pending batch.	*/
+	int		endpointCount;
+	AmsEndpoint	*endpoints[FANOUT_BATCH_LIMIT];
+	unsigned char	recipients[(RECIPIENT_MAP_BITS + 7) >> 3];
+} Fanout;
+
+static void	initFanout(Fanout *fanout, AmsSAP *sap, char *header,
+			int headerLength, char *content, int contentLength)
+{
+	memset((char *) fanout, 0, sizeof(Fanout));
+	fanout->sap = sap;
+	fanout->header = header;
+	fanout->headerLength = headerLength;
+	fanout->content = content;
+	fanout->contentLength = contentLength;
+}
+
+static int	recipientIdx(Node *node)
+{
+	if (node->unitNbr < 0 || node->unitNbr > MAX_UNIT_NBR
+	|| node->nbr < 0 || node->nbr > MAX_NODE_NBR)
+	{
+		return -1;
+	}
+
+	return (node->unitNbr * (MAX_NODE_NBR + 1)) + node->nbr;
+}
+
+static int	receivedMsgAlready(Fanout *fanout, Node *node)
+{
+	int	idx = recipientIdx(node);
+
+	if (idx < 0)
+	{
+		return 0;
+	}
+
+	return (fanout->recipients[idx >> 3] & (1 << (idx & 7))) != 0;
+}
+
+static void	noteRecipient(Fanout *fanout, Node *node)
+{
+	int	idx = recipientIdx(node);
+
+	if (idx >= 0)
+	{
+		fanout->recipients[idx >> 3] |= (1 << (idx & 7));
+	}
+}
+
+static int	flushFanout(Fanout *fanout)
+{
+	int		count = fanout->endpointCount;
+	TransSvc	*ts = fanout->ts;
+	int		i;
+
+	if (count == 0)
+	{
+		return 0;
+	}
 
-	for (elt = lyst_first(recipients); elt; elt = lyst_next(elt))
+	fanout->endpointCount = 0;
+	fanout->header[0] = fanout->headerByte;
+	if (count > 1 && ts->sendAmsBatchFn != NULL)
 	{
-		if (longNodeNbr == (long) lyst_data(elt))
+		return ts->sendAmsBatchFn(fanout->endpoints, count,
+				fanout->sap, fanout->flowLabel, fanout->header,
+				fanout->headerLength, fanout->content,
+				fanout->contentLength);
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if (ts->sendAmsFn(fanout->endpoints[i], fanout->sap,
+				fanout->flowLabel, fanout->header,
+				fanout->headerLength, fanout->content,
+				fanout->contentLength) < 0)
 		{
-			return 1;
+			return -1;
 		}
 	}
 
 	return 0;
 }
 
+static int	addToFanout(Fanout *fanout, XmitRule *rule, int priority,
+			unsigned char flowLabel, unsigned char protectedBits)
+{
+	TransSvc	*ts = rule->amsEndpoint->ts;
+	char		headerByte;
+
+	/*	Supply default priority and/or flow label as
+	 *	necessary.						*/
+
+	if (priority)		/*	Override.			*/
+	{
+		headerByte = (char) (protectedBits | priority);
+	}
+	else			/*	Use default per rule.		*/
+	{
+		headerByte = (char) (protectedBits | rule->priority);
+	}
+
+	if (flowLabel == 0)
+	{
+		flowLabel = rule->flowLabel;
+	}
+
+	if (fanout->endpointCount > 0)
+	{
+		if (fanout->endpointCount == FANOUT_BATCH_LIMIT
+		|| fanout->ts != ts || fanout->headerByte != headerByte
+		|| fanout->flowLabel != flowLabel)
+		{
+			if (flushFanout(fanout) < 0)
+			{
+				return -1;
+			}
+		}
+	}
+
+	fanout->ts = ts;
+	fanout->headerByte = headerByte;
+	fanout->flowLabel = flowLabel;
+	fanout->endpoints[fanout->endpointCount] = rule->amsEndpoint;
+	fanout->endpointCount++;
+	return 0;
+}
+
 static int	sendToSubscribers(AmsSAP *sap, Subject *subject,
 			int priority, unsigned char flowLabel, 
-			unsigned char protectedBits, char *amsHeader,
-			int headerLength, char *content, int contentLength,
-	       		Lyst recipients)
+			unsigned char protectedBits, Fanout *fanout)
 {
 	LystElt		elt;
 	InterestedNode	*intn;
 	XmitRule	*rule;
-	int		result;
 
 	for (elt = lyst_first(subject->nodes); elt; elt = lyst_next(elt))
 	{
 		intn = (InterestedNode *) lyst_data(elt);
-		if (subject->nbr == ALL_SUBJECTS)
+		if (receivedMsgAlready(fanout, intn->node))
 		{
-			if (receivedMsgAlready(recipients, intn->node->nbr))
-			{
-				continue;/*	Don't send 2nd copy.	*/
-			}
+			continue;	/*	Don't send 2nd copy.	*/
 		}
 
 		rule = getXmitRule(sap, intn->subj->subscriptions);
@@ -4279,38 +4684,15 @@ static int	sendToSubscribers(AmsSAP *sap, Subject *subject,
 			continue;	/*	Don't send node a copy.	*/
 		}
 
-		/*	Must send this node a copy of this message.
-		 *	Supply default priority and/or flow label as
-		 *	necessary, and send message to node.		*/
-
-		if (priority)		/*	Override.		*/
-		{
-			amsHeader[0] = (char) (protectedBits | priority);
-		}
-		else			/*	Use default per rule.	*/
-		{
-			amsHeader[0] = (char) (protectedBits | rule->priority);
-		}
-
-		if (flowLabel == 0)
-		{
-			flowLabel = rule->flowLabel;
-		}
+		/*	Must send this node a copy of this message.	*/
 
-		result = rule->amsEndpoint->ts->sendAmsFn(rule->amsEndpoint,
-				sap, flowLabel, amsHeader, headerLength,
-				content, contentLength);
-		if (result < 0)
+		if (addToFanout(fanout, rule, priority, flowLabel,
+				protectedBits) < 0)
 		{
-			return result;
+			return -1;
 		}
 
-		if (subject->nbr != ALL_SUBJECTS)
-		{
-			lyst_insert_last(recipients,
-					(void *) ((long) (intn->node->nbr)));
-			// cast to long to avoid warnings on 64-bit
-		}
+		noteRecipient(fanout, intn->node);
 	}
 
 	return 0;
@@ -4324,7 +4706,7 @@ static int	ams_publish2(AmsSAP *sap, int subjectNbr, int priority,
 	char		amsHeader[16];
 	int		headerLength = sizeof amsHeader;
 	unsigned char	protectedBits;
-	Lyst		recipients;
+	Fanout		fanout;
 
 	if (subjectNbr == 0 || !subjectIsValid(sap, subjectNbr, &subject)
 	|| priority < 0 || priority >= NBR_OF_PRIORITY_LEVELS
@@ -4340,15 +4722,15 @@ static int	ams_publish2(AmsSAP *sap, int subjectNbr, int priority,
 	constructMessage(sap, subjectNbr, priority, flowLabel, context, content,
 		contentLength, (unsigned char *) amsHeader, AmsMsgUnary);
 	protectedBits = amsHeader[0] & 0xf0;
-	recipients = lyst_create();
+	initFanout(&fanout, sap, amsHeader, headerLength, content,
+			contentLength);
 
 	/*	Now send a copy of the message to every subscriber
 	 *	that has posted at least one subscription whose domain
 	 *	includes the local node.				*/
 
 	if (sendToSubscribers(sap, subject, priority, flowLabel, protectedBits,
-			amsHeader, headerLength, content, contentLength,
-			recipients) < 0)
+			&fanout) < 0)
 	{
 		return -1;
 	}
@@ -4359,14 +4741,12 @@ static int	ams_publish2(AmsSAP *sap, int subjectNbr, int priority,
 
 	subject = sap->venture->subjects[ALL_SUBJECTS];
 	if (sendToSubscribers(sap, subject, priority, flowLabel, protectedBits,
-			amsHeader, headerLength, content, contentLength,
-		       	recipients) < 0)
+			&fanout) < 0)
 	{
 		return -1;
 	}
 
-	lyst_destroy(recipients);
-	return 0;
+	return flushFanout(&fanout);
 }
 
 int	ams_publish(AmsSAP *sap, int subjectNbr, int priority,
@@ -5281,39 +5661,62 @@ static int	getEvent(AmsSAP *sap, int term, AmsEvent *event,
 	*event = NULL;
 	while (1)
 	{
-		UNLOCK_MIB;
-		result = llcv_wait(sap->amsEventsCV, condition, term);
-		LOCK_MIB;
-		if (result < 0)
+		evt = NULL;
+#ifdef AMS_EVENT_RINGS
+		if (condition == llcv_events_pending)
 		{
-			lyst_compare_set(sap->amsEvents, NULL);
-			if (errno == ETIMEDOUT)
+			evt = pollRings(sap);
+		}
+#endif
+		if (evt == NULL)
+		{
+			UNLOCK_MIB;
+			result = llcv_wait(sap->amsEventsCV, condition, term);
+#ifdef AMS_EVENT_RINGS
+			sap->ringWaiter = 0;
+#endif
+			LOCK_MIB;
+			if (result < 0)
 			{
-				return deliverTimeout(event);
+				lyst_compare_set(sap->amsEvents, NULL);
+				if (errno == ETIMEDOUT)
+				{
+					return deliverTimeout(event);
+				}
+
+				return -1;
 			}
 
-			return -1;
+			/*	A non-timeout event has arrived.	*/
+#ifdef AMS_EVENT_RINGS
+			if (condition == llcv_events_pending)
+			{
+				evt = takeRingEvent(sap);
+			}
+#endif
 		}
 
-		/*	A non-timeout event has arrived.		*/
-
-		llcv_lock(sap->amsEventsCV);
-		elt = lyst_first(sap->amsEvents);
-		if (elt == NULL)	/*	Interrupted; no retry.	*/
+		if (evt == NULL)
 		{
-			/*	llcv_wait was ended by forced
-			 *	signal.  Respond by returning a
-			 *	simulated timeout event.		*/
+			llcv_lock(sap->amsEventsCV);
+			elt = lyst_first(sap->amsEvents);
+			if (elt == NULL)	/*	Interrupted.	*/
+			{
+				/*	llcv_wait was ended by forced
+				 *	signal.  Respond by returning
+				 *	a simulated timeout event.	*/
 
+				llcv_unlock(sap->amsEventsCV);
+				lyst_compare_set(sap->amsEvents, NULL);
+				return deliverTimeout(event);
+			}
+
+			noteEventDequeued(sap, elt);
+			evt = (AmsEvent) lyst_data_set(elt, NULL);
+			lyst_delete(elt);
 			llcv_unlock(sap->amsEventsCV);
-			lyst_compare_set(sap->amsEvents, NULL);
-			return deliverTimeout(event);
 		}
 
-		noteEventDequeued(sap, elt);
-		evt = (AmsEvent) lyst_data_set(elt, NULL);
-		lyst_delete(elt);
-		llcv_unlock(sap->amsEventsCV);
 		switch (evt->type)
 		{
 		case AMS_MSG_EVT:
@@ -5736,7 +6139,7 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 	int		headerLength = sizeof amsHeader;
 	int		result;
 	unsigned char	protectedBits;
-	Lyst		recipients;
+	Fanout		fanout;
 	LystElt		elt;
 	InterestedNode	*intn;
 	XmitRule	*rule;
@@ -5796,7 +6199,8 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 	 *	message space now.					*/
 
 	protectedBits = amsHeader[0] & 0xf0;
-	recipients = lyst_create();
+	initFanout(&fanout, sap, amsHeader, headerLength, content,
+			contentLength);
 
 	/*	First send a copy of the message to every node in the
 	 *	domain of this request that has posted at least one
@@ -5829,35 +6233,15 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 			continue;	/*	Can't send node a copy.	*/
 		}
 
-		/*	Can send this node a copy of this message.
-		 *	Supply default priority and/or flow label as
-		 *	necessary, and send message to node.		*/
-
-		if (priority)		/*	Override.		*/
-		{
-			amsHeader[0] = (char) (protectedBits | priority);
-		}
-		else			/*	Use default per rule.	*/
-		{
-			amsHeader[0] = (char) (protectedBits | rule->priority);
-		}
-
-		if (flowLabel == 0)
-		{
-			flowLabel = rule->flowLabel;
-		}
+		/*	Can send this node a copy of this message.	*/
 
-		result = rule->amsEndpoint->ts->sendAmsFn(rule->amsEndpoint,
-				sap, flowLabel, amsHeader, headerLength,
-				content, contentLength);
-		if (result < 0)
+		if (addToFanout(&fanout, rule, priority, flowLabel,
+				protectedBits) < 0)
 		{
-			return result;
+			return -1;
 		}
 
-		lyst_insert_last(recipients,
-				(void *) ((long) (intn->node->nbr)));
-		// cast to long to avoid warnings on 64-bit
+		noteRecipient(&fanout, intn->node);
 	}
 
 	/*	Now send a copy of the message to every node in the
@@ -5873,7 +6257,7 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 	for (elt = lyst_first(subject->nodes); elt; elt = lyst_next(elt))
 	{
 		intn = (InterestedNode *) lyst_data(elt);
-		if (receivedMsgAlready(recipients, intn->node->nbr))
+		if (receivedMsgAlready(&fanout, intn->node))
 		{
 			continue;	/*	Don't send 2nd copy.	*/
 		}
@@ -5897,35 +6281,16 @@ static int	ams_announce2(AmsSAP *sap, int roleNbr, int continuumNbr,
 			continue;	/*	Can't send node a copy.	*/
 		}
 
-		/*	Can send this node a copy of this message.
-		 *	Supply default priority and/or flow label as
-		 *	necessary, and send message to node.		*/
-
-		if (priority)		/*	Override.		*/
-		{
-			amsHeader[0] = (char) (protectedBits | priority);
-		}
-		else			/*	Use default per rule.	*/
-		{
-			amsHeader[0] = (char) (protectedBits | rule->priority);
-		}
-
-		if (flowLabel == 0)
-		{
-			flowLabel = rule->flowLabel;
-		}
+		/*	Can send this node a copy of this message.	*/
 
-		result = rule->amsEndpoint->ts->sendAmsFn(rule->amsEndpoint,
-				sap, flowLabel, amsHeader, headerLength,
-				content, contentLength);
-		if (result < 0)
+		if (addToFanout(&fanout, rule, priority, flowLabel,
+				protectedBits) < 0)
 		{
-			return result;
+			return -1;
 		}
 	}
 
-	lyst_destroy(recipients);
-	return 0;
+	return flushFanout(&fanout);
 }
 
 int	ams_announce(AmsSAP *sap, int roleNbr, int continuumNbr, int unitNbr,
@@ -6020,7 +6385,11 @@ static int	ams_get_event2(AmsSAP *sap, int term, AmsEvent *event)
 		return -1;
 	}
 
+#ifdef AMS_EVENT_RINGS
+	return getEvent(sap, term, event, llcv_events_pending);
+#else
 	return getEvent(sap, term, event, llcv_lyst_not_empty);
+#endif
 }
 
 int	ams_get_event(AmsSAP *sap, int term, AmsEvent *event)
@@ -266,7 +266,6 @@ static void	*udpAmsReceiver(void *parm)
 {
 	AmsInterface		*tsif = (AmsInterface *) parm;
 	int			fd;
-	AmsSAP			*amsSap;
 	char			*buffer;
 	sigset_t		signals;
 	int			length;
@@ -274,7 +273,6 @@ static void	*udpAmsReceiver(void *parm)
 	unsigned int		fromSize;
 
 	fd = (long) (tsif->sap);
-	amsSap = tsif->amsSap;
 	buffer = MTAKE(UDPTS_MAX_MSG_LEN);
 	if (buffer == NULL)
 	{
@@ -310,7 +308,7 @@ message", NULL);
 
 		/*	Got an AMS message.				*/
 
-		if (enqueueAmsMsg(amsSap, (unsigned char *) buffer, length) < 0)
+		if (deliverAmsMsg(tsif, (unsigned char *) buffer, length) < 0)
 		{
 			putErrmsg("udpts discarded AMS message.", NULL);
 		}
@@ -454,6 +452,74 @@ static int	udpSendMams(MamsEndpoint *ep, MamsInterface *tsif, char *msg,
 	}
 }
 
+static AmsInterface	*udpAmsTsif(AmsSAP *sap, TransSvc *ts)
+{
+	int		i;
+	AmsInterface	*tsif;
+
+	for (i = 0, tsif = sap->amsTsifs; i < sap->transportServiceCount; i++,
+			tsif++)
+	{
+		if (tsif->ts == ts)
+		{
+			return tsif;	/*	Have found interface.	*/
+		}
+	}
+
+	return NULL;			/*	No match.		*/
+}
+
+static int	udpBuildAmsMsg(char *buf, char *header, int headerLen,
+			char *content, int contentLen)
+{
+	unsigned short	checksum;
+
+	memcpy(buf, header, headerLen);
+	if (contentLen > 0)
+	{
+		memcpy(buf + headerLen, content, contentLen);
+	}
+
+	checksum = computeAmsChecksum((unsigned char *) buf,
+			headerLen + contentLen);
+	checksum = htons(checksum);
+	memcpy(buf + headerLen + contentLen, (char *) &checksum, 2);
+	return headerLen + contentLen + 2;
+}
+
+static int	udpSendAmsMsg(int fd, UdpTsep *tsep, char *msg, int len)
+{
+	unsigned short		portNbr;
+	unsigned int		hostNbr;
+	struct sockaddr		socketName;
+	struct sockaddr_in	*inetName;
+
+	portNbr = htons(tsep->portNbr);
+	hostNbr = htonl(tsep->ipAddress);
+	memset((char *) &socketName, 0, sizeof socketName);
+	inetName = (struct sockaddr_in *) &socketName;
+	inetName->sin_family = AF_INET;
+	inetName->sin_port = portNbr;
+	memcpy((char *) &(inetName->sin_addr.s_addr), (char *) &hostNbr, 4);
+	while (1)
+	{
+		if (sendto(fd, msg, len, 0, &socketName,
+				sizeof(struct sockaddr)) < 0)
+		{
+			if (errno == EINTR)	/*	Interrupted.	*/
+			{
+				continue;	/*	Retry.		*/
+			}
+
+//PUTS("udpSendAms failed.");
+			return -1;
+		}
+
+//PUTS("udpSendAms succeeded.");
+		return 0;
+	}
+}
+
 static int	udpSendAms(AmsEndpoint *dp, AmsSAP *sap,
 			unsigned char flowLabel, char *header,
 			int headerLen, char *content, int contentLen)
@@ -461,18 +527,11 @@ static int	udpSendAms(AmsEndpoint *dp, AmsSAP *sap,
 	static char		udpAmsBuf[UDPTS_MAX_MSG_LEN];
 	int			len;
 	UdpTsep			*tsep;
-	int			i;
 	AmsInterface		*tsif;
-	int			fd;
-	unsigned short		portNbr;
-	unsigned int		hostNbr;
-	struct sockaddr		socketName;
-	struct sockaddr_in	*inetName;
-	unsigned short		checksum;
 
 	if (dp == NULL || sap == NULL || header == NULL || headerLen < 0
 	|| contentLen < 0 || (contentLen > 0 && content == NULL)
-	|| (len = (headerLen + contentLen + 2)) > UDPTS_MAX_MSG_LEN)
+	|| (headerLen + contentLen + 2) > UDPTS_MAX_MSG_LEN)
 	{
 		errno = EINVAL;
 		putErrmsg("Can't use UDP to send AMS message.", NULL);
@@ -486,55 +545,85 @@ static int	udpSendAms(AmsEndpoint *dp, AmsSAP *sap,
 		return 0;
 	}
 
-	for (i = 0, tsif = sap->amsTsifs; i < sap->transportServiceCount; i++,
-			tsif++)
+	tsif = udpAmsTsif(sap, dp->ts);
+	if (tsif == NULL)
 	{
-		if (tsif->ts == dp->ts)
-		{
-			break;	/*	Have found interface to use.	*/
-		}
+		return 0;	/*	Cannot send msg to endpoint.	*/
 	}
 
-	if (i == sap->transportServiceCount)	/*	No match.	*/
+	len = udpBuildAmsMsg(udpAmsBuf, header, headerLen, content,
+			contentLen);
+	return udpSendAmsMsg((long) (tsif->sap), tsep, udpAmsBuf, len);
+}
+
+/*	udpSendAmsBatch sends a single AMS message to every endpoint
+ *	in the batch.  The message is assembled and checksummed only
+ *	once, and endpoints that resolve to the same UDP address (as
+ *	when several nodes share a multicast group) are sent only one
+ *	copy of it.							*/
+
+static int	udpSendAmsBatch(AmsEndpoint **endpoints, int endpointCount,
+			AmsSAP *sap, unsigned char flowLabel, char *header,
+			int headerLen, char *content, int contentLen)
+{
+	static char		udpAmsBuf[UDPTS_MAX_MSG_LEN];
+	int			len;
+	AmsInterface		*tsif;
+	int			fd;
+	int			i;
+	int			j;
+	UdpTsep			*tsep;
+	UdpTsep			*prior;
+
+	if (endpoints == NULL || endpointCount < 1 || sap == NULL
+	|| header == NULL || headerLen < 0
+	|| contentLen < 0 || (contentLen > 0 && content == NULL)
+	|| (headerLen + contentLen + 2) > UDPTS_MAX_MSG_LEN)
 	{
-		return 0;	/*	Cannot send msg to endpoint.	*/
+		errno = EINVAL;
+		putErrmsg("Can't use UDP to send AMS message.", NULL);
+		return -1;
 	}
 
-	fd = (long) (tsif->sap); 
-	portNbr = htons(tsep->portNbr);
-	hostNbr = htonl(tsep->ipAddress);
-	memset((char *) &socketName, 0, sizeof socketName);
-	inetName = (struct sockaddr_in *) &socketName;
-	inetName->sin_family = AF_INET;
-	inetName->sin_port = portNbr;
-	memcpy((char *) &(inetName->sin_addr.s_addr), (char *) &hostNbr, 4);
-	memcpy(udpAmsBuf, header, headerLen);
-	if (contentLen > 0)
+	tsif = udpAmsTsif(sap, endpoints[0]->ts);
+	if (tsif == NULL)
 	{
-		memcpy(udpAmsBuf + headerLen, content, contentLen);
+		return 0;	/*	Cannot send msg to endpoints.	*/
 	}
 
-	checksum = computeAmsChecksum((unsigned char *) udpAmsBuf,
-			headerLen + contentLen);
-	checksum = htons(checksum);
-	memcpy(udpAmsBuf + headerLen + contentLen, (char *) &checksum, 2);
-	while (1)
+	fd = (long) (tsif->sap);
+	len = udpBuildAmsMsg(udpAmsBuf, header, headerLen, content,
+			contentLen);
+	for (i = 0; i < endpointCount; i++)
 	{
-		if (sendto(fd, udpAmsBuf, len, 0, &socketName,
-				sizeof(struct sockaddr)) < 0)
+		tsep = (UdpTsep *) (endpoints[i]->tsep);
+		if (tsep == NULL)	/*	Lost connectivity.	*/
 		{
-			if (errno == EINTR)	/*	Interrupted.	*/
+			continue;
+		}
+
+		for (j = 0; j < i; j++)
+		{
+			prior = (UdpTsep *) (endpoints[j]->tsep);
+			if (prior && prior->ipAddress == tsep->ipAddress
+			&& prior->portNbr == tsep->portNbr)
 			{
-				continue;	/*	Retry.		*/
+				break;	/*	Already sent a copy.	*/
 			}
+		}
 
-//PUTS("udpSendAms failed.");
-			return -1;
+		if (j < i)
+		{
+			continue;
 		}
 
-//PUTS("udpSendAms succeeded.");
-		return 0;
+		if (udpSendAmsMsg(fd, tsep, udpAmsBuf, len) < 0)
+		{
+			return -1;
+		}
 	}
+
+	return 0;
 }
 
 static void	udpShutdown(void *abstract_sap)
@@ -566,5 +655,6 @@ void	udptsLoadTs(TransSvc *ts)
 	ts->parseAmsEndpointFn = udpParseAmsEndpoint;
 	ts->clearAmsEndpointFn = udpClearAmsEndpoint;
 	ts->sendAmsFn = udpSendAms;
+	ts->sendAmsBatchFn = udpSendAmsBatch;
 	ts->shutdownFn = udpShutdown;
 }
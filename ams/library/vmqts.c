@@ -102,14 +102,12 @@ static void	*vmqAmsReceiver(void *parm)
 {
 	AmsInterface	*tsif = (AmsInterface *) parm;
 	MSG_Q_ID	vmqSap;
-	AmsSAP		*amsSap;
 	char		*buffer;
 	sigset_t	signals;
 	int		length;
 	int		errnbr;
 
 	vmqSap = (MSG_Q_ID) (tsif->sap);
-	amsSap = tsif->amsSap;
 	buffer = MTAKE(VMQTS_MAX_MSG_LEN);
 	if (buffer == NULL)
 	{
@@ -133,7 +131,7 @@ static void	*vmqAmsReceiver(void *parm)
 
 		/*	Got an AMS message.				*/
 
-		if (enqueueAmsMsg(amsSap, buffer, length) < 0)
+		if (deliverAmsMsg(tsif, (unsigned char *) buffer, length) < 0)
 		{
 			putErrmsg("vmqts discarded AMS message.", NULL);
 		}
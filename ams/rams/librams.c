@@ -256,6 +256,7 @@ static void	handleBundle(BpDelivery *dlv, int *contentLength, char *content,
 	if ((byteCopied = zco_receive_source(sdr, &reader, *contentLength,
 			contentLoc)) < 0)
 	{
+		zco_stop_receiving(sdr, &reader);
 		sdr_cancel_xn(sdr);
 		ErrMsg("Can't receive payload.");
 		*running = 0;
@@ -289,6 +290,7 @@ EnvelopeHeader(content, Env_SubjectNbr),
 		if ((byteCopied = zco_receive_source(sdr, &reader,
 				*contentLength, contentLoc)) < 0)
 		{
+			zco_stop_receiving(sdr, &reader);
 			sdr_cancel_xn(sdr);
 			ErrMsg("Can't receive payload.");
 			*running = 0;
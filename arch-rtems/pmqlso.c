@@ -90,18 +90,18 @@ int	main(int argc, char *argv[])
 	}
 
 	sdr = getIonsdr();
-	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	sdr_begin_read(sdr);
 	findSpan(remoteEngineId, &vspan, &vspanElt);
 	if (vspanElt == 0)
 	{
-		sdr_exit_xn(sdr);
+		sdr_end_read(sdr);
 		putErrmsg("No such engine in database.", itoa(remoteEngineId));
 		return 1;
 	}
 
 	if (vspan->lsoPid > 0 && vspan->lsoPid != sm_TaskIdSelf())
 	{
-		sdr_exit_xn(sdr);
+		sdr_end_read(sdr);
 		putErrmsg("LSO task is already started for this span.",
 				itoa(vspan->lsoPid));
 		return 1;
@@ -109,7 +109,7 @@ int	main(int argc, char *argv[])
 
 	/*	All command-line arguments are now validated.		*/
 
-	sdr_exit_xn(sdr);
+	sdr_end_read(sdr);
 	mq = mq_open(mqName, O_RDWR | O_CREAT, 0777, &mqAttributes);
 	if (mq == (mqd_t) -1)
 	{
@@ -160,10 +160,10 @@ static int	reforwardStrandedBundles(int nodeNbr)
 		OBJ_POINTER(Bundle, bundle);
 
 	sdr_begin_xn(sdr);
-	for (elt = sdr_list_first(sdr, bpConstants->timeline); elt;
-			elt = sdr_list_next(sdr, elt))
+	for (elt = sdr_rbt_first(sdr, bpConstants->timeline); elt;
+			elt = sdr_rbt_next(sdr, elt))
 	{
-		eventObj = sdr_list_data(sdr, elt);
+		eventObj = sdr_rbt_data(sdr, elt);
 		GET_OBJ_POINTER(sdr, BpEvent, event, eventObj);
 		if (event->type != expiredTTL)
 		{
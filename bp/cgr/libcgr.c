@@ -22,6 +22,156 @@ typedef struct
 	int		distance;	/*	# hops from dest. node.	*/
 } ProximateNode;
 
+/*	Traversal of the contact graph depends on the bundle only
+ *	through the station node, the bundle's expiration time (the
+ *	"deadline"), its payload length, and the list of nodes that
+ *	are excluded from the route; everything else that bears on
+ *	the selection of proximate nodes (residual capacity, backlog,
+ *	plans, snubs by the proximate node itself) is examined by
+ *	tryContact.  So the contacts that a traversal would submit
+ *	to tryContact are cached as a CgrRoute and are replayed
+ *	through tryContact for every subsequent bundle that matches
+ *	the route's key, until the contact graph changes.
+ *
+ *	To make routes shareable, deadlines are grouped in buckets
+ *	and the traversal is performed for the last second of the
+ *	bundle's deadline bucket.  Every deadline that is computed
+ *	in the course of the traversal is min(bound, D - offset),
+ *	where D is the bundle's deadline, so for each candidate
+ *	contact the traversal also notes the earliest D for which
+ *	every test on the path to that contact succeeds and the
+ *	latest time at which the contact can still be seized.
+ *	Candidates that are not viable for the actual deadline of
+ *	the bundle at the current time are skipped on replay, so
+ *	the result is the same as that of a traversal performed
+ *	for the bundle's own deadline.
+ *
+ *	Payload lengths are likewise grouped: the traversal is
+ *	performed for the largest length that has the same three
+ *	most significant bits as the bundle's payload length, which
+ *	can only make the route more conservative.		*/
+
+#ifndef CGR_DEADLINE_BUCKET
+#define CGR_DEADLINE_BUCKET	(64)	/*	Seconds.		*/
+#endif
+
+#ifndef CGR_ROUTE_CACHE_SIZE
+#define CGR_ROUTE_CACHE_SIZE	(64)	/*	Must be a power of 2.	*/
+#endif
+
+typedef struct
+{
+	PsmAddress	node;		/*	IonNode to try.		*/
+	PsmAddress	xmit;		/*	IonXmit to that node.	*/
+	time_t		forfeitTime;
+	time_t		deliveryTime;
+	int		distance;	/*	# hops from dest. node.	*/
+	unsigned long	minDeadline;	/*	Earliest usable D.	*/
+	unsigned long	lastChance;	/*	Seize by this time.	*/
+	unsigned long	lastChanceLag;	/*	Also seize by D - lag.	*/
+} CgrCandidate;
+
+typedef struct
+{
+	unsigned long	stationNodeNbr;
+	unsigned long	deadline;	/*	End of bucket.		*/
+	unsigned long	payloadLength;	/*	Max. in length class.	*/
+	int		excludedCount;
+	unsigned long	*excluded;	/*	Sorted node numbers.	*/
+	int		candidateCount;
+	int		candidateLimit;
+	CgrCandidate	*candidates;
+} CgrRoute;
+
+typedef struct
+{
+	unsigned long	graphVersion;	/*	Per IonVdb.		*/
+	CgrRoute	*routes[CGR_ROUTE_CACHE_SIZE];
+} CgrCache;
+
+static CgrCache	*_routeCache()
+{
+	static CgrCache	cache;
+
+	return &cache;
+}
+
+static void	destroyRoute(CgrRoute *route)
+{
+	if (route->excluded)
+	{
+		MRELEASE(route->excluded);
+	}
+
+	if (route->candidates)
+	{
+		MRELEASE(route->candidates);
+	}
+
+	MRELEASE(route);
+}
+
+static void	flushRouteCache(CgrCache *cache)
+{
+	int	i;
+
+	for (i = 0; i < CGR_ROUTE_CACHE_SIZE; i++)
+	{
+		if (cache->routes[i])
+		{
+			destroyRoute(cache->routes[i]);
+			cache->routes[i] = NULL;
+		}
+	}
+}
+
+static int	noteCandidate(CgrRoute *route, IonNode *node, IonXmit *xmit,
+			time_t forfeitTime, time_t deliveryTime, int distance,
+			unsigned long minDeadline, unsigned long lastChance,
+			unsigned long lastChanceLag)
+{
+	PsmPartition	ionwm = getIonwm();
+	int		newLimit;
+	CgrCandidate	*newCandidates;
+	CgrCandidate	*candidate;
+
+	if (route->candidateCount == route->candidateLimit)
+	{
+		newLimit = route->candidateLimit == 0 ? 4
+				: route->candidateLimit << 1;
+		newCandidates = (CgrCandidate *)
+				MTAKE(newLimit * sizeof(CgrCandidate));
+		if (newCandidates == NULL)
+		{
+			putErrmsg("Can't note route candidate.", NULL);
+			return -1;
+		}
+
+		if (route->candidates)
+		{
+			memcpy((char *) newCandidates,
+				(char *) route->candidates,
+				route->candidateCount * sizeof(CgrCandidate));
+			MRELEASE(route->candidates);
+		}
+
+		route->candidates = newCandidates;
+		route->candidateLimit = newLimit;
+	}
+
+	candidate = route->candidates + route->candidateCount;
+	candidate->node = psa(ionwm, node);
+	candidate->xmit = psa(ionwm, xmit);
+	candidate->forfeitTime = forfeitTime;
+	candidate->deliveryTime = deliveryTime;
+	candidate->distance = distance;
+	candidate->minDeadline = minDeadline;
+	candidate->lastChance = lastChance;
+	candidate->lastChanceLag = lastChanceLag;
+	route->candidateCount++;
+	return 0;
+}
+
 static void	resetLastVisitor()
 {
 	PsmPartition	ionwm = getIonwm();
@@ -31,14 +181,15 @@ static void	resetLastVisitor()
 	PsmAddress	elt2;
 	IonXmit		*xmit;
 
-	for (elt = sm_list_first(ionwm, ionvdb->nodes); elt;
-			elt = sm_list_next(ionwm, elt))
+	for (elt = sm_rbt_first(ionwm, ionvdb->nodes); elt;
+			elt = sm_rbt_next(ionwm, elt))
 	{
-		node = (IonNode *) psp(ionwm, sm_list_data(ionwm, elt));
+		node = (IonNode *) psp(ionwm, sm_rbt_data(ionwm, elt));
 		for (elt2 = sm_list_first(ionwm, node->xmits); elt2;
 				elt2 = sm_list_next(ionwm, elt2))
 		{
-			xmit = (IonXmit *) psp(ionwm, sm_list_data(ionwm, elt));
+			xmit = (IonXmit *) psp(ionwm,
+					sm_list_data(ionwm, elt2));
 			xmit->lastVisitor = 0;
 			xmit->visitHorizon = 0;
 		}
@@ -271,14 +422,15 @@ static int	isExcluded(unsigned long nodeNbr, Lyst excludedNodes)
 	return 0;
 }
 
-static int	identifyProximateNodes(IonNode *node, Object plans,
-			unsigned long deadline, IonNode *stationNode,
-			Bundle *bundle, Object bundleObj, Lyst excludedNodes,
-			Lyst proximateNodes, time_t forfeitTime,
-			time_t deliveryTime, int distance,
+static int	identifyProximateNodes(IonNode *node, unsigned long bound,
+			unsigned long offset, unsigned long minDeadline,
+			Lyst excludedNodes, CgrRoute *route,
+			time_t forfeitTime, time_t deliveryTime, int distance,
 			unsigned int visitorNbr)
 {
 	PsmPartition	ionwm = getIonwm();
+	unsigned long	deadline;
+	unsigned long	floor;
 	LystElt		exclusion;
 	PsmAddress	elt;
 	IonXmit		*xmit;
@@ -293,6 +445,16 @@ static int	identifyProximateNodes(IonNode *node, Object plans,
 	unsigned long	forwardingLatency;
 	unsigned long	maxFromTime;
 
+	/*	The deadline for transmission to this node, for a
+	 *	bundle whose own deadline is D, is min(bound, D - offset).
+	 *	The route is computed for the latest D in the bucket.	*/
+
+	deadline = route->deadline > offset ? route->deadline - offset : 0;
+	if (bound < deadline)
+	{
+		deadline = bound;
+	}
+
 	/*	Make sure we don't get into a routing loop while
 	 *	trying to compute routes to this node.			*/
 
@@ -323,6 +485,15 @@ node->nodeNbr, deadline);
 			continue;	/*	Too late; ignore it.	*/
 		}
 
+		/*	Usable only if D - offset is not earlier than
+		 *	the start of the contact.			*/
+
+		floor = xmit->fromTime + offset;
+		if (floor < minDeadline)
+		{
+			floor = minDeadline;
+		}
+
 		/*	The "usability" of a contact is a best-case
 		 *	determination as to whether or not it is
 		 *	mathematically plausible for a bundle sent
@@ -342,9 +513,15 @@ node->nodeNbr, deadline);
 
 		if (xmit->lastVisitor == visitorNbr)
 		{
-			/*	Have already considered this contact.	*/
-
-			if (deadline <= xmit->visitHorizon)
+			/*	Have already considered this contact.
+			 *	Since the route applies to every D in
+			 *	the deadline bucket, the earlier visit
+			 *	supersedes this one only if that is so
+			 *	for every such D.			*/
+
+			if (deadline <= xmit->visitHorizon
+			&& offset >= xmit->visitOffset
+			&& floor >= xmit->visitFloor)
 			{
 				continue;
 			}
@@ -368,6 +545,8 @@ node->nodeNbr, deadline);
 
 		xmit->lastVisitor = visitorNbr;
 		xmit->visitHorizon = deadline;
+		xmit->visitOffset = offset;
+		xmit->visitFloor = floor;
 		if (distance == 0)	/*	Final contact on path.	*/
 		{
 			deliveryTime = xmit->toTime;
@@ -394,9 +573,9 @@ node->nodeNbr, deadline);
 				closingTime = forfeitTime;
 			}
 
-			if (tryContact(node, xmit, bundle, plans, 
-					proximateNodes, closingTime,
-					deliveryTime, distance))
+			if (noteCandidate(route, node, xmit, closingTime,
+					deliveryTime, distance, floor,
+					(unsigned long) -1, offset))
 			{
 				putErrmsg("Can't check contact.", NULL);
 				return -1;
@@ -428,7 +607,8 @@ printf("xmit's origin node (%lu) is excluded; next xmit.\n", origin->nodeNbr);
 		/*	Not a routing loop.  Can this happen in time?	*/
 
 		owltMargin = ((MAX_SPEED_MPH / 3600) * origin->owlt) / 186282;
-		lastChanceFromOrigin = deadline - (origin->owlt + owltMargin);
+		owltMargin += origin->owlt;
+		lastChanceFromOrigin = deadline - owltMargin;
 		currentTime = (unsigned long) getUTCTime();
 		if (currentTime > lastChanceFromOrigin)
 		{
@@ -454,6 +634,11 @@ xmit->fromTime, xmit->fromTime - lastChanceFromOrigin);
 		 *	bundle to the station node from the indicated
 		 *	origin node.					*/
 
+		if (floor < xmit->fromTime + offset + owltMargin)
+		{
+			floor = xmit->fromTime + offset + owltMargin;
+		}
+
 		if (origin->nodeNbr == getOwnNodeNbr())
 		{
 #if CGRDEBUG
@@ -469,9 +654,10 @@ printf("Queueing directly from local node to node %lu.\n", node->nodeNbr);
 				closingTime = forfeitTime;
 			}
 
-			if (tryContact(node, xmit, bundle, plans, 
-					proximateNodes, closingTime,
-					deliveryTime, distance))
+			if (noteCandidate(route, node, xmit, closingTime,
+					deliveryTime, distance, floor,
+					bound - owltMargin,
+					offset + owltMargin))
 			{
 				putErrmsg("Can't check contact.", NULL);
 				return -1;
@@ -511,24 +697,28 @@ printf("Now computing route to node %lu.\n", origin->nodeNbr);
 				closingTime = forfeitTime;
 			}
 
-			forwardingLatency = (bundle->payload.length << 1)
+			/*	For a bundle whose deadline is D,
+			 *	lastChanceFromOrigin is min(bound, D -
+			 *	offset) less the OWLT margin, so the new
+			 *	deadline is min(maxFromTime, D - offset
+			 *	- OWLT margin) for the maxFromTime
+			 *	computed here.				*/
+
+			forwardingLatency = (route->payloadLength << 1)
 					/ xmit->xmitRate;
 			maxFromTime = xmit->toTime - forwardingLatency;
-#if CGRDEBUG
-printf("New deadline is %lu.\n", maxFromTime);
-#endif
-			if (lastChanceFromOrigin < maxFromTime)
+			if (bound - owltMargin < maxFromTime)
 			{
-				maxFromTime = lastChanceFromOrigin;
+				maxFromTime = bound - owltMargin;
+			}
 #if CGRDEBUG
-printf("New deadline changed to %lu.\n", maxFromTime);
+printf("New deadline bound is %lu.\n", maxFromTime);
 #endif
-			}
 
-			if (identifyProximateNodes(originNode, plans,
-				maxFromTime, stationNode, bundle, bundleObj,
-				excludedNodes, proximateNodes, closingTime,
-				deliveryTime, distance + 1, visitorNbr) < 0)
+			if (identifyProximateNodes(originNode, maxFromTime,
+				offset + owltMargin, floor, excludedNodes,
+				route, closingTime, deliveryTime, distance + 1,
+				visitorNbr) < 0)
 			{
 				putErrmsg("Can't identify origin prox. nodes.",
 						NULL);
@@ -547,6 +737,158 @@ origin->nodeNbr, node->nodeNbr);
 	return 0;
 }
 
+static int	sameKey(CgrRoute *route, unsigned long stationNodeNbr,
+			unsigned long deadline, unsigned long payloadLength,
+			unsigned long *excluded, int excludedCount)
+{
+	int	i;
+
+	if (route->stationNodeNbr != stationNodeNbr
+	|| route->deadline != deadline
+	|| route->payloadLength != payloadLength
+	|| route->excludedCount != excludedCount)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < excludedCount; i++)
+	{
+		if (route->excluded[i] != excluded[i])
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static CgrRoute	*getRoute(IonNode *stationNode, unsigned long deadline,
+			unsigned long payloadLength, Lyst excludedNodes)
+{
+	CgrCache	*cache = _routeCache();
+	IonVdb		*ionvdb = getIonVdb();
+	int		shift;
+	int		excludedCount;
+	unsigned long	*excluded = NULL;
+	LystElt		elt;
+	unsigned long	nodeNbr;
+	int		i;
+	unsigned long	hash;
+	CgrRoute	*route;
+
+	if (cache->graphVersion != ionvdb->graphVersion)
+	{
+		flushRouteCache(cache);
+		cache->graphVersion = ionvdb->graphVersion;
+	}
+
+	/*	Compute the key of the applicable route: the last
+	 *	second of the deadline's bucket, the largest payload
+	 *	length with the same three most significant bits,
+	 *	and the sorted list of excluded nodes.			*/
+
+	deadline += (CGR_DEADLINE_BUCKET - 1)
+			- (deadline % CGR_DEADLINE_BUCKET);
+	for (shift = 0; (payloadLength >> shift) > 7; shift++)
+	{
+		;
+	}
+
+	payloadLength |= (1UL << shift) - 1;
+	excludedCount = lyst_length(excludedNodes);
+	if (excludedCount > 0)
+	{
+		excluded = (unsigned long *)
+				MTAKE(excludedCount * sizeof(unsigned long));
+		if (excluded == NULL)
+		{
+			putErrmsg("Can't note excluded nodes.", NULL);
+			return NULL;
+		}
+	}
+
+	excludedCount = 0;
+	for (elt = lyst_first(excludedNodes); elt; elt = lyst_next(elt))
+	{
+		/*	Insertion sort; the list is short.		*/
+
+		nodeNbr = (unsigned long) lyst_data(elt);
+		for (i = excludedCount; i > 0 && excluded[i - 1] > nodeNbr;
+				i--)
+		{
+			excluded[i] = excluded[i - 1];
+		}
+
+		excluded[i] = nodeNbr;
+		excludedCount++;
+	}
+
+	hash = stationNode->nodeNbr * 31 + deadline / CGR_DEADLINE_BUCKET;
+	hash = hash * 31 + payloadLength;
+	for (i = 0; i < excludedCount; i++)
+	{
+		hash = hash * 31 + excluded[i];
+	}
+
+	hash &= (CGR_ROUTE_CACHE_SIZE - 1);
+
+	/*	Use the cached route if there is one.			*/
+
+	route = cache->routes[hash];
+	if (route)
+	{
+		if (sameKey(route, stationNode->nodeNbr, deadline,
+				payloadLength, excluded, excludedCount))
+		{
+			getBpVdb()->cgrHits++;
+			if (excluded)
+			{
+				MRELEASE(excluded);
+			}
+
+			return route;
+		}
+
+		destroyRoute(route);
+		cache->routes[hash] = NULL;
+	}
+
+	/*	Must traverse the contact graph to compute the route.	*/
+
+	getBpVdb()->cgrMisses++;
+	route = (CgrRoute *) MTAKE(sizeof(CgrRoute));
+	if (route == NULL)
+	{
+		if (excluded)
+		{
+			MRELEASE(excluded);
+		}
+
+		putErrmsg("Can't create route.", NULL);
+		return NULL;
+	}
+
+	memset((char *) route, 0, sizeof(CgrRoute));
+	route->stationNodeNbr = stationNode->nodeNbr;
+	route->deadline = deadline;
+	route->payloadLength = payloadLength;
+	route->excludedCount = excludedCount;
+	route->excluded = excluded;
+#if CGRDEBUG
+printf("--------------- Start of contact graph traversal -------------\n");
+#endif
+	if (identifyProximateNodes(stationNode, (unsigned long) -1, 0, 0,
+			excludedNodes, route, 0, 0, 0, _visitorCount(1)) < 0)
+	{
+		destroyRoute(route);
+		putErrmsg("Can't compute route.", NULL);
+		return NULL;
+	}
+
+	cache->routes[hash] = route;
+	return route;
+}
+
 static int	enqueueToNeighbor(ProximateNode *proxNode, Bundle *bundle,
 			Object bundleObj, IonNode *stationNode)
 {
@@ -656,7 +998,11 @@ int	cgr_forward(Bundle *bundle, Object bundleObj,
 	PsmPartition	ionwm = getIonwm();
 	PsmAddress	snubElt;
 	IonSnub		*snub;
-	unsigned int	visitorNbr;
+	unsigned long	deadline;
+	unsigned long	currentTime;
+	CgrRoute	*route;
+	CgrCandidate	*candidate;
+	int		i;
 	LystElt		elt;
 	LystElt		nextElt;
 	ProximateNode	*proxNode;
@@ -742,19 +1088,37 @@ printf("No routing information for node %lu.\n", stationNodeNbr);
 	/*	Consult the contact graph to identify the neighboring
 	 *	node(s) to forward the bundle to.			*/
 
-#if CGRDEBUG
-printf("--------------- Start of contact graph traversal -------------\n");
-#endif
-	visitorNbr = _visitorCount(1);
-	if (identifyProximateNodes(stationNode, plans,
-			bundle->expirationTime + EPOCH_2000_SEC,
-			stationNode, bundle, bundleObj, excludedNodes,
-			proximateNodes, 0, 0, 0, visitorNbr) < 0)
+	deadline = bundle->expirationTime + EPOCH_2000_SEC;
+	route = getRoute(stationNode, deadline, bundle->payload.length,
+			excludedNodes);
+	if (route == NULL)
 	{
 		putErrmsg("Can't identify proximate nodes for bundle.", NULL);
 		return -1;
 	}
 
+	currentTime = getUTCTime();
+	for (i = 0, candidate = route->candidates; i < route->candidateCount;
+			i++, candidate++)
+	{
+		if (deadline < candidate->minDeadline
+		|| currentTime > candidate->lastChance
+		|| currentTime + candidate->lastChanceLag > deadline)
+		{
+			continue;	/*	Not viable for bundle.	*/
+		}
+
+		if (tryContact((IonNode *) psp(ionwm, candidate->node),
+				(IonXmit *) psp(ionwm, candidate->xmit),
+				bundle, plans, proximateNodes,
+				candidate->forfeitTime,
+				candidate->deliveryTime, candidate->distance))
+		{
+			putErrmsg("Can't check contact.", NULL);
+			return -1;
+		}
+	}
+
 	/*	Examine the list of proximate nodes.  If the bundle
 	 *	is critical, enqueue it on the outduct to EACH
 	 *	identified proximate destination node.
@@ -866,3 +1230,24 @@ printf("CGR found no route.\n");
 	lyst_destroy(proximateNodes);
 	return 0;
 }
+
+/*	Route cache statistics are kept in the BP volatile database,
+ *	where bpstats can report them while the forwarder is running.	*/
+
+void	cgr_stats(unsigned long *hits, unsigned long *misses)
+{
+	BpVdb	*bpvdb = getBpVdb();
+
+	CHKVOID(hits && misses);
+	*hits = bpvdb->cgrHits;
+	*misses = bpvdb->cgrMisses;
+}
+
+void	cgr_stop()
+{
+	BpVdb	*bpvdb = getBpVdb();
+
+	flushRouteCache(_routeCache());
+	bpvdb->cgrHits = 0;
+	bpvdb->cgrMisses = 0;
+}
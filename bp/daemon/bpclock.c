@@ -10,9 +10,30 @@
 									*/
 #include "bpP.h"
 #include "smlist.h"
+#include "timewheel.h"
+
+#ifndef BP_RATE_CONTROL_INTERVAL
+#define	BP_RATE_CONTROL_INTERVAL	(100)	/*	Milliseconds.	*/
+#endif
+
+#ifndef BP_CLOCK_BATCH_SIZE
+#define	BP_CLOCK_BATCH_SIZE	(1000)	/*	Events per transaction.	*/
+#endif
+
+#ifndef BPCLOCKDEBUG
+#define	BPCLOCKDEBUG	0
+#endif
 
 extern void	manageProductionThrottle(BpVdb *vdb);
 
+typedef struct
+{
+	Sdr		sdr;
+	Object		timeline;
+	TwTimer		*timelineTimer;
+	time_t		timelineDeadline;
+} BpClock;
+
 static int	_running(int *newValue)
 {
 	static int	state;
@@ -38,84 +59,206 @@ static void	shutDown()	/*	Commands bpclock termination.	*/
 	int	stop = 0;
 
 	oK(_running(&stop));	/*	Terminates bpclock.		*/
+	sm_SemGive(getBpVdb()->clockSemaphore);
 }
 
-static int	dispatchEvents(Sdr sdr, Object events, time_t currentTime)
+static int	dispatchEvent(Sdr sdr, Object elt, BpEvent *event)
 {
-	Object	elt;
-	Object	eventObj;
-		OBJ_POINTER(BpEvent, event);
-	int	result;
-
-	while (1)
+	switch (event->type)
 	{
-		sdr_begin_xn(sdr);
-		CHKERR(ionLocked());	/*	In case of killm.	*/
-		elt = sdr_list_first(sdr, events);
-		if (elt == 0)	/*	No more events to dispatch.	*/
-		{
-			sdr_exit_xn(sdr);
-			return 0;
-		}
+	case expiredTTL:
 
-		eventObj = sdr_list_data(sdr, elt);
-		GET_OBJ_POINTER(sdr, BpEvent, event, eventObj);
-		if (event->time > currentTime)
-		{
-			/*	This is the first future event.		*/
+		/*	Note that bpDestroyBundle() always erases the
+		 *	bundle's timeline event, so we must NOT do so
+		 *	here.						*/
 
-			sdr_exit_xn(sdr);
-			return 0;
-		}
+		return bpDestroyBundle(event->ref, 1);
 
-		switch (event->type)
-		{
-		case expiredTTL:
-			result = bpDestroyBundle(event->ref, 1);
+	case xmitOverdue:
+
+		/*	Note that bpReforwardBundle() always erases the
+		 *	bundle's xmitOverdue event, so we must NOT do
+		 *	so here.					*/
+
+		return bpReforwardBundle(event->ref);
 
-			/*	Note that bpDestroyBundle() always
-			 *	erases the bundle's timeline event,
-			 *	so we must NOT do so here.		*/
+	case ctDue:
 
-			break;		/*	Out of switch.		*/
+		/*	Note that bpReforwardBundle() always erases the
+		 *	bundle's ctDue event, so we must NOT do so here.*/
 
-		case xmitOverdue:
-			result = bpReforwardBundle(event->ref);
+		return bpReforwardBundle(event->ref);
 
-			/*	Note that bpReforwardBundle() always
-			 *	erases the bundle's xmitOverdue event,
-			 *	so we must NOT do so here.		*/
+	case acsDue:
 
-			break;		/*	Out of switch.		*/
+		/*	Note that bpFlushAcs() always erases the
+		 *	aggregate custody signal's acsDue event, so we
+		 *	must NOT do so here.				*/
+
+		return bpFlushAcs(event->ref);
+
+	default:		/*	Spurious event; erase.		*/
+		destroyBpTimelineEvent(elt);
+		return 0;	/*	Event is ignored.		*/
+	}
+}
 
-		case ctDue:
-			result = bpReforwardBundle(event->ref);
+static long	usecSince(struct timeval *start)
+{
+	struct timeval	now;
 
-			/*	Note that bpReforwardBundle() always
-			 *	erases the bundle's ctDue event, so
-			 *	we must NOT do so here.			*/
+	getCurrentTime(&now);
+	return ((now.tv_sec - start->tv_sec) * 1000000)
+			+ (now.tv_usec - start->tv_usec);
+}
 
-			break;		/*	Out of switch.		*/
+static void	noteTick(Sdr sdr, unsigned long events, unsigned long batches,
+			unsigned long usec)
+{
+	BpVdb	*vdb = getBpVdb();
+#if BPCLOCKDEBUG
+	char	buffer[128];
+#endif
 
-		default:		/*	Spurious event; erase.	*/
-			sdr_free(sdr, eventObj);
-			sdr_list_delete(sdr, elt, NULL, NULL);
-			result = 0;	/*	Event is ignored.	*/
+	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	vdb->tickEvents = events;
+	vdb->tickBatches = batches;
+	vdb->tickUsec = usec;
+	vdb->clockEvents += events;
+	vdb->clockUsec += usec;
+	sdr_exit_xn(sdr);	/*	Unlock memory.			*/
+#if BPCLOCKDEBUG
+	if (batches > 1)
+	{
+		isprintf(buffer, sizeof buffer, "[i] bpclock dispatched %lu \
+events in %lu transactions, %lu usec.", events, batches, usec);
+		writeMemo(buffer);
+	}
+#endif
+}
+
+/*	Due events are dispatched in batches, each batch in a single
+ *	transaction that ends when the timeline holds no more due
+ *	events, when BP_CLOCK_BATCH_SIZE events have been dispatched,
+ *	or when the BP database's clock batch time has elapsed --
+ *	whichever comes first.  Between batches bpclock yields, so
+ *	that CLOs blocked on the SDR lock are not starved by a large
+ *	backlog of events.
+ *
+ *	Since a batch is a single transaction, an event that can't
+ *	be handled would cancel every event dispatched before it in
+ *	the same batch.  So when that happens the batch is re-run,
+ *	stopping short of the failing event; the preceding events are
+ *	committed and the failing event is then retried by itself.
+ *	Only an event that fails in a batch of its own is fatal.	*/
+
+static int	dispatchEvents(Sdr sdr, Object events, time_t currentTime)
+{
+	BpVdb		*vdb = getBpVdb();
+	struct timeval	tickStart;
+	struct timeval	batchStart;
+	unsigned long	tickEvents = 0;
+	unsigned long	tickBatches = 0;
+	int		batchLimit = BP_CLOCK_BATCH_SIZE;
+	int		batchEvents;
+	int		moreEvents = 1;
+	BpStateStats	stateStats[8];
+	Object		elt;
+	Object		eventObj;
+			OBJ_POINTER(BpEvent, event);
+
+	getCurrentTime(&tickStart);
+	while (moreEvents)
+	{
+		getCurrentTime(&batchStart);
+		batchEvents = 0;
+		sdr_begin_xn(sdr);
+		CHKERR(ionLocked());	/*	In case of killm.	*/
+
+		/*	State statistics are in volatile memory, so
+		 *	they aren't restored if the batch is canceled.	*/
+
+		memcpy((char *) stateStats, (char *) vdb->stateStats,
+				sizeof stateStats);
+		while (1)
+		{
+			elt = sdr_rbt_first(sdr, events);
+			if (elt == 0)	/*	No more events to dispatch.	*/
+			{
+				moreEvents = 0;
+				break;
+			}
+
+			eventObj = sdr_rbt_data(sdr, elt);
+			GET_OBJ_POINTER(sdr, BpEvent, event, eventObj);
+			if (event->time > currentTime)
+			{
+				/*	This is the first future event.	*/
+
+				moreEvents = 0;
+				break;
+			}
+
+			if (dispatchEvent(sdr, elt, event) != 0)
+			{
+				memcpy((char *) vdb->stateStats,
+						(char *) stateStats,
+						sizeof stateStats);
+				sdr_cancel_xn(sdr);
+				if (batchEvents == 0)
+				{
+					putErrmsg("Failed handling BP event.",
+							NULL);
+					return -1;
+				}
+
+				break;	/*	Re-run up to this event.*/
+			}
+
+			batchEvents++;
+			if (batchEvents >= batchLimit
+			|| usecSince(&batchStart) >= vdb->clockBatchTime * 1000)
+			{
+				break;	/*	End of batch.		*/
+			}
+		}
+
+		if (!sdr_in_xn(sdr))	/*	Batch was canceled.	*/
+		{
+			writeMemoNote("[?] Re-running bpclock batch without \
+failed event", itoa(batchEvents));
+			batchLimit = batchEvents;
+			moreEvents = 1;
+			continue;
 		}
 
-		if (result != 0)	/*	Dispatching failed.	*/
+		if (batchEvents == 0)
 		{
-			sdr_cancel_xn(sdr);
-			putErrmsg("Failed handing BP event.", NULL);
-			return result;
+			sdr_exit_xn(sdr);
+			break;
 		}
 
 		if (sdr_end_xn(sdr) < 0)
 		{
-			putErrmsg("Failed dispatching BP event.", NULL);
+			putErrmsg("Failed dispatching BP events.", NULL);
 			return -1;
 		}
+
+		tickEvents += batchEvents;
+		tickBatches++;
+		batchLimit = BP_CLOCK_BATCH_SIZE;
+		if (moreEvents)
+		{
+			sm_TaskYield();	/*	Let CLOs have the SDR.	*/
+		}
 	}
+
+	if (tickEvents > 0)
+	{
+		noteTick(sdr, tickEvents, tickBatches, usecSince(&tickStart));
+	}
+
+	return 0;
 }
 
 static int	adjustThrottles()
@@ -269,7 +412,6 @@ static void	applyRateControl(Sdr sdr)
 	PsmAddress	elt;
 	VInduct		*induct;
 	VOutduct	*outduct;
-	long		capacityLimit;
 
 	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
 
@@ -277,40 +419,30 @@ static void	applyRateControl(Sdr sdr)
 
 	manageProductionThrottle(vdb);
 
-	/*	Enable some bundle acquisition.				*/
+	/*	Duct throttles are refilled continuously by the CLI
+	 *	and CLO tasks themselves.  Here we need only wake
+	 *	any task that is blocked on a throttle whose nominal
+	 *	rate was zero and now is not, so that it resumes
+	 *	acquisition or transmission.				*/
 
 	for (elt = sm_list_first(ionwm, vdb->inducts); elt;
 			elt = sm_list_next(ionwm, elt))
 	{
 		induct = (VInduct *) psp(ionwm, sm_list_data(ionwm, elt));
 		throttle = &(induct->acqThrottle);
-		capacityLimit = throttle->nominalRate << 1;
-		throttle->capacity += throttle->nominalRate;
-		if (throttle->capacity > capacityLimit)
-		{
-			throttle->capacity = capacityLimit;
-		}
-
+		refillThrottle(throttle);
 		if (throttle->capacity > 0)
 		{
 			sm_SemGive(throttle->semaphore);
 		}
 	}
 
-	/*	Enable some bundle transmission.			*/
-
 	for (elt = sm_list_first(ionwm, vdb->outducts); elt;
 			elt = sm_list_next(ionwm, elt))
 	{
 		outduct = (VOutduct *) psp(ionwm, sm_list_data(ionwm, elt));
 		throttle = &(outduct->xmitThrottle);
-		capacityLimit = throttle->nominalRate << 1;
-		throttle->capacity += throttle->nominalRate;
-		if (throttle->capacity > capacityLimit)
-		{
-			throttle->capacity = capacityLimit;
-		}
-
+		refillThrottle(throttle);
 		if (throttle->capacity > 0)
 		{
 			sm_SemGive(throttle->semaphore);
@@ -320,6 +452,96 @@ static void	applyRateControl(Sdr sdr)
 	sdr_exit_xn(sdr);	/*	Unlock memory.			*/
 }
 
+/*	*	*	Timer functions		*	*	*	*/
+
+static void	dispatchTimeline(TimeWheel *wheel, void *arg)
+{
+	BpClock	*clock = (BpClock *) arg;
+	int	stop = 0;
+
+	clock->timelineTimer = NULL;
+	if (dispatchEvents(clock->sdr, clock->timeline, getUTCTime()) < 0)
+	{
+		putErrmsg("Can't dispatch events.", NULL);
+		oK(_running(&stop));
+	}
+}
+
+static void	manageRates(TimeWheel *wheel, void *arg)
+{
+	BpClock		*clock = (BpClock *) arg;
+	int		stop = 0;
+
+	/*	Adjust throttles in response to rate changes noted
+	 *	in the shared ION database, then apply rate control.	*/
+
+	if (adjustThrottles() < 0)
+	{
+		putErrmsg("Can't adjust throttles.", NULL);
+		oK(_running(&stop));
+		return;
+	}
+
+	applyRateControl(clock->sdr);
+	if (tw_insert_ms(wheel, BP_RATE_CONTROL_INTERVAL, manageRates, clock)
+			== NULL)
+	{
+		putErrmsg("Can't schedule rate control.", NULL);
+		oK(_running(&stop));
+	}
+}
+
+/*	Makes sure the wheel holds a timer for the time of the first
+ *	event in the timeline, expressed in local clock time.		*/
+
+static int	scheduleTimeline(TimeWheel *wheel, BpClock *clock)
+{
+	Sdr		sdr = clock->sdr;
+	Object		elt;
+			OBJ_POINTER(BpEvent, event);
+	time_t		eventTime = 0;
+	struct timeval	deadline;
+
+	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	elt = sdr_rbt_first(sdr, clock->timeline);
+	if (elt)
+	{
+		GET_OBJ_POINTER(sdr, BpEvent, event, sdr_rbt_data(sdr, elt));
+		eventTime = event->time;
+	}
+
+	sdr_exit_xn(sdr);
+	if (clock->timelineTimer)
+	{
+		if (elt && eventTime == clock->timelineDeadline)
+		{
+			return 0;	/*	Already scheduled.	*/
+		}
+
+		tw_cancel(wheel, clock->timelineTimer);
+		clock->timelineTimer = NULL;
+	}
+
+	if (elt == 0)
+	{
+		return 0;		/*	Nothing to schedule.	*/
+	}
+
+	getCurrentTime(&deadline);
+	deadline.tv_sec = eventTime + (deadline.tv_sec - getUTCTime());
+	deadline.tv_usec = 0;
+	clock->timelineTimer = tw_insert(wheel, &deadline, dispatchTimeline,
+			clock);
+	if (clock->timelineTimer == NULL)
+	{
+		putErrmsg("Can't schedule timeline dispatch.", NULL);
+		return -1;
+	}
+
+	clock->timelineDeadline = eventTime;
+	return 0;
+}
+
 #if defined (VXWORKS) || defined (RTEMS)
 int	bpclock(int a1, int a2, int a3, int a4, int a5,
 		int a6, int a7, int a8, int a9, int a10)
@@ -328,10 +550,10 @@ int	bpclock(int a1, int a2, int a3, int a4, int a5,
 int	main(int argc, char *argv[])
 {
 #endif
-	Sdr	sdr;
-	BpDB	*bpConstants;
-	int	state = 1;
-	time_t	currentTime;
+	BpVdb		*bpvdb;
+	int		state = 1;
+	BpClock		clock;
+	TimeWheel	*wheel;
 
 	if (bpAttach() < 0)
 	{
@@ -339,46 +561,48 @@ int	main(int argc, char *argv[])
 		return 1;
 	}
 
-	sdr = getIonsdr();
-	bpConstants = getBpConstants();
+	bpvdb = getBpVdb();
+	memset((char *) &clock, 0, sizeof(BpClock));
+	clock.sdr = getIonsdr();
+	clock.timeline = getBpConstants()->timeline;
+	wheel = tw_create(bpvdb->clockSemaphore);
+	if (wheel == NULL || tw_insert_ms(wheel, BP_RATE_CONTROL_INTERVAL,
+			manageRates, &clock) == NULL)
+	{
+		putErrmsg("bpclock can't start timer wheel.", NULL);
+		ionDetach();
+		return 1;
+	}
+
 	isignal(SIGTERM, shutDown);
 
-	/*	Main loop: wait for event occurrence time, then
-	 *	execute applicable events.				*/
+	/*	Main loop: sleep until the earliest of (a) the time
+	 *	of the first event in the timeline, (b) the next rate
+	 *	control interval, and (c) insertion of a new event at
+	 *	the front of the timeline; then dispatch all events
+	 *	whose execution times have now been reached.		*/
 
 	oK(_running(&state));
 	writeMemo("[i] bpclock is running.");
 	while (_running(NULL))
 	{
-		/*	Sleep for 1 second, then dispatch all events
-		 *	whose executions times have now been reached.	*/
-
-		snooze(1);
-		currentTime = getUTCTime();
-		if (dispatchEvents(sdr, bpConstants->timeline, currentTime) < 0)
+		if (scheduleTimeline(wheel, &clock) < 0
+		|| tw_wait(wheel) < 0)
 		{
-			putErrmsg("Can't dispatch events.", NULL);
+			putErrmsg("Can't manage timeline.", NULL);
 			state = 0;	/*	Terminate loop.		*/
 			oK(_running(&state));
 			continue;
 		}
 
-		/*	Also adjust throttles in response to rate
-		 *	changes noted in the shared ION database.	*/
-
-		if (adjustThrottles() < 0)
+		if (sm_SemEnded(bpvdb->clockSemaphore))
 		{
-			putErrmsg("Can't adjust throttles.", NULL);
 			state = 0;	/*	Terminate loop.		*/
 			oK(_running(&state));
-			continue;
 		}
-
-		/*	Then apply rate control.			*/
-
-		applyRateControl(sdr);
 	}
 
+	tw_destroy(wheel);
 	writeErrmsgMemos();
 	writeMemo("[i] bpclock has ended.");
 	ionDetach();
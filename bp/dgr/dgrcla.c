@@ -63,9 +63,11 @@ static void	*sendBundles(void *parm)
 	Outflow			outflows[3];
 	int			i;
 	int			threadRunning = 1;
+	BpOutboundBundle	batch[BP_DEQUEUE_BATCH_SIZE];
+	int			batchLength;
+	int			j;
 	Object			bundleZco;
-	BpExtendedCOS		extendedCOS;
-	char			destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
+	char			*destDuctName;
 	char			*hostName;
 	unsigned short		portNbr;
 	unsigned int		hostNbr;
@@ -84,8 +86,10 @@ static void	*sendBundles(void *parm)
 	}
 
 	sdr = getIonsdr();
+	sdr_begin_read(sdr);
 	sdr_read(sdr, (char *) &outduct, sdr_list_data(sdr,
 			parms->vduct->outductElt), sizeof(Outduct));
+	sdr_end_read(sdr);
 	memset((char *) outflows, 0, sizeof outflows);
 	outflows[0].outboundBundles = outduct.bulkQueue;
 	outflows[1].outboundBundles = outduct.stdQueue;
@@ -104,84 +108,98 @@ static void	*sendBundles(void *parm)
 			break;
 		}
 
-		if (bpDequeue(parms->vduct, outflows, &bundleZco,
-				&extendedCOS, destDuctName) < 0)
+		batchLength = bpDequeueBatch(parms->vduct, outflows,
+				BP_DEQUEUE_BATCH_SIZE, BP_DEQUEUE_BATCH_BYTES,
+				batch);
+		if (batchLength < 0)
 		{
 			threadRunning = 0;
 			putErrmsg("Failed de-queueing bundle.", NULL);
 			continue;
 		}
 
-		if (bundleZco == 0)		/*	Interrupted.	*/
+		for (j = 0; j < batchLength && threadRunning; j++)
 		{
-			continue;
-		}
+			bundleZco = batch[j].bundleZco;
+			destDuctName = batch[j].destDuctName;
+			hostName = destDuctName;
+			parseSocketSpec(destDuctName, &portNbr, &hostNbr);
+			if (portNbr == 0)
+			{
+				portNbr = DGRCLA_PORT_NBR;
+			}
 
-		hostName = destDuctName;
-		parseSocketSpec(destDuctName, &portNbr, &hostNbr);
-		if (portNbr == 0)
-		{
-			portNbr = DGRCLA_PORT_NBR;
-		}
+			sdr_begin_xn(sdr);
+			bundleLength = zco_length(sdr, bundleZco);
+			if (hostNbr == 0)	/*	Can't send it.	*/
+			{
+				failedTransmissions++;
+				zco_destroy_reference(sdr, bundleZco);
+				if (sdr_end_xn(sdr) < 0)
+				{
+					threadRunning = 0;
+					putErrmsg("Can't destroy ZCO reference.",
+							NULL);
+				}
 
-		sdr_begin_xn(sdr);
-		bundleLength = zco_length(sdr, bundleZco);
-		if (hostNbr == 0)		/*	Can't send it.	*/
-		{
-			failedTransmissions++;
-			zco_destroy_reference(sdr, bundleZco);
-			if (sdr_end_xn(sdr) < 0)
+				continue;
+			}
+
+			zco_start_transmitting(sdr, bundleZco, &reader);
+			bytesToSend = zco_transmit(sdr, &reader, DGRCLA_BUFSZ,
+					buffer);
+			if (bytesToSend < 0)
 			{
+				sdr_cancel_xn(sdr);
 				threadRunning = 0;
-				putErrmsg("Can't destroy ZCO reference.", NULL);
+				putErrmsg("Can't issue from ZCO.", NULL);
+				continue;
 			}
 
-			continue;
-		}
-
-		zco_start_transmitting(sdr, bundleZco, &reader);
-		bytesToSend = zco_transmit(sdr, &reader, DGRCLA_BUFSZ, buffer);
-		if (bytesToSend < 0)
-		{
-			sdr_cancel_xn(sdr);
-			threadRunning = 0;
-			putErrmsg("Can't issue from ZCO.", NULL);
-			continue;
-		}
-
-		zco_stop_transmitting(sdr, &reader);
-		if (sdr_end_xn(sdr) < 0)
-		{
-			threadRunning = 0;
-			putErrmsg("Failed sending bundle.", NULL);
-			continue;
-		}
+			zco_stop_transmitting(sdr, &reader);
+			if (sdr_end_xn(sdr) < 0)
+			{
+				threadRunning = 0;
+				putErrmsg("Failed sending bundle.", NULL);
+				continue;
+			}
 
-		/*	Concatenated bundle is now in buffer.  Send it.	*/
+			/*	Concatenated bundle is now in buffer.
+			 *	Send it.				*/
 
-		if (bytesToSend > 0)
-		{
-			if (dgr_send(parms->dgrSap, portNbr, hostNbr,
-				DGR_NOTE_FAILED, buffer, bytesToSend)
-					== DgrFailed)
+			if (bytesToSend > 0)
 			{
-				failedTransmissions++;
-				if (bpHandleXmitFailure(bundleZco))
+				if (dgr_send(parms->dgrSap, portNbr, hostNbr,
+					DGR_NOTE_FAILED, buffer, bytesToSend)
+						== DgrFailed)
 				{
-					threadRunning = 0;
-					putErrmsg("Crashed handling failure.",
-							NULL);
+					failedTransmissions++;
+					if (bpHandleXmitFailure(bundleZco))
+					{
+						threadRunning = 0;
+						putErrmsg("Crashed handling \
+failure.", NULL);
+					}
 				}
 			}
+
+			sdr_begin_xn(sdr);
+			zco_destroy_reference(sdr, bundleZco);
+			if (sdr_end_xn(sdr) < 0)
+			{
+				threadRunning = 0;
+				putErrmsg("Failed destroying bundle ZCO.",
+						NULL);
+			}
 		}
 
-		sdr_begin_xn(sdr);
-		zco_destroy_reference(sdr, bundleZco);
-		if (sdr_end_xn(sdr) < 0)
+		/*	Release the batch, re-forwarding any bundles
+		 *	that were left untransmitted.			*/
+
+		if (bpEndBatch(parms->vduct, batch, batchLength, j) < 0)
 		{
 			threadRunning = 0;
-			putErrmsg("Failed destroying bundle ZCO.", NULL);
-			continue;
+			putErrmsg("Can't abandon bundles.", NULL);
 		}
 
 		/*	Make sure other tasks have a chance to run.	*/
@@ -425,9 +443,11 @@ int	main(int argc, char *argv[])
 	/*	All command-line arguments are now validated.		*/
 
 	sdr = getIonsdr();
+	sdr_begin_read(sdr);
 	sdr_read(sdr, (char *) &induct, sdr_list_data(sdr, vinduct->inductElt),
 			sizeof(Induct));
 	sdr_read(sdr, (char *) &protocol, induct.protocol, sizeof(ClProtocol));
+	sdr_end_read(sdr);
 	if (protocol.nominalRate <= 0)
 	{
 		vinduct->acqThrottle.nominalRate = DEFAULT_DGR_RATE;
@@ -475,25 +475,29 @@ static void	infoRule(int tokenCount, char **tokens)
 
 static void	executeInfo(int tokenCount, char **tokens)
 {
+	Sdr	sdr = getIonsdr();
+
 	if (tokenCount < 2)
 	{
 		printText("Information on what?");
 		return;
 	}
 
+	sdr_begin_read(sdr);
 	if (strcmp(tokens[1], "plan") == 0)
 	{
 		infoPlan(tokenCount, tokens);
-		return;
 	}
-
-	if (strcmp(tokens[1], "rule") == 0)
+	else if (strcmp(tokens[1], "rule") == 0)
 	{
 		infoRule(tokenCount, tokens);
-		return;
+	}
+	else
+	{
+		SYNTAX_ERROR;
 	}
 
-	SYNTAX_ERROR;
+	sdr_end_read(sdr);
 }
 
 static void	listPlans()
@@ -524,45 +528,54 @@ static void	listRules(Dtn2Plan *plan)
 	}
 }
 
-static void	executeList(int tokenCount, char **tokens)
+static void	listPlanRules(int tokenCount, char **tokens)
 {
 	Object	planAddr;
 		OBJ_POINTER(Dtn2Plan, plan);
 	Object	elt;
 
-	if (tokenCount < 2)
+	if (tokenCount < 3)
 	{
-		printText("List what?");
+		printText("Must specify node name for rules list.");
 		return;
 	}
 
-	if (strcmp(tokens[1], "plan") == 0)
+	dtn2_findPlan(tokens[2], &planAddr, &elt);
+	if (elt == 0)
 	{
-		listPlans();
+		printText("Unknown plan.");
 		return;
 	}
 
-	if (strcmp(tokens[1], "rule") == 0)
-	{
-		if (tokenCount < 3)
-		{
-			printText("Must specify node name for rules list.");
-			return;
-		}
+	GET_OBJ_POINTER(getIonsdr(), Dtn2Plan, plan, planAddr);
+	listRules(plan);
+}
 
-		dtn2_findPlan(tokens[2], &planAddr, &elt);
-		if (elt == 0)
-		{
-			printText("Unknown plan.");
-			return;
-		}
+static void	executeList(int tokenCount, char **tokens)
+{
+	Sdr	sdr = getIonsdr();
 
-		GET_OBJ_POINTER(getIonsdr(), Dtn2Plan, plan, planAddr);
-		listRules(plan);
+	if (tokenCount < 2)
+	{
+		printText("List what?");
 		return;
 	}
 
-	SYNTAX_ERROR;
+	sdr_begin_read(sdr);
+	if (strcmp(tokens[1], "plan") == 0)
+	{
+		listPlans();
+	}
+	else if (strcmp(tokens[1], "rule") == 0)
+	{
+		listPlanRules(tokenCount, tokens);
+	}
+	else
+	{
+		SYNTAX_ERROR;
+	}
+
+	sdr_end_read(sdr);
 }
 
 static void	switchEcho(int tokenCount, char **tokens)
@@ -227,7 +227,7 @@ int	dtn2_lookupDirective(char *nodeName, char *demux, FwdDirective *dirbuf)
 	/*	This function determines the relevant FwdDirective for
 	 *	the specified eid, if any.  Wild card match is okay.	*/
 
-	CHKERR(ionLocked());
+	CHKERR(sdr_in_read(sdr));
 	CHKERR(nodeName && demux && dirbuf);
 
 	/*	Find best matching plan.  Universal wild-card match,
@@ -357,7 +357,7 @@ void	dtn2_findPlan(char *nodeNm, Object *planAddr, Object *eltp)
 	/*	This function finds the Dtn2Plan for the specified
 	 *	node, if any.						*/
 
-	CHKVOID(ionLocked());
+	CHKVOID(sdr_in_read(sdr));
 	CHKVOID(nodeNm && planAddr && eltp);
 	*eltp = 0;
 	if (filterNodeName(nodeName, nodeNm) < 0)
@@ -567,7 +567,7 @@ void	dtn2_findRule(char *nodeNm, char *demux, Dtn2Plan *plan,
 	 *	demux token, for the specified destination node, if
 	 *	any.							*/
 
-	CHKVOID(ionLocked());
+	CHKVOID(sdr_in_read(sdr));
 	CHKVOID(ruleAddr);
 	CHKVOID(eltp);
 	*eltp = 0;
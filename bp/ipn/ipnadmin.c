@@ -750,37 +750,37 @@ static void	infoGroupRule(int tokenCount, char **tokens)
 
 static void	executeInfo(int tokenCount, char **tokens)
 {
+	Sdr	sdr = getIonsdr();
+
 	if (tokenCount < 2)
 	{
 		printText("Information on what?");
 		return;
 	}
 
+	sdr_begin_read(sdr);
 	if (strcmp(tokens[1], "plan") == 0)
 	{
 		infoPlan(tokenCount, tokens);
-		return;
 	}
-
-	if (strcmp(tokens[1], "planrule") == 0)
+	else if (strcmp(tokens[1], "planrule") == 0)
 	{
 		infoPlanRule(tokenCount, tokens);
-		return;
 	}
-
-	if (strcmp(tokens[1], "group") == 0)
+	else if (strcmp(tokens[1], "group") == 0)
 	{
 		infoGroup(tokenCount, tokens);
-		return;
 	}
-
-	if (strcmp(tokens[1], "grouprule") == 0)
+	else if (strcmp(tokens[1], "grouprule") == 0)
 	{
 		infoGroupRule(tokenCount, tokens);
-		return;
+	}
+	else
+	{
+		SYNTAX_ERROR;
 	}
 
-	SYNTAX_ERROR;
+	sdr_end_read(sdr);
 }
 
 static void	listPlans()
@@ -825,54 +825,61 @@ static void	listGroups()
 	}
 }
 
-static void	executeList(int tokenCount, char **tokens)
+static void	listPlanRules(int tokenCount, char **tokens)
 {
 	unsigned long	nodeNbr;
 	Object		planAddr;
 	Object		elt;
 			OBJ_POINTER(IpnPlan, plan);
 
-	if (tokenCount < 2)
+	if (tokenCount < 3)
 	{
-		printText("List what?");
+		printText("Must specify node nbr for rules list.");
 		return;
 	}
 
-	if (strcmp(tokens[1], "plan") == 0)
+	nodeNbr = atoi(tokens[2]);
+	ipn_findPlan(nodeNbr, &planAddr, &elt);
+	if (elt == 0)
 	{
-		listPlans();
+		printText("Unknown node.");
 		return;
 	}
 
-	if (strcmp(tokens[1], "planrule") == 0)
-	{
-		if (tokenCount < 3)
-		{
-			printText("Must specify node nbr for rules list.");
-			return;
-		}
+	GET_OBJ_POINTER(getIonsdr(), IpnPlan, plan, planAddr);
+	printPlan(plan);
+	listRules(plan->rules);
+}
 
-		nodeNbr = atoi(tokens[2]);
-		ipn_findPlan(nodeNbr, &planAddr, &elt);
-		if (elt == 0)
-		{
-			printText("Unknown node.");
-			return;
-		}
+static void	executeList(int tokenCount, char **tokens)
+{
+	Sdr	sdr = getIonsdr();
 
-		GET_OBJ_POINTER(getIonsdr(), IpnPlan, plan, planAddr);
-		printPlan(plan);
-		listRules(plan->rules);
+	if (tokenCount < 2)
+	{
+		printText("List what?");
 		return;
 	}
 
-	if (strcmp(tokens[1], "group") == 0)
+	sdr_begin_read(sdr);
+	if (strcmp(tokens[1], "plan") == 0)
+	{
+		listPlans();
+	}
+	else if (strcmp(tokens[1], "planrule") == 0)
+	{
+		listPlanRules(tokenCount, tokens);
+	}
+	else if (strcmp(tokens[1], "group") == 0)
 	{
 		listGroups();
-		return;
+	}
+	else
+	{
+		SYNTAX_ERROR;
 	}
 
-	SYNTAX_ERROR;
+	sdr_end_read(sdr);
 }
 
 static void	switchEcho(int tokenCount, char **tokens)
@@ -195,6 +195,9 @@ int	main(int argc, char *argv[])
 	Object		elt;
 	Object		bundleAddr;
 	Bundle		bundle;
+	unsigned long	cacheHits;
+	unsigned long	cacheMisses;
+	char		memoBuf[128];
 
 	if (bpAttach() < 0)
 	{
@@ -286,6 +289,11 @@ int	main(int argc, char *argv[])
 		sm_TaskYield();
 	}
 
+	cgr_stats(&cacheHits, &cacheMisses);
+	isprintf(memoBuf, sizeof memoBuf, "[i] ipnfw CGR route cache: \
+%lu hits, %lu misses.", cacheHits, cacheMisses);
+	writeMemo(memoBuf);
+	cgr_stop();
 	writeErrmsgMemos();
 	writeMemo("[i] ipnfw forwarder has ended.");
 	ionDetach();
@@ -162,6 +162,8 @@ extern int		ipn_lookupGroupDirective(unsigned long nodeNbr,
 
 extern int		cgr_forward(Bundle *bundle, Object bundleObj,
 				unsigned long stationNodeNbr, Object plans);
+extern void		cgr_stats(unsigned long *hits, unsigned long *misses);
+extern void		cgr_stop();
 #ifdef __cplusplus
 }
 #endif
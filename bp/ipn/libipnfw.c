@@ -183,7 +183,7 @@ void	ipn_findPlan(unsigned long nodeNbr, Object *planAddr, Object *eltp)
 	/*	This function finds the IpnPlan for the specified
 	 *	node, if any.						*/
 
-	CHKVOID(ionLocked());
+	CHKVOID(sdr_in_read(sdr));
 	CHKVOID(nodeNbr && planAddr && eltp);
 	*eltp = 0;
 	elt = locatePlan(nodeNbr, NULL);
@@ -407,7 +407,7 @@ void	ipn_findPlanRule(unsigned long nodeNbr, long argServiceNbr,
 	 *	service number and source node number, for the
 	 *	specified destination node number, if any.		*/
 
-	CHKVOID(ionLocked());
+	CHKVOID(sdr_in_read(sdr));
 	CHKVOID(ruleAddr);
 	CHKVOID(eltp);
 	*eltp = 0;
@@ -665,7 +665,7 @@ int	ipn_lookupPlanDirective(unsigned long nodeNbr,
 	/*	This function determines the relevant FwdDirective for
 	 *	the specified eid, if any.  Wild card match is okay.	*/
 
-	CHKERR(ionLocked());
+	CHKERR(sdr_in_read(sdr));
 	CHKERR(nodeNbr && dirbuf);
 
 	/*	Find the matching plan.					*/
@@ -750,7 +750,7 @@ void	ipn_findGroup(unsigned long firstNodeNbr, unsigned long lastNodeNbr,
 	/*	This function finds the IpnGroup for the specified
 	 *	node range, if any.					*/
 
-	CHKVOID(ionLocked());
+	CHKVOID(sdr_in_read(sdr));
 	CHKVOID(firstNodeNbr && groupAddr && eltp);
 	CHKVOID(firstNodeNbr <= lastNodeNbr);
 	*eltp = 0;
@@ -910,7 +910,7 @@ void	ipn_findGroupRule(unsigned long firstNodeNbr, unsigned long lastNodeNbr,
 	 *	service number and source node number, for the
 	 *	specified destination node number, if any.		*/
 
-	CHKVOID(ionLocked());
+	CHKVOID(sdr_in_read(sdr));
 	CHKVOID(ruleAddr);
 	CHKVOID(eltp);
 	*eltp = 0;
@@ -1116,7 +1116,7 @@ int	ipn_lookupGroupDirective(unsigned long nodeNbr,
 	/*	This function determines the relevant FwdDirective for
 	 *	the specified eid, if any.  Wild card match is okay.	*/
 
-	CHKERR(ionLocked());
+	CHKERR(sdr_in_read(sdr));
 	CHKERR(nodeNbr && dirbuf);
 
 	/*	Find best matching group.  Groups are sorted by first
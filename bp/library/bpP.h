@@ -20,6 +20,8 @@
 #include "rfx.h"
 #include "ionsec.h"
 #include "bp.h"
+#include "sdrhash.h"
+#include "sdrrbt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -93,10 +95,23 @@ extern "C" {
  *	the "convergence layer" and below) to transmit the bundles
  *	to other nodes.							*/
 
+/*	A Throttle is a token bucket: capacity is replenished
+ *	continuously at the nominal rate, as measured by a monotonic
+ *	clock, up to a limit of burstSize bytes.  A duct may transmit
+ *	or acquire a bundle whenever capacity is greater than zero,
+ *	and doing so reduces capacity (possibly to a negative value)
+ *	by the estimated capacity consumption of the bundle.		*/
+
+#ifndef BP_DEFAULT_BURST_MSEC
+#define	BP_DEFAULT_BURST_MSEC	(100)	/*	At most 1000.	*/
+#endif
+
 typedef struct
 {
 	long		nominalRate;	/*	In bytes per second.	*/
-	long		capacity;	/*	Bytes, current second.	*/
+	long		capacity;	/*	Bytes available now.	*/
+	long		burstSize;	/*	Bytes; 0 = default.	*/
+	struct timeval	lastRefill;	/*	Monotonic clock.	*/
 	sm_SemId	semaphore;
 } Throttle;
 
@@ -192,6 +207,7 @@ typedef struct
 /*	Administrative record types	*/
 #define	BP_STATUS_REPORT	(1)
 #define	BP_CUSTODY_SIGNAL	(2)
+#define	BP_AGGREGATE_CUSTODY_SIGNAL	(4)
 
 /*	Administrative record flags	*/
 #define BP_BDL_IS_A_FRAGMENT	(1)	/*	00000001		*/
@@ -240,6 +256,19 @@ typedef enum
 	CtBlockUnintelligible
 } BpCtReason;
 
+/*	An aggregate custody signal identifies the bundles it
+ *	covers not by bundle ID but by the custody IDs that the
+ *	custodian assigned to them, which it announced in each
+ *	bundle's custody transfer enhancement block (CTEB).  The
+ *	IDs are reported as a list of "fills", each one a range
+ *	of consecutive custody IDs.					*/
+
+typedef struct
+{
+	unsigned long	start;		/*	First custody ID.	*/
+	unsigned long	length;		/*	Number of custody IDs.	*/
+} AcsFill;
+
 typedef struct
 {
 	BpTimestamp	creationTime;	/*	From bundle's ID.	*/
@@ -250,6 +279,8 @@ typedef struct
 	unsigned char	succeeded;	/*	Boolean.		*/
 	BpCtReason	reasonCode;
 	DtnTime		signalTime;
+	int		fillsCount;	/*	Aggregate signal only.	*/
+	AcsFill		*fills;		/*	Aggregate signal only.	*/
 } BpCtSignal;
 
 /*	The convergence-layer adapter uses the ClDossier structure to
@@ -306,6 +337,13 @@ typedef struct
 
 	BpExtendedCOS	extendedCOS;
 
+	/*	Stuff in Custody Transfer Enhancement Block, as
+	 *	received: valid only if the block names the bundle's
+	 *	current custodian.					*/
+
+	unsigned long	ctebCustodyId;	/*	Assigned by custodian.	*/
+	char		ctebValid;	/*	Boolean.		*/
+
 	/*	Stuff in Payload block.					*/
 
 	unsigned long	payloadBlockProcFlags;
@@ -323,6 +361,7 @@ typedef struct
 	/*	Internal housekeeping stuff.				*/
 
 	char		custodyTaken;	/*	Boolean.		*/
+	unsigned long	custodyId;	/*	Local, if custodyTaken.	*/
 	char		catenated;	/*	Boolean.		*/
 	char		returnToSender;	/*	Boolean.		*/
 	int		dbOverhead;	/*	SDR bytes occupied.	*/
@@ -334,9 +373,10 @@ typedef struct
 
 	/*	Database navigation stuff (back-references).		*/
 
-	Object		timelineElt;	/*	TTL expire list ref.	*/
+	Object		timelineElt;	/*	TTL expire event ref.	*/
 	Object		overdueElt;	/*	Xmit overdue ref.	*/
 	Object		ctDueElt;	/*	CT deadline ref.	*/
+	Object		custodyElt;	/*	Custody ID index ref.	*/
 	Object		fwdQueueElt;	/*	Scheme's queue ref.	*/
 	Object		fragmentElt;	/*	Incomplete's list ref.	*/
 	Object		dlvQueueElt;	/*	Endpoint's queue ref.	*/
@@ -346,6 +386,7 @@ typedef struct
 
 	Object		xmitRefs;	/*	SDR list of XmitRefs	*/
 	int		xmitsNeeded;
+	int		xmitsPending;	/*	In CLOs' batches.	*/
 	time_t		enqueueTime;	/*	When queued for xmit.	*/
 } Bundle;
 
@@ -482,6 +523,7 @@ typedef struct
 	int		payloadBytesPerFrame;
 	int		overheadPerFrame;
 	long		nominalRate;	/*	Bytes per second.	*/
+	long		burstSize;	/*	Bytes; 0 = default.	*/
 	Object		inducts;	/*	SDR list of Inducts	*/
 	Object		outducts;	/*	SDR list of Outducts	*/
 } ClProtocol;
@@ -498,7 +540,8 @@ typedef enum
 {
 	expiredTTL = 1,
 	xmitOverdue = 2,
-	ctDue = 3
+	ctDue = 3,
+	acsDue = 4
 } BpEventType;
 
 typedef struct
@@ -511,11 +554,93 @@ typedef struct
 #define	MAX_TTL_DAYS	(16)
 #define	MAX_TTL_SEC	(MAX_TTL_DAYS * 86400)
 
+/*	Every bundle that is on the timeline (i.e., has a TTL
+ *	expiration event) is indexed by bundle ID in the "bundles"
+ *	hash table of the BP database, so that findBundle() need not
+ *	search the timeline.  Because the key contains only a hash
+ *	of the source EID, and because a node may briefly retain two
+ *	copies of a bundle, keys are not necessarily unique; a bundle
+ *	whose key is already in the table is not indexed but is
+ *	instead counted in unindexedBundles, and findBundle() falls
+ *	back to searching the timeline while that count is non-zero.
+ *
+ *	The table is sized when the BP database is created, for as
+ *	many bundles as the SDR heap could hold if it held nothing
+ *	but Bundle objects, at a mean search length of
+ *	BP_BUNDLES_HASH_SEARCH_LEN (subject to sdr_hash_create's
+ *	limit on the number of rows).  Every bundle also occupies
+ *	heap space for its blocks and, usually, its payload, so the
+ *	actual search length is normally much shorter.			*/
+
+#ifndef BP_BUNDLES_HASH_SEARCH_LEN
+#define	BP_BUNDLES_HASH_SEARCH_LEN	(8)
+#endif
+
+typedef struct
+{
+	unsigned long	sourceEidHash;
+	unsigned long	seconds;	/*	Creation time.		*/
+	unsigned long	count;		/*	Creation seq. count.	*/
+	unsigned long	fragmentOffset;
+	unsigned long	fragmentLength;	/*	0 if not a fragment.	*/
+} BundleKey;
+
+/*	Every bundle of which the local node has taken custody is
+ *	assigned a custody ID, announced in the bundle's CTEB, and
+ *	is indexed by that ID in the "custodyIds" tree of the BP
+ *	database so that the bundles covered by an aggregate custody
+ *	signal can be found without searching the timeline.		*/
+
+typedef struct
+{
+	unsigned long	custodyId;
+	Object		bundleObj;
+} CustodyRef;
+
+/*	Custody signals for bundles that arrived with valid CTEBs
+ *	are not sent one per bundle.  Instead, each custody ID is
+ *	added to a PendingAcs for the bundle's custodian, and the
+ *	PendingAcs is sent as a single aggregate custody signal when
+ *	it grows to BP_ACS_MAX_FILLS fills or when BP_ACS_DELAY
+ *	seconds have passed since the first ID was added to it,
+ *	whichever comes first.						*/
+
+#ifndef BP_ACS_MAX_FILLS
+#define	BP_ACS_MAX_FILLS	(64)
+#endif
+#ifndef BP_ACS_DELAY
+#define	BP_ACS_DELAY		(1)	/*	Seconds.		*/
+#endif
+
+typedef struct
+{
+	Object		custodianEid;	/*	SDR string		*/
+	unsigned char	succeeded;	/*	Boolean.		*/
+	BpCtReason	reasonCode;
+	Object		fills;		/*	SDR list of AcsFills	*/
+	unsigned int	ttl;		/*	For the signal bundle.	*/
+	Object		deadlineElt;	/*	acsDue event ref.	*/
+} PendingAcs;
+
+/*	The BP database is catalogued with the number of its format
+ *	as the type of its catalogue entry.  Databases whose timelines
+ *	are SDR lists rather than trees are catalogued with type 0;
+ *	BP refuses to use any database not of format BP_DB_FORMAT,
+ *	since its layout can't be interpreted.  Such a database must
+ *	be reinitialized.						*/
+
+#define	BP_DB_FORMAT	(1)
+
 typedef struct
 {
 	Object		schemes;	/*	SDR list of Schemes	*/
 	Object		protocols;	/*	SDR list of ClProtocols	*/
-	Object		timeline;	/*	SDR list of BpEvents	*/
+	Object		timeline;	/*	SDR rbt of BpEvents	*/
+	Object		bundles;	/*	SDR hash of Bundles	*/
+	unsigned long	unindexedBundles;
+	unsigned long	nextCustodyId;
+	Object		custodyIds;	/*	SDR rbt of CustodyRefs	*/
+	Object		pendingAcs;	/*	SDR list of PendingAcs	*/
 	Object		inboundBundles;	/*	SDR list of ZCOs	*/
 	Object		clockCmd; 	/*	For starting clock.	*/
 	BpString	custodianEidString;
@@ -565,6 +690,7 @@ typedef struct
 	unsigned long	creationTimeSec;
 	int		bundleCounter;
 	int		clockPid;	/*	For stopping clock.	*/
+	sm_SemId	clockSemaphore;	/*	For waking clock.	*/
 	int		watching;	/*	Activity watch switch.	*/
 
 	/*	For congestion control.					*/
@@ -584,8 +710,32 @@ typedef struct
 	time_t		xmitStartTime;	/*	Transmitted.		*/
 	time_t		recvStartTime;	/*	Received, delivered.	*/
 	time_t		statsStartTime;	/*	Sourced, forwarded.	*/
+
+	/*	For monitoring timeline event dispatching by bpclock.	*/
+
+	unsigned long	tickEvents;	/*	Dispatched, last tick.	*/
+	unsigned long	tickBatches;	/*	Transactions, last tick.*/
+	unsigned long	tickUsec;	/*	Elapsed, last tick.	*/
+	unsigned long	clockEvents;	/*	Dispatched, all ticks.	*/
+	unsigned long	clockUsec;	/*	Elapsed, all ticks.	*/
+
+	/*	For monitoring route caching by contact graph routing.	*/
+
+	unsigned long	cgrHits;	/*	Cached routes used.	*/
+	unsigned long	cgrMisses;	/*	Routes computed.	*/
+
+	/*	For tuning timeline event dispatching by bpclock.	*/
+
+	int		clockBatchTime;	/*	Msec per transaction.	*/
 } BpVdb;
 
+/*	Default limit on the time bpclock spends dispatching events
+ *	in a single transaction; adjustable by bpadmin.		*/
+
+#ifndef BP_CLOCK_BATCH_TIME
+#define	BP_CLOCK_BATCH_TIME	(20)	/*	Milliseconds.		*/
+#endif
+
 typedef struct
 {
 	unsigned char	type;		/*	Per extensions array.	*/
@@ -732,6 +882,26 @@ typedef struct
 	int		svcFactor;
 } Outflow;
 
+/*	A batch of outbound bundles is dequeued in a single SDR
+ *	transaction, for transmission by a CLO one after another.	*/
+
+#ifndef BP_DEQUEUE_BATCH_SIZE
+#define	BP_DEQUEUE_BATCH_SIZE	(16)	/*	Bundles per batch.	*/
+#endif
+
+#ifndef BP_DEQUEUE_BATCH_BYTES
+#define	BP_DEQUEUE_BATCH_BYTES	(65536)	/*	Payload bytes.		*/
+#endif
+
+typedef struct
+{
+	Object		bundleZco;
+	Object		bundleObj;	/*	Held until batch ends.	*/
+	int		xmitLength;	/*	Throttle capacity used.	*/
+	BpExtendedCOS	extendedCOS;
+	char		destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
+} BpOutboundBundle;
+
 /*	*	*	Function prototypes.	*	*	*	*/
 
 extern int		bpSend(		MetaEid *sourceMetaEid,
@@ -876,6 +1046,78 @@ extern int		bpDequeue(	VOutduct *vduct,
 			 *
 			 *	Returns 0 on success, -1 on failure.	*/
 
+extern int		bpDequeueBatch(	VOutduct *vduct,
+					Outflow *outflows,
+					int maxBundles,
+					unsigned int maxBytes,
+					BpOutboundBundle *batch);
+			/*	This function is invoked by a
+			 *	convergence-layer output adapter to
+			 *	get a batch of up to maxBundles
+			 *	bundles that it is to transmit, all
+			 *	dequeued in a single transaction.
+			 *	Each bundle is selected, catenated,
+			 *	and returned exactly as by bpDequeue,
+			 *	so the order of the bundles in the
+			 *	batch is the order in which successive
+			 *	calls to bpDequeue would have returned
+			 *	them: by priority, and by ordinal
+			 *	within expedited priority.
+			 *
+			 *	The function blocks as bpDequeue does
+			 *	until the first bundle of the batch is
+			 *	available.  It does not block for any
+			 *	other bundle: the batch ends when no
+			 *	other bundle is ready, when the
+			 *	capacity of the outduct's xmitThrottle
+			 *	is exhausted, or when the next bundle
+			 *	would bring the total length of the
+			 *	bundles in the batch above maxBytes
+			 *	(if non-zero), judging the length of
+			 *	that bundle by its payload.  The
+			 *	first bundle is always dequeued
+			 *	regardless of its length.
+			 *
+			 *	batch must be an array of at least
+			 *	maxBundles BpOutboundBundle structures.
+			 *	The bundle ZCOs are delivered to the
+			 *	CLO, which is responsible for
+			 *	transmitting them in order.  Every
+			 *	bundle in the batch is retained until
+			 *	the CLO passes the batch to bpEndBatch,
+			 *	so that bundles the CLO never gets to
+			 *	transmit can be re-forwarded.
+			 *
+			 *	Returns the number of bundles in the
+			 *	batch on success (zero only if
+			 *	interrupted), -1 on failure.		*/
+
+extern int		bpEndBatch(	VOutduct *vduct,
+					BpOutboundBundle *batch,
+					int count,
+					int sentCount);
+			/*	This function must be invoked by a
+			 *	convergence-layer output adapter once
+			 *	it is done with a batch of count
+			 *	bundles obtained from bpDequeueBatch,
+			 *	of which only the first sentCount were
+			 *	transmitted (or at least handed to the
+			 *	convergence-layer protocol).  The
+			 *	remaining bundles, which the CLO had to
+			 *	abandon, are re-forwarded -- whether or
+			 *	not custody transfer was requested for
+			 *	them -- unless their TTLs expired in
+			 *	the meantime, their ZCOs are destroyed,
+			 *	and the transmission capacity they
+			 *	consumed is returned to the outduct's
+			 *	xmitThrottle.  Status reports and
+			 *	statistics for the transmission of
+			 *	the first sentCount bundles are
+			 *	issued only now.  All bundles in the
+			 *	batch are released.
+			 *
+			 *	Returns 0 on success, -1 on failure.	*/
+
 extern int		bpIdentify(Object bundleZco, Object *bundleObj);
 			/*	This function parses out the ID fields
 			 *	of the catenated outbound bundle in
@@ -944,6 +1186,16 @@ extern int		bpReforwardBundle(Object bundleToReforward);
 			 *
 			 *	Returns 0 on success, -1 on failure.	*/
 
+extern int		bpFlushAcs(Object pendingAcsElt);
+			/*	bpFlushAcs sends the aggregate custody
+			 *	signal accumulated in the PendingAcs
+			 *	referenced by the indicated element of
+			 *	the BP database's pendingAcs list, then
+			 *	destroys the PendingAcs.  It is invoked
+			 *	when the signal's acsDue event occurs.
+			 *
+			 *	Returns 0 on success, -1 on failure.	*/
+
 extern AcqWorkArea	*bpGetAcqArea(VInduct *vduct);
 			/*	Allocates a bundle acquisition work
 			 *	area for use in acquiring inbound
@@ -1130,6 +1382,14 @@ extern int		guessBundleSize(Bundle *bundle);
 extern int		computeECCC(int bundleSize, ClProtocol *protocol);
 extern void		computeApplicableBacklog(Outduct *, Bundle *, Scalar *);
 
+extern void		refillThrottle(Throttle *throttle);
+			/*	Adds to the throttle's capacity the
+			 *	number of bytes that may be handled
+			 *	at its nominal rate in the time that
+			 *	has elapsed since the last refill, up
+			 *	to the throttle's burst size.  Must
+			 *	be called with ION memory locked.	*/
+
 extern int		putBpString(BpString *bpString, char *string);
 extern char		*getBpString(BpString *bpString);
 
@@ -1168,7 +1428,8 @@ extern int		removeEndpoint(char *endpointName);
 
 extern void		fetchProtocol(char *name, ClProtocol *clp, Object *elt);
 extern int		addProtocol(char *name, int payloadBytesPerFrame,
-				int overheadPerFrame, long nominalRate);
+				int overheadPerFrame, long nominalRate,
+				long burstSize);
 extern int		removeProtocol(char *name);
 extern int		bpStartProtocol(char *name);
 extern void		bpStopProtocol(char *name);
@@ -1194,6 +1455,7 @@ extern int		bpStartOutduct(char *protocolName, char *ductName);
 extern void		bpStopOutduct(char *protocolName, char *ductName);
 
 extern Object		insertBpTimelineEvent(BpEvent *newEvent);
+extern void		destroyBpTimelineEvent(Object timelineElt);
 
 extern int		findBundle(char *sourceEid, BpTimestamp *creationTime,
 				unsigned long fragmentOffset,
@@ -0,0 +1,171 @@
+/*
+ *	cteb.c:		implementation of the extension definition
+ *			functions for the Custody Transfer Enhancement
+ *			Block.
+ *
+ *	The CTEB carries the custody ID that the bundle's current
+ *	custodian assigned to the bundle when it took custody,
+ *	followed by that custodian's EID.  A node that receives a
+ *	bundle whose CTEB names the bundle's current custodian may
+ *	report custody disposition for that bundle in an aggregate
+ *	custody signal, identifying the bundle by its custody ID.
+ *
+ *	Copyright (c) 2010, California Institute of Technology.
+ *	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+ *	acknowledged.
+ */
+
+#include "bpP.h"
+#include "cteb.h"
+
+static int	serializeCteb(ExtensionBlock *blk, Bundle *bundle)
+{
+	char	*dictionary;
+	char	*custodianEid;
+	int	eidLength;
+	Sdnv	custodyIdSdnv;
+	char	dataBuffer[sizeof custodyIdSdnv.text + MAX_EID_LEN];
+
+	if ((dictionary = retrieveDictionary(bundle)) == (char *) bundle)
+	{
+		putErrmsg("Can't retrieve dictionary.", NULL);
+		return -1;
+	}
+
+	if (printEid(&bundle->custodian, dictionary, &custodianEid) < 0)
+	{
+		releaseDictionary(dictionary);
+		putErrmsg("Can't print custodian EID.", NULL);
+		return -1;
+	}
+
+	releaseDictionary(dictionary);
+	eidLength = strlen(custodianEid);
+	if (eidLength > MAX_EID_LEN)
+	{
+		putErrmsg("Custodian EID too long for CTEB.", custodianEid);
+		MRELEASE(custodianEid);
+		return -1;
+	}
+
+	encodeSdnv(&custodyIdSdnv, bundle->custodyId);
+	blk->blkProcFlags = BLK_MUST_BE_COPIED;
+	blk->dataLength = custodyIdSdnv.length + eidLength;
+	blk->size = 0;
+	blk->object = 0;
+	memcpy(dataBuffer, custodyIdSdnv.text, custodyIdSdnv.length);
+	memcpy(dataBuffer + custodyIdSdnv.length, custodianEid, eidLength);
+	MRELEASE(custodianEid);
+	return serializeExtBlk(blk, NULL, dataBuffer);
+}
+
+static int	parseCteb(AcqExtBlock *blk, unsigned long *custodyId,
+			char **custodianEid, int *eidLength)
+{
+	unsigned char	*cursor;
+	int		bytesRemaining = blk->dataLength;
+
+	cursor = blk->bytes + (blk->length - blk->dataLength);
+	extractSdnv(custodyId, &cursor, &bytesRemaining);
+	if (bytesRemaining < 1 || bytesRemaining > MAX_EID_LEN)
+	{
+		return 0;		/*	Malformed.		*/
+	}
+
+	*custodianEid = (char *) cursor;
+	*eidLength = bytesRemaining;
+	return 1;
+}
+
+int	cteb_offer(ExtensionBlock *blk, Bundle *bundle)
+{
+	if (!bundle->custodyTaken || bundle->custodyElt == 0)
+	{
+		return 0;	/*	No custody ID to announce.	*/
+	}
+
+	return serializeCteb(blk, bundle);
+}
+
+void	cteb_release(ExtensionBlock *blk)
+{
+	return;
+}
+
+int	cteb_record(ExtensionBlock *sdrBlk, AcqExtBlock *ramBlk)
+{
+	return 0;
+}
+
+int	cteb_copy(ExtensionBlock *newBlk, ExtensionBlock *oldBlk)
+{
+	return 0;
+}
+
+int	cteb_processOnTakeCustody(ExtensionBlock *blk, Bundle *bundle,
+		void *ctxt)
+{
+	if (bundle->custodyElt == 0)
+	{
+		/*	No custody ID was assigned, so the block can
+		 *	only name the previous custodian.  Drop it.	*/
+
+		scratchExtensionBlock(blk);
+		return 0;
+	}
+
+	/*	Announce the local node's custody ID and EID in place
+	 *	of those of the previous custodian.			*/
+
+	return serializeCteb(blk, bundle);
+}
+
+int	cteb_acquire(AcqExtBlock *blk, AcqWorkArea *wk)
+{
+	unsigned long	custodyId;
+	char		*custodianEid;
+	int		eidLength;
+
+	blk->size = 0;
+	blk->object = NULL;
+	return parseCteb(blk, &custodyId, &custodianEid, &eidLength);
+}
+
+int	cteb_check(AcqExtBlock *blk, AcqWorkArea *wk)
+{
+	Bundle		*bundle = &wk->bundle;
+	unsigned long	custodyId;
+	char		*custodianEid;
+	int		eidLength;
+	char		*eidString;
+
+	if (parseCteb(blk, &custodyId, &custodianEid, &eidLength) == 0)
+	{
+		return 0;	/*	Malformed; already noted.	*/
+	}
+
+	/*	A CTEB inserted by some earlier custodian, which was
+	 *	left in place by a custodian that doesn't support the
+	 *	CTEB, is stale and must be ignored.			*/
+
+	if (printEid(&bundle->custodian, wk->dictionary, &eidString) < 0)
+	{
+		putErrmsg("Can't print custodian EID.", NULL);
+		return -1;
+	}
+
+	if (strlen(eidString) == eidLength
+	&& memcmp(eidString, custodianEid, eidLength) == 0)
+	{
+		bundle->ctebCustodyId = custodyId;
+		bundle->ctebValid = 1;
+	}
+
+	MRELEASE(eidString);
+	return 0;
+}
+
+void	cteb_clear(AcqExtBlock *blk)
+{
+	return;
+}
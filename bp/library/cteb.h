@@ -0,0 +1,19 @@
+/*
+ *	cteb.h:		definitions supporting implementation of
+ *			the Custody Transfer Enhancement Block (CTEB).
+ *
+ *	Copyright (c) 2010, California Institute of Technology.
+ *	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+ *	acknowledged.
+ */
+
+#define	EXTENSION_TYPE_CTEB	10
+
+extern int	cteb_offer(ExtensionBlock *, Bundle *);
+extern void	cteb_release(ExtensionBlock *);
+extern int	cteb_record(ExtensionBlock *, AcqExtBlock *);
+extern int	cteb_copy(ExtensionBlock *, ExtensionBlock *);
+extern int	cteb_processOnTakeCustody(ExtensionBlock *, Bundle *, void *);
+extern int	cteb_acquire(AcqExtBlock *, AcqWorkArea *);
+extern int	cteb_check(AcqExtBlock *, AcqWorkArea *);
+extern void	cteb_clear(AcqExtBlock *);
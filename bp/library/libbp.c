@@ -16,12 +16,6 @@
 
 #include "bpP.h"
 
-typedef struct
-{
-	int		interval;	/*	Seconds.		*/
-	sm_SemId	semaphore;
-} TimerParms;
-
 int	bp_attach()
 {
 	return bpAttach();
@@ -339,57 +333,6 @@ int	bp_cancel(Object bundleObj)
 	return 0;
 }
 
-static void	*timerMain(void *parm)
-{
-	TimerParms	*timer = (TimerParms *) parm;
-	pthread_mutex_t	mutex;
-	pthread_cond_t	cv;
-	struct timeval	workTime;
-	struct timespec	deadline;
-	int		result;
-
-	memset((char *) &mutex, 0, sizeof mutex);
-	if (pthread_mutex_init(&mutex, NULL))
-	{
-		putSysErrmsg("can't start timer, mutex init failed", NULL);
-		sm_SemGive(timer->semaphore);
-		return NULL;
-	}
-
-	memset((char *) &cv, 0, sizeof cv);
-	if (pthread_cond_init(&cv, NULL))
-	{
-		putSysErrmsg("can't start timer, cond init failed", NULL);
-		sm_SemGive(timer->semaphore);
-		return NULL;
-	}
-
-	getCurrentTime(&workTime);
-	deadline.tv_sec = workTime.tv_sec + timer->interval;
-	deadline.tv_nsec = workTime.tv_usec * 1000;
-	pthread_mutex_lock(&mutex);
-	result = pthread_cond_timedwait(&cv, &mutex, &deadline);
-	pthread_mutex_unlock(&mutex);
-	pthread_mutex_destroy(&mutex);
-	pthread_cond_destroy(&cv);
-	if (result)
-	{
-		errno = result;
-		if (errno != ETIMEDOUT)
-		{
-			putSysErrmsg("timer failure", NULL);
-			sm_SemGive(timer->semaphore);
-			return NULL;
-		}
-	}
-
-	/*	Timed out; must wake up the main thread.		*/
-
-	timer->interval = 0;	/*	Indicate genuine timeout.	*/
-	sm_SemGive(timer->semaphore);
-	return NULL;
-}
-
 int	bp_receive(BpSAP sap, BpDelivery *dlvBuffer, int timeoutSeconds)
 {
 	Sdr		sdr = getIonsdr();
@@ -398,8 +341,6 @@ int	bp_receive(BpSAP sap, BpDelivery *dlvBuffer, int timeoutSeconds)
 	Object		dlvElt;
 	Object		bundleAddr;
 	Bundle		bundle;
-	TimerParms	timerParms;
-	pthread_t	timerThread;
 	int		result;
 	char		*dictionary;
 
@@ -446,28 +387,21 @@ int	bp_receive(BpSAP sap, BpDelivery *dlvBuffer, int timeoutSeconds)
 		}
 
 		/*	Wait for semaphore to be given, either by the
-		 *	deliverBundle() function or by timer thread.	*/
+		 *	deliverBundle() function or by bp_interrupt(),
+		 *	for at most timeoutSeconds if a deadline was
+		 *	specified.					*/
 
 		if (timeoutSeconds == BP_BLOCKING)
 		{
-			timerParms.interval = -1;
+			result = sm_SemTake(vpoint->semaphore);
 		}
 		else	/*	This is a receive() with a deadline.	*/
 		{
-			timerParms.interval = timeoutSeconds;
-			timerParms.semaphore = vpoint->semaphore;
-			if (pthread_create(&timerThread, NULL, timerMain,
-					&timerParms) < 0)
-			{
-				putSysErrmsg("Can't enable interval timer",
-						NULL);
-				return -1;
-			}
+			result = sm_SemTimedTake(vpoint->semaphore,
+					timeoutSeconds);
 		}
 
-		/*	Take endpoint semaphore.			*/
-
-		if (sm_SemTake(vpoint->semaphore) < 0)
+		if (result < 0)
 		{
 			putErrmsg("Can't take endpoint semaphore.", NULL);
 			return -1;
@@ -482,43 +416,27 @@ int	bp_receive(BpSAP sap, BpDelivery *dlvBuffer, int timeoutSeconds)
 			return -1;
 		}
 
-		/*	Have taken the semaphore, one way or another.	*/
+		/*	Have taken the semaphore or timed out.		*/
 
 		sdr_begin_xn(sdr);
 		dlvElt = sdr_list_first(sdr, endpoint->deliveryQueue);
 		if (dlvElt == 0)	/*	Still nothing.		*/
 		{
-			/*	Either sm_SemTake() was interrupted
-			 *	or else timer thread gave semaphore.	*/
+			/*	Either the deadline passed or else
+			 *	sm_SemTake() was interrupted.		*/
 
 			sdr_exit_xn(sdr);
-			if (timerParms.interval == 0)
+			if (result == 1)
 			{
-				/*	Timer expired.			*/
-
 				dlvBuffer->result = BpReceptionTimedOut;
-				pthread_join(timerThread, NULL);
 			}
-			else	/*	Interrupted.			*/
+			else
 			{
 				dlvBuffer->result = BpReceptionInterrupted;
-				if (timerParms.interval != -1)
-				{
-					pthread_cancel(timerThread);
-					pthread_join(timerThread, NULL);
-				}
 			}
 
 			return 0;
 		}
-		else		/*	Bundle was delivered.		*/
-		{
-			if (timerParms.interval != -1)
-			{
-				pthread_cancel(timerThread);
-				pthread_join(timerThread, NULL);
-			}
-		}
 	}
 
 	/*	At this point, we have got a dlvElt and are in an SDR
@@ -497,6 +497,7 @@ static int	raiseInduct(Object inductElt, BpVdb *bpvdb)
 	vduct->inductElt = inductElt;
 	istrcpy(vduct->protocolName, protocol.name, sizeof vduct->protocolName);
 	istrcpy(vduct->ductName, duct.name, sizeof vduct->ductName);
+	vduct->acqThrottle.burstSize = protocol.burstSize;
 	vduct->acqThrottle.semaphore = SM_SEM_NONE;
 	resetInduct(vduct);
 	return 0;
@@ -624,6 +625,7 @@ static int	raiseOutduct(Object outductElt, BpVdb *bpvdb)
 	istrcpy(vduct->protocolName, protocol.name, sizeof vduct->protocolName);
 	istrcpy(vduct->ductName, duct.name, sizeof vduct->ductName);
 	vduct->semaphore = SM_SEM_NONE;
+	vduct->xmitThrottle.burstSize = protocol.burstSize;
 	vduct->xmitThrottle.semaphore = SM_SEM_NONE;
 	resetOutduct(vduct);
 	return 0;
@@ -776,10 +778,13 @@ static BpVdb	*_bpvdb(char **name)
 		vdb->creationTimeSec = 0;
 		vdb->bundleCounter = 0;
 		vdb->clockPid = -1;
+		vdb->clockSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+		sm_SemTake(vdb->clockSemaphore);
 		vdb->productionThrottle.semaphore = sm_SemCreate(SM_NO_KEY,
 				SM_SEM_FIFO);
 		sm_SemTake(vdb->productionThrottle.semaphore);
 		vdb->productionThrottle.nominalRate = 0;
+		vdb->clockBatchTime = BP_CLOCK_BATCH_TIME;
 		if ((vdb->schemes = sm_list_create(wm)) == 0
 		|| (vdb->inducts = sm_list_create(wm)) == 0
 		|| (vdb->outducts = sm_list_create(wm)) == 0
@@ -828,10 +833,23 @@ static char	*_bpdbName()
 	return "bpdb";
 }
 
+static int	checkBpdbFormat(int format)
+{
+	if (format != BP_DB_FORMAT)
+	{
+		putErrmsg("BP database format is obsolete; must reinitialize.",
+				itoa(format));
+		return -1;
+	}
+
+	return 0;
+}
+
 int	bpInit()
 {
 	Sdr		bpSdr;
 	Object		bpdbObject;
+	int		bpdbFormat;
 	BpDB		bpdbBuf;
 	char		*bpvdbName = _bpvdbName();
 
@@ -846,7 +864,7 @@ int	bpInit()
 	/*	Recover the BP database, creating it if necessary.	*/
 
 	sdr_begin_xn(bpSdr);
-	bpdbObject = sdr_find(bpSdr, _bpdbName(), NULL);
+	bpdbObject = sdr_find(bpSdr, _bpdbName(), &bpdbFormat);
 	switch (bpdbObject)
 	{
 	case -1:		/*	SDR error.			*/
@@ -868,11 +886,16 @@ int	bpInit()
 		memset((char *) &bpdbBuf, 0, sizeof(BpDB));
 		bpdbBuf.schemes = sdr_list_create(bpSdr);
 		bpdbBuf.protocols = sdr_list_create(bpSdr);
-		bpdbBuf.timeline = sdr_list_create(bpSdr);
+		bpdbBuf.timeline = sdr_rbt_create(bpSdr);
+		bpdbBuf.bundles = sdr_hash_create(bpSdr, sizeof(BundleKey),
+				sdr_heap_size(bpSdr) / sizeof(Bundle),
+				BP_BUNDLES_HASH_SEARCH_LEN);
+		bpdbBuf.custodyIds = sdr_rbt_create(bpSdr);
+		bpdbBuf.pendingAcs = sdr_list_create(bpSdr);
 		bpdbBuf.inboundBundles = sdr_list_create(bpSdr);
 		bpdbBuf.clockCmd = sdr_string_create(bpSdr, "bpclock");
 		sdr_write(bpSdr, bpdbObject, (char *) &bpdbBuf, sizeof(BpDB));
-		sdr_catlg(bpSdr, _bpdbName(), 0, bpdbObject);
+		sdr_catlg(bpSdr, _bpdbName(), BP_DB_FORMAT, bpdbObject);
 		if (sdr_end_xn(bpSdr))
 		{
 			putErrmsg("Can't create BP database.", NULL);
@@ -883,6 +906,10 @@ int	bpInit()
 
 	default:		/*	Found DB in the SDR.		*/
 		sdr_exit_xn(bpSdr);
+		if (checkBpdbFormat(bpdbFormat) < 0)
+		{
+			return -1;
+		}
 	}
 
 	oK(_bpdbObject(&bpdbObject));	/*	Save database location.	*/
@@ -1006,6 +1033,11 @@ void	bpStop()		/*	Reverses bpStart.		*/
 		stopOutduct(voutduct);
 	}
 
+	if (bpvdb->clockSemaphore != SM_SEM_NONE)
+	{
+		sm_SemEnd(bpvdb->clockSemaphore);
+	}
+
 	if (bpvdb->clockPid > 0)
 	{
 		sm_TaskKill(bpvdb->clockPid, SIGTERM);
@@ -1048,6 +1080,16 @@ void	bpStop()		/*	Reverses bpStart.		*/
 
 	sdr_begin_xn(bpSdr);	/*	Just to lock memory.		*/
 	bpvdb->clockPid = -1;
+	if (bpvdb->clockSemaphore == SM_SEM_NONE)
+	{
+		bpvdb->clockSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+	}
+	else
+	{
+		sm_SemUnend(bpvdb->clockSemaphore);
+	}
+
+	sm_SemTake(bpvdb->clockSemaphore);		/*	Lock.	*/
 	if (bpvdb->productionThrottle.semaphore == SM_SEM_NONE)
 	{
 		bpvdb->productionThrottle.semaphore = sm_SemCreate(SM_NO_KEY,
@@ -1088,6 +1130,7 @@ int	bpAttach()
 	Object		bpdbObject = _bpdbObject(NULL);
 	BpVdb		*bpvdb = _bpvdb(NULL);
 	Sdr		bpSdr;
+	int		bpdbFormat;
 	char		*bpvdbName = _bpvdbName();
 
 	if (bpdbObject && bpvdb)
@@ -1108,7 +1151,7 @@ int	bpAttach()
 	if (bpdbObject == 0)
 	{
 		sdr_begin_xn(bpSdr);
-		bpdbObject = sdr_find(bpSdr, _bpdbName(), NULL);
+		bpdbObject = sdr_find(bpSdr, _bpdbName(), &bpdbFormat);
 		sdr_exit_xn(bpSdr);
 		if (bpdbObject == 0)
 		{
@@ -1116,6 +1159,11 @@ int	bpAttach()
 			return -1;
 		}
 
+		if (checkBpdbFormat(bpdbFormat) < 0)
+		{
+			return -1;
+		}
+
 		oK(_bpdbObject(&bpdbObject));
 	}
 
@@ -1893,6 +1941,38 @@ static void	reportStateStats(int stateIdx)
 	writeMemo(buffer);
 }
 
+static void	reportClockStats()
+{
+	BpVdb		*bpvdb = _bpvdb(NULL);
+	char		buffer[256];
+
+	if (bpvdb->clockEvents == 0)
+	{
+		return;		/*	No timeline events yet.		*/
+	}
+
+	isprintf(buffer, sizeof buffer, "[x] clk events %lu usec %lu; last \
+tick: events %lu transactions %lu usec %lu", bpvdb->clockEvents,
+			bpvdb->clockUsec, bpvdb->tickEvents,
+			bpvdb->tickBatches, bpvdb->tickUsec);
+	writeMemo(buffer);
+}
+
+static void	reportCgrStats()
+{
+	BpVdb		*bpvdb = _bpvdb(NULL);
+	char		buffer[128];
+
+	if (bpvdb->cgrHits == 0 && bpvdb->cgrMisses == 0)
+	{
+		return;		/*	No routes looked up yet.	*/
+	}
+
+	isprintf(buffer, sizeof buffer, "[x] cgr route cache hits %lu \
+misses %lu", bpvdb->cgrHits, bpvdb->cgrMisses);
+	writeMemo(buffer);
+}
+
 void	reportAllStateStats()
 {
 	BpVdb		*bpvdb = _bpvdb(NULL);
@@ -1920,6 +2000,9 @@ void	reportAllStateStats()
 	{
 		reportStateStats(i);
 	}
+
+	reportClockStats();
+	reportCgrStats();
 }
 
 static ExtensionDef	*findExtensionDef(unsigned char type, unsigned char idx)
@@ -2276,6 +2359,215 @@ static void	destroyExtensionBlocks(Bundle *bundle)
 	}
 }
 
+/*	*	*	Bundle index functions	*	*	*	*/
+
+static unsigned long	hashEidString(char *eidString)
+{
+	unsigned long	h = 2166136261U;	/*	FNV-1a basis.	*/
+
+	while (*eidString)
+	{
+		h ^= (unsigned char) *eidString;
+		h = (h * 16777619U) & 0xffffffff;
+		eidString++;
+	}
+
+	return h;
+}
+
+static void	computeBundleKey(char *sourceEid, BpTimestamp *creationTime,
+			unsigned long fragmentOffset,
+			unsigned long fragmentLength, BundleKey *key)
+{
+	/*	Key must be fully initialized, since the SDR hash
+	 *	table compares keys byte-by-byte.			*/
+
+	memset((char *) key, 0, sizeof(BundleKey));
+	key->sourceEidHash = hashEidString(sourceEid);
+	key->seconds = creationTime->seconds;
+	key->count = creationTime->count;
+	if (fragmentLength > 0)
+	{
+		key->fragmentOffset = fragmentOffset;
+		key->fragmentLength = fragmentLength;
+	}
+}
+
+static int	getBundleKey(Bundle *bundle, BundleKey *key)
+{
+	char	*dictionary;
+	char	*eidString;
+
+	dictionary = retrieveDictionary(bundle);
+	if (dictionary == (char *) bundle)
+	{
+		putErrmsg("Can't retrieve dictionary.", NULL);
+		return -1;
+	}
+
+	if (printEid(&(bundle->id.source), dictionary, &eidString) < 0)
+	{
+		putErrmsg("Can't print source EID string.", NULL);
+		releaseDictionary(dictionary);
+		return -1;
+	}
+
+	releaseDictionary(dictionary);
+	computeBundleKey(eidString, &(bundle->id.creationTime),
+			bundle->id.fragmentOffset,
+			(bundle->bundleProcFlags & BDL_IS_FRAGMENT) ?
+			bundle->payload.length : 0, key);
+	MRELEASE(eidString);
+	return 0;
+}
+
+static void	adjustUnindexedBundles(int delta)
+{
+	Sdr	bpSdr = getIonsdr();
+	Object	bpdbObj = _bpdbObject(NULL);
+	BpDB	bpdb;
+
+	sdr_stage(bpSdr, (char *) &bpdb, bpdbObj, sizeof(BpDB));
+	if (delta < 0 && bpdb.unindexedBundles == 0)
+	{
+		return;
+	}
+
+	bpdb.unindexedBundles += delta;
+	sdr_write(bpSdr, bpdbObj, (char *) &bpdb, sizeof(BpDB));
+}
+
+static int	indexBundle(Bundle *bundle, Object bundleObj)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		bundles = (_bpConstants())->bundles;
+	BundleKey	key;
+
+	if (getBundleKey(bundle, &key) < 0)
+	{
+		putErrmsg("Can't compute bundle key.", NULL);
+		return -1;
+	}
+
+	switch (sdr_hash_insert(bpSdr, bundles, (char *) &key, bundleObj))
+	{
+	case 1:
+		return 0;
+
+	case 0:		/*	Key is already in use.			*/
+
+		/*	Either another copy of this bundle is still
+		 *	on the timeline or two source EIDs have the
+		 *	same hash.  Either way, findBundle() must now
+		 *	resort to searching the timeline until this
+		 *	bundle is destroyed.				*/
+
+		adjustUnindexedBundles(1);
+		return 0;
+
+	default:
+		putErrmsg("Can't index bundle.", NULL);
+		return -1;
+	}
+}
+
+static int	unindexBundle(Bundle *bundle, Object bundleObj)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		bundles = (_bpConstants())->bundles;
+	BundleKey	key;
+	Address		value;
+
+	if (getBundleKey(bundle, &key) < 0)
+	{
+		putErrmsg("Can't compute bundle key.", NULL);
+		return -1;
+	}
+
+	if (sdr_hash_retrieve(bpSdr, bundles, (char *) &key, &value) == 1
+	&& value == bundleObj)
+	{
+		if (sdr_hash_remove(bpSdr, bundles, (char *) &key) < 0)
+		{
+			putErrmsg("Can't unindex bundle.", NULL);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	/*	This bundle was never indexed.				*/
+
+	adjustUnindexedBundles(-1);
+	return 0;
+}
+
+static int	orderCustodyRefs(Sdr sdr, Address refObj, void *argData)
+{
+	unsigned long	custodyId = *((unsigned long *) argData);
+		OBJ_POINTER(CustodyRef, ref);
+
+	GET_OBJ_POINTER(sdr, CustodyRef, ref, refObj);
+	if (ref->custodyId < custodyId)
+	{
+		return -1;
+	}
+
+	if (ref->custodyId > custodyId)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static int	indexCustody(Bundle *bundle, Object bundleObj)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		bpdbObj = _bpdbObject(NULL);
+	BpDB		bpdb;
+	CustodyRef	ref;
+	Object		refObj;
+
+	sdr_stage(bpSdr, (char *) &bpdb, bpdbObj, sizeof(BpDB));
+	ref.custodyId = bpdb.nextCustodyId;
+	ref.bundleObj = bundleObj;
+	bpdb.nextCustodyId++;
+	sdr_write(bpSdr, bpdbObj, (char *) &bpdb, sizeof(BpDB));
+	refObj = sdr_malloc(bpSdr, sizeof(CustodyRef));
+	if (refObj == 0)
+	{
+		putErrmsg("No space for custody ID.", NULL);
+		return -1;
+	}
+
+	sdr_write(bpSdr, refObj, (char *) &ref, sizeof(CustodyRef));
+	bundle->custodyElt = sdr_rbt_insert(bpSdr, bpdb.custodyIds, refObj,
+			orderCustodyRefs, &ref.custodyId);
+	if (bundle->custodyElt == 0)
+	{
+		putErrmsg("Can't index bundle by custody ID.", NULL);
+		return -1;
+	}
+
+	bundle->custodyId = ref.custodyId;
+	return 0;
+}
+
+static void	unindexCustody(Bundle *bundle)
+{
+	Sdr	bpSdr = getIonsdr();
+
+	if (bundle->custodyElt == 0)
+	{
+		return;		/*	No custody ID assigned.		*/
+	}
+
+	sdr_free(bpSdr, sdr_rbt_data(bpSdr, bundle->custodyElt));
+	sdr_rbt_delete(bpSdr, bundle->custodyElt, NULL, NULL);
+	bundle->custodyElt = 0;
+}
+
 int	bpDestroyBundle(Object bundleObj, int ttlExpired)
 {
 	Sdr	bpSdr = getIonsdr();
@@ -2370,33 +2662,54 @@ incomplete bundle.", NULL);
 		}
 
 		bundle.custodyTaken = 0;
+		if (bundle.xmitsPending > 0)
+		{
+			/*	Bundle is in the batch of some CLO,
+			 *	which will destroy it on ending the
+			 *	batch.  Just note that the bundle's
+			 *	TTL has expired.			*/
+
+			destroyBpTimelineEvent(bundle.timelineElt);
+			bundle.timelineElt = 0;
+			sdr_write(bpSdr, bundleObj, (char *) &bundle,
+					sizeof(Bundle));
+			return 0;
+		}
 	}
 
 	/*	Check for any remaining constraints on deletion.	*/
 
 	if (bundle.dlvQueueElt || bundle.fragmentElt || bundle.fwdQueueElt
-	|| bundle.xmitsNeeded > 0 || bundle.custodyTaken)
+	|| bundle.xmitsNeeded > 0 || bundle.xmitsPending > 0
+	|| bundle.custodyTaken)
 	{
 		return 0;	/*	Can't destroy bundle yet.	*/
 	}
 
-	/*	Remove bundle from timeline.				*/
+	/*	Remove bundle from index and timeline.			*/
+
+	if (unindexBundle(&bundle, bundleObj) < 0)
+	{
+		putErrmsg("Can't remove bundle from index.", NULL);
+		return -1;
+	}
 
-	sdr_free(bpSdr, sdr_list_data(bpSdr, bundle.timelineElt));
-	sdr_list_delete(bpSdr, bundle.timelineElt, NULL, NULL);
+	unindexCustody(&bundle);
+	if (bundle.timelineElt)	/*	Else TTL expired in a batch.	*/
+	{
+		destroyBpTimelineEvent(bundle.timelineElt);
+	}
 
 	/*	Turn off automatic re-forwarding.			*/
 
 	if (bundle.overdueElt)
 	{
-		sdr_free(bpSdr, sdr_list_data(bpSdr, bundle.overdueElt));
-		sdr_list_delete(bpSdr, bundle.overdueElt, NULL, NULL);
+		destroyBpTimelineEvent(bundle.overdueElt);
 	}
 
 	if (bundle.ctDueElt)
 	{
-		sdr_free(bpSdr, sdr_list_data(bpSdr, bundle.ctDueElt));
-		sdr_list_delete(bpSdr, bundle.ctDueElt, NULL, NULL);
+		destroyBpTimelineEvent(bundle.ctDueElt);
 	}
 
 	/*	Remove bundle from applications' bundle tracking lists.	*/
@@ -2470,9 +2783,10 @@ incomplete bundle.", NULL);
 
 /*	*	*	BP database mgt and access functions	*	*/
 
-int	findBundle(char *sourceEid, BpTimestamp *creationTime,
-		unsigned long fragmentOffset, unsigned long fragmentLength,
-		Object *bundleAddr, Object *timelineElt)
+static int	scanTimeline(char *sourceEid, BpTimestamp *creationTime,
+			unsigned long fragmentOffset,
+			unsigned long fragmentLength, Object *bundleAddr,
+			Object *timelineElt)
 {
 	Sdr	bpSdr = getIonsdr();
 	Object	elt;
@@ -2483,13 +2797,11 @@ int	findBundle(char *sourceEid, BpTimestamp *creationTime,
 	char	*eidString;
 	int	result;
 
-	CHKERR(ionLocked());
-	*timelineElt = 0;
-	for (elt = sdr_list_first(bpSdr, (_bpConstants())->timeline); elt;
-			elt = sdr_list_next(bpSdr, elt))
+	for (elt = sdr_rbt_first(bpSdr, (_bpConstants())->timeline); elt;
+			elt = sdr_rbt_next(bpSdr, elt))
 	{
 		GET_OBJ_POINTER(bpSdr, BpEvent, event,
-				sdr_list_data(bpSdr, elt));
+				sdr_rbt_data(bpSdr, elt));
 		if (event->type != expiredTTL)
 		{
 			continue;
@@ -2597,6 +2909,68 @@ int	findBundle(char *sourceEid, BpTimestamp *creationTime,
 	return 0;
 }
 
+int	findBundle(char *sourceEid, BpTimestamp *creationTime,
+		unsigned long fragmentOffset, unsigned long fragmentLength,
+		Object *bundleAddr, Object *timelineElt)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		bundles = (_bpConstants())->bundles;
+	BundleKey	key;
+	Address		value;
+	Bundle		bundle;
+	char		*dictionary;
+	char		*eidString;
+	int		result;
+		OBJ_POINTER(BpDB, bpdb);
+
+	CHKERR(sdr_in_read(bpSdr));
+	*timelineElt = 0;
+	computeBundleKey(sourceEid, creationTime, fragmentOffset,
+			fragmentLength, &key);
+	if (sdr_hash_retrieve(bpSdr, bundles, (char *) &key, &value) == 1)
+	{
+		/*	Source EID hash matches; confirm that the
+		 *	source EID itself matches.			*/
+
+		sdr_read(bpSdr, (char *) &bundle, value, sizeof(Bundle));
+		dictionary = retrieveDictionary(&bundle);
+		if (dictionary == (char *) &bundle)
+		{
+			putErrmsg("Can't retrieve dictionary.", NULL);
+			return -1;
+		}
+
+		result = printEid(&(bundle.id.source), dictionary, &eidString);
+		releaseDictionary(dictionary);
+		if (result < 0)
+		{
+			putErrmsg("Can't print EID string.", NULL);
+			return -1;
+		}
+
+		result = strcmp(eidString, sourceEid);
+		MRELEASE(eidString);
+		if (result == 0)	/*	Found the bundle.	*/
+		{
+			*bundleAddr = value;
+			*timelineElt = bundle.timelineElt;
+			return 0;
+		}
+	}
+
+	/*	Not in the index, but the bundle might be one of the
+	 *	ones that couldn't be indexed due to key collision.	*/
+
+	GET_OBJ_POINTER(bpSdr, BpDB, bpdb, _bpdbObject(NULL));
+	if (bpdb->unindexedBundles == 0)
+	{
+		return 0;		/*	No such bundle.		*/
+	}
+
+	return scanTimeline(sourceEid, creationTime, fragmentOffset,
+			fragmentLength, bundleAddr, timelineElt);
+}
+
 void	findScheme(char *schemeName, VScheme **scheme, PsmAddress *schemeElt)
 {
 	PsmPartition	bpwm = getIonwm();
@@ -3197,7 +3571,7 @@ void	fetchProtocol(char *protocolName, ClProtocol *clp, Object *clpElt)
 }
 
 int	addProtocol(char *protocolName, int payloadPerFrame, int ohdPerFrame,
-		long nominalRate)
+		long nominalRate, long burstSize)
 {
 	Sdr		bpSdr = getIonsdr();
 	ClProtocol	clpbuf;
@@ -3219,6 +3593,12 @@ int	addProtocol(char *protocolName, int payloadPerFrame, int ohdPerFrame,
 		return 0;
 	}
 
+	if (burstSize < 0)
+	{
+		writeMemoNote("[?] Burst size must be >= 0", protocolName);
+		return 0;
+	}
+
 	sdr_begin_xn(bpSdr);
 	fetchProtocol(protocolName, &clpbuf, &elt);
 	if (elt != 0)		/*	This is a known protocol.	*/
@@ -3235,6 +3615,7 @@ int	addProtocol(char *protocolName, int payloadPerFrame, int ohdPerFrame,
 	clpbuf.payloadBytesPerFrame = payloadPerFrame;
 	clpbuf.overheadPerFrame = ohdPerFrame;
 	clpbuf.nominalRate = nominalRate;
+	clpbuf.burstSize = burstSize;
 	clpbuf.inducts = sdr_list_create(bpSdr);
 	clpbuf.outducts = sdr_list_create(bpSdr);
 	addr = sdr_malloc(bpSdr, sizeof(ClProtocol));
@@ -4015,13 +4396,31 @@ static int	findIncomplete(Bundle *bundle, VEndpoint *vpoint,
 	return 0;
 }
 
+static int	orderBpEvents(Sdr sdr, Address eventObj, void *argData)
+{
+	BpEvent	*newEvent = (BpEvent *) argData;
+		OBJ_POINTER(BpEvent, event);
+
+	GET_OBJ_POINTER(sdr, BpEvent, event, eventObj);
+	if (event->time < newEvent->time)
+	{
+		return -1;
+	}
+
+	if (event->time > newEvent->time)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
 Object	insertBpTimelineEvent(BpEvent *newEvent)
 {
 	Sdr	bpSdr = getIonsdr();
 	BpDB	*bpConstants = _bpConstants();
 	Address	addr;
-	Object	elt;
-		OBJ_POINTER(BpEvent, event);
+	Object	node;
 
 	CHKZERO(ionLocked());
 	addr = sdr_malloc(bpSdr, sizeof(BpEvent));
@@ -4032,18 +4431,28 @@ Object	insertBpTimelineEvent(BpEvent *newEvent)
 	}
 
 	sdr_write(bpSdr, addr, (char *) newEvent, sizeof(BpEvent));
-	for (elt = sdr_list_last(bpSdr, bpConstants->timeline); elt;
-			elt = sdr_list_prev(bpSdr, elt))
+	node = sdr_rbt_insert(bpSdr, bpConstants->timeline, addr,
+			orderBpEvents, newEvent);
+
+	/*	If the new event is now the earliest in the timeline,
+	 *	bpclock must reschedule its wakeup.			*/
+
+	if (node != 0 && node == sdr_rbt_first(bpSdr, bpConstants->timeline))
 	{
-		GET_OBJ_POINTER(bpSdr, BpEvent, event,
-				sdr_list_data(bpSdr, elt));
-		if (event->time <= newEvent->time)
-		{
-			return sdr_list_insert_after(bpSdr, elt, addr);
-		}
+		sm_SemGive((_bpvdb(NULL))->clockSemaphore);
 	}
 
-	return sdr_list_insert_first(bpSdr, bpConstants->timeline, addr);
+	return node;
+}
+
+void	destroyBpTimelineEvent(Object timelineElt)
+{
+	Sdr	bpSdr = getIonsdr();
+
+	CHKVOID(ionLocked());
+	CHKVOID(timelineElt);
+	sdr_free(bpSdr, sdr_rbt_data(bpSdr, timelineElt));
+	sdr_rbt_delete(bpSdr, timelineElt, NULL, NULL);
 }
 
 int	enqueueToDuct(FwdDirective *directive, Bundle *bundle, Object bundleObj,
@@ -4121,7 +4530,9 @@ static int	setBundleTTL(Bundle *bundle, Object bundleObj)
 		return -1;
 	}
 
-	return 0;
+	/*	Every bundle on the timeline is indexed by ID.		*/
+
+	return indexBundle(bundle, bundleObj);
 }
 
 static int	insertExtensionBlock(ExtensionDef *def, ExtensionBlock *newBlk,
@@ -4332,6 +4743,13 @@ static int	copyBundle(Bundle *newBundle, Object *newBundleObj,
 	}
 
 	memcpy((char *) newBundle, (char *) oldBundle, sizeof(Bundle));
+
+	/*	The copy gets its own custody ID, if any, when the
+	 *	local node takes custody of it.				*/
+
+	newBundle->custodyElt = 0;
+	newBundle->custodyId = 0;
+	newBundle->xmitsPending = 0;	/*	Not in any batch.	*/
 	if (oldBundle->dictionary)	/*	Must copy dictionary.	*/
 	{
 		dictionaryBuffer = retrieveDictionary(oldBundle);
@@ -5145,6 +5563,7 @@ status reports for admin records.");
 	bundle.payload.length = aduLength;
 	bundle.payload.content = adu;
 	bundle.xmitsNeeded = 0;
+	bundle.xmitsPending = 0;
 
 	/*	Bundle is almost fully constructed at this point.	*/
 
@@ -5275,9 +5694,338 @@ status reports for admin records.");
 	return 1;
 }
 
-/*	*	*	Bundle reception functions	*	*	*/
+/*	*	*	Aggregate custody signal functions	*	*/
 
-int	sendCtSignal(Bundle *bundle, char *dictionary, int succeeded,
+static int	insertAcsFill(Object fills, unsigned long custodyId)
+{
+	Sdr	bpSdr = getIonsdr();
+	Object	elt;
+	Object	nextElt;
+	AcsFill	fill;
+	AcsFill	nextFill;
+	Object	fillObj;
+
+	/*	Fills are in ascending custody ID order.  Custody IDs
+	 *	are normally noted in the order in which they were
+	 *	assigned, so search backward from the end of the list
+	 *	for the last fill that starts at or before this ID.	*/
+
+	for (elt = sdr_list_last(bpSdr, fills); elt;
+			elt = sdr_list_prev(bpSdr, elt))
+	{
+		sdr_read(bpSdr, (char *) &fill, sdr_list_data(bpSdr, elt),
+				sizeof(AcsFill));
+		if (fill.start <= custodyId)
+		{
+			break;
+		}
+	}
+
+	if (elt)
+	{
+		if (custodyId < fill.start + fill.length)
+		{
+			return 0;	/*	Already noted.		*/
+		}
+
+		nextElt = sdr_list_next(bpSdr, elt);
+		if (custodyId == fill.start + fill.length)
+		{
+			/*	Extend this fill, merging it with the
+			 *	next one if the gap is now closed.	*/
+
+			fill.length++;
+			if (nextElt)
+			{
+				fillObj = sdr_list_data(bpSdr, nextElt);
+				sdr_read(bpSdr, (char *) &nextFill, fillObj,
+						sizeof(AcsFill));
+				if (nextFill.start == custodyId + 1)
+				{
+					fill.length += nextFill.length;
+					sdr_free(bpSdr, fillObj);
+					sdr_list_delete(bpSdr, nextElt, NULL,
+							NULL);
+				}
+			}
+
+			sdr_write(bpSdr, sdr_list_data(bpSdr, elt),
+					(char *) &fill, sizeof(AcsFill));
+			return 0;
+		}
+	}
+	else
+	{
+		nextElt = sdr_list_first(bpSdr, fills);
+	}
+
+	/*	Not contiguous with the preceding fill; may extend the
+	 *	following one backward.					*/
+
+	if (nextElt)
+	{
+		fillObj = sdr_list_data(bpSdr, nextElt);
+		sdr_read(bpSdr, (char *) &nextFill, fillObj, sizeof(AcsFill));
+		if (nextFill.start == custodyId + 1)
+		{
+			nextFill.start--;
+			nextFill.length++;
+			sdr_write(bpSdr, fillObj, (char *) &nextFill,
+					sizeof(AcsFill));
+			return 0;
+		}
+	}
+
+	fill.start = custodyId;
+	fill.length = 1;
+	fillObj = sdr_malloc(bpSdr, sizeof(AcsFill));
+	if (fillObj == 0)
+	{
+		putErrmsg("No space for ACS fill.", NULL);
+		return -1;
+	}
+
+	sdr_write(bpSdr, fillObj, (char *) &fill, sizeof(AcsFill));
+	if (elt)
+	{
+		elt = sdr_list_insert_after(bpSdr, elt, fillObj);
+	}
+	else
+	{
+		elt = sdr_list_insert_first(bpSdr, fills, fillObj);
+	}
+
+	if (elt == 0)
+	{
+		putErrmsg("Can't insert ACS fill.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int	noteAcsFill(char *custodianEid, unsigned long custodyId,
+			int succeeded, BpCtReason reasonCode, unsigned int ttl)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		pendingAcsList = (_bpConstants())->pendingAcs;
+	Object		elt;
+	Object		acsObj;
+	PendingAcs	acs;
+	char		eidBuf[SDRSTRING_BUFSZ];
+	BpEvent		event;
+
+	/*	Returns 1 if the custody ID was noted for inclusion
+	 *	in an aggregate custody signal, 0 if the signal can't
+	 *	be aggregated, -1 on system failure.			*/
+
+	if (strlen(custodianEid) >= SDRSTRING_BUFSZ)
+	{
+		return 0;
+	}
+
+	sdr_begin_xn(bpSdr);
+	for (elt = sdr_list_first(bpSdr, pendingAcsList); elt;
+			elt = sdr_list_next(bpSdr, elt))
+	{
+		acsObj = sdr_list_data(bpSdr, elt);
+		sdr_read(bpSdr, (char *) &acs, acsObj, sizeof(PendingAcs));
+		if (acs.succeeded != succeeded || acs.reasonCode != reasonCode)
+		{
+			continue;
+		}
+
+		sdr_string_read(bpSdr, eidBuf, acs.custodianEid);
+		if (strcmp(eidBuf, custodianEid) == 0)
+		{
+			break;
+		}
+	}
+
+	if (elt == 0)	/*	Start a new aggregate signal.		*/
+	{
+		memset((char *) &acs, 0, sizeof(PendingAcs));
+		acs.custodianEid = sdr_string_create(bpSdr, custodianEid);
+		acs.succeeded = succeeded;
+		acs.reasonCode = reasonCode;
+		acs.fills = sdr_list_create(bpSdr);
+		acs.ttl = ttl;
+		acsObj = sdr_malloc(bpSdr, sizeof(PendingAcs));
+		if (acsObj)
+		{
+			elt = sdr_list_insert_last(bpSdr, pendingAcsList,
+					acsObj);
+		}
+
+		if (elt)
+		{
+			event.type = acsDue;
+			event.time = getUTCTime() + BP_ACS_DELAY;
+			event.ref = elt;
+			acs.deadlineElt = insertBpTimelineEvent(&event);
+		}
+
+		if (acs.custodianEid == 0 || acs.fills == 0
+		|| acs.deadlineElt == 0)
+		{
+			putErrmsg("Can't start aggregate custody signal.",
+					custodianEid);
+			sdr_cancel_xn(bpSdr);
+			return -1;
+		}
+	}
+	else
+	{
+		if (ttl > acs.ttl)
+		{
+			acs.ttl = ttl;
+		}
+	}
+
+	if (insertAcsFill(acs.fills, custodyId) < 0)
+	{
+		putErrmsg("Can't note custody ID.", itoa(custodyId));
+		sdr_cancel_xn(bpSdr);
+		return -1;
+	}
+
+	sdr_write(bpSdr, acsObj, (char *) &acs, sizeof(PendingAcs));
+	if (sdr_list_length(bpSdr, acs.fills) >= BP_ACS_MAX_FILLS)
+	{
+		if (bpFlushAcs(elt) < 0)
+		{
+			putErrmsg("Can't send full aggregate custody signal.",
+					custodianEid);
+			sdr_cancel_xn(bpSdr);
+			return -1;
+		}
+	}
+
+	if (sdr_end_xn(bpSdr) < 0)
+	{
+		putErrmsg("Can't note custody ID.", itoa(custodyId));
+		return -1;
+	}
+
+	return 1;
+}
+
+int	bpFlushAcs(Object pendingAcsElt)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		acsObj;
+	PendingAcs	acs;
+	char		custodianEid[SDRSTRING_BUFSZ];
+	Object		elt;
+	Object		fillObj;
+	AcsFill		fill;
+	unsigned long	priorFillEnd = 0;
+	Sdnv		gapSdnv;
+	Sdnv		lengthSdnv;
+	int		recordLength;
+	char		*buffer;
+	char		*cursor;
+	Object		sourceData;
+	Object		payloadZco;
+	BpExtendedCOS	ecos = { 0, 0, 255 };
+	Object		bundleObj;
+	int		result;
+
+	CHKERR(ionLocked());
+	CHKERR(pendingAcsElt);
+	acsObj = sdr_list_data(bpSdr, pendingAcsElt);
+	sdr_read(bpSdr, (char *) &acs, acsObj, sizeof(PendingAcs));
+	sdr_string_read(bpSdr, custodianEid, acs.custodianEid);
+
+	/*	Each fill is encoded as the gap between its first
+	 *	custody ID and the end of the preceding fill (or zero),
+	 *	followed by its length.					*/
+
+	recordLength = 2 + (sdr_list_length(bpSdr, acs.fills)
+			* (sizeof gapSdnv.text + sizeof lengthSdnv.text));
+	buffer = MTAKE(recordLength);
+	if (buffer == NULL)
+	{
+		putErrmsg("Can't construct aggregate custody signal.", NULL);
+		return -1;
+	}
+
+	cursor = buffer;
+	*cursor = (char) (BP_AGGREGATE_CUSTODY_SIGNAL << 4);
+	cursor++;
+	*cursor = acs.reasonCode | (acs.succeeded << 7);
+	cursor++;
+	while ((elt = sdr_list_first(bpSdr, acs.fills)) != 0)
+	{
+		fillObj = sdr_list_data(bpSdr, elt);
+		sdr_read(bpSdr, (char *) &fill, fillObj, sizeof(AcsFill));
+		encodeSdnv(&gapSdnv, fill.start - priorFillEnd);
+		encodeSdnv(&lengthSdnv, fill.length);
+		memcpy(cursor, gapSdnv.text, gapSdnv.length);
+		cursor += gapSdnv.length;
+		memcpy(cursor, lengthSdnv.text, lengthSdnv.length);
+		cursor += lengthSdnv.length;
+		priorFillEnd = fill.start + fill.length;
+		sdr_free(bpSdr, fillObj);
+		sdr_list_delete(bpSdr, elt, NULL, NULL);
+	}
+
+	recordLength = cursor - buffer;
+
+	/*	Destroy the PendingAcs before sending the signal.	*/
+
+	sdr_list_destroy(bpSdr, acs.fills, NULL, NULL);
+	sdr_free(bpSdr, acs.custodianEid);
+	if (acs.deadlineElt)
+	{
+		destroyBpTimelineEvent(acs.deadlineElt);
+	}
+
+	sdr_free(bpSdr, acsObj);
+	sdr_list_delete(bpSdr, pendingAcsElt, NULL, NULL);
+
+	/*	Now send the signal.					*/
+
+	sourceData = sdr_malloc(bpSdr, recordLength);
+	if (sourceData == 0)
+	{
+		putErrmsg("No space for source data.", NULL);
+		MRELEASE(buffer);
+		return -1;
+	}
+
+	sdr_write(bpSdr, sourceData, buffer, recordLength);
+	MRELEASE(buffer);
+	payloadZco = zco_create(bpSdr, ZcoSdrSource, sourceData, 0,
+			recordLength);
+	if (payloadZco == 0)
+	{
+		putErrmsg("Can't create aggregate custody signal.", NULL);
+		return -1;
+	}
+
+	result = bpSend(NULL, custodianEid, NULL, acs.ttl,
+			BP_EXPEDITED_PRIORITY, NoCustodyRequested, 0, 0, &ecos,
+			payloadZco, &bundleObj, BP_AGGREGATE_CUSTODY_SIGNAL);
+	switch (result)
+	{
+	case -1:
+		putErrmsg("Can't send aggregate custody signal.", NULL);
+		return -1;
+
+	case 0:
+		putErrmsg("Aggregate custody signal not transmitted.", NULL);
+
+			/*	Intentional fall-through to next case.	*/
+
+	default:
+		return 0;
+	}
+}
+
+/*	*	*	Bundle reception functions	*	*	*/
+
+int	sendCtSignal(Bundle *bundle, char *dictionary, int succeeded,
 		BpCtReason reasonCode)
 {
 	char		*custodianEid;
@@ -5314,6 +6062,37 @@ int	sendCtSignal(Bundle *bundle, char *dictionary, int succeeded,
 	/*	There is a current custodian, so construct and send
 	 *	the signal.						*/
 
+	ttl = bundle->expirationTime - bundle->id.creationTime.seconds;
+	if (ttl < 1)
+	{
+		ttl = 1;
+	}
+
+	/*	If the custodian announced a custody ID for this
+	 *	bundle, the signal is aggregated with others to the
+	 *	same custodian instead.					*/
+
+	if (bundle->ctebValid)
+	{
+		result = noteAcsFill(custodianEid, bundle->ctebCustodyId,
+				succeeded, reasonCode, ttl);
+		if (result != 0)
+		{
+			MRELEASE(custodianEid);
+			if (result < 0)
+			{
+				putErrmsg("Can't aggregate custody signal.",
+						NULL);
+				return -1;
+			}
+
+			return 0;
+		}
+
+		/*	Can't aggregate; send a signal for this bundle
+		 *	alone.						*/
+	}
+
 	bundle->ctSignal.succeeded = succeeded;
 	bundle->ctSignal.reasonCode = reasonCode;
 	getCurrentDtnTime(&bundle->ctSignal.signalTime);
@@ -5339,12 +6118,6 @@ int	sendCtSignal(Bundle *bundle, char *dictionary, int succeeded,
 		}
 	}
 
-	ttl = bundle->expirationTime - bundle->id.creationTime.seconds;
-	if (ttl < 1)
-	{
-		ttl = 1;
-	}
-
 	if (printEid(&bundle->id.source, dictionary,
 			&bundle->ctSignal.sourceEid) < 0)
 	{
@@ -5664,6 +6437,17 @@ static int	extendIncomplete(IncompleteBundle *incomplete, Object incElt,
 	aggregateBundle.fragmentElt = 0;
 	aggregateBundle.incompleteElt = 0;
 	aggregateBundle.totalAduLength = 0;
+
+	/*	The bundle's ID changes from that of the fragment to
+	 *	that of the original bundle, so re-index it.		*/
+
+	if (unindexBundle(&aggregateBundle, aggregateBundleObj) < 0)
+	{
+		MRELEASE(buffer);
+		putErrmsg("Can't remove fragment from index.", NULL);
+		return -1;
+	}
+
 	aggregateBundle.bundleProcFlags &= ~BDL_IS_FRAGMENT;
 
 	/*	Back out of database occupancy this bundle's
@@ -5673,6 +6457,12 @@ static int	extendIncomplete(IncompleteBundle *incomplete, Object incElt,
 	noteBundleRemoved(&aggregateBundle);
 	aggregateAduLength = aggregateBundle.payload.length;
 	aggregateBundle.payload.length = incomplete->totalAduLength;
+	if (indexBundle(&aggregateBundle, aggregateBundleObj) < 0)
+	{
+		MRELEASE(buffer);
+		putErrmsg("Can't index reassembled bundle.", NULL);
+		return -1;
+	}
 
 	/*	Now collect payload data from all remaining fragments,
 	 *	discarding overlaps, and destroy the fragments.		*/
@@ -6225,6 +7015,7 @@ static int	eraseWorkZco(AcqWorkArea *work)
 	work->zco = 0;
 	work->zcoElt = 0;
 	work->zcoBytesConsumed = 0;
+	zco_stop_receiving(getIonsdr(), &(work->reader));
 	memset((char *) &(work->reader), 0, sizeof(ZcoReader));
 	work->zcoBytesReceived = 0;
 	work->bytesBuffered = 0;
@@ -6441,60 +7232,188 @@ int	computeECCC(int bundleSize, ClProtocol *protocol)
 	return bundleSize + (protocol->overheadPerFrame * framesNeeded);
 }
 
-static int	applyRecvRateControl(AcqWorkArea *work)
+static long	throttleLimit(Throttle *throttle)
 {
-	Sdr		bpSdr = getIonsdr();
-	Bundle		*bundle = &(work->bundle);
-			OBJ_POINTER(Induct, induct);
-			OBJ_POINTER(ClProtocol, protocol);
-	Throttle	*throttle;
-	int		recvLength;
+	double	limit;
 
-	sdr_begin_xn(bpSdr);		/*	Just to lock memory.	*/
-	GET_OBJ_POINTER(bpSdr, Induct, induct, sdr_list_data(bpSdr,
-			work->vduct->inductElt));
-	GET_OBJ_POINTER(bpSdr, ClProtocol, protocol, induct->protocol);
-	recvLength = computeECCC(bundle->payload.length
-			+ NOMINAL_PRIMARY_BLKSIZE, protocol);
-	throttle = &(work->vduct->acqThrottle);
-	while (throttle->capacity <= 0)
+	if (throttle->burstSize > 0)
 	{
-		sdr_exit_xn(bpSdr);
-		if (sm_SemTake(throttle->semaphore) < 0)
-		{
-			putErrmsg("CLI can't take throttle semaphore.", NULL);
-			return -1;
-		}
-
-		if (sm_SemEnded(throttle->semaphore))
-		{
-			putErrmsg("Induct has been stopped.", NULL);
-			return -1;
-		}
-
-		sdr_begin_xn(bpSdr);
+		return throttle->burstSize;
 	}
 
-	throttle->capacity -= recvLength;
-	if (throttle->capacity > 0)
+	limit = ((double) throttle->nominalRate * BP_DEFAULT_BURST_MSEC)
+			/ 1000.0;
+	if (limit < 1.0)	/*	Always admit at least 1 byte.	*/
 	{
-		sm_SemGive(throttle->semaphore);
+		return 1;
 	}
 
-	sdr_exit_xn(bpSdr);		/*	Release memory.		*/
-	return 0;
+	return (long) limit;
 }
 
-static int	advanceWorkBuffer(AcqWorkArea *work, int bytesParsed)
+void	refillThrottle(Throttle *throttle)
 {
-	int	bytesRemaining = work->zcoLength - work->zcoBytesReceived;
-	int	bytesToReceive;
-	int	bytesReceived;
-
-	/*	Shift buffer left by number of bytes parsed.		*/
+	struct timeval	now;
+	double		usec;
+	double		bytes;
+	long		limit;
+	long		increment;
 
-	work->bytesBuffered -= bytesParsed;
-	memcpy(work->buffer, work->buffer + bytesParsed, work->bytesBuffered);
+	CHKVOID(throttle);
+	getMonotonicTime(&now);
+	limit = throttleLimit(throttle);
+	usec = ((double) (now.tv_sec - throttle->lastRefill.tv_sec)
+			* 1000000.0) + (now.tv_usec - throttle->lastRefill.tv_usec);
+	if (throttle->nominalRate <= 0 || usec < 0.0)
+	{
+		/*	Duct is idle, or clock has gone backward:
+		 *	capacity accrues from now on.			*/
+
+		throttle->lastRefill.tv_sec = now.tv_sec;
+		throttle->lastRefill.tv_usec = now.tv_usec;
+		if (throttle->capacity > limit)
+		{
+			throttle->capacity = limit;
+		}
+
+		return;
+	}
+
+	bytes = ((double) throttle->nominalRate * usec) / 1000000.0;
+	if (bytes >= (double) (limit - throttle->capacity))
+	{
+		/*	Bucket is full; excess capacity is lost.	*/
+
+		throttle->capacity = (throttle->capacity > limit ?
+				throttle->capacity : limit);
+		throttle->lastRefill.tv_sec = now.tv_sec;
+		throttle->lastRefill.tv_usec = now.tv_usec;
+		return;
+	}
+
+	increment = (long) bytes;
+	if (increment == 0)
+	{
+		return;		/*	Let elapsed time accumulate.	*/
+	}
+
+	/*	Advance the refill time only by the time it takes to
+	 *	accrue the whole bytes added, so that no fraction of
+	 *	the nominal rate is lost to truncation.			*/
+
+	throttle->capacity += increment;
+	usec = ((double) increment * 1000000.0) / throttle->nominalRate;
+	throttle->lastRefill.tv_usec += (long) usec % 1000000;
+	throttle->lastRefill.tv_sec += (long) usec / 1000000;
+	if (throttle->lastRefill.tv_usec >= 1000000)
+	{
+		throttle->lastRefill.tv_sec += 1;
+		throttle->lastRefill.tv_usec -= 1000000;
+	}
+}
+
+/*	Waits until the throttle has capacity.  Must be called with
+ *	ION memory locked; returns 0 with memory still locked, or 1
+ *	(duct stopped) or -1 (error) with memory unlocked.		*/
+
+static int	awaitThrottle(Sdr bpSdr, Throttle *throttle)
+{
+	double	usec;
+
+	while (1)
+	{
+		refillThrottle(throttle);
+		if (throttle->capacity > 0)
+		{
+			return 0;
+		}
+
+		if (throttle->nominalRate > 0)
+		{
+			/*	Sleep until the deficit is paid off,
+			 *	but wake at least once per second to
+			 *	check for duct stop.			*/
+
+			usec = (((double) (1 - throttle->capacity))
+				* 1000000.0) / throttle->nominalRate;
+			sdr_exit_xn(bpSdr);
+			microsnooze(usec > 1000000.0 ? 1000000
+					: ((unsigned int) usec) + 1);
+		}
+		else
+		{
+			/*	No capacity will accrue until the
+			 *	nominal rate is changed, at which
+			 *	time bpclock gives the semaphore.	*/
+
+			sdr_exit_xn(bpSdr);
+			if (sm_SemTake(throttle->semaphore) < 0)
+			{
+				putErrmsg("Can't take throttle semaphore.",
+						NULL);
+				return -1;
+			}
+		}
+
+		if (sm_SemEnded(throttle->semaphore))
+		{
+			return 1;
+		}
+
+		sdr_begin_xn(bpSdr);
+	}
+}
+
+static int	applyRecvRateControl(AcqWorkArea *work)
+{
+	Sdr		bpSdr = getIonsdr();
+	Bundle		*bundle = &(work->bundle);
+			OBJ_POINTER(Induct, induct);
+			OBJ_POINTER(ClProtocol, protocol);
+	Throttle	*throttle;
+	int		recvLength;
+
+	sdr_begin_xn(bpSdr);		/*	Just to lock memory.	*/
+	GET_OBJ_POINTER(bpSdr, Induct, induct, sdr_list_data(bpSdr,
+			work->vduct->inductElt));
+	GET_OBJ_POINTER(bpSdr, ClProtocol, protocol, induct->protocol);
+	recvLength = computeECCC(bundle->payload.length
+			+ NOMINAL_PRIMARY_BLKSIZE, protocol);
+	throttle = &(work->vduct->acqThrottle);
+	switch (awaitThrottle(bpSdr, throttle))
+	{
+	case -1:
+		putErrmsg("CLI can't wait for throttle.", NULL);
+		return -1;
+
+	case 1:
+		putErrmsg("Induct has been stopped.", NULL);
+		return -1;
+
+	default:
+		break;
+	}
+
+	throttle->capacity -= recvLength;
+	if (throttle->capacity > 0)
+	{
+		sm_SemGive(throttle->semaphore);
+	}
+
+	sdr_exit_xn(bpSdr);		/*	Release memory.		*/
+	return 0;
+}
+
+static int	advanceWorkBuffer(AcqWorkArea *work, int bytesParsed)
+{
+	int	bytesRemaining = work->zcoLength - work->zcoBytesReceived;
+	int	bytesToReceive;
+	int	bytesReceived;
+
+	/*	Shift buffer left by number of bytes parsed.		*/
+
+	work->bytesBuffered -= bytesParsed;
+	memcpy(work->buffer, work->buffer + bytesParsed, work->bytesBuffered);
 
 	/*	Now read from ZCO to fill the buffer space that was
 	 *	vacated.						*/
@@ -7578,13 +8497,6 @@ static int	acquireBundle(Sdr bpSdr, AcqWorkArea *work)
 		return -1;
 	}
 
-	if (setBundleTTL(bundle, bundleObj) < 0)
-	{
-		putErrmsg("Can't insert new bundle into timeline.", NULL);
-		sdr_cancel_xn(bpSdr);
-		return -1;
-	}
-
 	if (bundle->dictionaryLength > 0)
 	{
 		bundle->dictionary = sdr_malloc(bpSdr,
@@ -7601,6 +8513,16 @@ static int	acquireBundle(Sdr bpSdr, AcqWorkArea *work)
 		bundle->dbOverhead += bundle->dictionaryLength;
 	}
 
+	/*	Dictionary must be stored before the bundle's TTL is
+	 *	set, because the bundle is then indexed by source EID.	*/
+
+	if (setBundleTTL(bundle, bundleObj) < 0)
+	{
+		putErrmsg("Can't insert new bundle into timeline.", NULL);
+		sdr_cancel_xn(bpSdr);
+		return -1;
+	}
+
 	if (recordExtensionBlocks(work) < 0)
 	{
 		putErrmsg("Can't record extensions.", NULL);
@@ -7666,6 +8588,7 @@ int	bpEndAcq(AcqWorkArea *work)
 	CHKERR(advanceWorkBuffer(work, 0) == 0);
 	if (sdr_end_xn(bpSdr) < 0)
 	{
+		zco_stop_receiving(bpSdr, &(work->reader));
 		putErrmsg("Acq buffer initialization failed.", NULL);
 		return -1;
 	}
@@ -7677,6 +8600,7 @@ int	bpEndAcq(AcqWorkArea *work)
 	{
 		if (acquireBundle(bpSdr, work) < 0)
 		{
+			zco_stop_receiving(bpSdr, &(work->reader));
 			putErrmsg("Bundle acquisition failed.", NULL);
 			return -1;
 		}
@@ -7865,9 +8789,83 @@ static int	bpParseCtSignal(BpCtSignal *csig, unsigned char *cursor,
 	return 1;
 }
 
+static int	bpParseAcs(BpCtSignal *csig, unsigned char *cursor,
+			int unparsedBytes)
+{
+	unsigned char	head1;
+	unsigned char	*fillsCursor;
+	int		fillsBytes;
+	unsigned long	gap;
+	unsigned long	length;
+	unsigned long	priorFillEnd = 0;
+	AcsFill		*fill;
+
+	memset((char *) csig, 0, sizeof(BpCtSignal));
+	if (unparsedBytes < 1)
+	{
+		writeMemoNote("[?] ACS too short to parse",
+				itoa(unparsedBytes));
+		return 0;
+	}
+
+	head1 = *cursor;
+	cursor++;
+	unparsedBytes -= 1;
+	csig->succeeded = ((head1 & 0x80) > 0);
+	csig->reasonCode = head1 & 0x7f;
+
+	/*	The aggregate signal carries no signal time, so the
+	 *	time of its reception is reported instead.		*/
+
+	getCurrentDtnTime(&csig->signalTime);
+
+	/*	Count the fills before taking space for them.		*/
+
+	fillsCursor = cursor;
+	fillsBytes = unparsedBytes;
+	while (fillsBytes > 0)
+	{
+		extractSdnv(&gap, &fillsCursor, &fillsBytes);
+		extractSdnv(&length, &fillsCursor, &fillsBytes);
+		csig->fillsCount++;
+	}
+
+	if (csig->fillsCount == 0)
+	{
+		writeMemo("[?] ACS has no fills.");
+		return 0;
+	}
+
+	csig->fills = MTAKE(csig->fillsCount * sizeof(AcsFill));
+	if (csig->fills == NULL)
+	{
+		putErrmsg("Can't acquire ACS fills.", itoa(csig->fillsCount));
+		return -1;
+	}
+
+	for (fill = csig->fills; unparsedBytes > 0; fill++)
+	{
+		extractSdnv(&gap, &cursor, &unparsedBytes);
+		extractSdnv(&length, &cursor, &unparsedBytes);
+		fill->start = priorFillEnd + gap;
+		fill->length = length;
+		priorFillEnd = fill->start + fill->length;
+	}
+
+	return 1;
+}
+
 void	bpEraseCtSignal(BpCtSignal *csig)
 {
-	MRELEASE(csig->sourceEid);
+	if (csig->sourceEid)
+	{
+		MRELEASE(csig->sourceEid);
+	}
+
+	if (csig->fills)
+	{
+		MRELEASE(csig->fills);
+	}
 }
 
 int	bpConstructStatusRpt(BpStatusRpt *rpt, Object *zcoRef)
@@ -8206,6 +9204,7 @@ int	bpParseAdminRecord(int *adminRecordType, BpStatusRpt *rpt,
 	if (bytesToParse < 0)
 	{
 		putErrmsg("Can't receive admin record.", NULL);
+		zco_stop_receiving(bpSdr, &reader);
 		sdr_cancel_xn(bpSdr);
 		MRELEASE(buffer);
 		return -1;
@@ -8239,6 +9238,11 @@ int	bpParseAdminRecord(int *adminRecordType, BpStatusRpt *rpt,
 					unparsedBytes, bundleIsFragment);
 			break;
 
+		case BP_AGGREGATE_CUSTODY_SIGNAL:
+			result = bpParseAcs(csig, (unsigned char *) cursor,
+					unparsedBytes);
+			break;
+
 		default:
 			writeMemoNote("[?] Unknown admin record type",
 					itoa(*adminRecordType));
@@ -8675,9 +9679,11 @@ static int	insertNonCbheCustodian(Bundle *bundle, VScheme *vscheme)
 
 static int	takeCustody(Bundle *bundle)
 {
+	Sdr		bpSdr = getIonsdr();
 	char		*custodialSchemeName;
 	VScheme		*vscheme;
 	PsmAddress	vschemeElt;
+	BpEvent		event;
 
 	custodialSchemeName = getCustodialSchemeName(bundle);
 	findScheme(custodialSchemeName, &vscheme, &vschemeElt);
@@ -8694,6 +9700,7 @@ static int	takeCustody(Bundle *bundle)
 	}
 
 	bundle->custodyTaken = 1;
+	bundle->ctebValid = 0;	/*	Previous custodian's CTEB.	*/
 	if (SRR_FLAGS(bundle->bundleProcFlags) & BP_CUSTODY_RPT)
 	{
 		bundle->statusRpt.flags |= BP_CUSTODY_RPT;
@@ -8710,18 +9717,48 @@ static int	takeCustody(Bundle *bundle)
 
 	if (bundle->dictionaryLength > 0)
 	{
-		return insertNonCbheCustodian(bundle, vscheme);
+		if (insertNonCbheCustodian(bundle, vscheme) < 0)
+		{
+			return -1;
+		}
+	}
+	else
+	{
+		bundle->custodian.cbhe = 1;
+		bundle->custodian.c.nodeNbr = getOwnNodeNbr();
+		bundle->custodian.c.serviceNbr = 0;
+	}
+
+	/*	Assign the custody ID by which aggregate custody
+	 *	signals will identify the bundle.  The bundle's TTL
+	 *	expiration event gives us the bundle's address.		*/
+
+	if (bundle->custodyElt == 0 && bundle->timelineElt != 0)
+	{
+		sdr_read(bpSdr, (char *) &event, sdr_rbt_data(bpSdr,
+				bundle->timelineElt), sizeof(BpEvent));
+		if (indexCustody(bundle, event.ref) < 0)
+		{
+			putErrmsg("Can't assign custody ID.", NULL);
+			return -1;
+		}
 	}
 
-	bundle->custodian.cbhe = 1;
-	bundle->custodian.c.nodeNbr = getOwnNodeNbr();
-	bundle->custodian.c.serviceNbr = 0;
 	if (processExtensionBlocks(bundle, PROCESS_ON_TAKE_CUSTODY, NULL) < 0)
 	{
 		putErrmsg("Can't process extensions.", "take custody");
 		return -1;
 	}
 
+	/*	Announce the custody ID in a CTEB, if the bundle
+	 *	didn't already have one to revise.			*/
+
+	if (patchExtensionBlocks(bundle) < 0)
+	{
+		putErrmsg("Can't insert missing extensions.", NULL);
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -8995,13 +10032,13 @@ static void	releaseCustody(Object bundleAddr, Bundle *bundle)
 	Sdr	bpSdr = getIonsdr();
 
 	bundle->custodyTaken = 0;
+	unindexCustody(bundle);
 	if (bundle->ctDueElt)
 	{
 		/*	Bundle was transmitted before "CT due" alarm
 		 *	went off, so disable the alarm.			*/
 
-		sdr_free(bpSdr, sdr_list_data(bpSdr, bundle->ctDueElt));
-		sdr_list_delete(bpSdr, bundle->ctDueElt, NULL, NULL);
+		destroyBpTimelineEvent(bundle->ctDueElt);
 		bundle->ctDueElt = 0;
 	}
 
@@ -9210,8 +10247,14 @@ static void	selectNextBundleForTransmission(Outflow *flows,
 }
 #endif
 
+/*	When batched, getOutboundBundle doesn't wait for a bundle to
+ *	be queued; if no bundle is ready, or the payload of the next
+ *	bundle is longer than spaceLeft (if non-zero), it leaves the
+ *	transaction open and returns with *bundleObj set to zero.	*/
+
 static int 	getOutboundBundle(Outflow *flows, VOutduct *vduct,
 			Outduct *outduct, Object outductObj,
+			int batched, unsigned long spaceLeft,
 			Object *bundleObj, Bundle *bundle,
 			Object *proxNodeEid, Object *destDuctName)
 {
@@ -9230,13 +10273,31 @@ static int 	getOutboundBundle(Outflow *flows, VOutduct *vduct,
 	IonSnub		*snub;
 
 	CHKERR(ionLocked());
+	*bundleObj = 0;			/*	Default: none.		*/
 	sdr_read(bpSdr, (char *) &protocol, outduct->protocol,
 			sizeof(ClProtocol));
 	while (1)	/*	Might do one or more reforwards.	*/
 	{
 		selectNextBundleForTransmission(flows, &selectedFlow, &xmitElt);
+		if (xmitElt && batched && spaceLeft > 0)
+		{
+			xrAddr = sdr_list_data(bpSdr, xmitElt);
+			sdr_read(bpSdr, (char *) &xr, xrAddr, sizeof(XmitRef));
+			sdr_read(bpSdr, (char *) bundle, xr.bundleObj,
+					sizeof(Bundle));
+			if (bundle->payload.length > spaceLeft)
+			{
+				return 0;	/*	Batch is full.	*/
+			}
+		}
+
 		if (xmitElt == 0)		/*	Nothing ready.	*/
 		{
+			if (batched)
+			{
+				return 0;	/*	Batch is done.	*/
+			}
+
 			sdr_exit_xn(bpSdr);
 
 			/*	Wait until forwarder announces an outbound
@@ -9363,59 +10424,75 @@ static int 	getOutboundBundle(Outflow *flows, VOutduct *vduct,
 	}
 }
 
-int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
-		BpExtendedCOS *extendedCOS, char *destDuctName)
-{
-	Sdr		bpSdr = getIonsdr();
-	Object		outductObj;
-	Outduct		outduct;
-			OBJ_POINTER(ClProtocol, protocol);
-	Object		bundleObj;
-	Bundle		bundle;
-	Object		proxNodeEidObj;
-	Object		destDuctNameObj;
-	char		proxNodeEid[SDRSTRING_BUFSZ];
-	DequeueContext	context;
-	char		*dictionary;
-	int		result;
-	int		xmitLength;
-
-	CHKERR(vduct && flows && bundleZco && extendedCOS && destDuctName);
-	*bundleZco = 0;			/*	Default behavior.	*/
-	*destDuctName = '\0';		/*	Default behavior.	*/
-	sdr_begin_xn(bpSdr);
+/*	Sends any requested "forwarded" status report for a bundle
+ *	that is being transmitted and tracks the transmission event.
+ *	The caller must write the bundle afterwards.			*/
 
-	/*	Transmission rate control: wait for capacity.		*/
+static int	noteBundleXmit(Bundle *bundle)
+{
+	char	*dictionary;
+	int	result;
 
-	while (vduct->xmitThrottle.capacity <= 0)
+	if (SRR_FLAGS(bundle->bundleProcFlags) & BP_FORWARDED_RPT)
 	{
-		sdr_exit_xn(bpSdr);
-		if (sm_SemTake(vduct->xmitThrottle.semaphore) < 0)
+		bundle->statusRpt.flags |= BP_FORWARDED_RPT;
+		getCurrentDtnTime(&bundle->statusRpt.forwardTime);
+		if ((dictionary = retrieveDictionary(bundle))
+				== (char *) bundle)
 		{
-			putErrmsg("CLO can't take throttle semaphore.", NULL);
+			putErrmsg("Can't retrieve dictionary.", NULL);
 			return -1;
 		}
 
-		if (sm_SemEnded(vduct->xmitThrottle.semaphore))
+		result = sendStatusRpt(bundle, dictionary);
+		releaseDictionary(dictionary);
+		if (result < 0)
 		{
-			writeMemo("[i] Outduct has been stopped.");
-
-			/*	End task, but without error.		*/
-
+			putErrmsg("Can't send status report.", NULL);
 			return -1;
 		}
+	}
 
-		sdr_begin_xn(bpSdr);
+	noteStateStats(BPSTATS_XMIT, bundle);
+	if ((_bpvdb(NULL))->watching & WATCH_c)
+	{
+		putchar('c');
+		fflush(stdout);
 	}
 
-	outductObj = sdr_list_data(bpSdr, vduct->outductElt);
-	sdr_stage(bpSdr, (char *) &outduct, outductObj, sizeof(Outduct));
-	GET_OBJ_POINTER(bpSdr, ClProtocol, protocol, outduct.protocol);
+	return 0;
+}
+
+/*	Dequeues and catenates the next outbound bundle within the
+ *	current transaction.  On failure the transaction is canceled.
+ *	When hold is non-zero the bundle is retained until released
+ *	by bpEndBatch, which is also where its transmission is noted
+ *	if the CLO did transmit it.					*/
+
+static int	dequeueBundle(VOutduct *vduct, Outflow *flows,
+			Outduct *outduct, Object outductObj,
+			ClProtocol *protocol, int batched,
+			unsigned long spaceLeft, int hold,
+			BpOutboundBundle *outbound)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		bundleObj;
+	Bundle		bundle;
+	Object		proxNodeEidObj;
+	Object		destDuctNameObj;
+	char		proxNodeEid[SDRSTRING_BUFSZ];
+	DequeueContext	context;
+	int		xmitLength;
+
+	outbound->bundleZco = 0;	/*	Default behavior.	*/
+	outbound->bundleObj = 0;	/*	Default behavior.	*/
+	*(outbound->destDuctName) = '\0';	/*	Default behavior.	*/
 
 	/*	Get a transmittable bundle.				*/
 
-	if (getOutboundBundle(flows, vduct, &outduct, outductObj,
-		&bundleObj, &bundle, &proxNodeEidObj, &destDuctNameObj) < 0)
+	if (getOutboundBundle(flows, vduct, outduct, outductObj, batched,
+			spaceLeft, &bundleObj, &bundle, &proxNodeEidObj,
+			&destDuctNameObj) < 0)
 	{
 		writeMemo("[?] CLO can't get next outbound bundle.");
 		sdr_cancel_xn(bpSdr);
@@ -9425,6 +10502,11 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 		return -1;
 	}
 
+	if (bundleObj == 0)		/*	Nothing for batch.	*/
+	{
+		return 0;
+	}
+
 	if (proxNodeEidObj)
 	{
 		sdr_string_read(bpSdr, proxNodeEid, proxNodeEidObj);
@@ -9450,8 +10532,7 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 		/*	Bundle was transmitted before "overdue"
 		 *	alarm went off, so disable the alarm.		*/
 
-		sdr_free(bpSdr, sdr_list_data(bpSdr, bundle.overdueElt));
-		sdr_list_delete(bpSdr, bundle.overdueElt, NULL, NULL);
+		destroyBpTimelineEvent(bundle.overdueElt);
 		bundle.overdueElt = 0;
 	}
 
@@ -9494,7 +10575,7 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 	 *	but is now the fully catenated bundle, ready for
 	 *	transmission.						*/
 
-	*bundleZco = catenateBundle(&bundle);
+	outbound->bundleZco = catenateBundle(&bundle);
 	bundle.catenated = 1;
 
 	/*	Some final extension-block processing may be necessary
@@ -9510,25 +10591,20 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 
 	/*	We assume that the CLO that's getting this outbound
 	 *	bundle is actually going to forward it now, so at
-	 *	this point we send any applicable forwarding notice.	*/
+	 *	this point we send any applicable forwarding notice
+	 *	and track the transmission event.  But a CLO might
+	 *	not get to transmit every bundle of a batch, so for
+	 *	a held bundle this is deferred to bpEndBatch.		*/
 
-	if (SRR_FLAGS(bundle.bundleProcFlags) & BP_FORWARDED_RPT)
+	if (hold)
+	{
+		bundle.xmitsPending += 1;
+		outbound->bundleObj = bundleObj;
+	}
+	else
 	{
-		bundle.statusRpt.flags |= BP_FORWARDED_RPT;
-		getCurrentDtnTime(&bundle.statusRpt.forwardTime);
-		if ((dictionary = retrieveDictionary(&bundle))
-				== (char *) &bundle)
+		if (noteBundleXmit(&bundle) < 0)
 		{
-			putErrmsg("Can't retrieve dictionary.", NULL);
-			sdr_cancel_xn(bpSdr);
-			return -1;
-		}
-
-		result = sendStatusRpt(&bundle, dictionary);
-		releaseDictionary(dictionary);
-	       	if (result < 0)
-		{
-			putErrmsg("Can't send status report.", NULL);
 			sdr_cancel_xn(bpSdr);
 			return -1;
 		}
@@ -9538,19 +10614,11 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 
 	sdr_write(bpSdr, bundleObj, (char *) &bundle, sizeof(Bundle));
 
-	/*	Track this transmission event.				*/
-
-	noteStateStats(BPSTATS_XMIT, &bundle);
-	if ((_bpvdb(NULL))->watching & WATCH_c)
-	{
-		putchar('c');
-		fflush(stdout);
-	}
-
 	/*	Consume estimated transmission capacity.		*/
 
 	xmitLength = computeECCC(bundle.payload.length
 			+ NOMINAL_PRIMARY_BLKSIZE, protocol);
+	outbound->xmitLength = xmitLength;
 	vduct->xmitThrottle.capacity -= xmitLength;
 	if (vduct->xmitThrottle.capacity > 0)
 	{
@@ -9559,14 +10627,15 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 
 	/*	Return the outbound buffer's extended class of service.	*/
 
-	memcpy((char *) extendedCOS, (char *) &bundle.extendedCOS,
+	memcpy((char *) &outbound->extendedCOS, (char *) &bundle.extendedCOS,
 			sizeof(BpExtendedCOS));
 
 	/*	Note destination duct name for this bundle, if any.	*/
 
 	if (destDuctNameObj)
 	{
-		sdr_string_read(bpSdr, destDuctName, destDuctNameObj);
+		sdr_string_read(bpSdr, outbound->destDuctName,
+				destDuctNameObj);
 		sdr_free(bpSdr, destDuctNameObj);
 	}
 
@@ -9576,8 +10645,14 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 	 *	of the bundle has been accepted.  Note that the
 	 *	bundle's *payload* object (the ZCO we are delivering
 	 *	for transmission) is protected from destruction in any
-	 *	case because *bundleZco is an additional reference to
-	 *	that reference-counted ZCO.				*/
+	 *	case because bundleZco is an additional reference to
+	 *	that reference-counted ZCO.  A bundle that is held
+	 *	for a batch is not destroyed until the batch ends.	*/
+
+	if (hold)
+	{
+		return 0;
+	}
 
 	if (bpDestroyBundle(bundleObj, 0) < 0)
 	{
@@ -9586,12 +10661,227 @@ int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
 		return -1;
 	}
 
+	return 0;
+}
+
+int	bpDequeue(VOutduct *vduct, Outflow *flows, Object *bundleZco,
+		BpExtendedCOS *extendedCOS, char *destDuctName)
+{
+	Sdr			bpSdr = getIonsdr();
+	Object			outductObj;
+	Outduct			outduct;
+	ClProtocol		protocol;
+	BpOutboundBundle	outbound;
+
+	CHKERR(vduct && flows && bundleZco && extendedCOS && destDuctName);
+	*bundleZco = 0;			/*	Default behavior.	*/
+	*destDuctName = '\0';		/*	Default behavior.	*/
+	sdr_begin_xn(bpSdr);
+
+	/*	Transmission rate control: wait for capacity.		*/
+
+	switch (awaitThrottle(bpSdr, &(vduct->xmitThrottle)))
+	{
+	case -1:
+		putErrmsg("CLO can't wait for throttle.", NULL);
+		return -1;
+
+	case 1:
+		writeMemo("[i] Outduct has been stopped.");
+
+		/*	End task, but without error.		*/
+
+		return -1;
+
+	default:
+		break;
+	}
+
+	outductObj = sdr_list_data(bpSdr, vduct->outductElt);
+	sdr_stage(bpSdr, (char *) &outduct, outductObj, sizeof(Outduct));
+	sdr_read(bpSdr, (char *) &protocol, outduct.protocol,
+			sizeof(ClProtocol));
+	if (dequeueBundle(vduct, flows, &outduct, outductObj, &protocol, 0, 0,
+			0, &outbound) < 0)
+	{
+		return -1;
+	}
+
 	if (sdr_end_xn(bpSdr))
 	{
 		putErrmsg("Can't get outbound bundle.", NULL);
 		return -1;
 	}
 
+	*bundleZco = outbound.bundleZco;
+	memcpy((char *) extendedCOS, (char *) &outbound.extendedCOS,
+			sizeof(BpExtendedCOS));
+	istrcpy(destDuctName, outbound.destDuctName,
+			MAX_CL_DUCT_NAME_LEN + 1);
+	return 0;
+}
+
+int	bpDequeueBatch(VOutduct *vduct, Outflow *flows, int maxBundles,
+		unsigned int maxBytes, BpOutboundBundle *batch)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		outductObj;
+	Outduct		outduct;
+	ClProtocol	protocol;
+	int		count = 0;
+	unsigned long	bytes = 0;
+	unsigned long	spaceLeft = 0;
+
+	CHKERR(vduct && flows && batch);
+	CHKERR(maxBundles > 0);
+	sdr_begin_xn(bpSdr);
+
+	/*	Transmission rate control: wait for capacity.		*/
+
+	switch (awaitThrottle(bpSdr, &(vduct->xmitThrottle)))
+	{
+	case -1:
+		putErrmsg("CLO can't wait for throttle.", NULL);
+		return -1;
+
+	case 1:
+		writeMemo("[i] Outduct has been stopped.");
+
+		/*	End task, but without error.		*/
+
+		return -1;
+
+	default:
+		break;
+	}
+
+	outductObj = sdr_list_data(bpSdr, vduct->outductElt);
+	sdr_stage(bpSdr, (char *) &outduct, outductObj, sizeof(Outduct));
+	sdr_read(bpSdr, (char *) &protocol, outduct.protocol,
+			sizeof(ClProtocol));
+
+	/*	The first bundle is dequeued exactly as by bpDequeue.
+	 *	Every subsequent bundle is dequeued only if it is
+	 *	ready now and the batch can still accommodate it.	*/
+
+	while (count < maxBundles)
+	{
+		if (count > 0)
+		{
+			refillThrottle(&(vduct->xmitThrottle));
+			if (vduct->xmitThrottle.capacity <= 0)
+			{
+				break;	/*	No capacity for more.	*/
+			}
+
+			if (maxBytes > 0)
+			{
+				if (bytes >= maxBytes)
+				{
+					break;	/*	Batch is full.	*/
+				}
+
+				spaceLeft = maxBytes - bytes;
+			}
+		}
+
+		if (dequeueBundle(vduct, flows, &outduct, outductObj,
+				&protocol, count > 0, spaceLeft, 1,
+				batch + count) < 0)
+		{
+			return -1;
+		}
+
+		if (batch[count].bundleZco == 0)
+		{
+			break;		/*	Nothing more to send.	*/
+		}
+
+		bytes += zco_length(bpSdr, batch[count].bundleZco);
+		count++;
+	}
+
+	if (sdr_end_xn(bpSdr))
+	{
+		putErrmsg("Can't get outbound bundles.", NULL);
+		return -1;
+	}
+
+	return count;
+}
+
+int	bpEndBatch(VOutduct *vduct, BpOutboundBundle *batch, int count,
+		int sentCount)
+{
+	Sdr	bpSdr = getIonsdr();
+	Object	bundleObj;
+	Bundle	bundle;
+	int	i;
+
+	CHKERR(vduct && batch);
+	sdr_begin_xn(bpSdr);
+	for (i = 0; i < count; i++)
+	{
+		bundleObj = batch[i].bundleObj;
+		if (bundleObj == 0)
+		{
+			continue;
+		}
+
+		sdr_stage(bpSdr, (char *) &bundle, bundleObj, sizeof(Bundle));
+		bundle.xmitsPending -= 1;
+		if (i < sentCount)
+		{
+			if (noteBundleXmit(&bundle) < 0)
+			{
+				sdr_cancel_xn(bpSdr);
+				return -1;
+			}
+		}
+
+		sdr_write(bpSdr, bundleObj, (char *) &bundle, sizeof(Bundle));
+		if (i >= sentCount)
+		{
+			/*	Never transmitted, so return the
+			 *	transmission capacity it consumed and
+			 *	re-forward the bundle unless its TTL
+			 *	has expired.				*/
+
+			vduct->xmitThrottle.capacity += batch[i].xmitLength;
+			zco_destroy_reference(bpSdr, batch[i].bundleZco);
+			if (bundle.timelineElt)
+			{
+				if (bpReforwardBundle(bundleObj) < 0)
+				{
+					putErrmsg("Can't re-forward abandoned \
+bundle.", NULL);
+					sdr_cancel_xn(bpSdr);
+					return -1;
+				}
+			}
+		}
+
+		if (bpDestroyBundle(bundleObj, 0) < 0)
+		{
+			putErrmsg("Can't destroy bundle.", NULL);
+			sdr_cancel_xn(bpSdr);
+			return -1;
+		}
+
+		batch[i].bundleObj = 0;
+	}
+
+	if (vduct->xmitThrottle.capacity > 0)
+	{
+		sm_SemGive(vduct->xmitThrottle.semaphore);
+	}
+
+	if (sdr_end_xn(bpSdr) < 0)
+	{
+		putErrmsg("Can't end batch of outbound bundles.", NULL);
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -9969,12 +11259,12 @@ int	bpIdentify(Object bundleZco, Object *bundleObj)
 
 	/*	Now use this bundle ID to find the bundle.		*/
 
-	sdr_begin_xn(bpSdr);		/*	Just to lock memory.	*/
+	sdr_begin_read(bpSdr);
 	result = findBundle(sourceEid, &image.id.creationTime,
 			image.id.fragmentOffset,
 			image.totalAduLength == 0 ? 0 : image.payload.length,
 			bundleObj, &timelineElt);
-	sdr_exit_xn(bpSdr);
+	sdr_end_read(bpSdr);
 	MRELEASE(sourceEid);
 	if (result < 0)
 	{
@@ -10094,15 +11384,13 @@ int	bpReforwardBundle(Object bundleAddr)
 
 	if (bundle.overdueElt)
 	{
-		sdr_free(bpSdr, sdr_list_data(bpSdr, bundle.overdueElt));
-		sdr_list_delete(bpSdr, bundle.overdueElt, NULL, NULL);
+		destroyBpTimelineEvent(bundle.overdueElt);
 		bundle.overdueElt = 0;
 	}
 
 	if (bundle.ctDueElt)
 	{
-		sdr_free(bpSdr, sdr_list_data(bpSdr, bundle.ctDueElt));
-		sdr_list_delete(bpSdr, bundle.ctDueElt, NULL, NULL);
+		destroyBpTimelineEvent(bundle.ctDueElt);
 		bundle.ctDueElt = 0;
 	}
 
@@ -10258,11 +11546,145 @@ static void	forgetSnub(Bundle *bundle, Object bundleAddr, char *neighborEid)
 	removeSnub(node, metaEid.nodeNbr);
 }
 
+static int	applyCtSignal(Object bundleAddr, BpCtSignal *cts,
+			char *signalSourceEid)
+{
+	Sdr		bpSdr = getIonsdr();
+	BpVdb		*bpvdb = _bpvdb(NULL);
+	Bundle		bundleBuf;
+	Bundle		*bundle = &bundleBuf;
+	char		*dictionary;
+	char		*eidString;
+	int		result;
+
+	/*	If custody was accepted, or if custody was refused
+	 *	due to redundant reception (meaning the receiver had
+	 *	previously accepted custody and we just never got
+	 *	the signal) we destroy the copy of the bundle retained
+	 *	here.  Otherwise we immediately re-dispatch the bundle,
+	 *	hoping that a change in the condition of the network
+	 *	(reduced congestion, revised routing) has occurred
+	 *	since the previous transmission so that re-transmission
+	 *	will succeed.						*/
+
+	sdr_stage(bpSdr, (char *) bundle, bundleAddr, sizeof(Bundle));
+	if (cts->succeeded || cts->reasonCode == CtRedundantReception)
+	{
+		if (bpvdb->watching & WATCH_m)
+		{
+			putchar('m');
+			fflush(stdout);
+		}
+
+		forgetSnub(bundle, bundleAddr, signalSourceEid);
+		releaseCustody(bundleAddr, bundle);
+		if (bpDestroyBundle(bundleAddr, 0) < 0)
+		{
+			putErrmsg("Can't destroy bundle.", NULL);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	/*	Custody refused; try again.				*/
+
+	noteSnub(bundle, bundleAddr, signalSourceEid);
+	if ((dictionary = retrieveDictionary(bundle)) == (char *) bundle)
+	{
+		putErrmsg("Can't retrieve dictionary.", NULL);
+		return -1;
+	}
+
+	if (printEid(&bundle->destination, dictionary, &eidString) < 0)
+	{
+		putErrmsg("Can't print dest EID.", NULL);
+		releaseDictionary(dictionary);
+		return -1;
+	}
+
+	result = forwardBundle(bundleAddr, bundle, eidString);
+	MRELEASE(eidString);
+	releaseDictionary(dictionary);
+	if (result < 0)
+	{
+		putErrmsg("Can't re-queue bundle for forwarding.", NULL);
+		return -1;
+	}
+
+	noteStateStats(BPSTATS_REFUSE, bundle);
+	if (bpvdb->watching & WATCH_refusal)
+	{
+		putchar('&');
+		fflush(stdout);
+	}
+
+	return 0;
+}
+
+static int	applyAcs(BpCtSignal *cts, char *signalSourceEid)
+{
+	Sdr		bpSdr = getIonsdr();
+	Object		custodyIds = (_bpConstants())->custodyIds;
+	int		i;
+	AcsFill		*fill;
+	unsigned long	fillEnd;
+	Object		node;
+	Object		nextNode;
+	CustodyRef	ref;
+
+	/*	All custody dispositions reported in the signal are
+	 *	applied in a single transaction.			*/
+
+	sdr_begin_xn(bpSdr);
+	for (i = 0, fill = cts->fills; i < cts->fillsCount; i++, fill++)
+	{
+		fillEnd = fill->start + fill->length;
+		node = sdr_rbt_search(bpSdr, custodyIds, orderCustodyRefs,
+				&fill->start, &nextNode);
+		if (node == 0)
+		{
+			node = nextNode;
+		}
+
+		while (node)
+		{
+			sdr_read(bpSdr, (char *) &ref, sdr_rbt_data(bpSdr,
+					node), sizeof(CustodyRef));
+			if (ref.custodyId >= fillEnd)
+			{
+				break;
+			}
+
+			/*	Releasing custody removes the bundle's
+			 *	node from the tree, so get the next
+			 *	node first.				*/
+
+			nextNode = sdr_rbt_next(bpSdr, node);
+			if (applyCtSignal(ref.bundleObj, cts, signalSourceEid)
+					< 0)
+			{
+				sdr_cancel_xn(bpSdr);
+				return -1;
+			}
+
+			node = nextNode;
+		}
+	}
+
+	if (sdr_end_xn(bpSdr) < 0)
+	{
+		putErrmsg("Can't apply aggregate custody signal.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
 int	_handleAdminBundles(char *adminEid, StatusRptCB handleStatusRpt,
 		CtSignalCB handleCtSignal)
 {
 	Sdr		bpSdr = getIonsdr();
-	BpVdb		*bpvdb = _bpvdb(NULL);
 	int		running = 1;
 	BpSAP		sap;
 	BpDelivery	dlv;
@@ -10271,11 +11693,6 @@ int	_handleAdminBundles(char *adminEid, StatusRptCB handleStatusRpt,
 	BpCtSignal	cts;
 	Object		timelineElt;
 	Object		bundleAddr;
-	Bundle		bundleBuf;
-	Bundle		*bundle = &bundleBuf;
-	char		*dictionary;
-	char		*eidString;
-	int		result;
 
 	CHKERR(adminEid);
 	if (handleStatusRpt == NULL)
@@ -10387,89 +11804,13 @@ int	_handleAdminBundles(char *adminEid, StatusRptCB handleStatusRpt,
 				break;		/*	Out of switch.	*/
 			}
 
-			/*	If custody was accepted, or if custody
-			 *	was refused due to redundant reception
-			 *	(meaning the receiver had previously
-			 *	accepted custody and we just never got
-			 *	the signal) we destroy the copy of the
-			 *	bundle retained here.  Otherwise we
-			 *	immediately re-dispatch the bundle,
-			 *	hoping that a change in the condition
-			 *	of the network (reduced congestion,
-			 *	revised routing) has occurred since
-			 *	the previous transmission so that
-			 *	re-transmission will succeed.		*/
-
-			sdr_stage(bpSdr, (char *) bundle, bundleAddr,
-					sizeof(Bundle));
-			if (cts.succeeded
-			|| cts.reasonCode == CtRedundantReception)
+			if (applyCtSignal(bundleAddr, &cts,
+					dlv.bundleSourceEid) < 0)
 			{
-				if (bpvdb->watching & WATCH_m)
-				{
-					putchar('m');
-					fflush(stdout);
-				}
-
-				forgetSnub(bundle, bundleAddr,
-						dlv.bundleSourceEid);
-				releaseCustody(bundleAddr, bundle);
-				if (bpDestroyBundle(bundleAddr, 0) < 0)
-				{
-					putErrmsg("Can't destroy bundle.",
-							NULL);
-					sdr_cancel_xn(bpSdr);
-					running = 0;
-					bpEraseCtSignal(&cts);
-					break;	/*	Out of switch.	*/
-				}
-			}
-			else	/*	Custody refused; try again.	*/
-			{
-				noteSnub(bundle, bundleAddr,
-						dlv.bundleSourceEid);
-				if ((dictionary = retrieveDictionary(bundle))
-						== (char *) bundle)
-				{
-					putErrmsg("Can't retrieve dictionary.",
-							NULL);
-					sdr_cancel_xn(bpSdr);
-					running = 0;
-					bpEraseCtSignal(&cts);
-					break;	/*	Out of switch.	*/
-				}
-
-				if (printEid(&bundle->destination, dictionary,
-						&eidString) < 0)
-				{
-					putErrmsg("Can't print dest EID.",
-							NULL);
-					sdr_cancel_xn(bpSdr);
-					running = 0;
-					bpEraseCtSignal(&cts);
-					break;	/*	Out of switch.	*/
-				}
-
-				result = forwardBundle(bundleAddr, bundle,
-						eidString);
-				MRELEASE(eidString);
-				releaseDictionary(dictionary);
-				if (result < 0)
-				{
-					putErrmsg("Can't re-queue bundle for \
-forwarding.", NULL);
-					sdr_cancel_xn(bpSdr);
-					running = 0;
-					bpEraseCtSignal(&cts);
-					break;	/*	Out of switch.	*/
-				}
-
-				noteStateStats(BPSTATS_REFUSE, &bundleBuf);
-				if (bpvdb->watching & WATCH_refusal)
-				{
-					putchar('&');
-					fflush(stdout);
-				}
+				sdr_cancel_xn(bpSdr);
+				running = 0;
+				bpEraseCtSignal(&cts);
+				break;		/*	Out of switch.	*/
 			}
 
 			bpEraseCtSignal(&cts);
@@ -10482,6 +11823,26 @@ forwarding.", NULL);
 
 			break;			/*	Out of switch.	*/
 
+		case 4:		/*	Aggregate custody signal.	*/
+			if (handleCtSignal(&dlv, &cts) < 0)
+			{
+				putErrmsg("Custody signal handler failed",
+						NULL);
+				running = 0;
+				bpEraseCtSignal(&cts);
+				break;		/*	Out of switch.	*/
+			}
+
+			if (applyAcs(&cts, dlv.bundleSourceEid) < 0)
+			{
+				putErrmsg("Can't handle aggregate custody \
+signal.", NULL);
+				running = 0;
+			}
+
+			bpEraseCtSignal(&cts);
+			break;			/*	Out of switch.	*/
+
 		default:	/*	Unknown admin payload type.	*/
 			break;			/*	Out of switch.	*/
 		}
@@ -2,7 +2,8 @@
  *	bpextensions.c:	Bundle Protocol extension definition
  *			module, implementing Bundle Authentication
  *			Block support in addition to the Extended
- *			Class of Service (ECOS) block.
+ *			Class of Service (ECOS) block and the Custody
+ *			Transfer Enhancement Block (CTEB).
  *
  *	Copyright (c) 2008, California Institute of Technology.
  *	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
@@ -14,6 +15,7 @@
 /*	Add external function declarations between here...		*/
 
 #include "ecos.h"
+#include "cteb.h"
 #include "ionbsp.h"
 
 /*	... and here.							*/
@@ -48,6 +50,20 @@ static ExtensionDef	extensions[] =
 					ecos_processOnDequeue,
 					0}
 			       	},
+				{ "cteb", EXTENSION_TYPE_CTEB, 0,
+					cteb_offer,
+					cteb_release,
+					cteb_acquire,
+					cteb_check,
+					cteb_record,
+					cteb_clear,
+					cteb_copy,
+					{0,
+					cteb_processOnTakeCustody,
+					0,
+					0,
+					0}
+				},
 				{ "bsp_bab_post", BSP_BAB_TYPE, 1,
 					bsp_babOffer,
 					bsp_babRelease,
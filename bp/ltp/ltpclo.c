@@ -50,9 +50,10 @@ int	main(int argc, char *argv[])
 	Outflow		outflows[3];
 	int		i;
 	int		running = 1;
+	BpOutboundBundle	batch[BP_DEQUEUE_BATCH_SIZE];
+	int		batchLength;
+	int		j;
 	Object		bundleZco;
-	BpExtendedCOS	extendedCOS;
-	char		destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
 	unsigned int	redPartLength;
 	LtpSessionId	sessionId;
 
@@ -85,8 +86,10 @@ int	main(int argc, char *argv[])
 
 	/*	All command-line arguments are now validated.		*/
 
+	sdr_begin_read(sdr);
 	sdr_read(sdr, (char *) &outduct, sdr_list_data(sdr, vduct->outductElt),
 			sizeof(Outduct));
+	sdr_end_read(sdr);
 	destEngineNbr = atol(ductName);
 	memset((char *) outflows, 0, sizeof outflows);
 	outflows[0].outboundBundles = outduct.bulkQueue;
@@ -113,37 +116,46 @@ int	main(int argc, char *argv[])
 	writeMemo("[i] ltpclo is running.");
 	while (running && !(sm_SemEnded(ltpcloSemaphore(NULL))))
 	{
-		if (bpDequeue(vduct, outflows, &bundleZco, &extendedCOS,
-				destDuctName) < 0)
+		batchLength = bpDequeueBatch(vduct, outflows,
+				BP_DEQUEUE_BATCH_SIZE, BP_DEQUEUE_BATCH_BYTES,
+				batch);
+		if (batchLength < 0)
 		{
 			running = 0;	/*	Terminate CLO.		*/
 			continue;
 		}
 
-		if (bundleZco == 0)	/*	Interrupted.		*/
+		for (j = 0; j < batchLength && running; j++)
 		{
-			continue;
+			bundleZco = batch[j].bundleZco;
+			if (batch[j].extendedCOS.flags & BP_BEST_EFFORT)
+			{
+				redPartLength = 0;
+			}
+			else
+			{
+				redPartLength = LTP_ALL_RED;
+			}
+
+			switch (ltp_send(destEngineNbr, BpLtpClientId,
+					bundleZco, redPartLength, &sessionId))
+			{
+			case 0:
+				putErrmsg("Unable to send this bundle via LTP.",
+						NULL);
+				break;
+
+			case -1:
+				putErrmsg("LtpSend failed.", NULL);
+				running = 0;	/*	Terminate CLO.	*/
+			}
 		}
 
-		if (extendedCOS.flags & BP_BEST_EFFORT)
-		{
-			redPartLength = 0;
-		}
-		else
-		{
-			redPartLength = LTP_ALL_RED;
-		}
+		/*	Release the batch, re-forwarding any bundles
+		 *	that were left untransmitted.			*/
 
-		switch (ltp_send(destEngineNbr, BpLtpClientId, bundleZco,
-				redPartLength, &sessionId))
+		if (bpEndBatch(vduct, batch, batchLength, j) < 0)
 		{
-		case 0:
-			putErrmsg("Unable to send this bundle via LTP.",
-					NULL);
-			break;
-
-		case -1:
-			putErrmsg("LtpSend failed.", NULL);
 			running = 0;	/*	Terminate CLO.		*/
 		}
 
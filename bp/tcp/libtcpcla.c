@@ -10,6 +10,9 @@
 	
 									*/
 #include "tcpcla.h"
+#ifdef TCPCLA_SENDFILE
+#include <sys/sendfile.h>
+#endif
 
 int	tcpDelayEnabled = 0;
 int	tcpDelayNsecPerByte = 0;
@@ -78,6 +81,87 @@ int	sendBytesByTCP(int *bundleSocket, char *from, int length)
 	}
 }
 
+static int	sendBufferByTCP(int *bundleSocket, char *from, int length)
+{
+	int	bytesToSend = length;
+	int	bytesSent;
+
+	while (bytesToSend > 0)
+	{
+		bytesSent = sendBytesByTCP(bundleSocket, from, bytesToSend);
+		if (bytesSent < 0)
+		{
+			return -1;
+		}
+
+		from += bytesSent;
+		bytesToSend -= bytesSent;
+	}
+
+	return length;
+}
+
+#ifdef TCPCLA_SENDFILE
+static int	sendFileByTCP(int *bundleSocket, int fd, unsigned int offset,
+			unsigned int length)
+{
+	off_t	fileOffset = offset;
+	int	bytesToSend = length;
+	int	bytesSent;
+	char	fill[256];
+
+	while (bytesToSend > 0)
+	{
+		bytesSent = sendfile(*bundleSocket, fd, &fileOffset,
+				bytesToSend);
+		if (bytesSent < 0)
+		{
+			switch (errno)
+			{
+			case EINTR:	/*	Interrupted; retry.	*/
+				continue;
+
+			case EPIPE:	/*	Lost connection.	*/
+			case EBADF:
+			case ETIMEDOUT:
+			case ECONNRESET:
+				close(*bundleSocket);
+				*bundleSocket = -1;
+			}
+
+			putSysErrmsg("CLO sendfile() error on socket", NULL);
+			return -1;
+		}
+
+		if (bytesSent == 0)
+		{
+			/*	File has been truncated; as in
+			 *	zco_transmit, send fill in place of
+			 *	the missing content.			*/
+
+			memset(fill, ZCO_FILE_FILL_CHAR, sizeof fill);
+			while (bytesToSend > 0)
+			{
+				bytesSent = MIN(bytesToSend, (int) sizeof fill);
+				if (sendBufferByTCP(bundleSocket, fill,
+						bytesSent) < 0)
+				{
+					return -1;
+				}
+
+				bytesToSend -= bytesSent;
+			}
+
+			break;
+		}
+
+		bytesToSend -= bytesSent;
+	}
+
+	return length;
+}
+#endif
+
 static int	sendZcoByTCP(int *bundleSocket, unsigned int bundleLength,
 			Object bundleZco, unsigned char *buffer,
 			unsigned int tcpclSegmentHeaderLength)
@@ -89,76 +173,137 @@ static int	sendZcoByTCP(int *bundleSocket, unsigned int bundleLength,
 	ZcoReader	reader;
 	int		bytesToLoad;
 	int		bytesLoaded;
-	int		bytesToSend;
-	char		*from;
 	int		bytesSent;
+	int		fileSpan;
+	int		fd;
+	unsigned int	fileOffset;
+
+	/*	Bytes residing in the SDR heap (the segment header,
+	 *	BP header and trailer capsules, and any SDR-sourced
+	 *	payload extents) are accumulated in the buffer and
+	 *	written from there.  Where sendfile() is available,
+	 *	file-sourced payload extents are instead streamed
+	 *	directly from the file, without copying, and the SDR
+	 *	transaction is held only while locating them.		*/
 
 	zco_start_transmitting(sdr, bundleZco, &reader);
-	while (bytesRemaining > 0)
+	while (bytesRemaining > 0 || bytesBuffered > 0)
 	{
+		fileSpan = 0;
+		bytesLoaded = 0;
 		bytesToLoad = TCPCLA_BUFSZ - bytesBuffered;
 		if (bytesToLoad > bytesRemaining)
 		{
 			bytesToLoad = bytesRemaining;
 		}
 
-		sdr_begin_xn(sdr);
-		bytesLoaded = zco_transmit(sdr, &reader, bytesToLoad,
-				(char *) buffer + bytesBuffered);
-		if (sdr_end_xn(sdr) < 0)
+		if (bytesToLoad > 0)
 		{
-			putErrmsg("Can't issue from ZCO.", NULL);
-			return -1;
-		}
+			sdr_begin_xn(sdr);
+#ifdef TCPCLA_SENDFILE
+			bytesLoaded = zco_transmit_sdr(sdr, &reader,
+				bytesToLoad, (char *) buffer + bytesBuffered);
+			if (bytesLoaded == 0)
+			{
+				bytesLoaded = zco_transmit_file(sdr, &reader,
+					bytesRemaining, &fd, &fileOffset);
+				if (bytesLoaded > 0)
+				{
+					fileSpan = 1;
+				}
+				else if (bytesLoaded == 0)
+				{
+					/*	Unreadable file: fill.	*/
 
-		if (bytesLoaded != bytesToLoad)		/*	Done.	*/
-		{
-			putErrmsg("ZCO length error.", NULL);
-			return -1;
-		}
+					bytesLoaded = zco_transmit(sdr,
+						&reader, bytesToLoad,
+						(char *) buffer
+						+ bytesBuffered);
+				}
+			}
+#else
+			bytesLoaded = zco_transmit(sdr, &reader, bytesToLoad,
+					(char *) buffer + bytesBuffered);
+#endif
+			if (sdr_end_xn(sdr) < 0)
+			{
+				zco_stop_transmitting(sdr, &reader);
+				putErrmsg("Can't issue from ZCO.", NULL);
+				return -1;
+			}
 
-		bytesToSend = bytesBuffered + bytesLoaded;
-		bytesRemaining -= bytesToSend;
-		from = (char *) buffer;
-		while (bytesToSend > 0)
-		{
-			bytesSent = sendBytesByTCP(bundleSocket, from,
-					bytesToSend);
-			if (bytesSent < 0)
+			if (bytesLoaded <= 0)
 			{
-				if (bpHandleXmitFailure(bundleZco))
+				zco_stop_transmitting(sdr, &reader);
+				putErrmsg("ZCO length error.", NULL);
+				return -1;
+			}
+
+			bytesRemaining -= bytesLoaded;
+			if (!fileSpan)
+			{
+				bytesBuffered += bytesLoaded;
+				if (bytesBuffered < TCPCLA_BUFSZ
+				&& bytesRemaining > 0)
 				{
-					putErrmsg("Can't handle xmit failure.",
-							NULL);
-					return -1;
+					continue;	/*	Fill buffer.	*/
 				}
+			}
+		}
 
-				if (*bundleSocket == -1)
-				{
-					/*	Just lost connection;
-					 *	treat as a transient
-					 *	anomaly, note the
-					 *	incomplete transmission.*/
+		/*	Write buffered bytes, then any file span.	*/
 
-					writeMemo("[i] Lost TCP connection to \
-CLI; restart CLO when connectivity is restored.");
-					totalBytesSent = 0;
-					bytesRemaining = 0;
-					break;	/*	Out of loop.	*/
-				}
+		bytesSent = 0;
+		if (bytesBuffered > 0)
+		{
+			bytesSent = sendBufferByTCP(bundleSocket,
+					(char *) buffer, bytesBuffered);
+			if (bytesSent > 0)
+			{
+				totalBytesSent += bytesSent;
+			}
 
-				/*	Big problem; shut down.		*/
+			bytesBuffered = 0;
+		}
 
-				putErrmsg("Failed to send by TCP.", NULL);
+#ifdef TCPCLA_SENDFILE
+		if (fileSpan && bytesSent >= 0)
+		{
+			bytesSent = sendFileByTCP(bundleSocket, fd, fileOffset,
+					bytesLoaded);
+			if (bytesSent > 0)
+			{
+				totalBytesSent += bytesSent;
+			}
+		}
+#endif
+		if (bytesSent < 0)
+		{
+			if (bpHandleXmitFailure(bundleZco))
+			{
+				zco_stop_transmitting(sdr, &reader);
+				putErrmsg("Can't handle xmit failure.", NULL);
 				return -1;
 			}
 
-			totalBytesSent += bytesSent;
-			from += bytesSent;
-			bytesToSend -= bytesSent;
-		}
+			if (*bundleSocket == -1)
+			{
+				/*	Just lost connection; treat as
+				 *	a transient anomaly, note the
+				 *	incomplete transmission.	*/
 
-		bytesBuffered = 0;
+				writeMemo("[i] Lost TCP connection to \
+CLI; restart CLO when connectivity is restored.");
+				totalBytesSent = 0;
+				break;		/*	Out of loop.	*/
+			}
+
+			/*	Big problem; shut down.			*/
+
+			zco_stop_transmitting(sdr, &reader);
+			putErrmsg("Failed to send by TCP.", NULL);
+			return -1;
+		}
 	}
 
 	zco_stop_transmitting(sdr, &reader);
@@ -113,9 +113,10 @@ int	main(int argc, char *argv[])
 	pthread_mutex_t		mutex;
 	KeepaliveThreadParms	parms;
 	pthread_t		keepaliveThread;
+	BpOutboundBundle	batch[BP_DEQUEUE_BATCH_SIZE];
+	int			batchLength;
+	int			j;
 	Object			bundleZco;
-	BpExtendedCOS		extendedCOS;
-	char			destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
 	unsigned int		bundleLength;
 	int			ductSocket = -1;
 	int			bytesSent;
@@ -158,9 +159,11 @@ int	main(int argc, char *argv[])
 	/*	All command-line arguments are now validated.		*/
 
 	sdr = getIonsdr();
+	sdr_begin_read(sdr);
 	sdr_read(sdr, (char *) &duct, sdr_list_data(sdr, vduct->outductElt),
 			sizeof(Outduct));
 	sdr_read(sdr, (char *) &protocol, duct.protocol, sizeof(ClProtocol));
+	sdr_end_read(sdr);
 	if (protocol.nominalRate <= 0)
 	{
 		vduct->xmitThrottle.nominalRate = DEFAULT_TCP_RATE;
@@ -227,26 +230,37 @@ int	main(int argc, char *argv[])
 	writeMemo("[i] stcpclo is running.");
 	while (!(sm_SemEnded(stcpcloSemaphore(NULL))))
 	{
-		if (bpDequeue(vduct, outflows, &bundleZco, &extendedCOS,
-				destDuctName) < 0)
+		batchLength = bpDequeueBatch(vduct, outflows,
+				BP_DEQUEUE_BATCH_SIZE, BP_DEQUEUE_BATCH_BYTES,
+				batch);
+		if (batchLength < 0)
 		{
 			sm_SemEnd(stcpcloSemaphore(NULL));/*	Stop.	*/
 			continue;
 		}
 
-		if (bundleZco == 0)	/*	Interrupted.		*/
+		for (j = 0; j < batchLength; j++)
 		{
-			continue;
+			bundleZco = batch[j].bundleZco;
+			bundleLength = zco_length(sdr, bundleZco);
+			pthread_mutex_lock(&mutex);
+			bytesSent = sendBundleByTCP(&socketName, &ductSocket,
+					bundleLength, bundleZco, buffer);
+			pthread_mutex_unlock(&mutex);
+			if (bytesSent < 0 || bytesSent < bundleLength)
+			{
+				sm_SemEnd(stcpcloSemaphore(NULL));
+				j++;	/*	Stop.			*/
+				break;
+			}
 		}
 
-		bundleLength = zco_length(sdr, bundleZco);
-		pthread_mutex_lock(&mutex);
-		bytesSent = sendBundleByTCP(&socketName, &ductSocket,
-				bundleLength, bundleZco, buffer);
-		pthread_mutex_unlock(&mutex);
-		if (bytesSent < bundleLength)
+		/*	Release the batch, re-forwarding any bundles
+		 *	that were left untransmitted.			*/
+
+		oK(bpEndBatch(vduct, batch, batchLength, j));
+		if (sm_SemEnded(stcpcloSemaphore(NULL)))
 		{
-			sm_SemEnd(stcpcloSemaphore(NULL));/*	Stop.	*/
 			continue;
 		}
 
@@ -31,6 +31,12 @@ extern "C" {
 #define TCPCLA_BUFSZ		(1024 * 1024)
 #endif
 #define TCPCLA_BUFSZ		(64 * 1024)
+
+/*	On Linux, file-sourced bundle payload is sent by sendfile().	*/
+
+#if defined (linux) && !defined (TCPCLA_NO_SENDFILE)
+#define TCPCLA_SENDFILE
+#endif
 #define BpTcpDefaultPortNbr	4556
 #define	DEFAULT_TCP_RATE	11250000
 #define TCPCLA_MAGIC 		"dtn!"
@@ -236,9 +236,10 @@ int	main(int argc, char *argv[])
 	ReceiveThreadParms	rparms;
 	pthread_t		keepaliveThread;
 	pthread_t		receiverThread;
+	BpOutboundBundle	batch[BP_DEQUEUE_BATCH_SIZE];
+	int			batchLength;
+	int			j;
 	Object			bundleZco;
-	BpExtendedCOS		extendedCOS;
-	char			destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
 	unsigned int		bundleLength;
 	int			ductSocket = -1;
 	int			bytesSent;
@@ -283,9 +284,11 @@ int	main(int argc, char *argv[])
 	/*	All command-line arguments are now validated.		*/
 
 	sdr = getIonsdr();
+	sdr_begin_read(sdr);
 	sdr_read(sdr, (char *) &duct, sdr_list_data(sdr, vduct->outductElt),
 			sizeof(Outduct));
 	sdr_read(sdr, (char *) &protocol, duct.protocol, sizeof(ClProtocol));
+	sdr_end_read(sdr);
 	if (protocol.nominalRate <= 0)
 	{
 		vduct->xmitThrottle.nominalRate = DEFAULT_TCP_RATE;
@@ -384,24 +387,34 @@ int	main(int argc, char *argv[])
 	writeMemo("[i] tcpclo is running.");
 	while (running && !(sm_SemEnded(tcpcloSemaphore)))
 	{
-		if (bpDequeue(vduct, outflows, &bundleZco, &extendedCOS,
-				destDuctName) < 0)
+		batchLength = bpDequeueBatch(vduct, outflows,
+				BP_DEQUEUE_BATCH_SIZE, BP_DEQUEUE_BATCH_BYTES,
+				batch);
+		if (batchLength < 0)
 		{
 			running = 0;	/*	Terminate CLO.		*/
 			continue;
 		}
 
-		if (bundleZco == 0)	/*	Interrupted.		*/
+		for (j = 0; j < batchLength && running; j++)
 		{
-			continue;
+			bundleZco = batch[j].bundleZco;
+			bundleLength = zco_length(sdr, bundleZco);
+			pthread_mutex_lock(&mutex);
+			bytesSent = sendBundleByTCPCL(&socketName, &ductSocket,
+				bundleLength, bundleZco, buffer,
+				&keepalivePeriod);
+			pthread_mutex_unlock(&mutex);
+			if(bytesSent < 0)
+			{
+				running = 0;	/*	Terminate CLO.	*/
+			}
 		}
 
-		bundleLength = zco_length(sdr, bundleZco);
-		pthread_mutex_lock(&mutex);
-		bytesSent = sendBundleByTCPCL(&socketName, &ductSocket,
-				bundleLength, bundleZco, buffer,&keepalivePeriod);
-		pthread_mutex_unlock(&mutex);
-		if(bytesSent < 0)
+		/*	Release the batch, re-forwarding any bundles
+		 *	that were left untransmitted.			*/
+
+		if (bpEndBatch(vduct, batch, batchLength, j) < 0)
 		{
 			running = 0;	/*	Terminate CLO.		*/
 		}
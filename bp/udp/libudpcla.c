@@ -95,6 +95,7 @@ int	sendBundleByUDP(struct sockaddr *socketName, int *bundleSocket,
 	zco_start_transmitting(sdr, bundleZco, &reader);
 	sdr_begin_xn(sdr);
 	bytesToSend = zco_transmit(sdr, &reader, UDPCLA_BUFSZ, (char *) buffer);
+	zco_stop_transmitting(sdr, &reader);
 	if (sdr_end_xn(sdr) < 0 || bytesToSend < 0)
 	{
 		putErrmsg("Can't issue from ZCO.", NULL);
@@ -130,7 +131,6 @@ when connectivity is restored.");
 		}
 	}
 
-	zco_stop_transmitting(sdr, &reader);
 	sdr_begin_xn(sdr);
 	zco_destroy_reference(sdr, bundleZco);
 	if (sdr_end_xn(sdr) < 0)
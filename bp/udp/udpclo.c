@@ -55,9 +55,11 @@ int	main(int argc, char *argv[])
 	unsigned int		hostNbr;
 	struct sockaddr		socketName;
 	struct sockaddr_in	*inetName;
+	BpOutboundBundle	batch[BP_DEQUEUE_BATCH_SIZE];
+	int			batchLength;
+	int			j;
 	Object			bundleZco;
-	BpExtendedCOS		extendedCOS;
-	char			destDuctName[MAX_CL_DUCT_NAME_LEN + 1];
+	char			*destDuctName;
 	unsigned int		bundleLength;
 	int			ductSocket = -1;
 	int			bytesSent;
@@ -94,9 +96,11 @@ int	main(int argc, char *argv[])
 	/*	All command-line arguments are now validated.		*/
 
 	sdr = getIonsdr();
+	sdr_begin_read(sdr);
 	sdr_read(sdr, (char *) &outduct, sdr_list_data(sdr, vduct->outductElt),
 			sizeof(Outduct));
 	sdr_read(sdr, (char *) &protocol, outduct.protocol, sizeof(ClProtocol));
+	sdr_end_read(sdr);
 	if (protocol.nominalRate <= 0)
 	{
 		vduct->xmitThrottle.nominalRate = DEFAULT_UDP_RATE;
@@ -125,45 +129,57 @@ int	main(int argc, char *argv[])
 	writeMemo("[i] udpclo is running.");
 	while (!(sm_SemEnded(vduct->semaphore)))
 	{
-		if (bpDequeue(vduct, outflows, &bundleZco, &extendedCOS,
-				destDuctName) < 0)
+		batchLength = bpDequeueBatch(vduct, outflows,
+				BP_DEQUEUE_BATCH_SIZE, BP_DEQUEUE_BATCH_BYTES,
+				batch);
+		if (batchLength < 0)
 		{
 			sm_SemEnd(udpcloSemaphore(NULL));/*	Stop.	*/
 			continue;
 		}
 
-		if (bundleZco == 0)	/*	Interrupted.		*/
+		for (j = 0; j < batchLength; j++)
 		{
-			continue;
+			bundleZco = batch[j].bundleZco;
+			destDuctName = batch[j].destDuctName;
+			hostName = destDuctName;
+			parseSocketSpec(destDuctName, &portNbr, &hostNbr);
+			if (portNbr == 0)
+			{
+				portNbr = BpUdpDefaultPortNbr;
+			}
+
+			portNbr = htons(portNbr);
+			if (hostNbr == 0)
+			{
+				writeMemoNote("[?] Can't get IP address for \
+host", hostName);
+			}
+
+			hostNbr = htonl(hostNbr);
+			memset((char *) &socketName, 0, sizeof socketName);
+			inetName = (struct sockaddr_in *) &socketName;
+			inetName->sin_family = AF_INET;
+			inetName->sin_port = portNbr;
+			memcpy((char *) &(inetName->sin_addr.s_addr),
+					(char *) &hostNbr, 4);
+			bundleLength = zco_length(sdr, bundleZco);
+			bytesSent = sendBundleByUDP(&socketName, &ductSocket,
+					bundleLength, bundleZco, buffer);
+			if (bytesSent < 0 || bytesSent < bundleLength)
+			{
+				sm_SemEnd(udpcloSemaphore(NULL));
+				j++;	/*	Stop.			*/
+				break;
+			}
 		}
 
-		hostName = destDuctName;
-		parseSocketSpec(destDuctName, &portNbr, &hostNbr);
-		if (portNbr == 0)
-		{
-			portNbr = BpUdpDefaultPortNbr;
-		}
+		/*	Release the batch, re-forwarding any bundles
+		 *	that were left untransmitted.			*/
 
-		portNbr = htons(portNbr);
-		if (hostNbr == 0)
+		oK(bpEndBatch(vduct, batch, batchLength, j));
+		if (sm_SemEnded(udpcloSemaphore(NULL)))
 		{
-			writeMemoNote("[?] Can't get IP address for host",
-					hostName);
-		}
-
-		hostNbr = htonl(hostNbr);
-		memset((char *) &socketName, 0, sizeof socketName);
-		inetName = (struct sockaddr_in *) &socketName;
-		inetName->sin_family = AF_INET;
-		inetName->sin_port = portNbr;
-		memcpy((char *) &(inetName->sin_addr.s_addr),
-				(char *) &hostNbr, 4);
-		bundleLength = zco_length(sdr, bundleZco);
-		bytesSent = sendBundleByUDP(&socketName, &ductSocket,
-				bundleLength, bundleZco, buffer);
-		if (bytesSent < bundleLength)
-		{
-			sm_SemEnd(udpcloSemaphore(NULL));/*	Stop.	*/
 			continue;
 		}
 
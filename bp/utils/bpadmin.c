@@ -68,7 +68,8 @@ static void	printUsage()
 	PUTS("\t   a scheme <scheme name> '<forwarder cmd>' '<admin app cmd>'");
 	PUTS("\t   a endpoint <endpoint name> {q|x} ['<recv script>']");
 	PUTS("\t   a protocol <protocol name> <payload bytes per frame> \
-<overhead bytes per frame> [<nominal data rate, in bytes/sec>]");
+<overhead bytes per frame> [<nominal data rate, in bytes/sec> \
+[<burst size, in bytes>]]");
 	PUTS("\t   a induct <protocol name> <duct name> '<CLI command>'");
 	PUTS("\t   a outduct <protocol name> <duct name> '<CLO command>'");
 	PUTS("\tc\tChange");
@@ -91,6 +92,7 @@ static void	printUsage()
 	PUTS("\t   l outduct [<protocol name>]");
 	PUTS("\tm\tManage");
 	PUTS("\t   m heapmax <max database heap for any single acquisition>");
+	PUTS("\t   m clocktime <max milliseconds per bpclock transaction>");
 	PUTS("\tr\tRun another admin program");
 	PUTS("\t   r '<admin command>'");
 	PUTS("\ts\tStart");
@@ -205,6 +207,7 @@ static void	executeAdd(int tokenCount, char **tokens)
 	char		*script;
 	BpRecvRule	rule;
 	long		nominalRate = 0;
+	long		burstSize = 0;
 
 	if (tokenCount < 2)
 	{
@@ -256,19 +259,24 @@ static void	executeAdd(int tokenCount, char **tokens)
 
 	if (strcmp(tokens[1], "protocol") == 0)
 	{
-		if (tokenCount < 5 || tokenCount > 6)
+		if (tokenCount < 5 || tokenCount > 7)
 		{
 			SYNTAX_ERROR;
 			return;
 		}
 
-		if (tokenCount == 6)
+		if (tokenCount > 5)
 		{
 			nominalRate = atol(tokens[5]);
 		}
 
+		if (tokenCount > 6)
+		{
+			burstSize = atol(tokens[6]);
+		}
+
 		addProtocol(tokens[2], atoi(tokens[3]), atoi(tokens[4]),
-				nominalRate);
+				nominalRate, burstSize);
 		return;
 	}
 
@@ -996,6 +1004,30 @@ static void	manageHeapmax(int tokenCount, char **tokens)
 	}
 }
 
+static void	manageClocktime(int tokenCount, char **tokens)
+{
+	Sdr	sdr = getIonsdr();
+	BpVdb	*vdb = getBpVdb();
+	int	clocktime;
+
+	if (tokenCount != 3)
+	{
+		SYNTAX_ERROR;
+		return;
+	}
+
+	clocktime = strtol(tokens[2], NULL, 0);
+	if (clocktime < 1)
+	{
+		writeMemoNote("[?] clocktime is invalid", tokens[2]);
+		return;
+	}
+
+	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	vdb->clockBatchTime = clocktime;
+	sdr_exit_xn(sdr);	/*	Unlock memory.			*/
+}
+
 static void	executeManage(int tokenCount, char **tokens)
 {
 	if (tokenCount < 2)
@@ -1010,6 +1042,12 @@ static void	executeManage(int tokenCount, char **tokens)
 		return;
 	}
 
+	if (strcmp(tokens[1], "clocktime") == 0)
+	{
+		manageClocktime(tokenCount, tokens);
+		return;
+	}
+
 	SYNTAX_ERROR;
 }
 
@@ -68,6 +68,7 @@ static void	*receivePdus(void *parm)
 			if (zco_receive_source(sdr, &reader, contentLength,
 					(char *) buffer) < 0)
 			{
+				zco_stop_receiving(sdr, &reader);
 				sdr_cancel_xn(sdr);
 				putErrmsg("bputa can't receive bundle ADU.",
 						itoa(contentLength));
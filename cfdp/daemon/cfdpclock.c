@@ -9,6 +9,7 @@
 	
 									*/
 #include "cfdpP.h"
+#include "timewheel.h"
 
 static int	_running(int *newValue)
 {
@@ -165,6 +166,54 @@ static int	scanOutFdus(Sdr sdr, time_t currentTime)
 	return 0;
 }
 
+/*	Returns the local clock time at which the indicated second
+ *	of UTC begins.							*/
+
+static void	getSecondBoundary(time_t utcTime, struct timeval *deadline)
+{
+	getCurrentTime(deadline);
+	deadline->tv_sec = utcTime + (deadline->tv_sec - getUTCTime());
+	deadline->tv_usec = 0;
+}
+
+static void	scanFdus(TimeWheel *wheel, void *arg)
+{
+	Sdr		sdr = (Sdr) arg;
+	int		stop = 0;
+	time_t		currentTime;
+	struct timeval	deadline;
+
+	/*	FDU check timers are counted in seconds, so all FDUs
+	 *	are scanned at the start of each second.		*/
+
+	currentTime = getUTCTime();
+
+	/*	Update check counts for inbound FDUs.			*/
+
+	if (scanInFdus(sdr, currentTime) < 0)
+	{
+		putErrmsg("Can't scan inbound FDUs.", NULL);
+		oK(_running(&stop));
+		return;
+	}
+
+	/*	Clean out completed outbound FDUs.			*/
+
+	if (scanOutFdus(sdr, currentTime) < 0)
+	{
+		putErrmsg("Can't scan outbound FDUs.", NULL);
+		oK(_running(&stop));
+		return;
+	}
+
+	getSecondBoundary(currentTime + 1, &deadline);
+	if (tw_insert(wheel, &deadline, scanFdus, sdr) == NULL)
+	{
+		putErrmsg("Can't schedule FDU scan.", NULL);
+		oK(_running(&stop));
+	}
+}
+
 #if defined (VXWORKS) || defined (RTEMS)
 int	cfdpclock(int a1, int a2, int a3, int a4, int a5,
 		int a6, int a7, int a8, int a9, int a10)
@@ -173,9 +222,10 @@ int	cfdpclock(int a1, int a2, int a3, int a4, int a5,
 int	main(int argc, char *argv[])
 {
 #endif
-	Sdr	sdr;
-	int	state = 1;
-	time_t	currentTime;
+	Sdr		sdr;
+	int		state = 1;
+	TimeWheel	*wheel;
+	struct timeval	deadline;
 
 	if (cfdpInit() < 0 || bp_attach() < 0)
 	{
@@ -184,37 +234,34 @@ int	main(int argc, char *argv[])
 	}
 
 	sdr = getIonsdr();
+	getSecondBoundary(getUTCTime() + 1, &deadline);
+	wheel = tw_create(SM_SEM_NONE);
+	if (wheel == NULL
+	|| tw_insert(wheel, &deadline, scanFdus, sdr) == NULL)
+	{
+		putErrmsg("cfdpclock can't start timer wheel.", NULL);
+		ionDetach();
+		return -1;
+	}
+
 	isignal(SIGTERM, shutDown);
 
-	/*	Main loop: wait one second, then scan all FDUS.		*/
+	/*	Main loop: sleep until the start of the next second,
+	 *	then scan all FDUs.					*/
 
 	oK(_running(&state));
 	writeMemo("[i] cfdpclock is running.");
 	while (_running(NULL))
 	{
-		snooze(1);
-		currentTime = getUTCTime();
-
-		/*	Update check counts for inbound FDUs.		*/
-
-		if (scanInFdus(sdr, currentTime) < 0)
-		{
-			putErrmsg("Can't scan inbound FDUs.", NULL);
-			state = 0;	/*	Terminate loop.		*/
-			oK(_running(&state));
-			continue;
-		}
-
-		/*	Clean out completed outbound FDUs.		*/
-
-		if (scanOutFdus(sdr, currentTime) < 0)
+		if (tw_wait(wheel) < 0)
 		{
-			putErrmsg("Can't scan inbound FDUs.", NULL);
+			putErrmsg("Can't wait for FDU scan.", NULL);
 			state = 0;	/*	Terminate loop.		*/
 			oK(_running(&state));
 		}
 	}
 
+	tw_destroy(wheel);
 	writeErrmsgMemos();
 	writeMemo("[i] cfdpclock has ended.");
 	ionDetach();
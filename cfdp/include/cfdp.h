@@ -71,7 +71,8 @@ typedef struct
  *	in the file (and beyond it as necessary) and return the length
  *	of the current record.  It is also required to update the
  *	computed checksum for the file by passing each octet of the
- *	current record to the cfdp_update_checksum() function.
+ *	current record to the cfdp_update_checksum() function, or
+ *	(faster) the entire record to cfdp_update_checksum_buffer().
  *
  *	In the absence of a specified reader function, the default
  *	reader function simply returns CFDP_MAX_FILE_DATA or the
@@ -198,6 +199,10 @@ extern void	cfdp_decompress_number(unsigned long *toNbr, CfdpNumber *from);
 extern void	cfdp_update_checksum(unsigned char octet,
 			unsigned int	*offset,
 			unsigned int	*checksum);
+extern void	cfdp_update_checksum_buffer(unsigned char *buffer,
+			int		length,
+			unsigned int	*offset,
+			unsigned int	*checksum);
 extern
 MetadataList	cfdp_create_usrmsg_list();
 extern int	cfdp_add_usrmsg(MetadataList list,
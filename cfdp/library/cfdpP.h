@@ -266,6 +266,8 @@ extern int		checkFile(char *);
 
 extern void		addToChecksum(unsigned char octet, unsigned int *offset,
 				unsigned int *checksum);
+extern void		addBufferToChecksum(unsigned char *buffer, int length,
+				unsigned int *offset, unsigned int *checksum);
 
 extern int		getReqNbr();	/*	Returns next req nbr.	*/
 
@@ -138,14 +138,18 @@ void	cfdp_update_checksum(unsigned char octet, unsigned int *offset,
 	addToChecksum(octet, offset, checksum);
 }
 
+void	cfdp_update_checksum_buffer(unsigned char *buffer, int length,
+		unsigned int *offset, unsigned int *checksum)
+{
+	addBufferToChecksum(buffer, length, offset, checksum);
+}
+
 static int	defaultReader(int fd, unsigned int *checksum)
 {
 	static char	defaultReaderBuf[CFDP_MAX_PDU_SIZE];
 	CfdpDB		*cfdpConstants = getCfdpConstants();
 	unsigned int	offset;
 	int		length;
-	int		i;
-	char		*octet;
 
 	offset = (unsigned int) lseek(fd, 0, SEEK_CUR);
 	if (offset == (unsigned int) -1)
@@ -161,10 +165,8 @@ static int	defaultReader(int fd, unsigned int *checksum)
 		return -1;
 	}
 
-	for (i = 0, octet = defaultReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum);
-	}
+	addBufferToChecksum((unsigned char *) defaultReaderBuf, length,
+			&offset, checksum);
 
 	return length;
 }
@@ -175,8 +177,6 @@ static int	bestEffortsReader(int fd, unsigned int *checksum)
 	CfdpDB		*cfdpConstants = getCfdpConstants();
 	unsigned int	offset;
 	int		length;
-	int		i;
-	char		*octet;
 
 	/*	For best-efforts transmission, we limit segment size
 	 *	to the maximum content length of a link-layer frame.
@@ -202,10 +202,8 @@ static int	bestEffortsReader(int fd, unsigned int *checksum)
 		return -1;
 	}
 
-	for (i = 0, octet = bestEffortsReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum);
-	}
+	addBufferToChecksum((unsigned char *) bestEffortsReaderBuf, length,
+			&offset, checksum);
 
 	return length;
 }
@@ -216,7 +214,6 @@ int	cfdp_read_space_packets(int fd, unsigned int *checksum)
 	CfdpDB		*cfdpConstants = getCfdpConstants();
 	unsigned int	offset;
 	int		length;
-	int		i;
 	char		*octet;
 	unsigned int	recordLen;
 	unsigned short	pktlen;
@@ -292,10 +289,8 @@ int	cfdp_read_space_packets(int fd, unsigned int *checksum)
 
 	/*	Add record to checksum.					*/
 
-	for (i = 0, octet = pktReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum);
-	}
+	addBufferToChecksum((unsigned char *) pktReaderBuf, length, &offset,
+			checksum);
 
 	return length;
 }
@@ -356,10 +351,8 @@ int	cfdp_read_text_lines(int fd, unsigned int *checksum)
 
 	/*	Add record to checksum.					*/
 
-	for (i = 0, octet = textReaderBuf; i < length; i++, octet++)
-	{
-		addToChecksum((unsigned char) *octet, &offset, checksum);
-	}
+	addBufferToChecksum((unsigned char *) textReaderBuf, length, &offset,
+			checksum);
 
 	return length;
 }
@@ -11,6 +11,7 @@
 
 #include "cfdpP.h"
 #include "lyst.h"
+#include "crc.h"
 
 #define	CFDP_DEBUG	0
 
@@ -207,6 +208,74 @@ void	addToChecksum(unsigned char octet, unsigned int *offset,
 	(*offset)++;
 }
 
+void	addBufferToChecksum(unsigned char *buffer, int length,
+		unsigned int *offset, unsigned int *checksum)
+{
+	unsigned int	sum;
+	unsigned int	word;
+	unsigned int	sum0 = 0;
+	unsigned int	sum1 = 0;
+	unsigned int	sum2 = 0;
+	unsigned int	sum3 = 0;
+
+	/*	The checksum is the modulo-2^32 sum of the file's
+	 *	content taken as big-endian 4-byte words aligned on
+	 *	file offsets that are multiples of 4.  Octets ahead
+	 *	of the first such word boundary and after the last
+	 *	one are added individually; everything in between
+	 *	is added a full word at a time.  Words are copied
+	 *	out of the buffer rather than dereferenced in place,
+	 *	as the buffer itself need not be word-aligned.		*/
+
+	CHKVOID(buffer || length == 0);
+	CHKVOID(length >= 0);
+	CHKVOID(offset);
+	CHKVOID(checksum);
+	while (length > 0 && (*offset & 0x03) != 0)
+	{
+		addToChecksum(*buffer, offset, checksum);
+		buffer++;
+		length--;
+	}
+
+	sum = *checksum;
+	*offset += (length & ~0x03);
+
+	/*	Four independent running sums let the additions of
+	 *	consecutive words overlap in the pipeline (and let
+	 *	the compiler vectorize the loop where it can).		*/
+
+	while (length >= 16)
+	{
+		memcpy((char *) &word, (char *) buffer, 4);
+		sum0 += ntohl(word);
+		memcpy((char *) &word, (char *) (buffer + 4), 4);
+		sum1 += ntohl(word);
+		memcpy((char *) &word, (char *) (buffer + 8), 4);
+		sum2 += ntohl(word);
+		memcpy((char *) &word, (char *) (buffer + 12), 4);
+		sum3 += ntohl(word);
+		buffer += 16;
+		length -= 16;
+	}
+
+	while (length >= 4)
+	{
+		memcpy((char *) &word, (char *) buffer, 4);
+		sum0 += ntohl(word);
+		buffer += 4;
+		length -= 4;
+	}
+
+	*checksum = sum + sum0 + sum1 + sum2 + sum3;
+	while (length > 0)
+	{
+		addToChecksum(*buffer, offset, checksum);
+		buffer++;
+		length--;
+	}
+}
+
 int	getReqNbr()
 {
 	Sdr	sdr = getIonsdr();
@@ -227,45 +296,6 @@ static unsigned char	*_crcComputationBuf()
 	return buffer;
 }
 
-static unsigned short	computeCRC(unsigned char *buffer, int length)
-{
-	static int		crcCalcValuesInitialized = 0;
-    	int			i;
-    	unsigned int		tmp;
-	static unsigned int	crcCalcValues[256];
-	unsigned char		*cursor = buffer;
-	unsigned int		crc = 0xffff;
-
-	if (!crcCalcValuesInitialized)
-	{
-		for (i = 0; i < 256; i++)
-		{
-			tmp = 0;
-			if ((i & 1) != 0) tmp = tmp ^ 0x1021;
-			if ((i & 2) != 0) tmp = tmp ^ 0x2042;
-			if ((i & 4) != 0) tmp = tmp ^ 0x4084;
-			if ((i & 8) != 0) tmp = tmp ^ 0x8108;
-			if ((i & 16) != 0) tmp = tmp ^ 0x1231;
-			if ((i & 32) != 0) tmp = tmp ^ 0x2462;
-			if ((i & 64) != 0) tmp = tmp ^ 0x48c4;
-			if ((i & 128) != 0) tmp = tmp ^ 0x9188;
-			crcCalcValues[i] = tmp;
-		}
-
-		crcCalcValuesInitialized = 1;
-	}
-
-	while (length > 0)
-	{
-	    crc = (((crc << 8) & 0xff00)
-			^ crcCalcValues[(((crc >> 8) ^ (*cursor)) & 0x00ff)]);
-	    cursor++;
-	    length--;
-	}
-
-	return crc;
-}
-
 /*	*	*	CFDP service control functions	*	*	*/
 
 static char	*_cfdpvdbName()
@@ -2190,13 +2220,15 @@ int	cfdpDequeueOutboundPdu(Object *pdu, OutFdu *fduBuffer)
 		if (zco_receive_source(sdr, &reader, pduSourceDataLength,
 				((char *) buf) + pduHeaderLength) < 0)
 		{
+			zco_stop_receiving(sdr, &reader);
 			sdr_cancel_xn(sdr);
 			putErrmsg("Can't read ZCO.", NULL);
 			return -1;
 		}
 
 		zco_stop_receiving(sdr, &reader);
-		crc = computeCRC(buf, pduHeaderLength + pduSourceDataLength);
+		crc = crc16_ccitt(buf, pduHeaderLength + pduSourceDataLength,
+				CRC16_CCITT_INIT);
 		crc = htons(crc);
 		oK(zco_append_trailer(sdr, *pdu, (char *) &crc, 2));
 	}
@@ -2342,13 +2374,10 @@ static int	writeSegmentData(InFdu *fdu, unsigned char **cursor,
 	}
 
 	fdu->bytesReceived += bytesToWrite;
-	while (bytesToWrite > 0)
-	{
-		addToChecksum(**cursor, segmentOffset, &fdu->computedChecksum);
-		(*cursor)++;
-		(*bytesRemaining)--;
-		bytesToWrite--;
-	}
+	addBufferToChecksum(*cursor, bytesToWrite, segmentOffset,
+			&fdu->computedChecksum);
+	(*cursor) += bytesToWrite;
+	(*bytesRemaining) -= bytesToWrite;
 
 	return 0;
 }
@@ -3330,7 +3359,9 @@ printf("...parsed the PDU...\n");
 #if CFDPDEBUG
 printf("...computing CRC...\n"); 
 #endif
-		if (computeCRC(buf, length) /* Including CRC itself. */ != 0)
+		/*	Length includes the CRC itself.		*/
+
+		if (crc16_ccitt(buf, length, CRC16_CCITT_INIT) != 0)
 		{
 			return 0;	/*	Corrupted PDU.		*/
 		}
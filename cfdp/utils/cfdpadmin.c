@@ -410,7 +410,7 @@ static void	executeInfo()
 		OBJ_POINTER(CfdpDB, db);
 	char	buffer[256];
 
-	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	sdr_begin_read(sdr);
 	GET_OBJ_POINTER(sdr, CfdpDB, db, getCfdpDbObject());
 	isprintf(buffer, sizeof buffer, "xncount=%lu, maxtrnbr=%lu, \
 fillchar=0x%x, discard=%hu, requirecrc=%hu, segsize=%hu, mtusize = %hu, \
@@ -420,7 +420,7 @@ inactivity=%u, ckperiod=%u, maxtimeouts=%u", db->transactionCounter,
 			db->maxFileDataLength, db->mtuSize,
 			db->transactionInactivityLimit, db->checkTimerPeriod,
 			db->checkTimeoutLimit);
-	sdr_exit_xn(sdr);
+	sdr_end_read(sdr);
 	printText(buffer);
 }
 
@@ -9,6 +9,7 @@
 	
 									*/
 #include "rfx.h"
+#include "timewheel.h"
 
 static int	_running(int *newValue)
 {
@@ -475,19 +476,42 @@ static int	applyContacts(time_t currentTime)
 	return 0;
 }
 
-#if defined (VXWORKS) || defined (RTEMS)
-int	rfxclock(int a1, int a2, int a3, int a4, int a5,
-		int a6, int a7, int a8, int a9, int a10)
+static void	noteOwltChanges(IonVdb *ionvdb)
 {
-#else
-int	main(int argc, char *argv[])
+	PsmPartition	ionwm = getIonwm();
+	PsmAddress	elt;
+	IonNode		*node;
+	PsmAddress	elt2;
+	IonOrigin	*origin;
+
+	/*	Origin OWLTs are reset and re-applied every second,
+	 *	so the contact graph has changed only if some OWLT
+	 *	now differs from the one that was in effect before.	*/
+
+	for (elt = sm_rbt_first(ionwm, ionvdb->nodes); elt;
+			elt = sm_rbt_next(ionwm, elt))
+	{
+		node = (IonNode *) psp(ionwm, sm_rbt_data(ionwm, elt));
+		CHKVOID(node);
+		for (elt2 = sm_list_first(ionwm, node->origins); elt2;
+				elt2 = sm_list_next(ionwm, elt2))
+		{
+			origin = (IonOrigin *) psp(ionwm,
+					sm_list_data(ionwm, elt2));
+			CHKVOID(origin);
+			if (origin->owlt != origin->prevOwlt)
+			{
+				ionvdb->graphVersion++;
+				return;
+			}
+		}
+	}
+}
+
+static int	applySchedule(Sdr sdr, time_t currentTime)
 {
-#endif
-	Sdr		sdr;
-	time_t		currentTime;
-	PsmPartition	ionwm;
-	IonVdb		*ionvdb;
-	int		start = 1;
+	PsmPartition	ionwm = getIonwm();
+	IonVdb		*ionvdb = getIonVdb();
 	PsmAddress	elt;
 	PsmAddress	addr;
 	IonProbe	*probe;
@@ -498,142 +522,210 @@ int	main(int argc, char *argv[])
 	IonNode		*node;
 	IonOrigin	*origin;
 
-	if (ionAttach() < 0)
+	sdr_begin_xn(sdr);
+
+	/*	First enable probes.				*/
+
+	for (elt = sm_list_first(ionwm, ionvdb->probes); elt;
+			elt = sm_list_next(ionwm, elt))
 	{
-		putErrmsg("rfxclock can't attach to ION.", NULL);
+		addr = sm_list_data(ionwm, elt);
+		probe = (IonProbe *) psp(ionwm, addr);
+		CHKERR(probe);
+		if (probe->time > currentTime)
+		{
+			break;	/*	No more for now.	*/
+		}
+
+		/*	Destroy this probe and post the next.	*/
+
+		oK(sm_list_delete(ionwm, elt, NULL, NULL));
+		destNodeNbr = probe->destNodeNbr;
+		neighborNodeNbr = probe->neighborNodeNbr;
+		psm_free(ionwm, addr);
+		if (setProbeIsDue(destNodeNbr, neighborNodeNbr) < 0)
+		{
+			putErrmsg("Can't enable probes.", NULL);
+			sdr_cancel_xn(sdr);
+			return -1;
+		}
+	}
+
+	/*	The intent of this code is to (a) enable
+	 *	contact and range applicability intervals to
+	 *	overlap and (b) assure that on system startup
+	 *	correct current rates and owlts are used to
+	 *	construct the initial contact state of the
+	 *	node.
+	 *
+	 *	First we purge all ranges and contacts that
+	 *	have ended.					*/
+
+	if (purgeRanges(currentTime) < 0)
+	{
+		putErrmsg("Can't purge ranges.", NULL);
+		sdr_cancel_xn(sdr);
 		return -1;
 	}
 
-	sdr = getIonsdr();
-	ionwm = getIonwm();
-	ionvdb = getIonVdb();
-	isignal(SIGTERM, shutDown);
+	if (purgeContacts(currentTime) < 0)
+	{
+		putErrmsg("Can't purge contacts.", NULL);
+		sdr_cancel_xn(sdr);
+		return -1;
+	}
 
-	/*	Main loop: wait for event occurrence time, then
-	 *	execute applicable events.				*/
+	/*	Now we set the volatile contact and range state
+	 *	per the remaining ranges and contacts in the
+	 *	database.
+	 *	
+	 *	First we reset current state to all zeros.	*/
 
-	oK(_running(&start));
-	writeMemo("[i] rfxclock is running.");
-	while (_running(NULL))
+	for (elt = sm_rbt_first(ionwm, ionvdb->neighbors); elt;
+			elt = sm_rbt_next(ionwm, elt))
 	{
-		/*	Sleep for 1 second, then dispatch all events
-		 *	whose execution times have now been reached.	*/
+		neighbor = (IonNeighbor *) psp(ionwm,
+				sm_rbt_data(ionwm, elt));
+		CHKERR(neighbor);
+		neighbor->owltInbound = 0;
+		neighbor->owltOutbound = 0;
+		neighbor->xmitRate = 0;
+		neighbor->fireRate = 0;
+		neighbor->recvRate = 0;
+	}
 
-		snooze(1);
-		currentTime = getUTCTime();
-		sdr_begin_xn(sdr);
+	for (elt = sm_rbt_first(ionwm, ionvdb->nodes); elt;
+			elt = sm_rbt_next(ionwm, elt))
+	{
+		node = (IonNode *) psp(ionwm,
+				sm_rbt_data(ionwm, elt));
+		CHKERR(node);
+		for (elt2 = sm_list_first(ionwm, node->origins); elt2;
+				elt2 = sm_list_next(ionwm, elt2))
+		{
+			origin = (IonOrigin *) psp(ionwm,
+					sm_list_data(ionwm, elt2));
+			CHKERR(origin);
+			origin->prevOwlt = origin->owlt;
+			origin->owlt = 0;
+		}
+	}
 
-		/*	First enable probes.				*/
+	/*	Then we apply all ranges and contacts that
+	 *	have begun and have not yet ended.		*/
 
-		for (elt = sm_list_first(ionwm, ionvdb->probes); elt;
-				elt = sm_list_next(ionwm, elt))
-		{
-			addr = sm_list_data(ionwm, elt);
-			probe = (IonProbe *) psp(ionwm, addr);
-			CHKZERO(probe);
-			if (probe->time > currentTime)
-			{
-				break;	/*	No more for now.	*/
-			}
+	if (applyRanges(currentTime) < 0)
+	{
+		putErrmsg("Can't apply ranges.", NULL);
+		sdr_cancel_xn(sdr);
+		return -1;
+	}
 
-			/*	Destroy this probe and post the next.	*/
+	if (applyContacts(currentTime) < 0)
+	{
+		putErrmsg("Can't apply contacts.", NULL);
+		sdr_cancel_xn(sdr);
+		return -1;
 
-			oK(sm_list_delete(ionwm, elt, NULL, NULL));
-			destNodeNbr = probe->destNodeNbr;
-			neighborNodeNbr = probe->neighborNodeNbr;
-			psm_free(ionwm, addr);
-			if (setProbeIsDue(destNodeNbr, neighborNodeNbr) < 0)
-			{
-				putErrmsg("Can't enable probes.", NULL);
-				sdr_cancel_xn(sdr);
-				return -1;
-			}
-		}
+	}
 
-		/*	The intent of this code is to (a) enable
-		 *	contact and range applicability intervals to
-		 *	overlap and (b) assure that on system startup
-		 *	correct current rates and owlts are used to
-		 *	construct the initial contact state of the
-		 *	node.
-		 *
-		 *	First we purge all ranges and contacts that
-		 *	have ended.					*/
-
-		if (purgeRanges(currentTime) < 0)
-		{
-			putErrmsg("Can't purge ranges.", NULL);
-			sdr_cancel_xn(sdr);
-			return -1;
-		}
+	noteOwltChanges(ionvdb);
 
-		if (purgeContacts(currentTime) < 0)
-		{
-			putErrmsg("Can't purge contacts.", NULL);
-			sdr_cancel_xn(sdr);
-			return -1;
-		}
+	if (sdr_end_xn(sdr) < 0)
+	{
+		putErrmsg("Can't set current topology.", NULL);
+		return -1;
+	}
 
-		/*	Now we set the volatile contact and range state
-		 *	per the remaining ranges and contacts in the
-		 *	database.
-		 *	
-		 *	First we reset current state to all zeros.	*/
+	return 0;
+}
 
-		for (elt = sm_list_first(ionwm, ionvdb->neighbors); elt;
-				elt = sm_list_next(ionwm, elt))
-		{
-			neighbor = (IonNeighbor *) psp(ionwm,
-					sm_list_data(ionwm, elt));
-			CHKZERO(neighbor);
-			neighbor->owltInbound = 0;
-			neighbor->owltOutbound = 0;
-			neighbor->xmitRate = 0;
-			neighbor->fireRate = 0;
-			neighbor->recvRate = 0;
-		}
+/*	Returns the local clock time at which the indicated second
+ *	of UTC begins.							*/
 
-		for (elt = sm_list_first(ionwm, ionvdb->nodes); elt;
-				elt = sm_list_next(ionwm, elt))
-		{
-			node = (IonNode *) psp(ionwm,
-					sm_list_data(ionwm, elt));
-			CHKZERO(node);
-			for (elt2 = sm_list_first(ionwm, node->origins); elt2;
-					elt2 = sm_list_next(ionwm, elt2))
-			{
-				origin = (IonOrigin *) psp(ionwm,
-						sm_list_data(ionwm, elt2));
-				CHKZERO(origin);
-				origin->owlt = 0;
-			}
-		}
+static void	getSecondBoundary(time_t utcTime, struct timeval *deadline)
+{
+	getCurrentTime(deadline);
+	deadline->tv_sec = utcTime + (deadline->tv_sec - getUTCTime());
+	deadline->tv_usec = 0;
+}
 
-		/*	Then we apply all ranges and contacts that
-		 *	have begun and have not yet ended.		*/
+static void	applyScheduleOnce(TimeWheel *wheel, void *arg)
+{
+	Sdr		sdr = (Sdr) arg;
+	int		stop = 0;
+	time_t		currentTime;
+	struct timeval	deadline;
 
-		if (applyRanges(currentTime) < 0)
-		{
-			putErrmsg("Can't apply ranges.", NULL);
-			sdr_cancel_xn(sdr);
-			return -1;
-		}
+	/*	Probes, ranges, and contacts are all scheduled by
+	 *	UTC second, so the schedule is applied at the start
+	 *	of each second.						*/
 
-		if (applyContacts(currentTime) < 0)
-		{
-			putErrmsg("Can't apply contacts.", NULL);
-			sdr_cancel_xn(sdr);
-			return -1;
+	currentTime = getUTCTime();
+	if (applySchedule(sdr, currentTime) < 0)
+	{
+		putErrmsg("Can't apply schedule.", NULL);
+		oK(_running(&stop));
+		return;
+	}
 
-		}
+	getSecondBoundary(currentTime + 1, &deadline);
+	if (tw_insert(wheel, &deadline, applyScheduleOnce, sdr) == NULL)
+	{
+		putErrmsg("Can't schedule rfxclock.", NULL);
+		oK(_running(&stop));
+	}
+}
 
-		if (sdr_end_xn(sdr) < 0)
+#if defined (VXWORKS) || defined (RTEMS)
+int	rfxclock(int a1, int a2, int a3, int a4, int a5,
+		int a6, int a7, int a8, int a9, int a10)
+{
+#else
+int	main(int argc, char *argv[])
+{
+#endif
+	Sdr		sdr;
+	int		start = 1;
+	TimeWheel	*wheel;
+	struct timeval	deadline;
+
+	if (ionAttach() < 0)
+	{
+		putErrmsg("rfxclock can't attach to ION.", NULL);
+		return -1;
+	}
+
+	sdr = getIonsdr();
+	getSecondBoundary(getUTCTime() + 1, &deadline);
+	wheel = tw_create(SM_SEM_NONE);
+	if (wheel == NULL
+	|| tw_insert(wheel, &deadline, applyScheduleOnce, sdr) == NULL)
+	{
+		putErrmsg("rfxclock can't start timer wheel.", NULL);
+		ionDetach();
+		return -1;
+	}
+
+	isignal(SIGTERM, shutDown);
+
+	/*	Main loop: sleep until the start of the next second,
+	 *	then dispatch all events whose execution times have
+	 *	now been reached.					*/
+
+	oK(_running(&start));
+	writeMemo("[i] rfxclock is running.");
+	while (_running(NULL))
+	{
+		if (tw_wait(wheel) < 0)
 		{
-			putErrmsg("Can't set current topology.", NULL);
-			return -1;
+			putErrmsg("Can't wait for schedule.", NULL);
+			start = 0;	/*	Terminate loop.		*/
+			oK(_running(&start));
 		}
 	}
 
+	tw_destroy(wheel);
 	writeErrmsgMemos();
 	writeMemo("[i] rfxclock has ended.");
 	ionDetach();
@@ -0,0 +1,41 @@
+/*
+
+	crc.h:	definitions supporting the computation of cyclic
+		redundancy checks over in-memory buffers.
+
+	The CRC-16-CCITT computed here is the one specified for
+	CFDP PDUs and numerous other CCSDS protocols: polynomial
+	0x1021, most significant bit first, no reflection of input
+	or output, no final exclusive-OR.  CFDP starts the register
+	at 0xffff (CRC16_CCITT_INIT); a buffer whose last two bytes
+	are its own CRC in network byte order yields zero.
+
+	Copyright (c) 2010, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+									*/
+#ifndef _CRC_H_
+#define _CRC_H_
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define	CRC16_CCITT_INIT	(0xffff)
+
+extern unsigned short	crc16_ccitt(unsigned char *buffer, int length,
+				unsigned short crc);
+			/*	Returns the CRC of the first length
+			 *	bytes of buffer, continuing from the
+			 *	CRC of any preceding data (crc).  Pass
+			 *	CRC16_CCITT_INIT as crc for the first
+			 *	block of a message.			*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _CRC_H_ */
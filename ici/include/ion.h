@@ -14,6 +14,7 @@
 #include "memmgr.h"
 #include "sdr.h"
 #include "smlist.h"
+#include "smrbt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +39,7 @@ typedef struct
 	long	heapWords;
 	int	heapKey;
 	char	pathName[MAXPATHLEN + 1];
+	long	commitLatency;
 } IonParms;
 
 /*	The IonDB lists of IonContacts and IonRanges are time-ordered,
@@ -121,6 +123,7 @@ typedef struct
 {
 	unsigned long	nodeNbr;	/*	As from IonContact.	*/
 	unsigned int	owlt;		/*	In seconds, current.	*/
+	unsigned int	prevOwlt;	/*	In seconds, previous.	*/
 } IonOrigin;
 
 typedef struct
@@ -133,6 +136,8 @@ typedef struct
 	time_t		mootAfter;	/*	As from time(2).	*/
 	unsigned int	lastVisitor;
 	time_t		visitHorizon;	/*	As from time(2).	*/
+	unsigned long	visitOffset;	/*	For route caching.	*/
+	time_t		visitFloor;	/*	For route caching.	*/
 } IonXmit;
 
 typedef struct
@@ -176,15 +181,19 @@ typedef struct
 } IonNeighbor;
 
 /*	The volatile database object encapsulates the current volatile
- *	state of the database.						*/
+ *	state of the database.  Its graphVersion is incremented on
+ *	every change to the xmits or origin OWLTs of the contact graph,
+ *	so that route computations cached by routing daemons can be
+ *	recognized as stale.						*/
 
 typedef struct
 {
 	int		clockPid;	/*	For stopping rfxclock.	*/
 	int		deltaFromUTC;	/*	In seconds.		*/
-	PsmAddress	nodes;		/*	SM list: IonNode*	*/
-	PsmAddress	neighbors;	/*	SM list: IonNeighbor*	*/
+	PsmAddress	nodes;		/*	SM RB tree: IonNode*	*/
+	PsmAddress	neighbors;	/*	SM RB tree: IonNeighbor	*/
 	PsmAddress	probes;		/*	SM list: IonProbe*	*/
+	unsigned long	graphVersion;	/*	Contact graph edits.	*/
 } IonVdb;
 
 #ifndef MTAKE
@@ -194,6 +194,7 @@ typedef void	(*FUNCPTR)(int, int, int, int, int, int, int, int, int, int);
 #include <netdb.h>
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <sys/mman.h>
 
 #define SVR4_MSGQS		/****	default				****/
 #define SVR4_SEMAPHORES		/****	default				****/
@@ -409,6 +410,10 @@ typedef void			(* Logger)(char *);
 
 extern void			*acquireSystemMemory(size_t);
 extern int			createFile(const char*, int);
+extern int			syncFile(int);
+extern char			*mapFile(int, size_t);
+extern void			unmapFile(char *, size_t);
+extern int			syncMappedFile(char *, size_t);
 extern char *			system_error_msg();
 extern void			setLogger(Logger);
 extern void			writeMemo(char *);
@@ -417,6 +422,7 @@ extern void			writeMemoNote(char *, char *);
 extern void			snooze(unsigned int);
 extern void			microsnooze(unsigned int);
 extern void			getCurrentTime(struct timeval *);
+extern void			getMonotonicTime(struct timeval *);
 extern unsigned long		getClockResolution();	/*	usec	*/
 #ifndef ION_NO_DNS
 extern unsigned int		getInternetAddress(char *);
@@ -43,6 +43,7 @@ extern int		sm_GetUniqueKey();
 
 extern sm_SemId		sm_SemCreate(int key, int semType);
 extern int		sm_SemTake(sm_SemId semId);
+extern int		sm_SemTimedTake(sm_SemId semId, int seconds);
 extern void		sm_SemGive(sm_SemId semId);
 extern int		sm_SemUnwedge(sm_SemId semId, int interval);
 extern void		sm_SemDelete(sm_SemId semId);
@@ -95,6 +95,14 @@ extern void		rfx_stop();
 
 /*	*	Additional database management functions.		*/
 
+/*	IonNeighbors and IonNodes are indexed by node number in
+ *	shared-memory red-black trees (see smrbt(3)), so the find
+ *	and add functions take O(log n) time.  The nextElt returned
+ *	by a failed find is the tree node of the first neighbor or
+ *	node whose number is greater than nodeNbr, if any; the add
+ *	functions no longer need it to position the new object and
+ *	ignore it.							*/
+
 extern IonNeighbor	*findNeighbor(IonVdb *ionvdb, unsigned long nodeNbr,
 				PsmAddress *nextElt);
 
@@ -0,0 +1,90 @@
+/*
+
+	sdrrbt.h:	definitions supporting use of SDR-based
+			red-black trees.
+
+	Copyright (c) 2010, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+									*/
+#ifndef _SDRRBT_H_
+#define _SDRRBT_H_
+
+#include "sdrmgt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*	Functions for operating on red-black trees in SDR.  An SDR
+	red-black tree is a sorted collection of Addresses, like a
+	sorted SDR list, but insertion and deletion take O(log n)
+	time rather than O(n).  The first and last nodes of the
+	tree are retained in the tree itself, so sdr_rbt_first()
+	and sdr_rbt_last() take constant time.  Nodes are never
+	relocated, so the Object returned by sdr_rbt_insert() may
+	safely be retained for later use in sdr_rbt_delete().	*/
+
+typedef int		(*SdrRbtCompareFn)(Sdr sdr, Address nodeData,
+				void *argData);
+/*	Note: an SdrRbtCompareFn operates by comparing some value(s)
+	derived from its first argument (which will always be the
+	sdr_rbt_data of some SDR red-black tree node) to some value(s)
+	derived from its second argument (which may be a pointer
+	to an object residing in memory).  It returns a value that
+	is less than, equal to, or greater than zero as the node
+	data is less than, equal to, or greater than the argument.	*/
+
+typedef void		(*SdrRbtDeleteFn)(Sdr sdr, Address nodeData,
+				void *argument);
+
+#define sdr_rbt_create(sdr) \
+Sdr_rbt_create(__FILE__, __LINE__, sdr)
+extern Object		Sdr_rbt_create(char *file, int line,
+				Sdr sdr);
+
+#define sdr_rbt_destroy(sdr, rbt, deleteFn, argument) \
+Sdr_rbt_destroy(__FILE__, __LINE__, sdr, rbt, deleteFn, argument)
+extern void		Sdr_rbt_destroy(char *file, int line,
+				Sdr sdr, Object rbt, SdrRbtDeleteFn deleteFn,
+				void *argument);
+
+extern long		sdr_rbt_length(Sdr sdr, Object rbt);
+
+#define sdr_rbt_insert(sdr, rbt, data, compare, arg) \
+Sdr_rbt_insert(__FILE__, __LINE__, sdr, rbt, data, compare, arg)
+extern Object		Sdr_rbt_insert(char *file, int line,
+				Sdr sdr, Object rbt, Address data,
+				SdrRbtCompareFn compare, void *arg);
+
+#define sdr_rbt_delete(sdr, node, deleteFn, argument) \
+Sdr_rbt_delete(__FILE__, __LINE__, sdr, node, deleteFn, argument)
+extern void		Sdr_rbt_delete(char *file, int line,
+				Sdr sdr, Object node, SdrRbtDeleteFn deleteFn,
+				void *argument);
+
+extern Object		sdr_rbt_rbt(Sdr sdr, Object node);
+extern Object		sdr_rbt_first(Sdr sdr, Object rbt);
+extern Object		sdr_rbt_last(Sdr sdr, Object rbt);
+extern Object		sdr_rbt_next(Sdr sdr, Object node);
+extern Object		sdr_rbt_prev(Sdr sdr, Object node);
+
+extern Object		sdr_rbt_search(Sdr sdr, Object rbt,
+				SdrRbtCompareFn compare, void *arg,
+				Object *successor);
+
+extern Address		sdr_rbt_data(Sdr sdr, Object node);
+
+extern int		sdr_rbt_check(Sdr sdr, Object rbt);
+/*	Returns 0 if the tree satisfies all red-black tree invariants
+	(root is black, no red node has a red child, every path from
+	a node to its leaves has the same number of black nodes)
+	and its node links, length, and first and last nodes are
+	consistent; otherwise notes the violation and returns -1.
+	Intended for testing: takes O(n) time.				*/
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _SDRRBT_H_ */
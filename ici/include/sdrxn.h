@@ -36,6 +36,9 @@ typedef struct sdrv_str	*Sdr;	/*	Local view of an SDR.		*/
 #define	SDR_IN_FILE	2	/*	Write file; read file if nec.	*/
 #define	SDR_REVERSIBLE	4	/*	Transactions may be reversed.	*/
 #define	SDR_BOUNDED	8	/*	Object boundaries defended.	*/
+#define	SDR_BUFFERED	16	/*	Log, file writes at xn end.	*/
+#define	SDR_MAPPED	32	/*	File mapped into memory.	*/
+#define	SDR_SYNCED	64	/*	Commits synced to storage.	*/
 
 /*		SDR system administration functions.			*/
 
@@ -129,7 +132,47 @@ extern int		sdr_load_profile(char *name, int configFlags,
 				option is selected, a file of the
 				indicated name and of the size given
 				by total SDR size will be created and
-				filled with zeros.			*/
+				filled with zeros.
+
+				If SDR_MAPPED is selected (which is
+				valid only in combination with
+				SDR_IN_FILE and not with SDR_IN_DRAM),
+				the db file is mapped into the memory
+				of each process that uses the SDR, so
+				that reads and writes are memory
+				copies rather than file I/O; the
+				modified extents of the mapping are
+				synced to the file when the
+				transaction is ended.  Since the
+				mapping may be written back to the
+				file at any time, SDR_MAPPED is not
+				valid in combination with
+				SDR_REVERSIBLE and either
+				SDR_BUFFERED or SDR_SYNCED.
+
+				If SDR_BUFFERED is selected (which
+				is valid only in combination with
+				SDR_IN_DRAM or SDR_MAPPED), log
+				entries are written
+				to a buffer in SDR working memory
+				rather than to the log file, and
+				updates to the db file are recorded
+				as dirty extents rather than written
+				immediately.  The buffered log entries
+				and the coalesced dirty extents are
+				written to the log file and db file,
+				in that order, when the transaction
+				is ended.
+
+				If SDR_SYNCED is selected (which is
+				valid only in combination with
+				SDR_IN_FILE), sdr_end_xn() does not
+				return until the log file and db file
+				have been synced to stable storage.
+				Transactions ended by multiple tasks
+				in quick succession share a single
+				sync ("group commit"); see
+				sdr_set_commit_latency().		*/
 
 extern int		sdr_reload_profile(char *name, int configFlags,
 				long heapWords, int memKey, char *pathName);
@@ -162,6 +205,30 @@ extern void		sdr_stop_using(Sdr sdr);
 				Sdr handle; other users of the SDR
 				are unaffected.				*/
 
+extern void		sdr_set_commit_latency(Sdr sdr,
+				long microseconds);
+			/*	For an SDR configured with SDR_SYNCED,
+				sets the maximum length of time that
+				the end of a transaction may wait for
+				other transactions to be ended, so
+				that all may be made durable by a
+				single sync of the log and db files.
+				Zero (the default) causes each sync
+				to be performed as soon as the prior
+				one is complete; transactions ended
+				while a sync is in progress are then
+				made durable by the next one.		*/
+
+extern void		sdr_sync_counts(Sdr sdr,
+				unsigned long *commits,
+				unsigned long *syncs);
+			/*	Reports the number of transactions
+				committed to the SDR and the number
+				of syncs by which those commits were
+				made durable, since the SDR's profile
+				was loaded.  Both are zero unless the
+				SDR is configured with SDR_SYNCED.	*/
+
 extern void		sdr_abort(Sdr sdr);
 			/*	Terminates the task.  In flight
 				configuration, also terminates all
@@ -181,6 +248,27 @@ extern void		sdr_exit_xn(Sdr sdr);
 extern void		sdr_cancel_xn(Sdr sdr);
 extern int		sdr_end_xn(Sdr sdr);
 
+extern void		sdr_begin_read(Sdr sdr);
+extern int		sdr_in_read(Sdr sdr);		/*	Boolean	*/
+extern void		sdr_end_read(Sdr sdr);
+			/*	sdr_begin_read locks the SDR in shared
+				mode: any number of tasks may read the
+				SDR concurrently, while a transaction
+				started by any other task waits until
+				all readers have called sdr_end_read.
+				Nothing may be modified in a read: not
+				the SDR heap, since sdr_write etc. fail
+				when not in a transaction, nor any
+				working memory that is otherwise
+				protected by the SDR lock.  A task
+				that is already in a transaction may
+				call sdr_begin_read, which then has
+				the same effect as sdr_begin_xn; but
+				a task that is in a read must not
+				call sdr_begin_xn.  sdr_in_read is
+				true in either a read or a transaction.
+									*/
+
 /*		Low-level SDR I/O functions.				*/
 
 typedef long		Address;
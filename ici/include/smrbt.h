@@ -0,0 +1,87 @@
+/*
+	Public header file for routines that manage red-black trees
+	in shared memory.  Like shared-memory lists, the trees are
+	usable in any PSM partition: all references to data items
+	are expressed as offsets from the start of the partition,
+	which can be converted to absolute memory pointers by the
+	psp() function provided by PSM.
+
+	Copyright (c) 2010, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+									*/
+#ifndef _SMRBT_H_
+#define _SMRBT_H_
+
+#include "psm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*	A shared-memory red-black tree is a sorted collection of
+	PsmAddresses, like a sorted shared-memory list, but search,
+	insertion, and deletion take O(log n) time rather than O(n).
+	The first and last nodes of the tree are retained in the
+	tree itself, so sm_rbt_first() and sm_rbt_last() take
+	constant time.  Nodes are never relocated, so the address
+	returned by sm_rbt_insert() may safely be retained for later
+	use in sm_rbt_delete().						*/
+
+typedef int		(*SmRbtCompareFn)(PsmPartition partition,
+				PsmAddress nodeData, void *argData);
+/*	Note: an SmRbtCompareFn operates by comparing some value(s)
+	derived from its first argument (which will always be the
+	sm_rbt_data of some shared memory red-black tree node) to
+	some value(s) derived from its second argument (which is
+	typically a pointer to an object residing in memory).  It
+	returns a value that is less than, equal to, or greater
+	than zero as the node data is less than, equal to, or
+	greater than the argument.					*/
+
+typedef void		(*SmRbtDeleteFn)(PsmPartition partition,
+				PsmAddress nodeData, void *argData);
+
+#define sm_rbt_create(partition) \
+Sm_rbt_create(__FILE__, __LINE__, partition)
+extern PsmAddress	Sm_rbt_create(char *file, int line,
+				PsmPartition partition);
+extern void		sm_rbt_unwedge(PsmPartition partition, PsmAddress rbt,
+				int interval);
+#define sm_rbt_destroy(partition, rbt, fn, arg) \
+Sm_rbt_destroy(__FILE__, __LINE__, partition, rbt, fn, arg)
+extern int		Sm_rbt_destroy(char *file, int line,
+				PsmPartition partition, PsmAddress rbt,
+				SmRbtDeleteFn deleteFn, void *argument);
+
+extern long		sm_rbt_length(PsmPartition partition, PsmAddress rbt);
+
+#define sm_rbt_insert(partition, rbt, data, fn, arg) \
+Sm_rbt_insert(__FILE__, __LINE__, partition, rbt, data, fn, arg)
+extern PsmAddress	Sm_rbt_insert(char *file, int line,
+				PsmPartition partition, PsmAddress rbt,
+				PsmAddress data, SmRbtCompareFn compare,
+				void *arg);
+
+#define sm_rbt_delete(partition, node, fn, arg) \
+Sm_rbt_delete(__FILE__, __LINE__, partition, node, fn, arg)
+extern int		Sm_rbt_delete(char *file, int line,
+				PsmPartition partition, PsmAddress node,
+				SmRbtDeleteFn deleteFn, void *argument);
+
+extern PsmAddress	sm_rbt_rbt(PsmPartition partition, PsmAddress node);
+extern PsmAddress	sm_rbt_first(PsmPartition partition, PsmAddress rbt);
+extern PsmAddress	sm_rbt_last(PsmPartition partition, PsmAddress rbt);
+extern PsmAddress	sm_rbt_next(PsmPartition partition, PsmAddress node);
+extern PsmAddress	sm_rbt_prev(PsmPartition partition, PsmAddress node);
+
+extern PsmAddress	sm_rbt_search(PsmPartition partition, PsmAddress rbt,
+				SmRbtCompareFn compare, void *arg,
+				PsmAddress *successor);
+
+extern PsmAddress	sm_rbt_data(PsmPartition partition, PsmAddress node);
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _SMRBT_H_ */
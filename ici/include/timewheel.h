@@ -0,0 +1,117 @@
+/*
+
+	timewheel.h:	definitions supporting the use of in-memory
+			hierarchical timer wheels.
+
+	A timer wheel is a private, per-process schedule of timers,
+	each of which causes an application-supplied function to be
+	invoked at some designated time.  The wheel has a resolution
+	of one millisecond.  Insertion and cancellation of timers
+	take constant time, as does the firing of each timer.
+
+	A wheel may be bound to a semaphore, in which case a single
+	alarm thread gives that semaphore whenever the earliest
+	timer in the wheel comes due.  A daemon that blocks on the
+	semaphore in tw_wait may therefore be awakened either by
+	the arrival of the next deadline or by any other task that
+	gives the same semaphore, e.g., on insertion of an event
+	into a shared timeline ahead of all previously scheduled
+	events.
+
+	Copyright (c) 2010, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+									*/
+#ifndef _TIMEWHEEL_H_
+#define _TIMEWHEEL_H_
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tw_str		TimeWheel;
+typedef struct twtimer_str	TwTimer;
+
+typedef void			(*TwTimerFn)(TimeWheel *wheel, void *arg);
+/*	Note: a TwTimerFn is invoked when the timer to which it
+	was attached comes due, by the thread that calls tw_advance
+	or tw_wait.  The timer itself has already been released by
+	the time the function is invoked, so the function must
+	not attempt to cancel it; it may insert new timers into
+	the wheel, including a new timer that invokes the same
+	function.						*/
+
+extern TimeWheel		*tw_create(sm_SemId wakeSemaphore);
+			/*	Creates a new, empty timer wheel.  If
+				wakeSemaphore is not SM_SEM_NONE, also
+				starts an alarm thread that gives that
+				semaphore whenever the earliest timer
+				in the wheel comes due.  Returns NULL
+				on any error.				*/
+
+extern void			tw_destroy(TimeWheel *wheel);
+			/*	Stops the wheel's alarm thread, if any,
+				and releases the wheel and all timers
+				in it without invoking any of their
+				functions.				*/
+
+extern TwTimer			*tw_insert(TimeWheel *wheel,
+					struct timeval *deadline,
+					TwTimerFn function, void *arg);
+			/*	Schedules invocation of function(arg)
+				at deadline, which is expressed in the
+				same terms as the time reported by
+				getCurrentTime().  The function is not
+				invoked before the deadline but may be
+				invoked up to one millisecond after it
+				(or later, if the thread that advances
+				the wheel is busy).  A deadline that
+				has already passed causes the function
+				to be invoked at the next advance of
+				the wheel.  Returns the new timer on
+				success, NULL on any error.		*/
+
+extern TwTimer			*tw_insert_ms(TimeWheel *wheel,
+					unsigned long interval,
+					TwTimerFn function, void *arg);
+			/*	As tw_insert, but the deadline is the
+				current time plus interval milliseconds.*/
+
+extern void			tw_cancel(TimeWheel *wheel, TwTimer *timer);
+			/*	Removes a timer that has not yet come
+				due from the wheel and releases it.	*/
+
+extern unsigned long		tw_count(TimeWheel *wheel);
+			/*	Returns the number of timers currently
+				scheduled in the wheel.			*/
+
+extern int			tw_next(TimeWheel *wheel,
+					struct timeval *deadline);
+			/*	Places in deadline the time at which
+				the earliest timer in the wheel comes
+				due, i.e., the time at which the wheel
+				next needs to be advanced.  Returns 1
+				on success, 0 if the wheel is empty.	*/
+
+extern int			tw_advance(TimeWheel *wheel);
+			/*	Advances the wheel to the current time,
+				invoking the functions of all timers
+				that have come due.  Returns the number
+				of functions invoked.			*/
+
+extern int			tw_wait(TimeWheel *wheel);
+			/*	Blocks until the earliest timer in the
+				wheel comes due or (if the wheel is
+				bound to a semaphore) the semaphore is
+				given by some other task, then advances
+				the wheel.  Returns the number of timer
+				functions invoked, or -1 on any error.	*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _TIMEWHEEL_H_ */
@@ -73,11 +73,39 @@ typedef enum
 	ZcoSdrSource
 } ZcoMedium;
 
+/*	A ZcoReader retains an open file descriptor for the most
+ *	recently read file reference, so that reading successive
+ *	chunks of a file-based ZCO costs no open() or close() calls.
+ *	Reads of file extents that are adjacent both in the file
+ *	and in the caller's buffer are deferred and combined, so
+ *	that one pread() serves all of them; deferred reads are
+ *	always completed before the copying function returns.  The
+ *	descriptor is closed by zco_stop_transmitting() and
+ *	zco_stop_receiving(), which must therefore be called at the
+ *	end of every read (a reader that is all zeros holds no
+ *	descriptor).
+ *
+ *	A ZcoReader also retains a cursor identifying the capsule or
+ *	extent at which its last read ended, so that sequential reads
+ *	cost constant time per call regardless of the number of
+ *	extents in the ZCO.  The cursor survives the appending of
+ *	extents and trailers, but the ZCO must not otherwise be
+ *	restructured (e.g., by zco_prepend_header, zco_discard_*,
+ *	zco_strip, or zco_concatenate) while a read is in progress.
+ *	A reader is used either for transmission or for reception,
+ *	never both.							*/
+
 typedef struct
 {
-	Object	reference;	/*	ZcoReference			*/
-	Object	fileRefObj;
-	int	fd;
+	Object		reference;	/*	ZcoReference		*/
+	Object		fileRefObj;	/*	FileRef of open file.	*/
+	int		fd;		/*	Valid if fileRefObj.	*/
+	char		*readBuffer;	/*	Deferred file read.	*/
+	unsigned int	readOffset;	/*	Offset within file.	*/
+	unsigned int	readLength;	/*	0 if no deferred read.	*/
+	int		cursorSection;	/*	0 if no cursor.		*/
+	Object		cursorObj;	/*	Capsule or SourceExtent	*/
+	unsigned int	cursorStart;	/*	Offset of cursorObj.	*/
 } ZcoReader;
 
 /*		Commonly used functions for building, managing,
@@ -241,6 +269,78 @@ int		zco_transmit(	Sdr sdr,
 			 *	this ZCO.  Returns the number of bytes
 			 *	copied, or -1 on any error.		*/
 
+int		zco_transmit_sdr(Sdr sdr,
+				ZcoReader *reader,
+				unsigned int length,
+				char *buffer);
+			/*	Like zco_transmit, but copies only
+			 *	bytes that reside in the SDR heap
+			 *	(capsules and SDR-sourced extents),
+			 *	stopping short of the first untrans-
+			 *	mitted byte that is in a file-sourced
+			 *	extent.  "buffer" is required.  Returns
+			 *	the number of bytes copied (0 if the
+			 *	next byte is file-sourced or the ZCO
+			 *	is exhausted), or -1 on any error.	*/
+
+int		zco_transmit_file(Sdr sdr,
+				ZcoReader *reader,
+				unsigned int length,
+				int *fd,
+				unsigned int *offset);
+			/*	If the next untransmitted byte of the
+			 *	ZCO is in a file-sourced extent, marks
+			 *	up to "length" bytes of that extent as
+			 *	transmitted and populates "fd" and
+			 *	"offset" with the reader's descriptor
+			 *	for the file and the location of those
+			 *	bytes within it, so that the caller can
+			 *	send them without copying (e.g., by
+			 *	sendfile()).  The descriptor remains
+			 *	owned by the reader and is valid until
+			 *	the next call using the reader.  Returns
+			 *	the number of bytes so marked, 0 if the
+			 *	next byte is not in a file (or the file
+			 *	can't be opened, in which case
+			 *	zco_transmit will supply fill), or -1
+			 *	on any error.				*/
+
+int		zco_read(	Sdr sdr,
+				ZcoReader *reader,
+				unsigned int offset,
+				unsigned int length,
+				char *buffer);
+			/*	Copies up to "length" bytes of the
+			 *	total concatenated ZCO object, starting
+			 *	at "offset", into "buffer", without
+			 *	regard to (and without changing) the
+			 *	amount of the ZCO already copied via
+			 *	the reader's ZCO reference.  Because
+			 *	nothing is written to the SDR, any
+			 *	number of readers may read the same
+			 *	reference in this way, with no need
+			 *	to add a reference per read.  "reader"
+			 *	is populated by zco_start_transmitting
+			 *	and must be terminated by
+			 *	zco_stop_transmitting.  Returns the
+			 *	number of bytes copied, or -1 on any
+			 *	error.					*/
+
+int		zco_seek(	Sdr sdr,
+				ZcoReader *reader,
+				unsigned int offset);
+			/*	Sets the position within the total
+			 *	concatenated ZCO object at which the
+			 *	next zco_transmit (or zco_transmit_sdr
+			 *	or zco_transmit_file) via "reader" will
+			 *	begin copying, which may be before or
+			 *	after the current position.  Seeking
+			 *	forward resumes from the reader's
+			 *	cursor; seeking backward rescans from
+			 *	the start of the ZCO.  Returns 0 on
+			 *	success, -1 on any error (e.g., offset
+			 *	beyond the end of the ZCO).		*/
+
 void		zco_stop_transmitting(Sdr sdr,
 				ZcoReader *reader);
 			/*	Terminate extraction of outbound ZCO
@@ -0,0 +1,99 @@
+/*
+
+	crc.c:	cyclic redundancy check computation.
+
+	Copyright (c) 2010, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+	The CRC is computed by "slicing by 8": eight 256-entry
+	tables are consulted per 8 bytes of input, in place of
+	the one table lookup per byte of the classic table-driven
+	algorithm.  Table 0 is the classic table, giving the
+	effect on the CRC register of one byte shifted out of
+	its high-order end.  Table k gives the effect of a byte
+	that is followed by k more bytes of zeroes.  Since the
+	CRC is linear, the CRC of 8 bytes of input is then the
+	exclusive-OR of the table entries for each of those bytes
+	(the first two of which are first combined with the
+	current CRC) at its distance from the end of the block.
+	The lookups are independent of one another, so they
+	proceed in parallel rather than each waiting on the CRC
+	produced by the one before.				*/
+
+#include "crc.h"
+
+#define	CRC16_CCITT_POLY	(0x1021)
+#define	CRC_SLICES		(8)
+
+static unsigned short	crc16Tables[CRC_SLICES][256];
+static pthread_once_t	crc16TablesOnce = PTHREAD_ONCE_INIT;
+
+static void	loadCrc16Tables()
+{
+	int		i;
+	int		j;
+	unsigned short	crc;
+
+	for (i = 0; i < 256; i++)
+	{
+		crc = i << 8;
+		for (j = 0; j < 8; j++)
+		{
+			if (crc & 0x8000)
+			{
+				crc = (crc << 1) ^ CRC16_CCITT_POLY;
+			}
+			else
+			{
+				crc <<= 1;
+			}
+		}
+
+		crc16Tables[0][i] = crc;
+	}
+
+	for (i = 0; i < 256; i++)
+	{
+		crc = crc16Tables[0][i];
+		for (j = 1; j < CRC_SLICES; j++)
+		{
+			crc = (crc << 8) ^ crc16Tables[0][crc >> 8];
+			crc16Tables[j][i] = crc;
+		}
+	}
+}
+
+unsigned short	crc16_ccitt(unsigned char *buffer, int length,
+			unsigned short crc)
+{
+	unsigned short	(*t)[256] = crc16Tables;
+
+	CHKZERO(buffer || length == 0);
+	CHKZERO(length >= 0);
+
+	/*	pthread_once guarantees that the tables are fully
+	 *	loaded, and visible to this thread, before use.		*/
+
+	oK(pthread_once(&crc16TablesOnce, loadCrc16Tables));
+
+	while (length >= CRC_SLICES)
+	{
+		crc ^= (buffer[0] << 8) | buffer[1];
+		crc = t[7][crc >> 8] ^ t[6][crc & 0xff]
+			^ t[5][buffer[2]] ^ t[4][buffer[3]]
+			^ t[3][buffer[4]] ^ t[2][buffer[5]]
+			^ t[1][buffer[6]] ^ t[0][buffer[7]];
+		buffer += CRC_SLICES;
+		length -= CRC_SLICES;
+	}
+
+	while (length > 0)
+	{
+		crc = (crc << 8) ^ t[0][(crc >> 8) ^ *buffer];
+		buffer++;
+		length--;
+	}
+
+	return crc;
+}
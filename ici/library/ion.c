@@ -238,8 +238,8 @@ static IonVdb	*_ionvdb(char **name)
 
 		vdb = (IonVdb *) psp(ionwm, vdbAddress);
 		memset((char *) vdb, 0, sizeof(IonVdb));
-		if ((vdb->nodes = sm_list_create(ionwm)) == 0
-		|| (vdb->neighbors = sm_list_create(ionwm)) == 0
+		if ((vdb->nodes = sm_rbt_create(ionwm)) == 0
+		|| (vdb->neighbors = sm_rbt_create(ionwm)) == 0
 		|| (vdb->probes = sm_list_create(ionwm)) == 0
 		|| psm_catlg(ionwm, *name, vdbAddress) < 0)
 		{
@@ -570,6 +570,11 @@ int	ionInitialize(IonParms *parms, unsigned long ownNodeNbr)
 		return -1;
 	}
 
+	if (parms->configFlags & SDR_SYNCED)
+	{
+		sdr_set_commit_latency(ionsdr, parms->commitLatency);
+	}
+
 	ionsdr = _ionsdr(&ionsdr);
 
 	/*	Recover the ION database, creating it if necessary.	*/
@@ -1283,6 +1288,17 @@ configuration file line (%d).", lineNbr);
 			continue;
 		}
 
+		if (strcmp(tokens[0], "commitLatency") == 0)
+		{
+			parms->commitLatency = atol(tokens[1]);
+			if (parms->commitLatency < 0)
+			{
+				parms->commitLatency = 0;
+			}
+
+			continue;
+		}
+
 		isprintf(buffer, sizeof buffer, "[?] unknown SDR config \
 keyword '%.32s' at line %d.", tokens[0], lineNbr);
 		writeMemo(buffer);
@@ -1323,4 +1339,7 @@ void	printIonParms(IonParms *parms)
 	isprintf(buffer, sizeof buffer, "pathName:       '%.256s'",
 			parms->pathName);
 	writeMemo(buffer);
+	isprintf(buffer, sizeof buffer, "commitLatency:   %ld",
+			parms->commitLatency);
+	writeMemo(buffer);
 }
@@ -37,6 +37,33 @@ int	createFile(const char *filename, int flags)
 	return result;
 }
 
+int	syncFile(int fd)
+{
+	if (ioctl(fd, FIOSYNC, 0) < 0)
+	{
+		putSysErrmsg("can't sync file", itoa(fd));
+		return -1;
+	}
+
+	return 0;
+}
+
+char	*mapFile(int fd, size_t length)
+{
+	putErrmsg("File mapping not supported on this platform.", NULL);
+	return NULL;
+}
+
+void	unmapFile(char *start, size_t length)
+{
+	return;
+}
+
+int	syncMappedFile(char *start, size_t length)
+{
+	return 0;
+}
+
 int	initResourceLock(ResourceLock *rl)
 {
 	Rlock	*lock = (Rlock *) rl;
@@ -179,6 +206,18 @@ void	getCurrentTime(struct timeval *tvp)
 	gettimeofday(tvp, NULL);
 }
 
+void	getMonotonicTime(struct timeval *tvp)
+{
+	unsigned long	tickCount;
+	int		ticksPerSec;
+
+	CHKVOID(tvp);
+	tickCount = tickGet();
+	ticksPerSec = sysClkRateGet();
+	tvp->tv_sec = tickCount / ticksPerSec;
+	tvp->tv_usec = ((tickCount % ticksPerSec) * 1000000) / ticksPerSec;
+}
+
 unsigned long	getClockResolution()
 {
 	struct timespec	ts;
@@ -358,6 +397,93 @@ int	createFile(const char *filename, int flags)
 	return result;
 }
 
+int	syncFile(int fd)
+{
+	int	result;
+
+	/*	Only the file's data (and any metadata needed to
+	 *	retrieve it, such as its length) need be on stable
+	 *	storage when the sync completes.			*/
+
+#if defined (linux)
+	result = fdatasync(fd);
+#else
+	result = fsync(fd);
+#endif
+	if (result < 0)
+	{
+		putSysErrmsg("can't sync file", itoa(fd));
+		return -1;
+	}
+
+	return 0;
+}
+
+#if defined (RTEMS)
+
+char	*mapFile(int fd, size_t length)
+{
+	putErrmsg("File mapping not supported on this platform.", NULL);
+	return NULL;
+}
+
+void	unmapFile(char *start, size_t length)
+{
+	return;
+}
+
+int	syncMappedFile(char *start, size_t length)
+{
+	return 0;
+}
+
+#else
+
+char	*mapFile(int fd, size_t length)
+{
+	void	*start;
+
+	start = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (start == MAP_FAILED)
+	{
+		putSysErrmsg("can't map file", itoa(length));
+		return NULL;
+	}
+
+	return (char *) start;
+}
+
+void	unmapFile(char *start, size_t length)
+{
+	oK(munmap(start, length));
+}
+
+int	syncMappedFile(char *start, size_t length)
+{
+	static long	pageSize = 0;
+	unsigned long	offset;
+
+	/*	msync(2) requires a page-aligned start address.  The
+	 *	mapping itself is page-aligned, so backing up to the
+	 *	start of the page stays within the mapping.		*/
+
+	if (pageSize == 0)
+	{
+		pageSize = sysconf(_SC_PAGESIZE);
+	}
+
+	offset = ((unsigned long) start) % pageSize;
+	if (msync(start - offset, length + offset, MS_ASYNC) < 0)
+	{
+		putSysErrmsg("can't sync mapped file", itoa(length));
+		return -1;
+	}
+
+	return 0;
+}
+
+#endif
+
 #ifdef _MULTITHREADED
 
 typedef struct rlock_str
@@ -571,6 +697,26 @@ void	getCurrentTime(struct timeval *tvp)
 	gettimeofday(tvp, NULL);
 }
 
+void	getMonotonicTime(struct timeval *tvp)
+{
+#if defined (CLOCK_MONOTONIC) && !defined (darwin)
+	struct timespec	ts;
+
+	CHKVOID(tvp);
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+	{
+		tvp->tv_sec = ts.tv_sec;
+		tvp->tv_usec = ts.tv_nsec / 1000;
+		return;
+	}
+#else
+	CHKVOID(tvp);
+#endif
+	/*	No monotonic clock; fall back to time of day.		*/
+
+	gettimeofday(tvp, NULL);
+}
+
 unsigned long	getClockResolution()
 {
 	/*	Linux clock resolution of Alpha is 1 ms, as is
@@ -10,6 +10,10 @@
 /*	        Scott Burleigh, Jet Propulsion Laboratory		*/
 /*									*/
 
+#if defined (linux) && !defined (_GNU_SOURCE)
+#define _GNU_SOURCE			/*	For semtimedop().	*/
+#endif
+
 #include <platform.h>
 
 static void	takeIpcLock();
@@ -769,6 +773,38 @@ int	sm_SemTake(sm_SemId i)
 	return 0;
 }
 
+int	sm_SemTimedTake(sm_SemId i, int seconds)
+{
+	SmSem	*semTbl = _semTbl();
+	SmSem	*sem;
+	int	ticks;
+
+	CHKERR(i >= 0);
+	CHKERR(i < nSemIds);
+	CHKERR(seconds >= 0);
+	sem = semTbl + i;
+	ticks = seconds * sysClkRateGet();
+#ifdef MSAP
+	char	nullMsg[1];
+
+	if (msgQReceive(sem->id, nullMsg, 1, ticks) == ERROR)
+#else
+	if (semTake(sem->id, ticks) == ERROR)
+#endif
+	{
+		if (errno == S_objLib_OBJ_TIMEOUT
+		|| errno == S_objLib_OBJ_UNAVAILABLE)
+		{
+			return 1;	/*	Interval expired.	*/
+		}
+
+		putSysErrmsg("Can't take semaphore", itoa(i));
+		return -1;
+	}
+
+	return 0;
+}
+
 void	sm_SemGive(sm_SemId i)
 {
 	SmSem	*semTbl = _semTbl();
@@ -1195,6 +1231,41 @@ int	sm_SemTake(sm_SemId i)
 	return result;
 }
 
+int	sm_SemTimedTake(sm_SemId i, int seconds)
+{
+	SmSem		*semTbl = _semTbl();
+	SmSem		*sem = semTbl + i;
+	struct timeval	workTime;
+	struct timespec	deadline;
+
+	CHKERR(i >= 0);
+	CHKERR(i < SEM_NSEMS_MAX);
+	CHKERR(seconds >= 0);
+	getCurrentTime(&workTime);
+	deadline.tv_sec = workTime.tv_sec + seconds;
+	deadline.tv_nsec = workTime.tv_usec * 1000;
+	while (1)
+	{
+		if (sem_timedwait(sem->id, &deadline) == 0)
+		{
+			return 0;
+		}
+
+		switch (errno)
+		{
+		case EINTR:
+			continue;
+
+		case ETIMEDOUT:
+			return 1;	/*	Interval expired.	*/
+
+		default:
+			putSysErrmsg("Can't take semaphore", itoa(i));
+			return -1;
+		}
+	}
+}
+
 void	sm_SemGive(sm_SemId i)
 {
 	SmSem	*semTbl = _semTbl();
@@ -1587,6 +1658,166 @@ int	sm_SemTake(sm_SemId i)
 	}
 }
 
+#if defined (linux) || defined (sol5)
+
+int	sm_SemTimedTake(sm_SemId i, int seconds)
+{
+	SemaphoreBase	*sembase = _sembase(0);
+	IciSemaphore	*sem;
+	IciSemaphoreSet	*semset;
+	struct sembuf	sem_op[2] = { {0,0,0}, {0,1,0} };
+	struct timeval	deadline;
+	struct timeval	workTime;
+	struct timespec	interval;
+
+	CHKERR(sembase);
+	CHKERR(i >= 0);
+	CHKERR(i < sembase->semaphoresCount);
+	CHKERR(seconds >= 0);
+	sem = sembase->semaphores + i;
+	if (sem->key == -1)	/*	semaphore deleted		*/
+	{
+		putErrmsg("Can't take deleted semaphore.", itoa(i));
+		return -1;
+	}
+
+	semset = sembase->semSets + sem->semSetIdx;
+	sem_op[0].sem_num = sem_op[1].sem_num = sem->semNbr;
+	getCurrentTime(&deadline);
+	deadline.tv_sec += seconds;
+	while (1)
+	{
+		getCurrentTime(&workTime);
+		if (workTime.tv_usec > deadline.tv_usec)
+		{
+			interval.tv_sec = deadline.tv_sec - (workTime.tv_sec + 1);
+			interval.tv_nsec = (1000000 + deadline.tv_usec
+					- workTime.tv_usec) * 1000;
+		}
+		else
+		{
+			interval.tv_sec = deadline.tv_sec - workTime.tv_sec;
+			interval.tv_nsec = (deadline.tv_usec
+					- workTime.tv_usec) * 1000;
+		}
+
+		if (interval.tv_sec < 0)
+		{
+			interval.tv_sec = 0;
+			interval.tv_nsec = 0;
+		}
+
+		if (semtimedop(semset->semid, sem_op, 2, &interval) == 0)
+		{
+			return 0;
+		}
+
+		switch (errno)
+		{
+		case EINTR:
+			continue;
+
+		case EAGAIN:
+			return 1;	/*	Interval expired.	*/
+
+		default:
+			putSysErrmsg("Can't take semaphore", itoa(i));
+			return -1;
+		}
+	}
+}
+
+#else	/*	No semtimedop(); a timer thread gives the semaphore.	*/
+
+typedef struct
+{
+	int		interval;	/*	Seconds.		*/
+	sm_SemId	semaphore;
+} SemTimerParms;
+
+static void	*semTimerMain(void *parm)
+{
+	SemTimerParms	*timer = (SemTimerParms *) parm;
+	pthread_mutex_t	mutex;
+	pthread_cond_t	cv;
+	struct timeval	workTime;
+	struct timespec	deadline;
+	int		result;
+
+	memset((char *) &mutex, 0, sizeof mutex);
+	if (pthread_mutex_init(&mutex, NULL))
+	{
+		putSysErrmsg("can't start timer, mutex init failed", NULL);
+		sm_SemGive(timer->semaphore);
+		return NULL;
+	}
+
+	memset((char *) &cv, 0, sizeof cv);
+	if (pthread_cond_init(&cv, NULL))
+	{
+		putSysErrmsg("can't start timer, cond init failed", NULL);
+		sm_SemGive(timer->semaphore);
+		return NULL;
+	}
+
+	getCurrentTime(&workTime);
+	deadline.tv_sec = workTime.tv_sec + timer->interval;
+	deadline.tv_nsec = workTime.tv_usec * 1000;
+	pthread_mutex_lock(&mutex);
+	result = pthread_cond_timedwait(&cv, &mutex, &deadline);
+	pthread_mutex_unlock(&mutex);
+	pthread_mutex_destroy(&mutex);
+	pthread_cond_destroy(&cv);
+	if (result)
+	{
+		errno = result;
+		if (errno != ETIMEDOUT)
+		{
+			putSysErrmsg("timer failure", NULL);
+			sm_SemGive(timer->semaphore);
+			return NULL;
+		}
+	}
+
+	/*	Timed out; must wake up the waiting thread.		*/
+
+	timer->interval = 0;	/*	Indicate genuine timeout.	*/
+	sm_SemGive(timer->semaphore);
+	return NULL;
+}
+
+int	sm_SemTimedTake(sm_SemId i, int seconds)
+{
+	SemTimerParms	timerParms;
+	pthread_t	timerThread;
+	int		result;
+
+	CHKERR(seconds >= 0);
+	timerParms.interval = seconds;
+	timerParms.semaphore = i;
+	if (pthread_create(&timerThread, NULL, semTimerMain, &timerParms))
+	{
+		putSysErrmsg("Can't enable interval timer", NULL);
+		return -1;
+	}
+
+	result = sm_SemTake(i);
+	if (timerParms.interval != 0)
+	{
+		pthread_cancel(timerThread);
+	}
+
+	pthread_join(timerThread, NULL);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	return (timerParms.interval == 0 ? 1 : 0);
+}
+
+#endif	/*	End of #if defined (linux) || defined (sol5)		*/
+
 void	sm_SemGive(sm_SemId i)
 {
 	SemaphoreBase	*sembase = _sembase(0);
@@ -1696,6 +1927,11 @@ int	sm_SemTake(sm_SemId i)
 	return needIPC("semaphore");
 }
 
+int	sm_SemTimedTake(sm_SemId i, int seconds)
+{
+	return needIPC("semaphore");
+}
+
 int	sm_SemGive(sm_SemId i)
 {
 	return needIPC("semaphore");
@@ -33,35 +33,42 @@ int	rfx_system_is_started()
 	return (vdb && vdb->clockPid > 0) ? 1 : 0;
 }
 
+/*	IonNodes and IonNeighbors are retained in shared-memory
+ *	red-black trees ordered by node number, so that they can be
+ *	located in O(log n) time while still supporting traversal
+ *	in node number order.						*/
+
+static int	orderNeighbors(PsmPartition partition, PsmAddress nodeData,
+			void *argData)
+{
+	IonNeighbor	*neighbor;
+	unsigned long	nodeNbr = *((unsigned long *) argData);
+
+	neighbor = (IonNeighbor *) psp(partition, nodeData);
+	if (neighbor->nodeNbr < nodeNbr)
+	{
+		return -1;
+	}
+
+	return (neighbor->nodeNbr > nodeNbr) ? 1 : 0;
+}
+
 IonNeighbor	*findNeighbor(IonVdb *ionvdb, unsigned long nodeNbr,
 			PsmAddress *nextElt)
 {
 	PsmPartition	ionwm = getIonwm();
 	PsmAddress	elt;
-	IonNeighbor	*neighbor;
 
 	CHKNULL(ionvdb);
 	CHKNULL(nextElt);
-	for (elt = sm_list_first(ionwm, ionvdb->neighbors); elt;
-			elt = sm_list_next(ionwm, elt))
+	elt = sm_rbt_search(ionwm, ionvdb->neighbors, orderNeighbors,
+			&nodeNbr, nextElt);
+	if (elt == 0)
 	{
-		neighbor = (IonNeighbor *) psp(ionwm, sm_list_data(ionwm, elt));
-		CHKNULL(neighbor);
-		if (neighbor->nodeNbr < nodeNbr)
-		{
-			continue;
-		}
-
-		if (neighbor->nodeNbr > nodeNbr)
-		{
-			break;
-		}
-
-		return neighbor;
+		return NULL;
 	}
 
-	*nextElt = elt;
-	return NULL;
+	return (IonNeighbor *) psp(ionwm, sm_rbt_data(ionwm, elt));
 }
 
 IonNeighbor	*addNeighbor(IonVdb *ionvdb, unsigned long nodeNbr,
@@ -74,6 +81,7 @@ IonNeighbor	*addNeighbor(IonVdb *ionvdb, unsigned long nodeNbr,
 	IonNode		*node;
 	PsmAddress	nextNode;
 
+	CHKNULL(ionvdb);
 	addr = psm_zalloc(ionwm, sizeof(IonNeighbor));
 	if (addr == 0)
 	{
@@ -81,15 +89,11 @@ IonNeighbor	*addNeighbor(IonVdb *ionvdb, unsigned long nodeNbr,
 		return NULL;
 	}
 
-	if (nextElt)
-	{
-		elt = sm_list_insert_before(ionwm, nextElt, addr);
-	}
-	else
-	{
-		elt = sm_list_insert_last(ionwm, ionvdb->neighbors, addr);
-	}
-
+	neighbor = (IonNeighbor *) psp(ionwm, addr);
+	memset((char *) neighbor, 0, sizeof(IonNeighbor));
+	neighbor->nodeNbr = nodeNbr;
+	elt = sm_rbt_insert(ionwm, ionvdb->neighbors, addr, orderNeighbors,
+			&nodeNbr);
 	if (elt == 0)
 	{
 		psm_free(ionwm, addr);
@@ -97,9 +101,6 @@ IonNeighbor	*addNeighbor(IonVdb *ionvdb, unsigned long nodeNbr,
 		return NULL;
 	}
 
-	neighbor = (IonNeighbor *) psp(ionwm, addr);
-	memset((char *) neighbor, 0, sizeof(IonNeighbor));
-	neighbor->nodeNbr = nodeNbr;
 	node = findNode(ionvdb, nodeNbr, &nextNode);
 	if (node == NULL)
 	{
@@ -115,34 +116,36 @@ IonNeighbor	*addNeighbor(IonVdb *ionvdb, unsigned long nodeNbr,
 	return neighbor;
 }
 
+static int	orderNodes(PsmPartition partition, PsmAddress nodeData,
+			void *argData)
+{
+	IonNode		*node;
+	unsigned long	nodeNbr = *((unsigned long *) argData);
+
+	node = (IonNode *) psp(partition, nodeData);
+	if (node->nodeNbr < nodeNbr)
+	{
+		return -1;
+	}
+
+	return (node->nodeNbr > nodeNbr) ? 1 : 0;
+}
+
 IonNode	*findNode(IonVdb *ionvdb, unsigned long nodeNbr, PsmAddress *nextElt)
 {
 	PsmPartition	ionwm = getIonwm();
 	PsmAddress	elt;
-	IonNode		*node;
 
 	CHKNULL(ionvdb);
 	CHKNULL(nextElt);
-	for (elt = sm_list_first(ionwm, ionvdb->nodes); elt;
-			elt = sm_list_next(ionwm, elt))
+	elt = sm_rbt_search(ionwm, ionvdb->nodes, orderNodes, &nodeNbr,
+			nextElt);
+	if (elt == 0)
 	{
-		node = (IonNode *) psp(ionwm, sm_list_data(ionwm, elt));
-		CHKNULL(node);
-		if (node->nodeNbr < nodeNbr)
-		{
-			continue;
-		}
-
-		if (node->nodeNbr > nodeNbr)
-		{
-			break;
-		}
-
-		return node;
+		return NULL;
 	}
 
-	*nextElt = elt;
-	return NULL;
+	return (IonNode *) psp(ionwm, sm_rbt_data(ionwm, elt));
 }
 
 IonNode	*addNode(IonVdb *ionvdb, unsigned long nodeNbr, PsmAddress nextElt)
@@ -152,6 +155,7 @@ IonNode	*addNode(IonVdb *ionvdb, unsigned long nodeNbr, PsmAddress nextElt)
 	PsmAddress	elt;
 	IonNode		*node;
 
+	CHKNULL(ionvdb);
 	addr = psm_zalloc(ionwm, sizeof(IonNode));
 	if (addr == 0)
 	{
@@ -159,15 +163,11 @@ IonNode	*addNode(IonVdb *ionvdb, unsigned long nodeNbr, PsmAddress nextElt)
 		return NULL;
 	}
 
-	if (nextElt)
-	{
-		elt = sm_list_insert_before(ionwm, nextElt, addr);
-	}
-	else
-	{
-		elt = sm_list_insert_last(ionwm, ionvdb->nodes, addr);
-	}
-
+	node = (IonNode *) psp(ionwm, addr);
+	CHKNULL(node);
+	memset((char *) node, 0, sizeof(IonNode));
+	node->nodeNbr = nodeNbr;
+	elt = sm_rbt_insert(ionwm, ionvdb->nodes, addr, orderNodes, &nodeNbr);
 	if (elt == 0)
 	{
 		psm_free(ionwm, addr);
@@ -175,9 +175,6 @@ IonNode	*addNode(IonVdb *ionvdb, unsigned long nodeNbr, PsmAddress nextElt)
 		return NULL;
 	}
 
-	node = (IonNode *) psp(ionwm, addr);
-	CHKNULL(node);
-	node->nodeNbr = nodeNbr;
 	node->xmits = sm_list_create(ionwm);
 	node->origins = sm_list_create(ionwm);
 	node->snubs = sm_list_create(ionwm);
@@ -348,6 +345,7 @@ static int	noteXmit(IonNode *node, IonContact *contact)
 	xmit->fromTime = contact->fromTime;
 	xmit->toTime = contact->toTime;
 	xmit->xmitRate = contact->xmitRate;
+	getIonVdb()->graphVersion++;
 
 	/*	If node is a neighbor, must note this addition in
 	 *	the aggregated capacities of all subsequent xmits
@@ -452,6 +450,7 @@ void	forgetXmit(IonNode *node, IonContact *contact)
 
 	nextElt = sm_list_next(ionwm, elt);
 	oK(sm_list_delete(ionwm, elt, NULL, NULL));
+	getIonVdb()->graphVersion++;
 
 	/*	If node is a neighbor, must note this removal in
 	 *	the aggregated capacities of all subsequent xmits
@@ -709,10 +708,10 @@ int	checkForCongestion()
        	maxForecastInTransit = iondb.currentOccupancy;
 	netGrowthPerSec = iondb.productionRate - iondb.consumptionRate;
 	ionvdb = getIonVdb();
-	for (elt1 = sm_list_first(ionwm, ionvdb->neighbors); elt1;
-			elt1 = sm_list_next(ionwm, elt1))
+	for (elt1 = sm_rbt_first(ionwm, ionvdb->neighbors); elt1;
+			elt1 = sm_rbt_next(ionwm, elt1))
 	{
-		neighbor = (IonNeighbor*) psp(ionwm, sm_list_data(ionwm, elt1));
+		neighbor = (IonNeighbor*) psp(ionwm, sm_rbt_data(ionwm, elt1));
 		CHKERR(neighbor);
 		netGrowthPerSec += neighbor->recvRate;
 		netGrowthPerSec -= neighbor->xmitRate;
@@ -1232,10 +1231,10 @@ static int	setMootAfterTimes()
 
 	/*	First initialize all mootAfter times to max time.	*/
 
-	for (elt = sm_list_first(ionwm, ionvdb->nodes); elt;
-			elt = sm_list_next(ionwm, elt))
+	for (elt = sm_rbt_first(ionwm, ionvdb->nodes); elt;
+			elt = sm_rbt_next(ionwm, elt))
 	{
-		node = (IonNode *) psp(ionwm, sm_list_data(ionwm, elt));
+		node = (IonNode *) psp(ionwm, sm_rbt_data(ionwm, elt));
 		for (elt2 = sm_list_first(ionwm, node->xmits); elt2;
 				elt2 = sm_list_next(ionwm, elt2))
 		{
@@ -1247,10 +1246,10 @@ static int	setMootAfterTimes()
 
 	/*	Now compute new mootAfter times for all contacts.	*/
 
-	for (elt = sm_list_first(ionwm, ionvdb->nodes); elt;
-			elt = sm_list_next(ionwm, elt))
+	for (elt = sm_rbt_first(ionwm, ionvdb->nodes); elt;
+			elt = sm_rbt_next(ionwm, elt))
 	{
-		node = (IonNode *) psp(ionwm, sm_list_data(ionwm, elt));
+		node = (IonNode *) psp(ionwm, sm_rbt_data(ionwm, elt));
 		if (node->nodeNbr == ownNodeNbr)
 		{
 			continue;
@@ -1618,6 +1617,12 @@ Object	rfx_insert_range(time_t fromTime, time_t toTime, unsigned long fromNode,
 		}
 	}
 
+	/*	The new range takes effect in the contact graph when
+	 *	rfxclock next applies the schedule, but any cached
+	 *	routes are invalidated now.				*/
+
+	getIonVdb()->graphVersion++;
+
 	if (sdr_end_xn(sdr) < 0)
 	{
 		putErrmsg("Can't insert range.", NULL);
@@ -1704,6 +1709,7 @@ int	rfx_remove_range(time_t fromTime, unsigned long fromNode,
 
 		sdr_free(sdr, obj);
 		sdr_list_delete(sdr, elt, NULL, NULL);
+		getIonVdb()->graphVersion++;
 		if (sdr_end_xn(sdr) < 0)
 		{
 			putErrmsg("Can't remove range.", NULL);
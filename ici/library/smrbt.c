@@ -0,0 +1,739 @@
+/*
+ *	smrbt.c:	shared-memory red-black tree management.
+ *			Adapted from SDR red-black tree management.
+ *
+ *	Copyright (c) 2010, California Institute of Technology.
+ *	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+ *	acknowledged.
+ *
+ *	This library follows the algorithms presented in Cormen,
+ *	Leiserson, and Rivest, "Introduction to Algorithms" (chapter
+ *	14), adapted to use a null address in place of the sentinel
+ *	leaf node.  Because applications retain the addresses of
+ *	tree nodes, deletion of a node that has two children relinks
+ *	that node's successor into the deleted node's position rather
+ *	than copying the successor's data.  As for shared-memory lists,
+ *	each tree is protected by its own mutex.
+ */
+
+#include "platform.h"
+#include "smrbt.h"
+
+#define	LEFT	0
+#define	RIGHT	1
+
+/* define a tree */
+typedef struct
+{
+	PsmAddress	root;	/*	root node of the tree		*/
+	PsmAddress	first;	/*	node with the least data	*/
+	PsmAddress	last;	/*	node with the greatest data	*/
+	unsigned long	length;	/*	number of nodes in the tree	*/
+	sm_SemId	lock;	/*	mutex for tree			*/
+} SmRbt;
+
+/* define a node of a tree */
+typedef struct
+{
+	PsmAddress	rbt;	/*	tree that this node is in	*/
+	PsmAddress	parent;	/*	parent node in tree		*/
+	PsmAddress	child[2];	/*	left and right subtrees	*/
+	PsmAddress	data;	/*	data for this node		*/
+	int		isRed;	/*	Boolean; if 0, node is black	*/
+} SmRbtNode;
+
+static char	*_noTreeMsg()
+{
+	return "Can't access rbt at address zero.";
+}
+
+static char	*_cannotLockMsg()
+{
+	return "Can't lock rbt.";
+}
+
+static int	lockSmrbt(SmRbt *rbt)
+{
+	return sm_SemTake(rbt->lock);
+}
+
+static void	unlockSmrbt(SmRbt *rbt)
+{
+	sm_SemGive(rbt->lock);
+}
+
+/*	*	*	Private tree navigation functions	*	*/
+
+#define	NODE(addr)	((SmRbtNode *) psp(partition, addr))
+
+static PsmAddress	subtreeExtreme(PsmPartition partition, PsmAddress node,
+				int direction)
+{
+	while (NODE(node)->child[direction])
+	{
+		node = NODE(node)->child[direction];
+	}
+
+	return node;
+}
+
+static PsmAddress	traverse(PsmPartition partition, PsmAddress node,
+				int direction)
+{
+	PsmAddress	parent;
+
+	/*	Direction RIGHT yields the successor of this node,
+	 *	direction LEFT yields the predecessor.			*/
+
+	if (NODE(node)->child[direction])
+	{
+		return subtreeExtreme(partition, NODE(node)->child[direction],
+				1 - direction);
+	}
+
+	for (parent = NODE(node)->parent; parent != 0;
+			parent = NODE(parent)->parent)
+	{
+		if (NODE(parent)->child[direction] != node)
+		{
+			break;
+		}
+
+		node = parent;
+	}
+
+	return parent;
+}
+
+static int	isRed(PsmPartition partition, PsmAddress node)
+{
+	return (node == 0) ? 0 : NODE(node)->isRed;
+}
+
+/*	Replace oldChild with newChild as child of parent.		*/
+
+static void	replaceChild(PsmPartition partition, SmRbt *rbtBuffer,
+			PsmAddress parent, PsmAddress oldChild,
+			PsmAddress newChild)
+{
+	SmRbtNode	*parentBuffer;
+
+	if (parent == 0)
+	{
+		rbtBuffer->root = newChild;
+		return;
+	}
+
+	parentBuffer = NODE(parent);
+	if (parentBuffer->child[LEFT] == oldChild)
+	{
+		parentBuffer->child[LEFT] = newChild;
+	}
+	else
+	{
+		parentBuffer->child[RIGHT] = newChild;
+	}
+}
+
+/*	Rotate node down in the indicated direction, promoting its
+ *	child on the opposite side.					*/
+
+static void	rotate(PsmPartition partition, SmRbt *rbtBuffer,
+			PsmAddress node, int direction)
+{
+	int		other = 1 - direction;
+	SmRbtNode	*nodeBuffer = NODE(node);
+	PsmAddress	pivot = nodeBuffer->child[other];
+	SmRbtNode	*pivotBuffer = NODE(pivot);
+	PsmAddress	grandchild = pivotBuffer->child[direction];
+
+	nodeBuffer->child[other] = grandchild;
+	if (grandchild)
+	{
+		NODE(grandchild)->parent = node;
+	}
+
+	pivotBuffer->parent = nodeBuffer->parent;
+	replaceChild(partition, rbtBuffer, nodeBuffer->parent, node, pivot);
+	pivotBuffer->child[direction] = node;
+	nodeBuffer->parent = pivot;
+}
+
+static void	rebalanceAfterInsertion(PsmPartition partition,
+			SmRbt *rbtBuffer, PsmAddress node)
+{
+	PsmAddress	parent;
+	PsmAddress	grandparent;
+	PsmAddress	uncle;
+	int		direction;
+
+	while (1)
+	{
+		parent = NODE(node)->parent;
+		if (parent == 0)
+		{
+			break;		/*	Node is the root.	*/
+		}
+
+		if (!NODE(parent)->isRed)
+		{
+			break;		/*	No red-red violation.	*/
+		}
+
+		/*	Parent is red, so it can't be the root.		*/
+
+		grandparent = NODE(parent)->parent;
+		direction = (NODE(grandparent)->child[LEFT] == parent)
+				? LEFT : RIGHT;
+		uncle = NODE(grandparent)->child[1 - direction];
+		if (isRed(partition, uncle))
+		{
+			/*	Push blackness down from grandparent.	*/
+
+			NODE(parent)->isRed = 0;
+			NODE(uncle)->isRed = 0;
+			NODE(grandparent)->isRed = 1;
+			node = grandparent;
+			continue;
+		}
+
+		if (NODE(parent)->child[1 - direction] == node)
+		{
+			/*	Node is an inner grandchild; make it
+			 *	an outer grandchild.			*/
+
+			rotate(partition, rbtBuffer, parent, direction);
+			parent = node;
+		}
+
+		NODE(parent)->isRed = 0;
+		NODE(grandparent)->isRed = 1;
+		rotate(partition, rbtBuffer, grandparent, 1 - direction);
+		break;
+	}
+
+	NODE(rbtBuffer->root)->isRed = 0;
+}
+
+static void	rebalanceAfterDeletion(PsmPartition partition,
+			SmRbt *rbtBuffer, PsmAddress node, PsmAddress parent)
+{
+	PsmAddress	sibling;
+	PsmAddress	nearNephew;
+	PsmAddress	farNephew;
+	int		direction;
+
+	/*	Node (which may be null) is "doubly black": the black
+	 *	height of every path through it is one less than that
+	 *	of the paths through its sibling.			*/
+
+	while (node != rbtBuffer->root && !isRed(partition, node))
+	{
+		direction = (NODE(parent)->child[LEFT] == node) ? LEFT : RIGHT;
+		sibling = NODE(parent)->child[1 - direction];
+		if (isRed(partition, sibling))
+		{
+			NODE(sibling)->isRed = 0;
+			NODE(parent)->isRed = 1;
+			rotate(partition, rbtBuffer, parent, direction);
+			sibling = NODE(parent)->child[1 - direction];
+		}
+
+		nearNephew = NODE(sibling)->child[direction];
+		farNephew = NODE(sibling)->child[1 - direction];
+		if (!isRed(partition, nearNephew)
+		&& !isRed(partition, farNephew))
+		{
+			NODE(sibling)->isRed = 1;
+			node = parent;
+			parent = NODE(parent)->parent;
+			continue;
+		}
+
+		if (!isRed(partition, farNephew))
+		{
+			NODE(nearNephew)->isRed = 0;
+			NODE(sibling)->isRed = 1;
+			rotate(partition, rbtBuffer, sibling, 1 - direction);
+			sibling = NODE(parent)->child[1 - direction];
+			farNephew = NODE(sibling)->child[1 - direction];
+		}
+
+		NODE(sibling)->isRed = NODE(parent)->isRed;
+		NODE(parent)->isRed = 0;
+		NODE(farNephew)->isRed = 0;
+		rotate(partition, rbtBuffer, parent, direction);
+		node = rbtBuffer->root;
+		break;
+	}
+
+	if (node)
+	{
+		NODE(node)->isRed = 0;
+	}
+}
+
+/*	*	*	Tree management functions	*	*	*/
+
+PsmAddress	Sm_rbt_create(char *fileName, int lineNbr,
+			PsmPartition partition)
+{
+	sm_SemId	lock;
+	PsmAddress	rbt;
+	SmRbt		*rbtBuffer;
+
+	lock = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+	if (lock < 0)
+	{
+		putErrmsg("Can't create semaphore for rbt.", NULL);
+		return 0;
+	}
+
+	rbt = Psm_zalloc(fileName, lineNbr, partition, sizeof(SmRbt));
+	if (rbt == 0)
+	{
+		sm_SemDelete(lock);
+		putErrmsg("Can't allocate space for rbt.", NULL);
+		return 0;
+	}
+
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	memset((char *) rbtBuffer, 0, sizeof(SmRbt));
+	rbtBuffer->lock = lock;
+	return rbt;
+}
+
+void	sm_rbt_unwedge(PsmPartition partition, PsmAddress rbt, int interval)
+{
+	SmRbt	*rbtBuffer;
+
+	CHKVOID(partition);
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	CHKVOID(rbtBuffer);
+	sm_SemUnwedge(rbtBuffer->lock, interval);
+}
+
+int	Sm_rbt_destroy(char *fileName, int lineNbr, PsmPartition partition,
+		PsmAddress rbt, SmRbtDeleteFn deleteFn, void *arg)
+{
+	SmRbt		*rbtBuffer;
+	PsmAddress	node;
+	SmRbtNode	*nodeBuffer;
+	PsmAddress	parent;
+
+	CHKERR(partition);
+	CHKERR(rbt);
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	if (lockSmrbt(rbtBuffer) < 0)
+	{
+		putErrmsg(_cannotLockMsg(), NULL);
+		return -1;
+	}
+
+	/*	Post-order traversal: free each node after freeing
+	 *	both of its subtrees, without rebalancing.		*/
+
+	node = rbtBuffer->root;
+	while (node)
+	{
+		nodeBuffer = NODE(node);
+		if (nodeBuffer->child[LEFT])
+		{
+			node = nodeBuffer->child[LEFT];
+			continue;
+		}
+
+		if (nodeBuffer->child[RIGHT])
+		{
+			node = nodeBuffer->child[RIGHT];
+			continue;
+		}
+
+		/*	Node is a leaf; detach it from its parent.	*/
+
+		parent = nodeBuffer->parent;
+		replaceChild(partition, rbtBuffer, parent, node, 0);
+		if (deleteFn)
+		{
+			deleteFn(partition, nodeBuffer->data, arg);
+		}
+
+		/* clear in case user mistakenly accesses later... */
+		memset((char *) nodeBuffer, 0, sizeof(SmRbtNode));
+		Psm_free(fileName, lineNbr, partition, node);
+		node = parent;
+	}
+
+	sm_SemDelete(rbtBuffer->lock);
+	memset((char *) rbtBuffer, 0, sizeof(SmRbt));
+	rbtBuffer->lock = SM_SEM_NONE;
+	Psm_free(fileName, lineNbr, partition, rbt);
+	return 0;
+}
+
+long	sm_rbt_length(PsmPartition partition, PsmAddress rbt)
+{
+	SmRbt	*rbtBuffer;
+	long	length;
+
+	CHKERR(partition);
+	CHKERR(rbt);
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	CHKERR(rbtBuffer);
+	if (lockSmrbt(rbtBuffer) == ERROR)
+	{
+		putErrmsg(_cannotLockMsg(), NULL);
+		return -1;
+	}
+
+	length = rbtBuffer->length;
+	unlockSmrbt(rbtBuffer);
+	return length;
+}
+
+PsmAddress	Sm_rbt_insert(char *fileName, int lineNbr,
+			PsmPartition partition, PsmAddress rbt,
+			PsmAddress data, SmRbtCompareFn compare, void *argData)
+{
+	SmRbt		*rbtBuffer;
+	PsmAddress	node;
+	SmRbtNode	*nodeBuffer;
+	PsmAddress	parent;
+	int		direction = LEFT;
+
+	CHKZERO(partition);
+	CHKZERO(compare);
+	if (rbt == 0)
+	{
+		putErrmsg(_noTreeMsg(), NULL);
+		return 0;
+	}
+
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	if (lockSmrbt(rbtBuffer) == ERROR)
+	{
+		putErrmsg(_cannotLockMsg(), NULL);
+		return 0;
+	}
+
+	/*	Find the parent of the new node.  Sort sequence is
+	 *	FIFO within key, as for sorted shared-memory lists:
+	 *	the new node goes to the right of every node with
+	 *	the same key.						*/
+
+	parent = 0;
+	for (node = rbtBuffer->root; node != 0;
+			node = NODE(parent)->child[direction])
+	{
+		parent = node;
+		direction = compare(partition, NODE(parent)->data, argData)
+				<= 0 ? RIGHT : LEFT;
+	}
+
+	/* create new node */
+	node = Psm_zalloc(fileName, lineNbr, partition, sizeof(SmRbtNode));
+	if (node == 0)
+	{
+		unlockSmrbt(rbtBuffer);
+		putErrmsg("Can't allocate space for rbt node.", NULL);
+		return 0;
+	}
+
+	nodeBuffer = NODE(node);
+	memset((char *) nodeBuffer, 0, sizeof(SmRbtNode));
+	nodeBuffer->rbt = rbt;
+	nodeBuffer->parent = parent;
+	nodeBuffer->data = data;
+	nodeBuffer->isRed = 1;
+	if (parent == 0)
+	{
+		rbtBuffer->root = node;
+		rbtBuffer->first = node;
+		rbtBuffer->last = node;
+	}
+	else
+	{
+		NODE(parent)->child[direction] = node;
+		if (direction == LEFT && parent == rbtBuffer->first)
+		{
+			rbtBuffer->first = node;
+		}
+		else if (direction == RIGHT && parent == rbtBuffer->last)
+		{
+			rbtBuffer->last = node;
+		}
+	}
+
+	rbtBuffer->length += 1;
+	rebalanceAfterInsertion(partition, rbtBuffer, node);
+	unlockSmrbt(rbtBuffer);
+	return node;
+}
+
+int	Sm_rbt_delete(char *fileName, int lineNbr, PsmPartition partition,
+		PsmAddress node, SmRbtDeleteFn deleteFn, void *arg)
+{
+	SmRbtNode	*nodeBuffer;
+	PsmAddress	rbt;
+	SmRbt		*rbtBuffer;
+	PsmAddress	spliced;
+	SmRbtNode	*splicedBuffer;
+	PsmAddress	orphan;
+	PsmAddress	orphanParent;
+	int		splicedWasRed;
+	int		i;
+
+	CHKERR(partition);
+	CHKERR(node);
+	nodeBuffer = NODE(node);
+	CHKERR(nodeBuffer);
+	if ((rbt = nodeBuffer->rbt) == 0)
+	{
+		putErrmsg(_noTreeMsg(), NULL);
+		return -1;
+	}
+
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	if (lockSmrbt(rbtBuffer) == ERROR)
+	{
+		putErrmsg(_cannotLockMsg(), NULL);
+		return -1;
+	}
+
+	if (rbtBuffer->length < 1)
+	{
+		unlockSmrbt(rbtBuffer);
+		putErrmsg("rbt node can't be deleted, rbt is empty", NULL);
+		return -1;
+	}
+
+	if (deleteFn)
+	{
+		deleteFn(partition, nodeBuffer->data, arg);
+	}
+
+	if (node == rbtBuffer->first)
+	{
+		rbtBuffer->first = traverse(partition, node, RIGHT);
+	}
+
+	if (node == rbtBuffer->last)
+	{
+		rbtBuffer->last = traverse(partition, node, LEFT);
+	}
+
+	/*	Spliced is the node that is actually removed from its
+	 *	position in the tree: either the deleted node itself
+	 *	(if it has at most one child) or else its successor,
+	 *	which has no left child and which is then relinked
+	 *	into the deleted node's position.			*/
+
+	if (nodeBuffer->child[LEFT] && nodeBuffer->child[RIGHT])
+	{
+		spliced = subtreeExtreme(partition, nodeBuffer->child[RIGHT],
+				LEFT);
+	}
+	else
+	{
+		spliced = node;
+	}
+
+	splicedBuffer = NODE(spliced);
+	orphan = splicedBuffer->child[LEFT] ? splicedBuffer->child[LEFT]
+			: splicedBuffer->child[RIGHT];
+	orphanParent = splicedBuffer->parent;
+	if (orphan)
+	{
+		NODE(orphan)->parent = orphanParent;
+	}
+
+	replaceChild(partition, rbtBuffer, orphanParent, spliced, orphan);
+	splicedWasRed = splicedBuffer->isRed;
+	if (spliced != node)
+	{
+		/*	Move successor into the deleted node's place.	*/
+
+		if (orphanParent == node)
+		{
+			orphanParent = spliced;
+		}
+
+		splicedBuffer->parent = nodeBuffer->parent;
+		splicedBuffer->child[LEFT] = nodeBuffer->child[LEFT];
+		splicedBuffer->child[RIGHT] = nodeBuffer->child[RIGHT];
+		splicedBuffer->isRed = nodeBuffer->isRed;
+		replaceChild(partition, rbtBuffer, nodeBuffer->parent, node,
+				spliced);
+		for (i = LEFT; i <= RIGHT; i++)
+		{
+			if (splicedBuffer->child[i])
+			{
+				NODE(splicedBuffer->child[i])->parent = spliced;
+			}
+		}
+	}
+
+	/* clear in case user accesses later... */
+	memset((char *) nodeBuffer, 0, sizeof(SmRbtNode));
+	Psm_free(fileName, lineNbr, partition, node);
+	rbtBuffer->length -= 1;
+	if (!splicedWasRed)
+	{
+		rebalanceAfterDeletion(partition, rbtBuffer, orphan,
+				orphanParent);
+	}
+
+	unlockSmrbt(rbtBuffer);
+	return 0;
+}
+
+PsmAddress	sm_rbt_rbt(PsmPartition partition, PsmAddress node)
+{
+	SmRbtNode	*nodeBuffer;
+
+	CHKZERO(partition);
+	CHKZERO(node);
+	nodeBuffer = NODE(node);
+	CHKZERO(nodeBuffer);
+	return nodeBuffer->rbt;
+}
+
+PsmAddress	sm_rbt_first(PsmPartition partition, PsmAddress rbt)
+{
+	SmRbt		*rbtBuffer;
+	PsmAddress	first;
+
+	CHKZERO(partition);
+	CHKZERO(rbt);
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	CHKZERO(rbtBuffer);
+	if (lockSmrbt(rbtBuffer) == ERROR)
+	{
+		putErrmsg("Can't get first node.", NULL);
+		return 0;
+	}
+
+	first = rbtBuffer->first;
+	unlockSmrbt(rbtBuffer);
+	return first;
+}
+
+PsmAddress	sm_rbt_last(PsmPartition partition, PsmAddress rbt)
+{
+	SmRbt		*rbtBuffer;
+	PsmAddress	last;
+
+	CHKZERO(partition);
+	CHKZERO(rbt);
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	CHKZERO(rbtBuffer);
+	if (lockSmrbt(rbtBuffer) == ERROR)
+	{
+		putErrmsg("Can't get last node.", NULL);
+		return 0;
+	}
+
+	last = rbtBuffer->last;
+	unlockSmrbt(rbtBuffer);
+	return last;
+}
+
+static PsmAddress	step(PsmPartition partition, PsmAddress node,
+				int direction)
+{
+	SmRbtNode	*nodeBuffer;
+	SmRbt		*rbtBuffer;
+	PsmAddress	neighbor;
+
+	CHKZERO(partition);
+	CHKZERO(node);
+	nodeBuffer = NODE(node);
+	CHKZERO(nodeBuffer);
+	rbtBuffer = (SmRbt *) psp(partition, nodeBuffer->rbt);
+	CHKZERO(rbtBuffer);
+	if (lockSmrbt(rbtBuffer) == ERROR)
+	{
+		putErrmsg(_cannotLockMsg(), NULL);
+		return 0;
+	}
+
+	neighbor = traverse(partition, node, direction);
+	unlockSmrbt(rbtBuffer);
+	return neighbor;
+}
+
+PsmAddress	sm_rbt_next(PsmPartition partition, PsmAddress node)
+{
+	return step(partition, node, RIGHT);
+}
+
+PsmAddress	sm_rbt_prev(PsmPartition partition, PsmAddress node)
+{
+	return step(partition, node, LEFT);
+}
+
+PsmAddress	sm_rbt_search(PsmPartition partition, PsmAddress rbt,
+			SmRbtCompareFn compare, void *arg,
+			PsmAddress *successor)
+{
+	SmRbt		*rbtBuffer;
+	PsmAddress	node;
+	PsmAddress	match = 0;
+	PsmAddress	next = 0;
+	int		result;
+
+	CHKZERO(partition);
+	CHKZERO(rbt);
+	CHKZERO(compare);
+	rbtBuffer = (SmRbt *) psp(partition, rbt);
+	CHKZERO(rbtBuffer);
+	if (lockSmrbt(rbtBuffer) == ERROR)
+	{
+		putErrmsg(_cannotLockMsg(), NULL);
+		return 0;
+	}
+
+	/*	Find the first (leftmost) node whose data matches
+	 *	the argument and, failing that, the first node whose
+	 *	data is greater than the argument.			*/
+
+	for (node = rbtBuffer->root; node != 0; )
+	{
+		result = compare(partition, NODE(node)->data, arg);
+		if (result < 0)
+		{
+			node = NODE(node)->child[RIGHT];
+			continue;
+		}
+
+		if (result == 0)
+		{
+			match = node;
+		}
+		else
+		{
+			next = node;
+		}
+
+		node = NODE(node)->child[LEFT];
+	}
+
+	unlockSmrbt(rbtBuffer);
+	if (successor)
+	{
+		*successor = next;
+	}
+
+	return match;
+}
+
+PsmAddress	sm_rbt_data(PsmPartition partition, PsmAddress node)
+{
+	SmRbtNode	*nodeBuffer;
+
+	CHKZERO(partition);
+	CHKZERO(node);
+	nodeBuffer = NODE(node);
+	CHKZERO(nodeBuffer);
+	return nodeBuffer->data;
+}
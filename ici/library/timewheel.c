@@ -0,0 +1,726 @@
+/*
+
+	timewheel.c:	hierarchical timer wheels.
+
+	Copyright (c) 2010, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+	The wheel comprises TW_LEVELS arrays of slots.  Each slot
+	of level 0 spans one tick (millisecond); each slot of level
+	n spans all of level n-1.  Every slot is the head of a
+	circular, doubly-linked list of timers.  A timer is placed
+	in level 0 if it is due within TW_LEVEL0_SLOTS ticks, else
+	in the lowest level whose range covers its deadline.  Each
+	time level 0 wraps around, the timers in the next slot of
+	level 1 are "cascaded" down into the lower levels, and so
+	on.  Deadlines more distant than the range of the wheel
+	are clamped to that range; such timers are simply cascaded
+	back into the highest level until their deadlines are in
+	range.
+
+	Each timer retains its actual deadline, so cascading never
+	causes a timer to fire early: ticks are derived from
+	deadlines by rounding up.				*/
+
+#include "timewheel.h"
+
+#define	TW_LEVEL0_BITS	(8)
+#define	TW_LEVEL0_SLOTS	(1 << TW_LEVEL0_BITS)
+#define	TW_LEVEL0_MASK	(TW_LEVEL0_SLOTS - 1)
+#define	TW_LEVELN_BITS	(6)
+#define	TW_LEVELN_SLOTS	(1 << TW_LEVELN_BITS)
+#define	TW_LEVELN_MASK	(TW_LEVELN_SLOTS - 1)
+#define	TW_LEVELS	(4)
+#define	TW_TOTAL_BITS	(TW_LEVEL0_BITS + (TW_LEVELN_BITS * (TW_LEVELS - 1)))
+#define	TW_MAX_TICKS	((1UL << TW_TOTAL_BITS) - 1)	/*	~18.6 hrs	*/
+#define	TW_IDLE_USEC	(1000000)
+
+#define	LEVEL_SHIFT(n)	(TW_LEVEL0_BITS + (TW_LEVELN_BITS * ((n) - 1)))
+
+typedef struct twlink_str
+{
+	struct twlink_str	*next;
+	struct twlink_str	*prev;
+} TwLink;
+
+struct twtimer_str
+{
+	TwLink		link;		/*	Must be first.		*/
+	struct timeval	deadline;
+	unsigned long	expires;	/*	Tick.			*/
+	int		level;		/*	-1 if not in a slot.	*/
+	TwTimerFn	function;
+	void		*arg;
+};
+
+struct tw_str
+{
+	pthread_mutex_t	mutex;
+	pthread_cond_t	cv;		/*	Signals alarm thread.	*/
+	pthread_t	alarmThread;
+	sm_SemId	wakeSemaphore;
+	int		stopping;
+	int		alarmed;	/*	Semaphore given.	*/
+
+	unsigned long	now;		/*	Next tick to process.	*/
+	struct timeval	nowTime;	/*	Time of that tick.	*/
+	unsigned long	count;		/*	Timers scheduled.	*/
+	unsigned long	level0Count;	/*	Timers in level 0.	*/
+	TwLink		freeTimers;
+
+	TwLink		level0[TW_LEVEL0_SLOTS];
+	TwLink		levelN[TW_LEVELS - 1][TW_LEVELN_SLOTS];
+};
+
+/*	*	*	Link management		*	*	*	*/
+
+static void	initLink(TwLink *head)
+{
+	head->next = head;
+	head->prev = head;
+}
+
+static int	linkIsEmpty(TwLink *head)
+{
+	return (head->next == head);
+}
+
+static void	appendLink(TwLink *head, TwLink *link)
+{
+	link->prev = head->prev;
+	link->next = head;
+	head->prev->next = link;
+	head->prev = link;
+}
+
+static void	removeLink(TwLink *link)
+{
+	link->prev->next = link->next;
+	link->next->prev = link->prev;
+	initLink(link);
+}
+
+static void	moveLinks(TwLink *from, TwLink *to)
+{
+	initLink(to);
+	if (linkIsEmpty(from))
+	{
+		return;
+	}
+
+	to->next = from->next;
+	to->prev = from->prev;
+	to->next->prev = to;
+	to->prev->next = to;
+	initLink(from);
+}
+
+/*	*	*	Time arithmetic		*	*	*	*	*/
+
+static void	addTicks(struct timeval *time, unsigned long ticks)
+{
+	time->tv_sec += ticks / 1000;
+	time->tv_usec += (ticks % 1000) * 1000;
+	if (time->tv_usec >= 1000000)
+	{
+		time->tv_sec += 1;
+		time->tv_usec -= 1000000;
+	}
+}
+
+/*	Returns the number of ticks from "from" to "to", rounded up
+ *	if roundUp is nonzero and down otherwise, limited to the
+ *	range 0 through TW_MAX_TICKS.					*/
+
+static unsigned long	ticksBetween(struct timeval *from, struct timeval *to,
+				int roundUp)
+{
+	long	sec;
+	long	usec;
+
+	sec = to->tv_sec - from->tv_sec;
+	usec = to->tv_usec - from->tv_usec;
+	if (usec < 0)
+	{
+		sec -= 1;
+		usec += 1000000;
+	}
+
+	if (sec < 0)
+	{
+		return 0;
+	}
+
+	if (sec >= (long) (TW_MAX_TICKS / 1000))
+	{
+		return TW_MAX_TICKS;
+	}
+
+	if (roundUp)
+	{
+		usec += 999;
+	}
+
+	return (sec * 1000) + (usec / 1000);
+}
+
+/*	*	*	Timer placement		*	*	*	*	*/
+
+static void	placeTimer(TimeWheel *wheel, TwTimer *timer)
+{
+	unsigned long	ticks;
+	int		level;
+	TwLink		*slot;
+
+	ticks = ticksBetween(&wheel->nowTime, &timer->deadline, 1);
+	timer->expires = wheel->now + ticks;
+	if (ticks < TW_LEVEL0_SLOTS)
+	{
+		level = 0;
+		wheel->level0Count++;
+		slot = wheel->level0 + (timer->expires & TW_LEVEL0_MASK);
+	}
+	else
+	{
+		for (level = 1; level < TW_LEVELS; level++)
+		{
+			if (ticks < (1UL << LEVEL_SHIFT(level + 1)))
+			{
+				break;
+			}
+		}
+
+		if (level == TW_LEVELS)	/*	Clamped.		*/
+		{
+			level = TW_LEVELS - 1;
+		}
+
+		slot = wheel->levelN[level - 1]
+			+ ((timer->expires >> LEVEL_SHIFT(level))
+				& TW_LEVELN_MASK);
+	}
+
+	timer->level = level;
+	appendLink(slot, &timer->link);
+}
+
+static void	unplaceTimer(TimeWheel *wheel, TwTimer *timer)
+{
+	if (timer->level == 0)
+	{
+		wheel->level0Count--;
+	}
+
+	timer->level = -1;
+	removeLink(&timer->link);
+}
+
+/*	Re-places all timers in the indicated slot of the indicated
+ *	level, relative to the current tick.  Returns the index of
+ *	the slot, which is zero when the next level must in turn be
+ *	cascaded.							*/
+
+static int	cascade(TimeWheel *wheel, int level)
+{
+	int	idx;
+	TwLink	*slot;
+	TwLink	pending;
+	TwLink	*link;
+
+	idx = (wheel->now >> LEVEL_SHIFT(level)) & TW_LEVELN_MASK;
+	slot = wheel->levelN[level - 1] + idx;
+	moveLinks(slot, &pending);
+	while (!linkIsEmpty(&pending))
+	{
+		link = pending.next;
+		unplaceTimer(wheel, (TwTimer *) link);
+		placeTimer(wheel, (TwTimer *) link);
+	}
+
+	return idx;
+}
+
+/*	Advances the current tick by the indicated number of ticks,
+ *	which must not carry it beyond the next wrap of level 0.  On
+ *	each wrap, the timers in the next slot of level 1 (and, as
+ *	necessary, higher levels) are cascaded down immediately, so
+ *	that the current slot of every level above level 0 is always
+ *	empty.								*/
+
+static void	stepTicks(TimeWheel *wheel, unsigned long ticks)
+{
+	int	level;
+
+	wheel->now += ticks;
+	addTicks(&wheel->nowTime, ticks);
+	if ((wheel->now & TW_LEVEL0_MASK) == 0)
+	{
+		for (level = 1; level < TW_LEVELS; level++)
+		{
+			if (cascade(wheel, level) != 0)
+			{
+				break;
+			}
+		}
+	}
+}
+
+/*	Computes the tick at which the earliest timer in the wheel
+ *	comes due.  Within each level, slots are searched in the
+ *	order in which they will be reached, starting with the slot
+ *	following the current one (for level 0, starting with the
+ *	current one); the first non-empty slot at each level holds
+ *	the earliest timers at that level.				*/
+
+static int	nextTicks(TimeWheel *wheel, unsigned long *ticks)
+{
+	int		found = 0;
+	unsigned long	best = 0;
+	unsigned long	delta;
+	int		i;
+	int		level;
+	int		idx;
+	TwLink		*slot;
+	TwLink		*link;
+
+	if (wheel->count == 0)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < TW_LEVEL0_SLOTS; i++)
+	{
+		slot = wheel->level0 + ((wheel->now + i) & TW_LEVEL0_MASK);
+		if (!linkIsEmpty(slot))
+		{
+			best = i;
+			found = 1;
+			break;
+		}
+	}
+
+	for (level = 1; level < TW_LEVELS; level++)
+	{
+		idx = (wheel->now >> LEVEL_SHIFT(level)) & TW_LEVELN_MASK;
+		for (i = 1; i <= TW_LEVELN_SLOTS; i++)
+		{
+			slot = wheel->levelN[level - 1]
+					+ ((idx + i) & TW_LEVELN_MASK);
+			if (linkIsEmpty(slot))
+			{
+				continue;
+			}
+
+			for (link = slot->next; link != slot; link = link->next)
+			{
+				delta = ((TwTimer *) link)->expires - wheel->now;
+				if (found == 0 || delta < best)
+				{
+					best = delta;
+					found = 1;
+				}
+			}
+
+			break;
+		}
+	}
+
+	*ticks = best;
+	return found;
+}
+
+static TwTimer	*takeTimer(TimeWheel *wheel)
+{
+	TwLink	*link;
+
+	if (!linkIsEmpty(&wheel->freeTimers))
+	{
+		link = wheel->freeTimers.next;
+		removeLink(link);
+		return (TwTimer *) link;
+	}
+
+	return (TwTimer *) acquireSystemMemory(sizeof(TwTimer));
+}
+
+static void	releaseTimer(TimeWheel *wheel, TwTimer *timer)
+{
+	appendLink(&wheel->freeTimers, &timer->link);
+}
+
+/*	*	*	Alarm thread		*	*	*	*	*/
+
+static void	*alarmMain(void *parm)
+{
+	TimeWheel	*wheel = (TimeWheel *) parm;
+	unsigned long	ticks;
+	struct timeval	alarmTime;
+	struct timespec	deadline;
+	int		result;
+
+	oK(pthread_mutex_lock(&wheel->mutex));
+	while (wheel->stopping == 0)
+	{
+		/*	Once the semaphore has been given, nothing
+		 *	more is to be done until the wheel has been
+		 *	advanced.					*/
+
+		if (wheel->alarmed || nextTicks(wheel, &ticks) == 0)
+		{
+			oK(pthread_cond_wait(&wheel->cv, &wheel->mutex));
+			continue;
+		}
+
+		alarmTime.tv_sec = wheel->nowTime.tv_sec;
+		alarmTime.tv_usec = wheel->nowTime.tv_usec;
+		addTicks(&alarmTime, ticks);
+		deadline.tv_sec = alarmTime.tv_sec;
+		deadline.tv_nsec = alarmTime.tv_usec * 1000;
+		result = pthread_cond_timedwait(&wheel->cv, &wheel->mutex,
+				&deadline);
+		if (result == ETIMEDOUT && wheel->stopping == 0)
+		{
+			wheel->alarmed = 1;
+			sm_SemGive(wheel->wakeSemaphore);
+		}
+
+		/*	Otherwise the wheel has changed; recompute.	*/
+	}
+
+	oK(pthread_mutex_unlock(&wheel->mutex));
+	return NULL;
+}
+
+static void	signalAlarm(TimeWheel *wheel)
+{
+	if (wheel->wakeSemaphore != SM_SEM_NONE)
+	{
+		oK(pthread_cond_signal(&wheel->cv));
+	}
+}
+
+/*	*	*	Timer wheel API		*	*	*	*	*/
+
+TimeWheel	*tw_create(sm_SemId wakeSemaphore)
+{
+	TimeWheel	*wheel;
+	int		i;
+	int		j;
+
+	wheel = (TimeWheel *) acquireSystemMemory(sizeof(TimeWheel));
+	if (wheel == NULL)
+	{
+		putErrmsg("Can't create timer wheel.", NULL);
+		return NULL;
+	}
+
+	for (i = 0; i < TW_LEVEL0_SLOTS; i++)
+	{
+		initLink(wheel->level0 + i);
+	}
+
+	for (i = 0; i < TW_LEVELS - 1; i++)
+	{
+		for (j = 0; j < TW_LEVELN_SLOTS; j++)
+		{
+			initLink(wheel->levelN[i] + j);
+		}
+	}
+
+	initLink(&wheel->freeTimers);
+	getCurrentTime(&wheel->nowTime);
+	wheel->wakeSemaphore = wakeSemaphore;
+	if (pthread_mutex_init(&wheel->mutex, NULL))
+	{
+		free(wheel);
+		putSysErrmsg("Can't initialize timer wheel mutex", NULL);
+		return NULL;
+	}
+
+	if (pthread_cond_init(&wheel->cv, NULL))
+	{
+		oK(pthread_mutex_destroy(&wheel->mutex));
+		free(wheel);
+		putSysErrmsg("Can't initialize timer wheel cv", NULL);
+		return NULL;
+	}
+
+	if (wakeSemaphore != SM_SEM_NONE)
+	{
+		errno = pthread_create(&wheel->alarmThread, NULL, alarmMain,
+				wheel);
+		if (errno)
+		{
+			oK(pthread_cond_destroy(&wheel->cv));
+			oK(pthread_mutex_destroy(&wheel->mutex));
+			free(wheel);
+			putSysErrmsg("Can't create timer wheel alarm thread",
+					NULL);
+			return NULL;
+		}
+	}
+
+	return wheel;
+}
+
+static void	releaseList(TwLink *head)
+{
+	TwLink	*link;
+
+	while (!linkIsEmpty(head))
+	{
+		link = head->next;
+		removeLink(link);
+		free(link);
+	}
+}
+
+void	tw_destroy(TimeWheel *wheel)
+{
+	int	i;
+	int	j;
+
+	CHKVOID(wheel);
+	if (wheel->wakeSemaphore != SM_SEM_NONE)
+	{
+		oK(pthread_mutex_lock(&wheel->mutex));
+		wheel->stopping = 1;
+		oK(pthread_cond_signal(&wheel->cv));
+		oK(pthread_mutex_unlock(&wheel->mutex));
+		oK(pthread_join(wheel->alarmThread, NULL));
+	}
+
+	for (i = 0; i < TW_LEVEL0_SLOTS; i++)
+	{
+		releaseList(wheel->level0 + i);
+	}
+
+	for (i = 0; i < TW_LEVELS - 1; i++)
+	{
+		for (j = 0; j < TW_LEVELN_SLOTS; j++)
+		{
+			releaseList(wheel->levelN[i] + j);
+		}
+	}
+
+	releaseList(&wheel->freeTimers);
+	oK(pthread_cond_destroy(&wheel->cv));
+	oK(pthread_mutex_destroy(&wheel->mutex));
+	free(wheel);
+}
+
+TwTimer	*tw_insert(TimeWheel *wheel, struct timeval *deadline,
+		TwTimerFn function, void *arg)
+{
+	TwTimer	*timer;
+
+	CHKNULL(wheel);
+	CHKNULL(deadline);
+	CHKNULL(function);
+	oK(pthread_mutex_lock(&wheel->mutex));
+	timer = takeTimer(wheel);
+	if (timer == NULL)
+	{
+		oK(pthread_mutex_unlock(&wheel->mutex));
+		putErrmsg("Can't create timer.", NULL);
+		return NULL;
+	}
+
+	timer->deadline.tv_sec = deadline->tv_sec;
+	timer->deadline.tv_usec = deadline->tv_usec;
+	timer->function = function;
+	timer->arg = arg;
+	placeTimer(wheel, timer);
+	wheel->count++;
+	signalAlarm(wheel);
+	oK(pthread_mutex_unlock(&wheel->mutex));
+	return timer;
+}
+
+TwTimer	*tw_insert_ms(TimeWheel *wheel, unsigned long interval,
+		TwTimerFn function, void *arg)
+{
+	struct timeval	deadline;
+
+	getCurrentTime(&deadline);
+	addTicks(&deadline, interval);
+	return tw_insert(wheel, &deadline, function, arg);
+}
+
+void	tw_cancel(TimeWheel *wheel, TwTimer *timer)
+{
+	CHKVOID(wheel);
+	CHKVOID(timer);
+	oK(pthread_mutex_lock(&wheel->mutex));
+	unplaceTimer(wheel, timer);
+	releaseTimer(wheel, timer);
+	wheel->count--;
+	signalAlarm(wheel);
+	oK(pthread_mutex_unlock(&wheel->mutex));
+}
+
+unsigned long	tw_count(TimeWheel *wheel)
+{
+	unsigned long	count;
+
+	CHKZERO(wheel);
+	oK(pthread_mutex_lock(&wheel->mutex));
+	count = wheel->count;
+	oK(pthread_mutex_unlock(&wheel->mutex));
+	return count;
+}
+
+int	tw_next(TimeWheel *wheel, struct timeval *deadline)
+{
+	unsigned long	ticks;
+	int		result;
+
+	CHKZERO(wheel);
+	CHKZERO(deadline);
+	oK(pthread_mutex_lock(&wheel->mutex));
+	result = nextTicks(wheel, &ticks);
+	if (result)
+	{
+		deadline->tv_sec = wheel->nowTime.tv_sec;
+		deadline->tv_usec = wheel->nowTime.tv_usec;
+		addTicks(deadline, ticks);
+	}
+
+	oK(pthread_mutex_unlock(&wheel->mutex));
+	return result;
+}
+
+int	tw_advance(TimeWheel *wheel)
+{
+	struct timeval	currentTime;
+	unsigned long	ticks;
+	unsigned long	skip;
+	int		idx;
+	TwLink		*slot;
+	TwLink		due;
+	TwLink		*link;
+	TwTimer		*timer;
+	TwTimerFn	function;
+	void		*arg;
+	int		fired = 0;
+
+	CHKZERO(wheel);
+	getCurrentTime(&currentTime);
+	oK(pthread_mutex_lock(&wheel->mutex));
+	wheel->alarmed = 0;
+
+	/*	Process every tick whose time has been reached, i.e.,
+	 *	the current tick and the number of whole ticks that
+	 *	have elapsed since then.				*/
+
+	if (currentTime.tv_sec < wheel->nowTime.tv_sec
+	|| (currentTime.tv_sec == wheel->nowTime.tv_sec
+		&& currentTime.tv_usec < wheel->nowTime.tv_usec))
+	{
+		oK(pthread_mutex_unlock(&wheel->mutex));
+		return 0;		/*	Not yet reached.	*/
+	}
+
+	ticks = ticksBetween(&wheel->nowTime, &currentTime, 0) + 1;
+	while (ticks > 0)
+	{
+		if (wheel->count == 0)	/*	Nothing to process.	*/
+		{
+			wheel->now += ticks;
+			addTicks(&wheel->nowTime, ticks);
+			break;
+		}
+
+		idx = wheel->now & TW_LEVEL0_MASK;
+
+		/*	Skip directly to the next cascade if there
+		 *	are no timers in level 0.			*/
+
+		if (wheel->level0Count == 0)
+		{
+			skip = TW_LEVEL0_SLOTS - idx;
+			if (skip > ticks)
+			{
+				skip = ticks;
+			}
+
+			stepTicks(wheel, skip);
+			ticks -= skip;
+			continue;
+		}
+
+		slot = wheel->level0 + idx;
+		moveLinks(slot, &due);
+		for (link = due.next; link != &due; link = link->next)
+		{
+			((TwTimer *) link)->level = -1;
+			wheel->level0Count--;
+		}
+
+		stepTicks(wheel, 1);
+		ticks--;
+
+		/*	Invoke the due timers' functions with the mutex
+		 *	unlocked, so that they can schedule new timers.	*/
+
+		while (!linkIsEmpty(&due))
+		{
+			link = due.next;
+			removeLink(link);
+			timer = (TwTimer *) link;
+			function = timer->function;
+			arg = timer->arg;
+			releaseTimer(wheel, timer);
+			wheel->count--;
+			oK(pthread_mutex_unlock(&wheel->mutex));
+			function(wheel, arg);
+			fired++;
+			oK(pthread_mutex_lock(&wheel->mutex));
+		}
+	}
+
+	signalAlarm(wheel);
+	oK(pthread_mutex_unlock(&wheel->mutex));
+	return fired;
+}
+
+int	tw_wait(TimeWheel *wheel)
+{
+	struct timeval	currentTime;
+	struct timeval	deadline;
+	unsigned long	ticks;
+
+	CHKERR(wheel);
+	if (wheel->wakeSemaphore != SM_SEM_NONE)
+	{
+		if (sm_SemTake(wheel->wakeSemaphore) < 0)
+		{
+			putErrmsg("Can't take timer wheel semaphore.", NULL);
+			return -1;
+		}
+	}
+	else
+	{
+		if (tw_next(wheel, &deadline))
+		{
+			getCurrentTime(&currentTime);
+			ticks = ticksBetween(&currentTime, &deadline, 1);
+			if (ticks > TW_IDLE_USEC / 1000)
+			{
+				ticks = TW_IDLE_USEC / 1000;
+			}
+
+			if (ticks > 0)
+			{
+				microsnooze(ticks * 1000);
+			}
+		}
+		else
+		{
+			microsnooze(TW_IDLE_USEC);
+		}
+	}
+
+	return tw_advance(wheel);
+}
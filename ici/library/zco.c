@@ -919,46 +919,128 @@ void	zco_concatenate(Sdr sdr, Object aggregateZcoRef, Object atomicZcoRef)
 	zco_destroy_reference(sdr, atomicZcoRef);
 }
 #endif
+static int	readFile(int fd, char *buffer, unsigned int length,
+			unsigned int offset)
+{
+#ifdef VXWORKS
+	if (lseek(fd, offset, SEEK_SET) < 0)
+	{
+		return -1;
+	}
+
+	return read(fd, buffer, length);
+#else
+	return pread(fd, buffer, length, offset);
+#endif
+}
+
+static void	completeFileRead(ZcoReader *reader)
+{
+	int	bytesRead = 0;
+	int	result;
+
+	if (reader->readLength == 0)
+	{
+		return;			/*	No deferred read.	*/
+	}
+
+	if (reader->fileRefObj)
+	{
+		while (bytesRead < reader->readLength)
+		{
+			result = readFile(reader->fd,
+					reader->readBuffer + bytesRead,
+					reader->readLength - bytesRead,
+					reader->readOffset + bytesRead);
+			if (result <= 0)
+			{
+				if (result < 0 && errno == EINTR)
+				{
+					continue;
+				}
+
+				break;
+			}
+
+			bytesRead += result;
+		}
+	}
+
+	/*	On any problem reading from file, write fill.		*/
+
+	if (bytesRead < reader->readLength)
+	{
+		memset(reader->readBuffer + bytesRead, ZCO_FILE_FILL_CHAR,
+				reader->readLength - bytesRead);
+	}
+
+	reader->readLength = 0;
+}
+
+static void	closeFile(ZcoReader *reader)
+{
+	completeFileRead(reader);
+	if (reader->fileRefObj)
+	{
+		close(reader->fd);
+		reader->fileRefObj = 0;
+	}
+}
+
+static void	openFile(Sdr sdr, ZcoReader *reader, Object fileRefObj)
+{
+	FileRef	fileRef;
+
+	closeFile(reader);
+	sdr_read(sdr, (char *) &fileRef, fileRefObj, sizeof(FileRef));
+	reader->fd = open(fileRef.pathName, O_RDONLY, 0);
+	if (reader->fd >= 0)
+	{
+		reader->fileRefObj = fileRefObj;
+	}
+}
+
 static void	copyFromSource(Sdr sdr, char *buffer, SourceExtent *extent,
 			unsigned int bytesToSkip, unsigned int bytesAvbl,
 			ZcoReader *reader, ZcoMedium sourceMedium)
 {
-	FileRef	fileRef;
-	int	fd;
-	int	bytesRead;
+	unsigned int	offset;
 
 	if (sourceMedium == ZcoSdrSource)
 	{
 		sdr_read(sdr, buffer, extent->location
 				+ extent->offset + bytesToSkip, bytesAvbl);
+		return;
 	}
-	else	/*	Source text of ZCO is a file.			*/
+
+	/*	Source text of ZCO is a file.				*/
+
+	offset = extent->offset + bytesToSkip;
+	if (extent->location == reader->fileRefObj)
 	{
-		sdr_read(sdr, (char *) &fileRef, extent->location,
-					sizeof(FileRef));
-		fd = open(fileRef.pathName, O_RDONLY, 0);
-		if (fd >= 0)
+		if (reader->readLength > 0
+		&& reader->readBuffer + reader->readLength == buffer
+		&& reader->readOffset + reader->readLength == offset)
 		{
-			if (lseek(fd, extent->offset + bytesToSkip, SEEK_SET)
-					< 0)
-			{
-				close(fd);
-			}
-			else
-			{
-				bytesRead = read(fd, buffer, bytesAvbl);
-				close(fd);
-				if (bytesRead == bytesAvbl)
-				{
-					return;
-				}
-			}
-		}
+			/*	Contiguous with deferred read.		*/
 
-		/*	On any problem reading from file, write fill.	*/
+			reader->readLength += bytesAvbl;
+			return;
+		}
 
-		memset(buffer, ZCO_FILE_FILL_CHAR, bytesAvbl);
+		completeFileRead(reader);
 	}
+	else
+	{
+		openFile(sdr, reader, extent->location);
+	}
+
+	/*	If the file couldn't be opened, the deferred read will
+	 *	simply write fill.					*/
+
+	reader->readBuffer = buffer;
+	reader->readOffset = offset;
+	reader->readLength = bytesAvbl;
 }
 #if 0
 Object	zco_copy(Sdr sdr, Object zcoRef, ZcoMedium sourceMedium,
@@ -999,9 +1081,7 @@ Object	zco_copy(Sdr sdr, Object zcoRef, ZcoMedium sourceMedium,
 		return 0;
 	}
 
-	reader.reference = 0;		/*	Not needed.		*/
-	reader.fileRefObj = 0;
-	reader.file = NULL;
+	memset((char *) &reader, 0, sizeof(ZcoReader));
 
 	/*	Set up writing of new ZCO.				*/
 
@@ -1176,153 +1256,328 @@ void	zco_start_transmitting(Sdr sdr, Object zcoRef, ZcoReader *reader)
 {
 	CHKVOID(zcoRef);
 	CHKVOID(reader);
+	memset((char *) reader, 0, sizeof(ZcoReader));
 	reader->reference = zcoRef;
 }
 
-int	zco_transmit(Sdr sdr, ZcoReader *reader, unsigned int length,
-		char *buffer)
+/*	A ZcoReader's cursor notes the header capsule, source extent,
+ *	or trailer capsule at which the reader's last read ended and
+ *	the offset at which that element begins, so that each read
+ *	resumes there rather than walking the lists from the start.
+ *	Offsets are within the entire ZCO for transmission and within
+ *	the concatenated extents for reception.  When the ZCO is
+ *	exhausted the cursor stays on its last element, so extents
+ *	appended later are found without rescanning.			*/
+
+#define	ZCO_HEADERS	1
+#define	ZCO_EXTENTS	2
+#define	ZCO_TRAILERS	3
+
+static Object	firstElement(Zco *zco, int section)
 {
-	ZcoReference	ref;
-	Zco		zco;
-	unsigned int	bytesToSkip;
-	unsigned int	bytesToTransmit;
-	int		bytesTransmitted;
-	Object		obj;
-	Capsule		capsule;
-	unsigned int	bytesAvbl;
-	SourceExtent	extent;
+	switch (section)
+	{
+	case ZCO_HEADERS:
+		return zco->firstHeader;
 
-	CHKERR(sdr);
-	CHKERR(reader);
-	CHKERR(length);
-	sdr_stage(sdr, (char *) &ref, reader->reference, sizeof(ZcoReference));
-	sdr_read(sdr, (char *) &zco, ref.zcoObj, sizeof(Zco));
-	bytesToSkip = ref.lengthCopied;
-	bytesToTransmit = length;
-	bytesTransmitted = 0;
+	case ZCO_EXTENTS:
+		return zco->firstExtent;
 
-	/*	Transmit any untransmitted header data.			*/
+	case ZCO_TRAILERS:
+		return zco->firstTrailer;
 
-	for (obj = zco.firstHeader; obj; obj = capsule.nextCapsule)
+	default:
+		return 0;
+	}
+}
+
+static Object	seekElement(Sdr sdr, ZcoReader *reader, Zco *zco,
+			int firstSection, int lastSection,
+			unsigned int position, unsigned int *bytesToSkip,
+			Capsule *capsule, SourceExtent *extent)
+{
+	int		section;
+	Object		obj;
+	unsigned int	start;
+	unsigned int	length;
+	Object		nextObj;
+
+	if (reader->cursorSection >= firstSection
+	&& reader->cursorSection <= lastSection
+	&& position >= reader->cursorStart)
 	{
-		if (bytesToTransmit == 0)	/*	Done.		*/
+		section = reader->cursorSection;
+		obj = reader->cursorObj;
+		start = reader->cursorStart;
+	}
+	else			/*	Must rewind.			*/
+	{
+		reader->cursorSection = 0;
+		section = firstSection;
+		obj = firstElement(zco, section);
+		start = 0;
+	}
+
+	while (1)
+	{
+		if (obj == 0)
 		{
-			break;
+			if (section == lastSection)
+			{
+				return 0;	/*	Past end of ZCO.	*/
+			}
+
+			section++;
+			obj = firstElement(zco, section);
+			continue;
 		}
 
-		sdr_read(sdr, (char *) &capsule, obj, sizeof(Capsule));
-		bytesAvbl = capsule.length;
-		if (bytesToSkip >= bytesAvbl)
+		if (section == ZCO_EXTENTS)
 		{
-			bytesToSkip -= bytesAvbl;
-			continue;	/*	Send none of this one.	*/
+			sdr_read(sdr, (char *) extent, obj,
+					sizeof(SourceExtent));
+			length = extent->length;
+			nextObj = extent->nextExtent;
 		}
-
-		bytesAvbl -= bytesToSkip;
-		if (bytesToTransmit < bytesAvbl)
+		else
 		{
-			bytesAvbl = bytesToTransmit;
+			sdr_read(sdr, (char *) capsule, obj, sizeof(Capsule));
+			length = capsule->length;
+			nextObj = capsule->nextCapsule;
 		}
 
-		if (buffer)
+		reader->cursorSection = section;
+		reader->cursorObj = obj;
+		reader->cursorStart = start;
+		if (position - start < length)
 		{
-			sdr_read(sdr, buffer, capsule.text + bytesToSkip,
-					bytesAvbl);
-			buffer += bytesAvbl;
+			*bytesToSkip = position - start;
+			return obj;
 		}
 
-		bytesToSkip = 0;
-		ref.lengthCopied += bytesAvbl;
-		bytesToTransmit -= bytesAvbl;
-		bytesTransmitted += bytesAvbl;
+		start += length;
+		obj = nextObj;
 	}
+}
 
-	/*	Transmit any untransmitted source data.			*/
+static int	copyFromZco(Sdr sdr, ZcoReader *reader, Zco *zco,
+			unsigned int position, unsigned int length,
+			char *buffer, int sdrOnly)
+{
+	unsigned int	bytesToSkip;
+	unsigned int	bytesToCopy = length;
+	int		bytesCopied = 0;
+	Object		obj;
+	Capsule		capsule;
+	unsigned int	bytesAvbl;
+	SourceExtent	extent;
 
-	for (obj = zco.firstExtent; obj; obj = extent.nextExtent)
+	/*	Copy header data, source data, and trailer data, in
+	 *	that order, starting at "position".			*/
+
+	while (bytesToCopy > 0)
 	{
-		if (bytesToTransmit == 0)	/*	Done.		*/
+		obj = seekElement(sdr, reader, zco, ZCO_HEADERS,
+				ZCO_TRAILERS, position, &bytesToSkip,
+				&capsule, &extent);
+		if (obj == 0)		/*	Nothing left to copy.	*/
 		{
 			break;
 		}
 
-		sdr_read(sdr, (char *) &extent, obj, sizeof(SourceExtent));
-		bytesAvbl = extent.length;
-		if (bytesToSkip >= bytesAvbl)
+		if (reader->cursorSection == ZCO_EXTENTS)
 		{
-			bytesToSkip -= bytesAvbl;
-			continue;	/*	Send none of this one.	*/
-		}
+			if (sdrOnly && extent.sourceMedium == ZcoFileSource)
+			{
+				break;		/*	Stop here.	*/
+			}
+
+			bytesAvbl = extent.length - bytesToSkip;
+			if (bytesToCopy < bytesAvbl)
+			{
+				bytesAvbl = bytesToCopy;
+			}
 
-		bytesAvbl -= bytesToSkip;
-		if (bytesToTransmit < bytesAvbl)
+			if (buffer)
+			{
+				copyFromSource(sdr, buffer, &extent,
+					bytesToSkip, bytesAvbl, reader,
+					extent.sourceMedium);
+			}
+		}
+		else
 		{
-			bytesAvbl = bytesToTransmit;
+			bytesAvbl = capsule.length - bytesToSkip;
+			if (bytesToCopy < bytesAvbl)
+			{
+				bytesAvbl = bytesToCopy;
+			}
+
+			if (buffer)
+			{
+				sdr_read(sdr, buffer, capsule.text
+						+ bytesToSkip, bytesAvbl);
+			}
 		}
 
 		if (buffer)
 		{
-			copyFromSource(sdr, buffer, &extent, bytesToSkip,
-				bytesAvbl, reader, extent.sourceMedium);
 			buffer += bytesAvbl;
 		}
 
-		bytesToSkip = 0;
-		ref.lengthCopied += bytesAvbl;
-		bytesToTransmit -= bytesAvbl;
-		bytesTransmitted += bytesAvbl;
+		position += bytesAvbl;
+		bytesToCopy -= bytesAvbl;
+		bytesCopied += bytesAvbl;
 	}
 
-	/*	Transmit any untransmitted trailer data.		*/
+	completeFileRead(reader);
+	return bytesCopied;
+}
 
-	for (obj = zco.firstTrailer; obj; obj = capsule.nextCapsule)
+static int	transmitZco(Sdr sdr, ZcoReader *reader, unsigned int length,
+			char *buffer, int sdrOnly)
+{
+	ZcoReference	ref;
+	Zco		zco;
+	int		bytesTransmitted;
+
+	CHKERR(sdr);
+	CHKERR(reader);
+	CHKERR(length);
+	sdr_stage(sdr, (char *) &ref, reader->reference, sizeof(ZcoReference));
+	sdr_read(sdr, (char *) &zco, ref.zcoObj, sizeof(Zco));
+	bytesTransmitted = copyFromZco(sdr, reader, &zco, ref.lengthCopied,
+			length, buffer, sdrOnly);
+
+	/*	Update ZcoReference if necessary.			*/
+
+	if (bytesTransmitted > 0)
 	{
-		if (bytesToTransmit == 0)	/*	Done.		*/
-		{
-			break;
-		}
+		ref.lengthCopied += bytesTransmitted;
+		sdr_write(sdr, reader->reference, (char *) &ref,
+				sizeof(ZcoReference));
+	}
 
-		sdr_read(sdr, (char *) &capsule, obj, sizeof(Capsule));
-		bytesAvbl = capsule.length;
-		if (bytesToSkip >= bytesAvbl)
-		{
-			bytesToSkip -= bytesAvbl;
-			continue;	/*	Send none of this one.	*/
-		}
+	return bytesTransmitted;
+}
 
-		bytesAvbl -= bytesToSkip;
-		if (bytesToTransmit < bytesAvbl)
-		{
-			bytesAvbl = bytesToTransmit;
-		}
+int	zco_transmit(Sdr sdr, ZcoReader *reader, unsigned int length,
+		char *buffer)
+{
+	return transmitZco(sdr, reader, length, buffer, 0);
+}
 
-		if (buffer)
+int	zco_transmit_sdr(Sdr sdr, ZcoReader *reader, unsigned int length,
+		char *buffer)
+{
+	CHKERR(buffer);
+	return transmitZco(sdr, reader, length, buffer, 1);
+}
+
+int	zco_transmit_file(Sdr sdr, ZcoReader *reader, unsigned int length,
+		int *fd, unsigned int *offset)
+{
+	ZcoReference	ref;
+	Zco		zco;
+	unsigned int	bytesToSkip;
+	Object		obj;
+	Capsule		capsule;
+	SourceExtent	extent;
+	unsigned int	bytesAvbl;
+
+	CHKERR(sdr);
+	CHKERR(reader);
+	CHKERR(length);
+	CHKERR(fd);
+	CHKERR(offset);
+	sdr_stage(sdr, (char *) &ref, reader->reference, sizeof(ZcoReference));
+	sdr_read(sdr, (char *) &zco, ref.zcoObj, sizeof(Zco));
+
+	/*	Find the element containing the next untransmitted
+	 *	byte; it must be in a file-sourced extent.		*/
+
+	obj = seekElement(sdr, reader, &zco, ZCO_HEADERS, ZCO_TRAILERS,
+			ref.lengthCopied, &bytesToSkip, &capsule, &extent);
+	if (obj == 0 || reader->cursorSection != ZCO_EXTENTS
+	|| extent.sourceMedium != ZcoFileSource)
+	{
+		return 0;	/*	Next byte isn't in a file.	*/
+	}
+
+	if (extent.location != reader->fileRefObj)
+	{
+		openFile(sdr, reader, extent.location);
+		if (reader->fileRefObj == 0)
 		{
-			sdr_read(sdr, buffer, capsule.text + bytesToSkip,
-					bytesAvbl);
-			buffer += bytesAvbl;
+			/*	Can't open the file; let zco_transmit
+			 *	write fill in place of its content.	*/
+
+			return 0;
 		}
+	}
 
-		bytesToSkip = 0;
-		ref.lengthCopied += bytesAvbl;
-		bytesToTransmit -= bytesAvbl;
-		bytesTransmitted += bytesAvbl;
+	bytesAvbl = extent.length - bytesToSkip;
+	if (length < bytesAvbl)
+	{
+		bytesAvbl = length;
 	}
 
-	/*	Update ZcoReference if necessary.			*/
+	*fd = reader->fd;
+	*offset = extent.offset + bytesToSkip;
+	ref.lengthCopied += bytesAvbl;
+	sdr_write(sdr, reader->reference, (char *) &ref, sizeof(ZcoReference));
+	return bytesAvbl;
+}
 
-	if (bytesTransmitted > 0)
+int	zco_read(Sdr sdr, ZcoReader *reader, unsigned int offset,
+		unsigned int length, char *buffer)
+{
+	ZcoReference	ref;
+	Zco		zco;
+
+	CHKERR(sdr);
+	CHKERR(reader);
+	CHKERR(length);
+	CHKERR(buffer);
+	sdr_read(sdr, (char *) &ref, reader->reference, sizeof(ZcoReference));
+	sdr_read(sdr, (char *) &zco, ref.zcoObj, sizeof(Zco));
+	return copyFromZco(sdr, reader, &zco, offset, length, buffer, 0);
+}
+
+int	zco_seek(Sdr sdr, ZcoReader *reader, unsigned int offset)
+{
+	ZcoReference	ref;
+	Zco		zco;
+	unsigned int	bytesToSkip;
+	Capsule		capsule;
+	SourceExtent	extent;
+
+	CHKERR(sdr);
+	CHKERR(reader);
+	sdr_stage(sdr, (char *) &ref, reader->reference, sizeof(ZcoReference));
+	sdr_read(sdr, (char *) &zco, ref.zcoObj, sizeof(Zco));
+	if (offset > zco.totalLength)
+	{
+		putErrmsg("Offset exceeds ZCO length.", utoa(offset));
+		return -1;
+	}
+
+	oK(seekElement(sdr, reader, &zco, ZCO_HEADERS, ZCO_TRAILERS, offset,
+			&bytesToSkip, &capsule, &extent));
+	if (ref.lengthCopied != offset)
 	{
+		ref.lengthCopied = offset;
 		sdr_write(sdr, reader->reference, (char *) &ref,
 				sizeof(ZcoReference));
 	}
 
-	return bytesTransmitted;
+	return 0;
 }
 
 void	zco_stop_transmitting(Sdr sdr, ZcoReader *reader)
 {
-	return;		/*	For backward compatibility.		*/
+	CHKVOID(reader);
+	closeFile(reader);
 }
 
 /*	Functions for delivery to overlying protocol or application
@@ -1332,6 +1587,7 @@ void	zco_start_receiving(Sdr sdr, Object zcoRef, ZcoReader *reader)
 {
 	CHKVOID(zcoRef);
 	CHKVOID(reader);
+	memset((char *) reader, 0, sizeof(ZcoReader));
 	reader->reference = zcoRef;
 }
 
@@ -1352,20 +1608,19 @@ int	zco_receive_headers(Sdr sdr, ZcoReader *reader, unsigned int length,
 	CHKERR(length > 0);
 	sdr_stage(sdr, (char *) &ref, reader->reference, sizeof(ZcoReference));
 	sdr_stage(sdr, (char *) &zco, ref.zcoObj, sizeof(Zco));
-	bytesToSkip = ref.headersLengthCopied;
 	bytesToReceive = length;
 	bytesReceived = 0;
-	for (obj = zco.firstExtent; obj; obj = extent.nextExtent)
+	while (bytesToReceive > 0)
 	{
-		sdr_read(sdr, (char *) &extent, obj, sizeof(SourceExtent));
-		bytesAvbl = extent.length;
-		if (bytesToSkip >= bytesAvbl)
+		obj = seekElement(sdr, reader, &zco, ZCO_EXTENTS, ZCO_EXTENTS,
+				ref.headersLengthCopied, &bytesToSkip, NULL,
+				&extent);
+		if (obj == 0)
 		{
-			bytesToSkip -= bytesAvbl;
-			continue;	/*	Take none of this one.	*/
+			break;
 		}
 
-		bytesAvbl -= bytesToSkip;
+		bytesAvbl = extent.length - bytesToSkip;
 		if (bytesToReceive < bytesAvbl)
 		{
 			bytesAvbl = bytesToReceive;
@@ -1378,8 +1633,6 @@ int	zco_receive_headers(Sdr sdr, ZcoReader *reader, unsigned int length,
 			buffer += bytesAvbl;
 		}
 
-		bytesToSkip = 0;
-
 		/*	Reading a header implicitly asserts an
 		 *	increase in aggregate header length and a
 		 *	decrease in source data length.			*/
@@ -1392,12 +1645,10 @@ int	zco_receive_headers(Sdr sdr, ZcoReader *reader, unsigned int length,
 		ref.headersLengthCopied += bytesAvbl;
 		bytesToReceive -= bytesAvbl;
 		bytesReceived += bytesAvbl;
-		if (bytesToReceive == 0)	/*	Done.		*/
-		{
-			break;
-		}
 	}
 
+	completeFileRead(reader);
+
 	/*	Update Zco and ZcoReference if necessary.		*/
 
 	if (bytesReceived > 0)
@@ -1489,25 +1740,19 @@ int	zco_receive_source(Sdr sdr, ZcoReader *reader, unsigned int length,
 	CHKERR(length);
 	sdr_stage(sdr, (char *) &ref, reader->reference, sizeof(ZcoReference));
 	sdr_read(sdr, (char *) &zco, ref.zcoObj, sizeof(Zco));
-	bytesToSkip = zco.headersLength + ref.sourceLengthCopied;
 	bytesToReceive = length;
 	bytesReceived = 0;
-	for (obj = zco.firstExtent; obj; obj = extent.nextExtent)
+	while (bytesToReceive > 0)
 	{
-		if (bytesToReceive == 0)	/*	Done.		*/
+		obj = seekElement(sdr, reader, &zco, ZCO_EXTENTS, ZCO_EXTENTS,
+				zco.headersLength + ref.sourceLengthCopied,
+				&bytesToSkip, NULL, &extent);
+		if (obj == 0)
 		{
 			break;
 		}
 
-		sdr_read(sdr, (char *) &extent, obj, sizeof(SourceExtent));
-		bytesAvbl = extent.length;
-		if (bytesToSkip >= bytesAvbl)
-		{
-			bytesToSkip -= bytesAvbl;
-			continue;	/*	Take none of this one.	*/
-		}
-
-		bytesAvbl -= bytesToSkip;
+		bytesAvbl = extent.length - bytesToSkip;
 		if (bytesToReceive < bytesAvbl)
 		{
 			bytesAvbl = bytesToReceive;
@@ -1516,12 +1761,10 @@ int	zco_receive_source(Sdr sdr, ZcoReader *reader, unsigned int length,
 		if (buffer)
 		{
 			copyFromSource(sdr, buffer, &extent, bytesToSkip,
-				bytesAvbl, reader, extent.sourceMedium);
+					bytesAvbl, reader, extent.sourceMedium);
 			buffer += bytesAvbl;
 		}
 
-		bytesToSkip = 0;
-
 		/*	Note bytes copied.				*/
 
 		ref.sourceLengthCopied += bytesAvbl;
@@ -1529,6 +1772,8 @@ int	zco_receive_source(Sdr sdr, ZcoReader *reader, unsigned int length,
 		bytesReceived += bytesAvbl;
 	}
 
+	completeFileRead(reader);
+
 	/*	Update ZcoReference if necessary.			*/
 
 	if (bytesReceived > 0)
@@ -1557,21 +1802,20 @@ int	zco_receive_trailers(Sdr sdr, ZcoReader *reader, unsigned int length,
 	CHKERR(length > 0);
 	sdr_stage(sdr, (char *) &ref, reader->reference, sizeof(ZcoReference));
 	sdr_read(sdr, (char *) &zco, ref.zcoObj, sizeof(Zco));
-	bytesToSkip = zco.headersLength + zco.sourceLength
-			+ ref.trailersLengthCopied;
 	bytesToReceive = length;
 	bytesReceived = 0;
-	for (obj = zco.firstExtent; obj; obj = extent.nextExtent)
+	while (bytesToReceive > 0)
 	{
-		sdr_read(sdr, (char *) &extent, obj, sizeof(SourceExtent));
-		bytesAvbl = extent.length;
-		if (bytesToSkip >= bytesAvbl)
+		obj = seekElement(sdr, reader, &zco, ZCO_EXTENTS, ZCO_EXTENTS,
+				zco.headersLength + zco.sourceLength
+				+ ref.trailersLengthCopied, &bytesToSkip,
+				NULL, &extent);
+		if (obj == 0)
 		{
-			bytesToSkip -= bytesAvbl;
-			continue;	/*	Take none of this one.	*/
+			break;
 		}
 
-		bytesAvbl -= bytesToSkip;
+		bytesAvbl = extent.length - bytesToSkip;
 		if (bytesToReceive < bytesAvbl)
 		{
 			bytesAvbl = bytesToReceive;
@@ -1584,19 +1828,15 @@ int	zco_receive_trailers(Sdr sdr, ZcoReader *reader, unsigned int length,
 			buffer += bytesAvbl;
 		}
 
-		bytesToSkip = 0;
-
 		/*	Note bytes copied.				*/
 
 		ref.trailersLengthCopied += bytesAvbl;
 		bytesToReceive -= bytesAvbl;
 		bytesReceived += bytesAvbl;
-		if (bytesToReceive == 0)	/*	Done.		*/
-		{
-			break;
-		}
 	}
 
+	completeFileRead(reader);
+
 	/*	Update ZcoReference if necessary.			*/
 
 	if (bytesReceived > 0)
@@ -1610,7 +1850,8 @@ int	zco_receive_trailers(Sdr sdr, ZcoReader *reader, unsigned int length,
 
 void	zco_stop_receiving(Sdr sdr, ZcoReader *reader)
 {
-	return;		/*	For backward compatibility.		*/
+	CHKVOID(reader);
+	closeFile(reader);
 }
 
 void	zco_strip(Sdr sdr, Object zcoRef)
@@ -44,6 +44,26 @@
 
 #define	INITIALIZED	(0x99999999)
 
+/*	For SDR_BUFFERED databases, the size of the transaction log
+ *	buffer in SDR working memory.  A log entry that would overflow
+ *	the buffer causes the buffer to be flushed to the log file;
+ *	a log entry larger than the buffer is written directly.	Dirty
+ *	extents of the db file that are separated by no more than
+ *	SDR_EXTENT_GAP bytes are coalesced into a single write.	*/
+
+#ifndef SDR_LOG_BUFFER_SIZE
+#define	SDR_LOG_BUFFER_SIZE	(32768)
+#endif
+
+#ifndef SDR_EXTENT_GAP
+#define	SDR_EXTENT_GAP		(256)
+#endif
+
+/*	The heap of an SDR is directly addressable, at sdrv->dbsm, if
+ *	it resides in shared memory or if its db file is mapped.	*/
+
+#define	HEAP_IN_MEMORY(flags)	((flags) & (SDR_IN_DRAM | SDR_MAPPED))
+
 /*	Memory management abstraction.					*/
 #define MTAKE(size)	allocFromSdrMemory(__FILE__, __LINE__, size)
 #define MRELEASE(addr)	releaseToSdrMemory(__FILE__, __LINE__, addr)
@@ -72,6 +92,17 @@ typedef struct
  *	a single SDR.  It resides in SDR working memory (a shared
  *	memory partition), in the control header's list of sdrs.	*/
 
+#ifndef SDR_MAX_READERS
+#define	SDR_MAX_READERS		(16)
+#endif
+
+typedef struct
+{
+	int		readerTask;		/*	task ID		*/
+	pthread_t	readerThread;		/*	thread ID	*/
+	int		readDepth;		/*	0 = slot free	*/
+} SdrReader;
+
 typedef struct sdr_str
 {
 		/*	General SDR operational parameters.	*/
@@ -92,6 +123,26 @@ typedef struct sdr_str
 	int		xnDepth;
 	int		xnCanceled;		/*	boolean		*/
 
+		/*	Shared read-only access.		*/
+
+	sm_SemId	readerSemaphore;	/*	Guards readers.	*/
+	sm_SemId	drainSemaphore;		/*	Held by readers.*/
+	int		readerCount;
+	SdrReader	readers[SDR_MAX_READERS];
+
+		/*	Buffered log (SDR_BUFFERED only).	*/
+
+	PsmAddress	logBuffer;		/*	In SDR wm.	*/
+	long		logBufferLength;	/*	Unflushed.	*/
+
+		/*	Group commit (SDR_SYNCED only).		*/
+
+	sm_SemId	syncSemaphore;
+	long		maxCommitLatency;	/*	usec		*/
+	unsigned long	commitCount;
+	unsigned long	syncedCommitCount;	/*	Durable.	*/
+	unsigned long	syncCount;
+
 		/*	SDR trace data access.			*/
 
 	int		traceKey;
@@ -142,14 +193,17 @@ typedef struct sdrv_str
 {
 	SdrState	*sdr;		/*	local SDR state access	*/
 	int		dbfile;		/*	SDR in file (fd).	*/
-	char		*dbsm;		/*	SDR in shared memory.	*/
+	char		*dbsm;		/*	SDR in memory or mapped.*/
 	int		dbsmId;		/*	DRAM database shmId	*/
 
 	int		logfile;	/*	Xn log file (fd).	*/
 	int		logfileLength;
+	int		logfileWritten;	/*	Boolean.		*/
 	Lyst		logEntries;	/*	Offsets in log file.	*/
 	Lyst		knownObjects;	/*	ObjectExtents.		*/
-	int		modified;	/*	Boolean.		*/
+	Lyst		dirtyExtents;	/*	Unwritten db extents.	*/
+	int		modified;	/*	Since latest begin_xn.	*/
+	int		updated;	/*	Since start of xn.	*/
 
 	PsmView		traceArea;	/*	local access to trace	*/
 	PsmView		*trace;		/*	local access to trace	*/
@@ -201,7 +201,7 @@ Object	sdr_read_catlg(Sdr sdrv, char *name, int *type, Object *object,
 	Object		elt;
 	CatalogueEntry	entry;
 
-	CHKZERO(sdr_in_xn(sdrv));
+	CHKZERO(sdr_in_read(sdrv));
 	sdr = sdrv->sdr;
 	if (prev_elt == 0)
 	{
@@ -0,0 +1,848 @@
+/*
+ *	sdrrbt.c:	simple data recorder red-black tree management
+ *			library.
+ *
+ *	Copyright (c) 2010, California Institute of Technology.
+ *	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+ *	acknowledged.
+ *
+ *	This library implements the Simple Data Recorder system's
+ *	red-black trees, following the algorithms presented in
+ *	Cormen, Leiserson, and Rivest, "Introduction to Algorithms"
+ *	(chapter 14), adapted to use a null Object in place of the
+ *	sentinel leaf node.  Because applications retain the
+ *	addresses of tree nodes, deletion of a node that has two
+ *	children relinks that node's successor into the deleted
+ *	node's position rather than copying the successor's data.
+ */
+
+#include "sdrP.h"
+#include "sdrrbt.h"
+
+#define	LEFT	0
+#define	RIGHT	1
+
+/*		Private definitions of SDR red-black tree structures.	*/
+
+typedef struct
+{
+	Object		root;	/*	root node of the tree		*/
+	Object		first;	/*	node with the least data	*/
+	Object		last;	/*	node with the greatest data	*/
+	unsigned long	length;	/*	number of nodes in the tree	*/
+} SdrRbt;
+
+typedef struct
+{
+	Object		rbt;	/*	tree that this node is in	*/
+	Object		parent;	/*	parent node in tree		*/
+	Object		child[2];	/*	left and right subtrees	*/
+	Object		data;	/*	data for this node		*/
+	int		isRed;	/*	Boolean; if 0, node is black	*/
+} SdrRbtNode;
+
+/*	*	*	Private tree navigation functions	*	*/
+
+static Object	subtreeExtreme(Sdr sdrv, Object node, int direction)
+{
+	SdrRbtNode	nodeBuffer;
+
+	while (1)
+	{
+		sdrFetch(nodeBuffer, (Address) node);
+		if (nodeBuffer.child[direction] == 0)
+		{
+			return node;
+		}
+
+		node = nodeBuffer.child[direction];
+	}
+}
+
+static Object	traverse(Sdr sdrv, Object node, int direction)
+{
+	SdrRbtNode	nodeBuffer;
+	Object		parent;
+	SdrRbtNode	parentBuffer;
+
+	/*	Direction RIGHT yields the successor of this node,
+	 *	direction LEFT yields the predecessor.			*/
+
+	sdrFetch(nodeBuffer, (Address) node);
+	if (nodeBuffer.child[direction])
+	{
+		return subtreeExtreme(sdrv, nodeBuffer.child[direction],
+				1 - direction);
+	}
+
+	for (parent = nodeBuffer.parent; parent != 0;
+			parent = parentBuffer.parent)
+	{
+		sdrFetch(parentBuffer, (Address) parent);
+		if (parentBuffer.child[direction] != node)
+		{
+			break;
+		}
+
+		node = parent;
+	}
+
+	return parent;
+}
+
+static int	isRed(Sdr sdrv, Object node)
+{
+	SdrRbtNode	nodeBuffer;
+
+	if (node == 0)
+	{
+		return 0;	/*	Null leaves are black.		*/
+	}
+
+	sdrFetch(nodeBuffer, (Address) node);
+	return nodeBuffer.isRed;
+}
+
+static void	setColor(char *file, int line, Sdr sdrv, Object node,
+			int red)
+{
+	SdrRbtNode	nodeBuffer;
+
+	sdrFetch(nodeBuffer, (Address) node);
+	nodeBuffer.isRed = red;
+	sdrPut((Address) node, nodeBuffer);
+}
+
+/*	Replace oldChild with newChild as child of parent.		*/
+
+static void	replaceChild(char *file, int line, Sdr sdrv,
+			SdrRbt *rbtBuffer, Object parent, Object oldChild,
+			Object newChild)
+{
+	SdrRbtNode	parentBuffer;
+
+	if (parent == 0)
+	{
+		rbtBuffer->root = newChild;
+		return;
+	}
+
+	sdrFetch(parentBuffer, (Address) parent);
+	if (parentBuffer.child[LEFT] == oldChild)
+	{
+		parentBuffer.child[LEFT] = newChild;
+	}
+	else
+	{
+		parentBuffer.child[RIGHT] = newChild;
+	}
+
+	sdrPut((Address) parent, parentBuffer);
+}
+
+/*	Rotate node down in the indicated direction, promoting its
+ *	child on the opposite side.					*/
+
+static void	rotate(char *file, int line, Sdr sdrv, SdrRbt *rbtBuffer,
+			Object node, int direction)
+{
+	int		other = 1 - direction;
+	SdrRbtNode	nodeBuffer;
+	Object		pivot;
+	SdrRbtNode	pivotBuffer;
+	Object		grandchild;
+	SdrRbtNode	grandchildBuffer;
+
+	sdrFetch(nodeBuffer, (Address) node);
+	pivot = nodeBuffer.child[other];
+	sdrFetch(pivotBuffer, (Address) pivot);
+	grandchild = pivotBuffer.child[direction];
+	nodeBuffer.child[other] = grandchild;
+	if (grandchild)
+	{
+		sdrFetch(grandchildBuffer, (Address) grandchild);
+		grandchildBuffer.parent = node;
+		sdrPut((Address) grandchild, grandchildBuffer);
+	}
+
+	pivotBuffer.parent = nodeBuffer.parent;
+	replaceChild(file, line, sdrv, rbtBuffer, nodeBuffer.parent, node,
+			pivot);
+	pivotBuffer.child[direction] = node;
+	nodeBuffer.parent = pivot;
+	sdrPut((Address) node, nodeBuffer);
+	sdrPut((Address) pivot, pivotBuffer);
+}
+
+static void	rebalanceAfterInsertion(char *file, int line, Sdr sdrv,
+			SdrRbt *rbtBuffer, Object node)
+{
+	SdrRbtNode	nodeBuffer;
+	Object		parent;
+	SdrRbtNode	parentBuffer;
+	Object		grandparent;
+	SdrRbtNode	grandparentBuffer;
+	Object		uncle;
+	int		direction;
+
+	while (1)
+	{
+		sdrFetch(nodeBuffer, (Address) node);
+		parent = nodeBuffer.parent;
+		if (parent == 0)
+		{
+			break;		/*	Node is the root.	*/
+		}
+
+		sdrFetch(parentBuffer, (Address) parent);
+		if (!parentBuffer.isRed)
+		{
+			break;		/*	No red-red violation.	*/
+		}
+
+		/*	Parent is red, so it can't be the root.		*/
+
+		grandparent = parentBuffer.parent;
+		sdrFetch(grandparentBuffer, (Address) grandparent);
+		direction = (grandparentBuffer.child[LEFT] == parent)
+				? LEFT : RIGHT;
+		uncle = grandparentBuffer.child[1 - direction];
+		if (isRed(sdrv, uncle))
+		{
+			/*	Push blackness down from grandparent.	*/
+
+			setColor(file, line, sdrv, parent, 0);
+			setColor(file, line, sdrv, uncle, 0);
+			setColor(file, line, sdrv, grandparent, 1);
+			node = grandparent;
+			continue;
+		}
+
+		if (parentBuffer.child[1 - direction] == node)
+		{
+			/*	Node is an inner grandchild; make it
+			 *	an outer grandchild.			*/
+
+			rotate(file, line, sdrv, rbtBuffer, parent, direction);
+			parent = node;
+		}
+
+		setColor(file, line, sdrv, parent, 0);
+		setColor(file, line, sdrv, grandparent, 1);
+		rotate(file, line, sdrv, rbtBuffer, grandparent,
+				1 - direction);
+		break;
+	}
+
+	if (isRed(sdrv, rbtBuffer->root))
+	{
+		setColor(file, line, sdrv, rbtBuffer->root, 0);
+	}
+}
+
+static void	rebalanceAfterDeletion(char *file, int line, Sdr sdrv,
+			SdrRbt *rbtBuffer, Object node, Object parent)
+{
+	SdrRbtNode	parentBuffer;
+	Object		sibling;
+	SdrRbtNode	siblingBuffer;
+	Object		nearNephew;
+	Object		farNephew;
+	int		direction;
+
+	/*	Node (which may be null) is "doubly black": the black
+	 *	height of every path through it is one less than that
+	 *	of the paths through its sibling.			*/
+
+	while (node != rbtBuffer->root && !isRed(sdrv, node))
+	{
+		sdrFetch(parentBuffer, (Address) parent);
+		direction = (parentBuffer.child[LEFT] == node) ? LEFT : RIGHT;
+		sibling = parentBuffer.child[1 - direction];
+		if (isRed(sdrv, sibling))
+		{
+			setColor(file, line, sdrv, sibling, 0);
+			setColor(file, line, sdrv, parent, 1);
+			rotate(file, line, sdrv, rbtBuffer, parent, direction);
+			sdrFetch(parentBuffer, (Address) parent);
+			sibling = parentBuffer.child[1 - direction];
+		}
+
+		sdrFetch(siblingBuffer, (Address) sibling);
+		nearNephew = siblingBuffer.child[direction];
+		farNephew = siblingBuffer.child[1 - direction];
+		if (!isRed(sdrv, nearNephew) && !isRed(sdrv, farNephew))
+		{
+			setColor(file, line, sdrv, sibling, 1);
+			node = parent;
+			parent = parentBuffer.parent;
+			continue;
+		}
+
+		if (!isRed(sdrv, farNephew))
+		{
+			setColor(file, line, sdrv, nearNephew, 0);
+			setColor(file, line, sdrv, sibling, 1);
+			rotate(file, line, sdrv, rbtBuffer, sibling,
+					1 - direction);
+			sdrFetch(parentBuffer, (Address) parent);
+			sibling = parentBuffer.child[1 - direction];
+			sdrFetch(siblingBuffer, (Address) sibling);
+			farNephew = siblingBuffer.child[1 - direction];
+		}
+
+		setColor(file, line, sdrv, sibling, parentBuffer.isRed);
+		setColor(file, line, sdrv, parent, 0);
+		setColor(file, line, sdrv, farNephew, 0);
+		rotate(file, line, sdrv, rbtBuffer, parent, direction);
+		node = rbtBuffer->root;
+		break;
+	}
+
+	if (node)
+	{
+		setColor(file, line, sdrv, node, 0);
+	}
+}
+
+/*	*	*	Tree management functions	*	*	*/
+
+Object	Sdr_rbt_create(char *file, int line, Sdr sdrv)
+{
+	Object	rbt;
+	SdrRbt	rbtBuffer;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return 0;
+	}
+
+	joinTrace(sdrv, file, line);
+	rbt = _sdrzalloc(sdrv, sizeof(SdrRbt));
+	if (rbt == 0)
+	{
+		oK(_iEnd(file, line, "rbt"));
+		return 0;
+	}
+
+	memset((char *) &rbtBuffer, 0, sizeof(SdrRbt));
+	sdrPut((Address) rbt, rbtBuffer);
+	return rbt;
+}
+
+void	Sdr_rbt_destroy(char *file, int line, Sdr sdrv, Object rbt,
+		SdrRbtDeleteFn deleteFn, void *arg)
+{
+	SdrRbt		rbtBuffer;
+	Object		node;
+	SdrRbtNode	nodeBuffer;
+	Object		parent;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (rbt == 0)
+	{
+		oK(_xniEnd(file, line, "rbt", sdrv));
+		return;
+	}
+
+	/*	Post-order traversal: free each node after freeing
+	 *	both of its subtrees, without rebalancing.		*/
+
+	sdrFetch(rbtBuffer, (Address) rbt);
+	node = rbtBuffer.root;
+	while (node)
+	{
+		sdrFetch(nodeBuffer, (Address) node);
+		if (nodeBuffer.child[LEFT])
+		{
+			node = nodeBuffer.child[LEFT];
+			continue;
+		}
+
+		if (nodeBuffer.child[RIGHT])
+		{
+			node = nodeBuffer.child[RIGHT];
+			continue;
+		}
+
+		/*	Node is a leaf; detach it from its parent.	*/
+
+		parent = nodeBuffer.parent;
+		replaceChild(file, line, sdrv, &rbtBuffer, parent, node, 0);
+		if (deleteFn)
+		{
+			deleteFn(sdrv, nodeBuffer.data, arg);
+		}
+
+		/* just in case user mistakenly accesses later... */
+		memset((char *) &nodeBuffer, 0, sizeof(SdrRbtNode));
+		sdrPut((Address) node, nodeBuffer);
+		sdrFree(node);
+		node = parent;
+	}
+
+	/* just in case user mistakenly accesses later... */
+	memset((char *) &rbtBuffer, 0, sizeof(SdrRbt));
+	sdrPut((Address) rbt, rbtBuffer);
+	sdrFree(rbt);
+}
+
+long	sdr_rbt_length(Sdr sdrv, Object rbt)
+{
+	SdrState	*sdr;
+	SdrRbt		rbtBuffer;
+
+	CHKERR(sdrv);
+	CHKERR(rbt);
+	sdr = sdrv->sdr;
+	CHKERR(takeSdr(sdr) == 0);
+	sdrFetch(rbtBuffer, (Address) rbt);
+	releaseSdr(sdr);
+	return rbtBuffer.length;
+}
+
+Object	Sdr_rbt_insert(char *file, int line, Sdr sdrv, Object rbt,
+		Address data, SdrRbtCompareFn compare, void *argData)
+{
+	SdrRbt		rbtBuffer;
+	Object		node;
+	SdrRbtNode	nodeBuffer;
+	Object		parent;
+	SdrRbtNode	parentBuffer;
+	int		direction = LEFT;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return 0;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (rbt == 0 || compare == NULL)
+	{
+		oK(_xniEnd(file, line, _apiErrMsg(), sdrv));
+		return 0;
+	}
+
+	/*	Find the parent of the new node.  Sort sequence is
+	 *	FIFO within key, as for sorted SDR lists: the new node
+	 *	goes to the right of every node with the same key.	*/
+
+	sdrFetch(rbtBuffer, (Address) rbt);
+	parent = 0;
+	for (node = rbtBuffer.root; node != 0;
+			node = parentBuffer.child[direction])
+	{
+		parent = node;
+		sdrFetch(parentBuffer, (Address) parent);
+		direction = compare(sdrv, parentBuffer.data, argData) <= 0
+				? RIGHT : LEFT;
+	}
+
+	/* create new node */
+	node = _sdrzalloc(sdrv, sizeof(SdrRbtNode));
+	if (node == 0)
+	{
+		oK(_iEnd(file, line, "node"));
+		return 0;
+	}
+
+	memset((char *) &nodeBuffer, 0, sizeof(SdrRbtNode));
+	nodeBuffer.rbt = rbt;
+	nodeBuffer.parent = parent;
+	nodeBuffer.data = data;
+	nodeBuffer.isRed = 1;
+	sdrPut((Address) node, nodeBuffer);
+	if (parent == 0)
+	{
+		rbtBuffer.root = node;
+		rbtBuffer.first = node;
+		rbtBuffer.last = node;
+	}
+	else
+	{
+		parentBuffer.child[direction] = node;
+		sdrPut((Address) parent, parentBuffer);
+		if (direction == LEFT && parent == rbtBuffer.first)
+		{
+			rbtBuffer.first = node;
+		}
+		else if (direction == RIGHT && parent == rbtBuffer.last)
+		{
+			rbtBuffer.last = node;
+		}
+	}
+
+	rbtBuffer.length += 1;
+	rebalanceAfterInsertion(file, line, sdrv, &rbtBuffer, node);
+	sdrPut((Address) rbt, rbtBuffer);
+	return node;
+}
+
+void	Sdr_rbt_delete(char *file, int line, Sdr sdrv, Object node,
+		SdrRbtDeleteFn deleteFn, void *arg)
+{
+	SdrRbtNode	nodeBuffer;
+	Object		rbt;
+	SdrRbt		rbtBuffer;
+	Object		spliced;
+	SdrRbtNode	splicedBuffer;
+	Object		orphan;
+	SdrRbtNode	orphanBuffer;
+	Object		orphanParent;
+	int		splicedWasRed;
+	int		i;
+
+	if (!(sdr_in_xn(sdrv)))
+	{
+		oK(_iEnd(file, line, _notInXnMsg()));
+		return;
+	}
+
+	joinTrace(sdrv, file, line);
+	if (node == 0)
+	{
+		oK(_xniEnd(file, line, "node", sdrv));
+		return;
+	}
+
+	sdrFetch(nodeBuffer, (Address) node);
+	if ((rbt = nodeBuffer.rbt) == 0)
+	{
+		oK(_xniEnd(file, line, "rbt", sdrv));
+		return;
+	}
+
+	sdrFetch(rbtBuffer, (Address) rbt);
+	if (rbtBuffer.length < 1)
+	{
+		oK(_xniEnd(file, line, "rbt non-empty", sdrv));
+		return;
+	}
+
+	if (deleteFn)
+	{
+		deleteFn(sdrv, nodeBuffer.data, arg);
+	}
+
+	if (node == rbtBuffer.first)
+	{
+		rbtBuffer.first = traverse(sdrv, node, RIGHT);
+	}
+
+	if (node == rbtBuffer.last)
+	{
+		rbtBuffer.last = traverse(sdrv, node, LEFT);
+	}
+
+	/*	Spliced is the node that is actually removed from its
+	 *	position in the tree: either the deleted node itself
+	 *	(if it has at most one child) or else its successor,
+	 *	which has no left child and which is then relinked
+	 *	into the deleted node's position.			*/
+
+	if (nodeBuffer.child[LEFT] && nodeBuffer.child[RIGHT])
+	{
+		spliced = subtreeExtreme(sdrv, nodeBuffer.child[RIGHT], LEFT);
+	}
+	else
+	{
+		spliced = node;
+	}
+
+	sdrFetch(splicedBuffer, (Address) spliced);
+	orphan = splicedBuffer.child[LEFT] ? splicedBuffer.child[LEFT]
+			: splicedBuffer.child[RIGHT];
+	orphanParent = splicedBuffer.parent;
+	if (orphan)
+	{
+		sdrFetch(orphanBuffer, (Address) orphan);
+		orphanBuffer.parent = orphanParent;
+		sdrPut((Address) orphan, orphanBuffer);
+	}
+
+	replaceChild(file, line, sdrv, &rbtBuffer, orphanParent, spliced,
+			orphan);
+	splicedWasRed = splicedBuffer.isRed;
+	if (spliced != node)
+	{
+		/*	Move successor into the deleted node's place.	*/
+
+		if (orphanParent == node)
+		{
+			orphanParent = spliced;
+		}
+
+		sdrFetch(nodeBuffer, (Address) node);
+		splicedBuffer.parent = nodeBuffer.parent;
+		splicedBuffer.child[LEFT] = nodeBuffer.child[LEFT];
+		splicedBuffer.child[RIGHT] = nodeBuffer.child[RIGHT];
+		splicedBuffer.isRed = nodeBuffer.isRed;
+		sdrPut((Address) spliced, splicedBuffer);
+		replaceChild(file, line, sdrv, &rbtBuffer, nodeBuffer.parent,
+				node, spliced);
+		for (i = LEFT; i <= RIGHT; i++)
+		{
+			if (splicedBuffer.child[i])
+			{
+				sdrFetch(orphanBuffer,
+					(Address) splicedBuffer.child[i]);
+				orphanBuffer.parent = spliced;
+				sdrPut((Address) splicedBuffer.child[i],
+					orphanBuffer);
+			}
+		}
+	}
+
+	/* just in case user accesses later... */
+	memset((char *) &nodeBuffer, 0, sizeof(SdrRbtNode));
+	sdrPut((Address) node, nodeBuffer);
+	sdrFree(node);
+	rbtBuffer.length -= 1;
+	if (!splicedWasRed)
+	{
+		rebalanceAfterDeletion(file, line, sdrv, &rbtBuffer, orphan,
+				orphanParent);
+	}
+
+	sdrPut((Address) rbt, rbtBuffer);
+}
+
+Object	sdr_rbt_rbt(Sdr sdrv, Object node)
+{
+	SdrState	*sdr;
+	SdrRbtNode	nodeBuffer;
+
+	CHKZERO(sdrv);
+	CHKZERO(node);
+	sdr = sdrv->sdr;
+	CHKZERO(takeSdr(sdr) == 0);
+	sdrFetch(nodeBuffer, (Address) node);
+	releaseSdr(sdr);
+	return nodeBuffer.rbt;
+}
+
+Object	sdr_rbt_first(Sdr sdrv, Object rbt)
+{
+	SdrState	*sdr;
+	SdrRbt		rbtBuffer;
+
+	CHKZERO(sdrv);
+	CHKZERO(rbt);
+	sdr = sdrv->sdr;
+	CHKZERO(takeSdr(sdr) == 0);
+	sdrFetch(rbtBuffer, (Address) rbt);
+	releaseSdr(sdr);
+	return rbtBuffer.first;
+}
+
+Object	sdr_rbt_last(Sdr sdrv, Object rbt)
+{
+	SdrState	*sdr;
+	SdrRbt		rbtBuffer;
+
+	CHKZERO(sdrv);
+	CHKZERO(rbt);
+	sdr = sdrv->sdr;
+	CHKZERO(takeSdr(sdr) == 0);
+	sdrFetch(rbtBuffer, (Address) rbt);
+	releaseSdr(sdr);
+	return rbtBuffer.last;
+}
+
+Object	sdr_rbt_next(Sdr sdrv, Object node)
+{
+	SdrState	*sdr;
+	Object		next;
+
+	CHKZERO(sdrv);
+	CHKZERO(node);
+	sdr = sdrv->sdr;
+	CHKZERO(takeSdr(sdr) == 0);
+	next = traverse(sdrv, node, RIGHT);
+	releaseSdr(sdr);
+	return next;
+}
+
+Object	sdr_rbt_prev(Sdr sdrv, Object node)
+{
+	SdrState	*sdr;
+	Object		prev;
+
+	CHKZERO(sdrv);
+	CHKZERO(node);
+	sdr = sdrv->sdr;
+	CHKZERO(takeSdr(sdr) == 0);
+	prev = traverse(sdrv, node, LEFT);
+	releaseSdr(sdr);
+	return prev;
+}
+
+Object	sdr_rbt_search(Sdr sdrv, Object rbt, SdrRbtCompareFn compare,
+		void *arg, Object *successor)
+{
+	SdrState	*sdr;
+	SdrRbt		rbtBuffer;
+	Object		node;
+	SdrRbtNode	nodeBuffer;
+	Object		match = 0;
+	Object		next = 0;
+	int		result;
+
+	CHKZERO(sdrv);
+	CHKZERO(rbt);
+	CHKZERO(compare);
+	sdr = sdrv->sdr;
+	CHKZERO(takeSdr(sdr) == 0);
+
+	/*	Find the first (leftmost) node whose data matches
+	 *	the argument and, failing that, the first node whose
+	 *	data is greater than the argument.			*/
+
+	sdrFetch(rbtBuffer, (Address) rbt);
+	for (node = rbtBuffer.root; node != 0; )
+	{
+		sdrFetch(nodeBuffer, (Address) node);
+		result = compare(sdrv, nodeBuffer.data, arg);
+		if (result < 0)
+		{
+			node = nodeBuffer.child[RIGHT];
+			continue;
+		}
+
+		if (result == 0)
+		{
+			match = node;
+		}
+		else
+		{
+			next = node;
+		}
+
+		node = nodeBuffer.child[LEFT];
+	}
+
+	releaseSdr(sdr);
+	if (successor)
+	{
+		*successor = next;
+	}
+
+	return match;
+}
+
+static int	checkSubtree(Sdr sdrv, Object rbt, Object node,
+			Object parent, unsigned long *count)
+{
+	SdrRbtNode	nodeBuffer;
+	int		leftHeight;
+	int		rightHeight;
+
+	/*	Returns the black height of the subtree rooted at
+	 *	node, or -1 if the subtree is not a valid red-black
+	 *	tree.							*/
+
+	if (node == 0)
+	{
+		return 1;	/*	Null leaves are black.		*/
+	}
+
+	sdrFetch(nodeBuffer, (Address) node);
+	if (nodeBuffer.rbt != rbt || nodeBuffer.parent != parent)
+	{
+		putErrmsg("Red-black tree node is mislinked.", utoa(node));
+		return -1;
+	}
+
+	if (nodeBuffer.isRed && (isRed(sdrv, nodeBuffer.child[LEFT])
+			|| isRed(sdrv, nodeBuffer.child[RIGHT])))
+	{
+		putErrmsg("Red-black tree red node has red child.",
+				utoa(node));
+		return -1;
+	}
+
+	*count += 1;
+	leftHeight = checkSubtree(sdrv, rbt, nodeBuffer.child[LEFT], node,
+			count);
+	rightHeight = checkSubtree(sdrv, rbt, nodeBuffer.child[RIGHT], node,
+			count);
+	if (leftHeight < 0 || rightHeight < 0)
+	{
+		return -1;
+	}
+
+	if (leftHeight != rightHeight)
+	{
+		putErrmsg("Red-black tree black heights differ.", utoa(node));
+		return -1;
+	}
+
+	return leftHeight + (nodeBuffer.isRed ? 0 : 1);
+}
+
+int	sdr_rbt_check(Sdr sdrv, Object rbt)
+{
+	SdrState	*sdr;
+	SdrRbt		rbtBuffer;
+	unsigned long	count = 0;
+	int		result = 0;
+
+	CHKERR(sdrv);
+	CHKERR(rbt);
+	sdr = sdrv->sdr;
+	CHKERR(takeSdr(sdr) == 0);
+	sdrFetch(rbtBuffer, (Address) rbt);
+	if (isRed(sdrv, rbtBuffer.root))
+	{
+		putErrmsg("Red-black tree root is red.", NULL);
+		result = -1;
+	}
+	else if (checkSubtree(sdrv, rbt, rbtBuffer.root, 0, &count) < 0)
+	{
+		result = -1;
+	}
+	else if (count != rbtBuffer.length)
+	{
+		putErrmsg("Red-black tree length is wrong.", utoa(count));
+		result = -1;
+	}
+	else if (rbtBuffer.root != 0
+	&& (rbtBuffer.first != subtreeExtreme(sdrv, rbtBuffer.root, LEFT)
+	|| rbtBuffer.last != subtreeExtreme(sdrv, rbtBuffer.root, RIGHT)))
+	{
+		putErrmsg("Red-black tree first or last node is wrong.", NULL);
+		result = -1;
+	}
+	else if (rbtBuffer.root == 0
+	&& (rbtBuffer.first != 0 || rbtBuffer.last != 0))
+	{
+		putErrmsg("Empty red-black tree has first or last node.",
+				NULL);
+		result = -1;
+	}
+
+	releaseSdr(sdr);
+	return result;
+}
+
+Address	sdr_rbt_data(Sdr sdrv, Object node)
+{
+	SdrState	*sdr;
+	SdrRbtNode	nodeBuffer;
+
+	CHKZERO(sdrv);
+	CHKZERO(node);
+	sdr = sdrv->sdr;
+	CHKZERO(takeSdr(sdr) == 0);
+	sdrFetch(nodeBuffer, (Address) node);
+	releaseSdr(sdr);
+	return nodeBuffer.data;
+}
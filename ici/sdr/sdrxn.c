@@ -22,7 +22,14 @@
 #include "lyst.h"
 #include "sdrxn.h"
 
+typedef struct
+{
+	Address		from;	/*	1st byte of dirty extent	*/
+	Address		to;	/*	1st byte beyond dirty extent	*/
+} DirtyExtent;
+
 static PsmPartition	_sdrwm(sm_WmParms *parms);
+static void		destroyAuxSemaphores(SdrState *sdr);
 
 #ifndef SDR_TRACE
 char	*_noTraceMsg()
@@ -129,6 +136,8 @@ static SdrControlHeader	*_sch(SdrControlHeader **schp)
 					sm_SemDelete(sdr->sdrSemaphore);
 					sdr->sdrSemaphore = -1;
 				}
+
+				destroyAuxSemaphores(sdr);
 			}
 
 			sm_SemDelete(sch->lock);
@@ -339,7 +348,7 @@ SdrMap	*_mapImage(Sdr sdrv)
 {
 	static SdrMap	map;
 
-	if (sdrv->sdr->configFlags & SDR_IN_DRAM)
+	if (HEAP_IN_MEMORY(sdrv->sdr->configFlags))
 	{
 		return (SdrMap *) (sdrv->dbsm);
 	}
@@ -350,6 +359,110 @@ SdrMap	*_mapImage(Sdr sdrv)
 
 /*	*	Mutual exclusion functions	*	*	*	*/
 
+/*	The SDR is locked in one of two modes.  A transaction holds
+ *	sdrSemaphore for its entire duration and so has exclusive
+ *	access.  A reader (see sdr_begin_read) holds sdrSemaphore
+ *	only long enough to register itself in the SDR's table of
+ *	readers; the first reader to register takes drainSemaphore,
+ *	and the last reader to unregister gives it.  So a task that
+ *	needs exclusive access takes sdrSemaphore, which prevents any
+ *	new readers from registering, and then waits for all current
+ *	readers to unregister by taking (and immediately giving)
+ *	drainSemaphore.							*/
+
+static int	createAuxSemaphores(SdrState *sdr)
+{
+	sdr->readerSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+	sdr->drainSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+	sdr->syncSemaphore = -1;
+	if (sdr->configFlags & SDR_SYNCED)
+	{
+		sdr->syncSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+	}
+
+	if (sdr->readerSemaphore == SM_SEM_NONE
+	|| sdr->drainSemaphore == SM_SEM_NONE
+	|| (sdr->configFlags & SDR_SYNCED
+		&& sdr->syncSemaphore == SM_SEM_NONE))
+	{
+		destroyAuxSemaphores(sdr);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void	destroyAuxSemaphores(SdrState *sdr)
+{
+	if (sdr->readerSemaphore != -1)
+	{
+		sm_SemDelete(sdr->readerSemaphore);
+		sdr->readerSemaphore = -1;
+	}
+
+	if (sdr->drainSemaphore != -1)
+	{
+		sm_SemDelete(sdr->drainSemaphore);
+		sdr->drainSemaphore = -1;
+	}
+
+	if (sdr->syncSemaphore != -1)
+	{
+		sm_SemDelete(sdr->syncSemaphore);
+		sdr->syncSemaphore = -1;
+	}
+}
+
+static SdrReader	*findReader(SdrState *sdr)
+{
+	int		taskId;
+	pthread_t	threadId;
+	int		i;
+	SdrReader	*reader;
+
+	/*	Only the reader itself ever fills or clears its own
+	 *	slot, so the table can be searched for the calling
+	 *	task's slot without taking readerSemaphore.		*/
+
+	if (sdr->readerCount == 0)
+	{
+		return NULL;
+	}
+
+	taskId = sm_TaskIdSelf();
+	threadId = pthread_self();
+	for (i = 0, reader = sdr->readers; i < SDR_MAX_READERS; i++, reader++)
+	{
+		if (reader->readDepth > 0
+		&& reader->readerTask == taskId
+		&& pthread_equal(reader->readerThread, threadId))
+		{
+			return reader;
+		}
+	}
+
+	return NULL;
+}
+
+static int	waitForReaders(SdrState *sdr)
+{
+	/*	Caller holds sdrSemaphore, so no new reader can
+	 *	register while we wait for the current ones.		*/
+
+	if (sdr->readerCount > 0)
+	{
+		if (sdr->drainSemaphore == -1
+		|| sm_SemTake(sdr->drainSemaphore) < 0)
+		{
+			return -1;
+		}
+
+		sm_SemGive(sdr->drainSemaphore);
+	}
+
+	return 0;
+}
+
 static int	lockSdr(SdrState *sdr)
 {
 	if (sdr->sdrSemaphore == -1
@@ -358,6 +471,12 @@ static int	lockSdr(SdrState *sdr)
 		return -1;
 	}
 
+	if (waitForReaders(sdr) < 0)
+	{
+		sm_SemGive(sdr->sdrSemaphore);
+		return -1;
+	}
+
 	sdr->sdrOwnerTask = sm_TaskIdSelf();
 	sdr->sdrOwnerThread = pthread_self();
 	sdr->xnDepth = 1;
@@ -366,6 +485,8 @@ static int	lockSdr(SdrState *sdr)
 
 int	takeSdr(SdrState *sdr)
 {
+	SdrReader	*reader;
+
 	CHKERR(sdr);
 	if (sdr->sdrOwnerTask == sm_TaskIdSelf()
 	&& pthread_equal(sdr->sdrOwnerThread, pthread_self()))
@@ -374,6 +495,13 @@ int	takeSdr(SdrState *sdr)
 		return 0;
 	}
 
+	reader = findReader(sdr);
+	if (reader)
+	{
+		reader->readDepth++;
+		return 0;
+	}
+
 	return lockSdr(sdr);
 }
 
@@ -389,6 +517,8 @@ static void	unlockSdr(SdrState *sdr)
 
 void	releaseSdr(SdrState *sdr)
 {
+	SdrReader	*reader;
+
 	CHKVOID(sdr);
 	if (sdr->sdrOwnerTask == sm_TaskIdSelf()
 	&& pthread_equal(sdr->sdrOwnerThread, pthread_self()))
@@ -398,6 +528,16 @@ void	releaseSdr(SdrState *sdr)
 		{
 			unlockSdr(sdr);
 		}
+
+		return;
+	}
+
+	/*	A reader's registration is ended only by sdr_end_read.	*/
+
+	reader = findReader(sdr);
+	if (reader && reader->readDepth > 1)
+	{
+		reader->readDepth--;
 	}
 }
 
@@ -505,10 +645,38 @@ int	_xniEnd(const char *fileName, int lineNbr, const char *arg, Sdr sdrv)
 	the event that it is canceled: the log entries in the list
 	are processed in reverse order, with the original data of
 	each log entry being written back into the indicated start
-	address.							*/
-
-static int	reverseTransaction(Lyst logEntries, int logfile, int dbfile,
-			char *dbsm)
+	address.
+
+	When an SDR is configured to be buffered (SDR_BUFFERED), log
+	entries are instead appended to a log buffer in SDR working
+	memory and are written to the log file in a single write when
+	the transaction is ended (or earlier, if the buffer fills up).
+	The offset of each log entry is still its offset within the
+	log as a whole, so an entry whose offset is at or beyond the
+	length of the log file is located in the log buffer.  Updates
+	to the db file are likewise deferred: the dirty extents of
+	the heap are noted, coalesced, and written from the DRAM image
+	of the heap immediately after the log has been flushed.  Since
+	the db file is not modified until the log is complete, the
+	write-ahead property of the log is preserved.  Because the log
+	buffer resides in SDR working memory, log entries that had not
+	yet been flushed when a program crashed are appended to the
+	log file when the SDR's profile is reloaded, for reversal in
+	the usual way.
+
+	When the db file of an SDR is mapped into memory (SDR_MAPPED)
+	there is no separate write to the db file at all: each update
+	is a copy into the mapping, and at the end of the transaction
+	the dirty extents of the mapping are synced to the file.
+	Since the operating system may write the mapping back to the
+	file at any time, each log entry must already be in the log
+	file when the update it protects is copied into the mapping,
+	so a reversible mapped SDR can't buffer its log entries; nor
+	can it be synced, as the log would then have to be synced
+	before every update.						*/
+
+static int	reverseTransaction(Lyst logEntries, int logfile, char *logbuf,
+			unsigned long logbufStart, int dbfile, char *dbsm)
 {
 	LystElt		elt;
 	unsigned long	logEntryOffset;
@@ -516,7 +684,7 @@ static int	reverseTransaction(Lyst logEntries, int logfile, int dbfile,
 	size_t		length;
 	char		*buf;
 
-	if (logfile == -1 || logEntries == NULL)
+	if ((logfile == -1 && logbuf == NULL) || logEntries == NULL)
 	{
 		return 0;	/*	No reversal possible.		*/
 	}
@@ -525,6 +693,34 @@ static int	reverseTransaction(Lyst logEntries, int logfile, int dbfile,
 	{
 		length = sizeof logEntryControl;
 		logEntryOffset = (unsigned long) lyst_data(elt);
+		if (logbuf && logEntryOffset >= logbufStart)
+		{
+			/*	Log entry was never flushed to file.	*/
+
+			buf = logbuf + (logEntryOffset - logbufStart);
+			memcpy((char *) logEntryControl, buf, length);
+			buf += length;
+			length = logEntryControl[1];
+			if (dbsm)
+			{
+				memcpy(dbsm + logEntryControl[0], buf, length);
+			}
+
+			if (dbfile != -1)
+			{
+				if (lseek(dbfile, logEntryControl[0], SEEK_SET)
+						< 0
+				|| write(dbfile, buf, length) < length)
+				{
+					putSysErrmsg("Can't reverse log entry",
+							NULL);
+					return -1;
+				}
+			}
+
+			continue;
+		}
+
 		if (lseek(logfile, logEntryOffset, SEEK_SET) < 0
 		|| read(logfile, (char *) logEntryControl, length) < length)
 		{
@@ -601,15 +797,23 @@ static int	reverseTransaction(Lyst logEntries, int logfile, int dbfile,
 
 static void	clearTransaction(Sdr sdrv)
 {
-	char	logfilename[PATHLENMAX + 1 + 32 + 1 + 6 + 1];
+	SdrState	*sdr = sdrv->sdr;
+	char		logfilename[PATHLENMAX + 1 + 32 + 1 + 6 + 1];
 
-	if (sdrv->logfile != -1)
+	/*	The log file need only be truncated if something
+	 *	was actually written to it.  The log of a synced
+	 *	SDR is instead truncated by the task that performs
+	 *	the next group sync, once the updates that its
+	 *	entries could reverse are durable (see syncCommits).	*/
+
+	if (sdrv->logfile != -1 && sdrv->logfileWritten
+	&& !(sdr->configFlags & SDR_SYNCED))
 	{
 		close(sdrv->logfile);
 		sdrv->logfile = -1;
 	}
 
-	if (sdrv->sdr->configFlags & SDR_REVERSIBLE)
+	if (sdr->configFlags & SDR_REVERSIBLE && sdrv->logfile == -1)
 	{
 		isprintf(logfilename, sizeof logfilename, "%s%c%s.sdrlog",
 				sdrv->sdr->pathName, ION_PATH_DELIMITER,
@@ -623,6 +827,10 @@ static void	clearTransaction(Sdr sdrv)
 	}
 
 	sdrv->logfileLength = 0;
+	sdrv->logfileWritten = 0;
+	sdrv->modified = 0;
+	sdrv->updated = 0;
+	sdr->logBufferLength = 0;
 	if (sdrv->logEntries)
 	{
 		lyst_clear(sdrv->logEntries);
@@ -632,6 +840,240 @@ static void	clearTransaction(Sdr sdrv)
 	{
 		lyst_clear(sdrv->knownObjects);
 	}
+
+	if (sdrv->dirtyExtents)
+	{
+		lyst_clear(sdrv->dirtyExtents);
+	}
+}
+
+static int	flushLogBuffer(Sdr sdrv)
+{
+	SdrState	*sdr = sdrv->sdr;
+	char		*logbuf;
+
+	if (sdr->logBufferLength == 0)
+	{
+		return 0;
+	}
+
+	logbuf = (char *) sdrMemAtoP(sdr->logBuffer);
+	sdrv->logfileWritten = 1;
+	if (write(sdrv->logfile, logbuf, sdr->logBufferLength)
+			< sdr->logBufferLength)
+	{
+		putSysErrmsg("Can't flush log buffer",
+				itoa(sdr->logBufferLength));
+		return -1;
+	}
+
+	sdr->logBufferLength = 0;
+	return 0;
+}
+
+static int	bufferLogEntry(Sdr sdrv, Address into, long length)
+{
+	SdrState	*sdr = sdrv->sdr;
+	unsigned long	logEntryControl[2];
+	long		entryLength;
+	char		*cursor;
+
+	logEntryControl[0] = into;
+	logEntryControl[1] = length;
+	entryLength = sizeof logEntryControl + length;
+	if (sdr->logBufferLength + entryLength > SDR_LOG_BUFFER_SIZE)
+	{
+		if (flushLogBuffer(sdrv) < 0)
+		{
+			return -1;
+		}
+
+		if (entryLength > SDR_LOG_BUFFER_SIZE)
+		{
+			/*	Too large to buffer; write directly.	*/
+
+			sdrv->logfileWritten = 1;
+			if (write(sdrv->logfile, (char *) logEntryControl,
+				sizeof logEntryControl) < sizeof logEntryControl
+			|| write(sdrv->logfile, sdrv->dbsm + into, length)
+					< length)
+			{
+				putSysErrmsg("Can't write log entry",
+						itoa(length));
+				return -1;
+			}
+
+			return 0;
+		}
+	}
+
+	cursor = ((char *) sdrMemAtoP(sdr->logBuffer)) + sdr->logBufferLength;
+	memcpy(cursor, (char *) logEntryControl, sizeof logEntryControl);
+	memcpy(cursor + sizeof logEntryControl, sdrv->dbsm + into, length);
+	sdr->logBufferLength += entryLength;
+	return 0;
+}
+
+static int	noteDirtyExtent(Sdr sdrv, Address from, long length)
+{
+	Address		to = from + length;
+	LystElt		elt;
+	LystElt		prevElt;
+	DirtyExtent	*extent = NULL;
+	DirtyExtent	*prev;
+
+	/*	Dirty extents are kept in ascending order of address.
+	 *	Since the DRAM image of the heap is identical to the
+	 *	db file outside the dirty extents, extents that are
+	 *	separated by no more than SDR_EXTENT_GAP bytes can be
+	 *	merged.  Search from the end of the list, as updates
+	 *	within a transaction frequently ascend.			*/
+
+	for (elt = lyst_last(sdrv->dirtyExtents); elt; elt = lyst_prev(elt))
+	{
+		extent = (DirtyExtent *) lyst_data(elt);
+		if (extent->from <= to + SDR_EXTENT_GAP)
+		{
+			break;
+		}
+	}
+
+	if (elt && extent->to + SDR_EXTENT_GAP >= from)
+	{
+		if (from < extent->from)
+		{
+			extent->from = from;
+		}
+
+		if (to > extent->to)
+		{
+			extent->to = to;
+		}
+
+		/*	Absorb preceding extents now within reach.	*/
+
+		while ((prevElt = lyst_prev(elt)) != NULL)
+		{
+			prev = (DirtyExtent *) lyst_data(prevElt);
+			if (prev->to + SDR_EXTENT_GAP < extent->from)
+			{
+				break;
+			}
+
+			if (prev->from < extent->from)
+			{
+				extent->from = prev->from;
+			}
+
+			lyst_delete(prevElt);
+		}
+
+		return 0;
+	}
+
+	extent = (DirtyExtent *) MTAKE(sizeof(DirtyExtent));
+	if (extent == NULL)
+	{
+		putErrmsg(_noMemoryMsg(), NULL);
+		return -1;
+	}
+
+	extent->from = from;
+	extent->to = to;
+	if (elt)
+	{
+		elt = lyst_insert_after(elt, extent);
+	}
+	else
+	{
+		elt = lyst_insert_first(sdrv->dirtyExtents, extent);
+	}
+
+	if (elt == NULL)
+	{
+		MRELEASE(extent);
+		putErrmsg(_noMemoryMsg(), NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int	writeDirtyExtents(Sdr sdrv)
+{
+	LystElt		elt;
+	DirtyExtent	*extent;
+	size_t		length;
+
+	for (elt = lyst_first(sdrv->dirtyExtents); elt; elt = lyst_next(elt))
+	{
+		extent = (DirtyExtent *) lyst_data(elt);
+		length = extent->to - extent->from;
+		if (lseek(sdrv->dbfile, extent->from, SEEK_SET) < 0
+		|| write(sdrv->dbfile, sdrv->dbsm + extent->from, length)
+				< length)
+		{
+			putSysErrmsg("Can't write to database", itoa(length));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int	syncDirtyExtents(Sdr sdrv)
+{
+	LystElt		elt;
+	DirtyExtent	*extent;
+
+	for (elt = lyst_first(sdrv->dirtyExtents); elt; elt = lyst_next(elt))
+	{
+		extent = (DirtyExtent *) lyst_data(elt);
+		if (syncMappedFile(sdrv->dbsm + extent->from,
+				extent->to - extent->from) < 0)
+		{
+			putErrmsg("Can't sync database.", NULL);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int	commitXn(Sdr sdrv)
+{
+	SdrState	*sdr = sdrv->sdr;
+
+	/*	Log must be complete before the db file is modified.
+	 *	(A mapped db file has already been modified, but a
+	 *	mapped SDR is never both buffered and reversible.)	*/
+
+	if (sdr->configFlags & SDR_BUFFERED
+	&& sdr->configFlags & SDR_REVERSIBLE)
+	{
+		if (flushLogBuffer(sdrv) < 0)
+		{
+			return -1;
+		}
+	}
+
+	if (sdr->configFlags & SDR_MAPPED)
+	{
+		if (syncDirtyExtents(sdrv) < 0)
+		{
+			return -1;
+		}
+	}
+	else if (sdr->configFlags & SDR_BUFFERED
+	&& sdr->configFlags & SDR_IN_FILE)
+	{
+		if (writeDirtyExtents(sdrv) < 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
 }
 
 static void	handleUnrecoverableError(Sdr sdrv)
@@ -643,9 +1085,155 @@ static void	handleUnrecoverableError(Sdr sdrv)
 	sm_Abort();
 }
 
-static void	terminateXn(Sdr sdrv)
+static int	syncCommits(Sdr sdrv, unsigned long commitNbr,
+			struct timeval *commitTime)
+{
+	SdrState	*sdr = sdrv->sdr;
+	struct timeval	now;
+	long		delay;
+	unsigned long	syncedCommitNbr;
+	int		result = 0;
+
+	/*	Group commit: tasks that have ended transactions queue
+	 *	up (in FIFO order) on the sync semaphore.  The task
+	 *	at the head of the queue syncs the log and db files
+	 *	on behalf of every transaction committed so far, so
+	 *	the tasks behind it normally find that their own
+	 *	commits have already been made durable.			*/
+
+	if (sdr->syncSemaphore == -1
+	|| sm_SemTake(sdr->syncSemaphore) < 0)
+	{
+		putErrmsg("Can't take SDR sync semaphore.", NULL);
+		return -1;
+	}
+
+	if (sdr->syncedCommitCount >= commitNbr)
+	{
+		sm_SemGive(sdr->syncSemaphore);
+		return 0;		/*	Synced by another task.	*/
+	}
+
+	/*	Give transactions ended by other tasks a chance to
+	 *	share this sync, up to the maximum commit latency.	*/
+
+	if (sdr->maxCommitLatency > 0)
+	{
+		getCurrentTime(&now);
+		delay = sdr->maxCommitLatency
+			- (((now.tv_sec - commitTime->tv_sec) * 1000000)
+			+ (now.tv_usec - commitTime->tv_usec));
+		if (delay > 0)
+		{
+			microsnooze(delay);
+		}
+	}
+
+	/*	commitCount is incremented only after a transaction's
+	 *	db writes are complete, so every commit counted at
+	 *	this point is covered by the sync.  (Where the db
+	 *	file is mapped, fsync of the file also writes back
+	 *	the mapping's dirty pages.)  The db file is synced
+	 *	without holding the SDR, so that other transactions
+	 *	can proceed in the meantime.				*/
+
+	syncedCommitNbr = sdr->commitCount;
+	if (syncFile(sdrv->dbfile) < 0)
+	{
+		result = -1;
+	}
+
+	/*	Only now can the log of committed transactions be
+	 *	discarded, since it must not be made durably empty
+	 *	while the updates it could reverse are not durable
+	 *	themselves.  Truncation requires the SDR, so that
+	 *	no transaction is in progress; any transactions
+	 *	committed during the sync above must be covered by
+	 *	another sync of the db file before their entries,
+	 *	too, are discarded.					*/
+
+	if (result == 0 && sdrv->logfile != -1)
+	{
+		if (takeSdr(sdr) < 0)
+		{
+			putErrmsg("Can't take SDR to truncate log.", NULL);
+			result = -1;
+		}
+		else
+		{
+			if (sdr->commitCount != syncedCommitNbr)
+			{
+				syncedCommitNbr = sdr->commitCount;
+				if (syncFile(sdrv->dbfile) < 0)
+				{
+					result = -1;
+				}
+			}
+
+			if (result == 0 && ftruncate(sdrv->logfile, 0) < 0)
+			{
+				putSysErrmsg("Can't truncate log file", NULL);
+				result = -1;
+			}
+
+			releaseSdr(sdr);
+		}
+
+		if (result == 0 && syncFile(sdrv->logfile) < 0)
+		{
+			result = -1;
+		}
+	}
+
+	if (result == 0)
+	{
+		sdr->syncedCommitCount = syncedCommitNbr;
+		sdr->syncCount++;
+	}
+
+	sm_SemGive(sdr->syncSemaphore);
+	return result;
+}
+
+static int	terminateXn(Sdr sdrv)
 {
 	SdrState	*sdr = sdrv->sdr;
+	int		result = 0;
+	int		dbfile = sdrv->dbfile;
+	char		*logbuf = NULL;
+	unsigned long	logbufStart = 0;
+	int		committed = 0;
+	unsigned long	commitNbr = 0;
+	struct timeval	commitTime;
+
+	if (sdr->configFlags & (SDR_BUFFERED | SDR_MAPPED))
+	{
+		if (sdr->xnCanceled || sdr->configFlags & SDR_MAPPED)
+		{
+			/*	Either no change has yet been written
+			 *	to the db file or else the db file is
+			 *	the mapped heap itself.			*/
+
+			dbfile = -1;
+		}
+
+		if (sdr->xnCanceled == 0)
+		{
+			if (sdrv->updated && commitXn(sdrv) < 0)
+			{
+				putErrmsg("Can't commit transaction.", NULL);
+				sdr->xnCanceled = 1;
+				result = -1;
+			}
+		}
+
+		if (sdr->logBuffer)
+		{
+			logbuf = (char *) sdrMemAtoP(sdr->logBuffer);
+			logbufStart = sdrv->logfileLength
+					- sdr->logBufferLength;
+		}
+	}
 
 	if (sdr->xnCanceled)
 	{
@@ -653,24 +1241,43 @@ static void	terminateXn(Sdr sdrv)
 		if (sdr->configFlags & SDR_REVERSIBLE)
 		{
 			if (reverseTransaction(sdrv->logEntries, sdrv->logfile,
-					sdrv->dbfile, sdrv->dbsm) < 0)
+					logbuf, logbufStart, dbfile,
+					sdrv->dbsm) < 0)
 			{
 				handleUnrecoverableError(sdrv);
 			}
 		}
 		else	/*	Can't back out; if data modified, bail.	*/
 		{
-			if (sdrv->modified)
+			if (sdrv->updated)
 			{
 				handleUnrecoverableError(sdrv);
 			}
 		}
 	}
+	else
+	{
+		committed = sdrv->updated;
+	}
 
 	/*	Database is in a consistent state, one way or another.	*/
 
 	clearTransaction(sdrv);
+	if (committed && sdr->configFlags & SDR_SYNCED)
+	{
+		sdr->commitCount++;
+		commitNbr = sdr->commitCount;
+		getCurrentTime(&commitTime);
+	}
+
 	unlockSdr(sdr);
+	if (commitNbr > 0 && syncCommits(sdrv, commitNbr, &commitTime) < 0)
+	{
+		putErrmsg("Can't sync transaction.", NULL);
+		result = -1;
+	}
+
+	return result;
 }
 
 void	crashXn(Sdr sdrv)
@@ -689,7 +1296,7 @@ void	crashXn(Sdr sdrv)
 		putErrmsg("Transaction aborted.", NULL);
 		sdr->xnCanceled = 1;	/*	Force reversal.		*/
 		sdr->xnDepth = 0;	/*	Unlock is immediate.	*/
-		terminateXn(sdrv);
+		oK(terminateXn(sdrv));
 	}
 }
 
@@ -888,6 +1495,36 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 		return -1;
 	}
 
+	if (configFlags & SDR_MAPPED && (configFlags & SDR_IN_DRAM
+			|| !(configFlags & SDR_IN_FILE)))
+	{
+		putErrmsg("SDR_MAPPED requires SDR_IN_FILE, not SDR_IN_DRAM.",
+				itoa(configFlags));
+		return -1;
+	}
+
+	if (configFlags & SDR_MAPPED && configFlags & SDR_REVERSIBLE
+	&& configFlags & (SDR_BUFFERED | SDR_SYNCED))
+	{
+		putErrmsg("Reversible SDR_MAPPED excludes SDR_BUFFERED and \
+SDR_SYNCED.", itoa(configFlags));
+		return -1;
+	}
+
+	if (configFlags & SDR_BUFFERED && !HEAP_IN_MEMORY(configFlags))
+	{
+		putErrmsg("SDR_BUFFERED requires SDR_IN_DRAM or SDR_MAPPED.",
+				itoa(configFlags));
+		return -1;
+	}
+
+	if (configFlags & SDR_SYNCED && !(configFlags & SDR_IN_FILE))
+	{
+		putErrmsg("SDR_SYNCED requires SDR_IN_FILE.",
+				itoa(configFlags));
+		return -1;
+	}
+
 	sm_SemTake(sch->lock);
 	for (elt = sm_list_first(sdrwm, sch->sdrs); elt;
 			elt = sm_list_next(sdrwm, elt))
@@ -944,6 +1581,29 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 		return -1;
 	}
 
+	if (createAuxSemaphores(sdr) < 0)
+	{
+		sm_SemDelete(sdr->sdrSemaphore);
+		psm_free(sdrwm, newSdrAddress);
+		sm_SemGive(sch->lock);
+		putErrmsg("Can't create semaphores for SDR.", NULL);
+		return -1;
+	}
+
+	if (configFlags & SDR_BUFFERED && configFlags & SDR_REVERSIBLE)
+	{
+		sdr->logBuffer = psm_zalloc(sdrwm, SDR_LOG_BUFFER_SIZE);
+		if (sdr->logBuffer == 0)
+		{
+			destroyAuxSemaphores(sdr);
+			sm_SemDelete(sdr->sdrSemaphore);
+			psm_free(sdrwm, newSdrAddress);
+			sm_SemGive(sch->lock);
+			putErrmsg("Can't allocate SDR log buffer.", NULL);
+			return -1;
+		}
+	}
+
 	sdr->sdrOwnerTask = -1;
 	sdr->sdrOwnerThread = 0;
 	sdr->traceKey = sm_GetUniqueKey();
@@ -1020,8 +1680,8 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 		}
 		else	/*	Database file exists.			*/
 		{
-			if (reverseTransaction(logEntries, logfile, dbfile,
-					NULL) < 0)
+			if (reverseTransaction(logEntries, logfile, NULL, 0,
+					dbfile, NULL) < 0)
 			{
 				close(dbfile);
 				if (logfile != -1) close(logfile);
@@ -1053,7 +1713,8 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 			{
 				/*	File is authoritative.		*/
 
-				if (read(dbfile, dbsm, sdr->sdrSize)
+				if (lseek(dbfile, 0, SEEK_SET) < 0
+				|| read(dbfile, dbsm, sdr->sdrSize)
 						< sdr->sdrSize)
 				{
 					close(dbfile);
@@ -1072,8 +1733,8 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 	
 			/*	Back transaction out of memory if nec.	*/
 	
-			if (reverseTransaction(logEntries, logfile, -1, dbsm)
-					< 0)
+			if (reverseTransaction(logEntries, logfile, NULL, 0,
+					-1, dbsm) < 0)
 			{
 				if (logfile != -1) close(logfile);
 				if (logEntries) lyst_destroy(logEntries);
@@ -1090,7 +1751,8 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 			{
 				/*	File is authoritative.		*/
 
-				if (read(dbfile, dbsm, sdr->sdrSize)
+				if (lseek(dbfile, 0, SEEK_SET) < 0
+				|| read(dbfile, dbsm, sdr->sdrSize)
 						< sdr->sdrSize)
 				{
 					close(dbfile);
@@ -1116,6 +1778,19 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 	if (logfile != -1)
 	{
 		close(logfile);
+
+		/*	Any log entries have now been reversed, so
+		 *	the log itself can be discarded.		*/
+
+		if (lyst_length(logEntries) > 0)
+		{
+			logfile = open(logfilename, O_RDWR | O_CREAT | O_TRUNC,
+					0777);
+			if (logfile != -1)
+			{
+				close(logfile);
+			}
+		}
 	}
 
 	if (logEntries)
@@ -1132,6 +1807,36 @@ int	sdr_load_profile(char *name, int configFlags, long heapWords,
 	return 0;
 }
 
+static void	spillLogBuffer(SdrState *sdr)
+{
+	char	logfilename[PATHLENMAX + 1 + 32 + 1 + 6 + 1];
+	int	logfile;
+	char	*logbuf;
+
+	/*	Log entries buffered by a transaction that never
+	 *	ended are appended to the log file, so that they
+	 *	are reversed when the SDR's profile is reloaded.	*/
+
+	isprintf(logfilename, sizeof logfilename, "%s%c%s.sdrlog",
+			sdr->pathName, ION_PATH_DELIMITER, sdr->name);
+	logfile = open(logfilename, O_RDWR | O_CREAT | O_APPEND, 0777);
+	if (logfile == -1)
+	{
+		putSysErrmsg("Can't open log file", logfilename);
+		return;
+	}
+
+	logbuf = (char *) sdrMemAtoP(sdr->logBuffer);
+	if (write(logfile, logbuf, sdr->logBufferLength)
+			< sdr->logBufferLength)
+	{
+		putSysErrmsg("Can't spill log buffer", logfilename);
+	}
+
+	close(logfile);
+	sdr->logBufferLength = 0;
+}
+
 int	sdr_reload_profile(char *name, int configFlags, long heapWords,
 		int memKey, char *pathName)
 {
@@ -1176,6 +1881,18 @@ int	sdr_reload_profile(char *name, int configFlags, long heapWords,
 		 *	that is currently in progress.			*/
 
 		sm_SemDelete(sdr->sdrSemaphore);
+		destroyAuxSemaphores(sdr);
+
+		if (sdr->logBuffer)
+		{
+			if (sdr->logBufferLength > 0)
+			{
+				spillLogBuffer(sdr);
+			}
+
+			psm_free(sdrwm, sdr->logBuffer);
+		}
+
 		psm_free(sdrwm, sdrAddress);
 		oK(sm_list_delete(sdrwm, elt, NULL, NULL));
 	}
@@ -1186,7 +1903,7 @@ int	sdr_reload_profile(char *name, int configFlags, long heapWords,
 	return sdr_load_profile(name, configFlags, heapWords, memKey, pathName);
 }
 
-static void	deleteObjectExtent(LystElt elt, void *userData)
+static void	deleteExtent(LystElt elt, void *userData)
 {
 	MRELEASE(lyst_data(elt));
 }
@@ -1247,6 +1964,18 @@ Sdr	Sdr_start_using(char *name)
 			putSysErrmsg("Can't open database file", dbfilename);
 			return NULL;
 		}
+
+		if (sdr->configFlags & SDR_MAPPED)
+		{
+			sdrv->dbsm = mapFile(sdrv->dbfile, sdr->sdrSize);
+			if (sdrv->dbsm == NULL)
+			{
+				sm_SemGive(sch->lock);
+				putErrmsg("Can't map database file.",
+						dbfilename);
+				return NULL;
+			}
+		}
 	}
 	else
 	{
@@ -1302,9 +2031,25 @@ Sdr	Sdr_start_using(char *name)
 			return NULL;
 		}
 
-		lyst_delete_set(sdrv->knownObjects, deleteObjectExtent, NULL);
+		lyst_delete_set(sdrv->knownObjects, deleteExtent, NULL);
+	}
+
+	if (sdr->configFlags & SDR_IN_FILE
+	&& sdr->configFlags & (SDR_BUFFERED | SDR_MAPPED))
+	{
+		sdrv->dirtyExtents = lyst_create_using(_sdrMemory(NULL));
+		if (sdrv->dirtyExtents == 0)
+		{
+			sm_SemGive(sch->lock);
+			putErrmsg(_noMemoryMsg(), NULL);
+			return NULL;
+		}
+
+		lyst_delete_set(sdrv->dirtyExtents, deleteExtent, NULL);
 	}
 
+	sdrv->modified = 0;
+	sdrv->updated = 0;
 	sdrv->trace = NULL;
 	sdrv->currentSourceFileName = NULL;
 	sdrv->currentSourceFileLine = 0;
@@ -1324,6 +2069,23 @@ long	sdr_heap_size(Sdr sdrv)
 	return sdrv->sdr->heapSize;
 }
 
+void	sdr_set_commit_latency(Sdr sdrv, long microseconds)
+{
+	CHKVOID(sdrv);
+	CHKVOID(microseconds >= 0);
+	sdrv->sdr->maxCommitLatency = microseconds;
+}
+
+void	sdr_sync_counts(Sdr sdrv, unsigned long *commits,
+		unsigned long *syncs)
+{
+	CHKVOID(sdrv);
+	CHKVOID(commits);
+	CHKVOID(syncs);
+	*commits = sdrv->sdr->commitCount;
+	*syncs = sdrv->sdr->syncCount;
+}
+
 void	sdr_stop_using(Sdr sdrv)
 {
 	PsmPartition	sdrwm = _sdrwm(NULL);
@@ -1347,7 +2109,14 @@ void	sdr_stop_using(Sdr sdrv)
 
 	if (sdrv->dbsm)
 	{
-		sm_ShmDetach(sdrv->dbsm);
+		if (sdrv->sdr->configFlags & SDR_MAPPED)
+		{
+			unmapFile(sdrv->dbsm, sdrv->sdr->sdrSize);
+		}
+		else
+		{
+			sm_ShmDetach(sdrv->dbsm);
+		}
 	}
 
 	if (sdrv->logfile != -1)
@@ -1365,6 +2134,11 @@ void	sdr_stop_using(Sdr sdrv)
 		lyst_destroy(sdrv->knownObjects);
 	}
 
+	if (sdrv->dirtyExtents)
+	{
+		lyst_destroy(sdrv->dirtyExtents);
+	}
+
 	psm_free(sdrwm, psa(sdrwm, sdrv));
 }
 
@@ -1404,6 +2178,8 @@ void	sdr_destroy(Sdr sdrv)
 
 	sdr = sdrv->sdr;
 	sm_SemDelete(sdr->sdrSemaphore);	/*	Interrupt.	*/
+	destroyAuxSemaphores(sdr);
+
 	sdr_stop_using(sdrv);
 	sm_SemTake(sch->lock);
 
@@ -1441,6 +2217,11 @@ void	sdr_destroy(Sdr sdrv)
 
 	/*	Unload profile and destroy it.				*/
 
+	if (sdr->logBuffer)
+	{
+		psm_free(sdrwm, sdr->logBuffer);
+	}
+
 	oK(sm_list_delete(sdrwm, sdr->sdrsElt, NULL, NULL));
 	psm_free(sdrwm, psa(sdrwm, sdr));
 	sm_SemGive(sch->lock);
@@ -1451,8 +2232,23 @@ void	sdr_destroy(Sdr sdrv)
 void	sdr_begin_xn(Sdr sdrv)
 {
 	CHKVOID(sdrv);
-	sdrv->modified = 0;
-	oK(takeSdr(sdrv->sdr));
+
+	/*	The modified flag notes only updates made since the
+	 *	most recent sdr_begin_xn, nested or not, so that an
+	 *	sdr_exit_xn following updates can be detected.  It
+	 *	is shared by all threads of the process, so it may
+	 *	be cleared only once this thread owns the SDR (not
+	 *	merely reading it); clearing it while waiting for
+	 *	the SDR would clobber the flag of another thread's
+	 *	transaction in progress.  Whether or not anything
+	 *	has been updated in the transaction as a whole is
+	 *	noted by the updated flag, which is cleared only
+	 *	when the transaction is terminated.			*/
+
+	if (takeSdr(sdrv->sdr) == 0 && sdr_in_xn(sdrv))
+	{
+		sdrv->modified = 0;
+	}
 }
 
 int	sdr_in_xn(Sdr sdrv)
@@ -1485,12 +2281,158 @@ void	sdr_exit_xn(Sdr sdrv)
 				handleUnrecoverableError(sdrv);
 			}
 
+			if (sdrv->updated)
+			{
+				/*	Data were modified only in
+				 *	nested transactions that were
+				 *	ended, so the updates must be
+				 *	committed now.			*/
+
+				oK(terminateXn(sdrv));
+				return;
+			}
+
 			clearTransaction(sdrv);
 			unlockSdr(sdr);
 		}
 	}
 }
 
+void	sdr_begin_read(Sdr sdrv)
+{
+	SdrState	*sdr;
+	SdrReader	*reader;
+	int		i;
+
+	CHKVOID(sdrv);
+	sdr = sdrv->sdr;
+	if (sdr_in_xn(sdrv))		/*	Nested in transaction.	*/
+	{
+		sdr->xnDepth++;
+		return;
+	}
+
+	reader = findReader(sdr);
+	if (reader)			/*	Nested read.		*/
+	{
+		reader->readDepth++;
+		return;
+	}
+
+	if (sdr->sdrSemaphore == -1
+	|| sm_SemTake(sdr->sdrSemaphore) < 0)
+	{
+		putErrmsg("Can't lock SDR for reading.", NULL);
+		return;
+	}
+
+	if (sdr->readerSemaphore == -1
+	|| sm_SemTake(sdr->readerSemaphore) < 0)
+	{
+		sm_SemGive(sdr->sdrSemaphore);
+		putErrmsg("Can't register SDR reader.", NULL);
+		return;
+	}
+
+	for (i = 0, reader = sdr->readers; i < SDR_MAX_READERS; i++, reader++)
+	{
+		if (reader->readDepth == 0)
+		{
+			break;
+		}
+	}
+
+#ifdef VXWORKS
+	/*	Without pread(), reading a heap that is only in the
+	 *	db file moves the shared file offset, so such reads
+	 *	can't be concurrent.					*/
+
+	if (!HEAP_IN_MEMORY(sdr->configFlags))
+	{
+		i = SDR_MAX_READERS;
+	}
+#endif
+	if (i == SDR_MAX_READERS)
+	{
+		/*	Reader table is full (or reads can't be shared),
+		 *	so read with exclusive access instead, exactly
+		 *	as if in a transaction in which nothing is
+		 *	modified.					*/
+
+		sm_SemGive(sdr->readerSemaphore);
+		if (waitForReaders(sdr) < 0)
+		{
+			sm_SemGive(sdr->sdrSemaphore);
+			putErrmsg("Can't lock SDR for reading.", NULL);
+			return;
+		}
+
+		sdrv->modified = 0;
+		sdr->sdrOwnerTask = sm_TaskIdSelf();
+		sdr->sdrOwnerThread = pthread_self();
+		sdr->xnDepth = 1;
+		return;
+	}
+
+	if (sdr->readerCount == 0)
+	{
+		/*	First reader holds drainSemaphore on behalf of
+		 *	all readers.  No writer can be waiting for it,
+		 *	because we hold sdrSemaphore.			*/
+
+		oK(sm_SemTake(sdr->drainSemaphore));
+	}
+
+	reader->readerTask = sm_TaskIdSelf();
+	reader->readerThread = pthread_self();
+	reader->readDepth = 1;
+	sdr->readerCount++;
+	sm_SemGive(sdr->readerSemaphore);
+	sm_SemGive(sdr->sdrSemaphore);
+}
+
+int	sdr_in_read(Sdr sdrv)
+{
+	CHKZERO(sdrv);
+	return (sdr_in_xn(sdrv) || findReader(sdrv->sdr) != NULL);
+}
+
+void	sdr_end_read(Sdr sdrv)
+{
+	SdrState	*sdr;
+	SdrReader	*reader;
+
+	CHKVOID(sdrv);
+	sdr = sdrv->sdr;
+	if (sdr_in_xn(sdrv))
+	{
+		sdr_exit_xn(sdrv);
+		return;
+	}
+
+	reader = findReader(sdr);
+	if (reader == NULL)
+	{
+		return;
+	}
+
+	if (reader->readDepth > 1)
+	{
+		reader->readDepth--;
+		return;
+	}
+
+	oK(sm_SemTake(sdr->readerSemaphore));
+	reader->readDepth = 0;
+	sdr->readerCount--;
+	if (sdr->readerCount == 0)
+	{
+		sm_SemGive(sdr->drainSemaphore);
+	}
+
+	sm_SemGive(sdr->readerSemaphore);
+}
+
 void	sdr_cancel_xn(Sdr sdrv)
 {
 	SdrState	*sdr;
@@ -1503,7 +2445,7 @@ void	sdr_cancel_xn(Sdr sdrv)
 		sdr->xnDepth--;
 		if (sdr->xnDepth == 0)
 		{
-			terminateXn(sdrv);
+			oK(terminateXn(sdrv));
 		}
 	}
 }
@@ -1519,9 +2461,13 @@ int	sdr_end_xn(Sdr sdrv)
 		sdr->xnDepth--;
 		if (sdr->xnDepth == 0)
 		{
-			terminateXn(sdrv);
+			return terminateXn(sdrv);
 		}
 
+		/*	The nested transaction's updates are ended,
+		 *	to be committed with the outermost one.		*/
+
+		sdrv->modified = 0;
 		return 0;
 	}
 
@@ -1543,14 +2489,14 @@ void	sdr_eject_xn(Sdr sdrv)
 	{
 		sdr->xnCanceled = 1;
 		sdr->xnDepth = 0;
-		terminateXn(sdrv);
+		oK(terminateXn(sdrv));
 	}
 }
 
 void	*sdr_pointer(Sdr sdrv, Address address)
 {
 	CHKNULL(sdrv);
-	if ((sdrv->sdr->configFlags & SDR_IN_DRAM) == 0 || address <= 0)
+	if (HEAP_IN_MEMORY(sdrv->sdr->configFlags) == 0 || address <= 0)
 	{
 		return NULL;
 	}
@@ -1564,7 +2510,7 @@ Address	sdr_address(Sdr sdrv, void *pointer)
 
 	CHKZERO(sdrv);
 	ptr = (char *) pointer;
-	if ((sdrv->sdr->configFlags & SDR_IN_DRAM) == 0 || ptr <= sdrv->dbsm)
+	if (HEAP_IN_MEMORY(sdrv->sdr->configFlags) == 0 || ptr <= sdrv->dbsm)
 	{
 		return 0;
 	}
@@ -1635,10 +2581,53 @@ void	_sdrput(char *file, int line, Sdr sdrv, Address into, char *from,
 		}
 	}
 
-	if (sdr->configFlags & SDR_REVERSIBLE)
+	if (sdr->configFlags & SDR_REVERSIBLE
+	&& sdr->configFlags & SDR_SYNCED
+	&& lyst_length(sdrv->logEntries) == 0)
+	{
+		/*	The log of a synced SDR may still contain the
+		 *	entries of transactions committed since the
+		 *	last group sync, so this transaction's entries
+		 *	follow them.					*/
+
+		sdrv->logfileLength = lseek(sdrv->logfile, 0, SEEK_END);
+		if (sdrv->logfileLength < 0)
+		{
+			_putSysErrmsg(file, line, "Can't seek to end of log",
+					NULL);
+			crashXn(sdrv);
+			return;
+		}
+	}
+
+	if (sdr->configFlags & SDR_REVERSIBLE
+	&& sdr->configFlags & SDR_BUFFERED)
+	{
+		if (bufferLogEntry(sdrv, into, length) < 0)
+		{
+			_putErrmsg(file, line, "Can't buffer log entry.",
+					itoa(length));
+			crashXn(sdrv);
+			return;
+		}
+
+		logOffset = sdrv->logfileLength;
+		if (lyst_insert_last(sdrv->logEntries, (void *) logOffset)
+				== NULL)
+		{
+			_putErrmsg(file, line, "Can't note transaction log \
+entry.", NULL);
+			crashXn(sdrv);
+			return;
+		}
+
+		sdrv->logfileLength += (length + sizeof logEntryControl);
+	}
+	else if (sdr->configFlags & SDR_REVERSIBLE)
 	{
 		logEntryControl[0] = into;
 		logEntryControl[1] = length;
+		sdrv->logfileWritten = 1;
 		if (write(sdrv->logfile, (char *) logEntryControl,
 			sizeof logEntryControl) < sizeof logEntryControl)
 		{
@@ -1648,7 +2637,7 @@ void	_sdrput(char *file, int line, Sdr sdrv, Address into, char *from,
 			return;
 		}
 
-		if (sdr->configFlags & SDR_IN_DRAM)
+		if (HEAP_IN_MEMORY(sdr->configFlags))
 		{
 			if (write(sdrv->logfile, sdrv->dbsm + into, length)
 					< length)
@@ -1710,22 +2699,36 @@ entry.", NULL);
 
 	if (sdr->configFlags & SDR_IN_FILE)
 	{
-		if (lseek(sdrv->dbfile, into, SEEK_SET) < 0
-		|| write(sdrv->dbfile, from, length) < length)
+		if (sdr->configFlags & (SDR_BUFFERED | SDR_MAPPED))
 		{
-			_putSysErrmsg(file, line, "Can't write to database",
-					itoa(length));
-			crashXn(sdrv);
-			return;
+			if (noteDirtyExtent(sdrv, into, length) < 0)
+			{
+				_putErrmsg(file, line, "Can't note dirty \
+extent.", itoa(length));
+				crashXn(sdrv);
+				return;
+			}
+		}
+		else
+		{
+			if (lseek(sdrv->dbfile, into, SEEK_SET) < 0
+			|| write(sdrv->dbfile, from, length) < length)
+			{
+				_putSysErrmsg(file, line, "Can't write to \
+database", itoa(length));
+				crashXn(sdrv);
+				return;
+			}
 		}
 	}
 
-	if (sdr->configFlags & SDR_IN_DRAM)
+	if (HEAP_IN_MEMORY(sdr->configFlags))
 	{
 		memcpy(sdrv->dbsm + into, from, length);
 	}
 
 	sdrv->modified = 1;
+	sdrv->updated = 1;
 }
 
 void	Sdr_write(char *file, int line, Sdr sdrv, Address into, char *from,
@@ -1765,7 +2768,7 @@ void	_sdrfetch(Sdr sdrv, char *into, Address from, long length)
 		return;
 	}
 
-	if (sdr->configFlags & SDR_IN_DRAM)
+	if (HEAP_IN_MEMORY(sdr->configFlags))
 	{
 		memcpy(into, sdrv->dbsm + from, length);
 	}
@@ -1773,8 +2776,15 @@ void	_sdrfetch(Sdr sdrv, char *into, Address from, long length)
 	{
 		if (sdr->configFlags & SDR_IN_FILE)
 		{
+			/*	Shared readers in the same process use
+			 *	the same file descriptor, so the read
+			 *	must not depend on the file offset.	*/
+#ifdef VXWORKS
 			if (lseek(sdrv->dbfile, from, SEEK_SET) < 0
 			|| read(sdrv->dbfile, into, length) < length)
+#else
+			if (pread(sdrv->dbfile, into, length, from) < length)
+#endif
 			{
 				putSysErrmsg("Database read failed",
 						itoa(length));
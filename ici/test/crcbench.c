@@ -0,0 +1,234 @@
+/*
+	crcbench.c:	test of crc16_ccitt() against the classic
+			one-byte-at-a-time CRC algorithm, plus a
+			comparison of their throughput.
+
+	Copyright (c) 2010, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+									*/
+#include "platform.h"
+#include "crc.h"
+
+#define	DEFAULT_BUFFER_LENGTH	(65536)
+#define	DEFAULT_ITERATIONS	(1000)
+#define	MAX_CHECK_LENGTH	(1024)
+#define	MAX_CHECK_ALIGNMENT	(8)
+
+/*	The reference CRC is the table-driven algorithm formerly
+ *	used by CFDP, consuming one byte per table lookup.		*/
+
+static unsigned short	referenceCRC(unsigned char *buffer, int length,
+				unsigned short crc)
+{
+	static int		crcCalcValuesInitialized = 0;
+	static unsigned int	crcCalcValues[256];
+	int			i;
+	unsigned int		tmp;
+
+	if (!crcCalcValuesInitialized)
+	{
+		for (i = 0; i < 256; i++)
+		{
+			tmp = 0;
+			if ((i & 1) != 0) tmp = tmp ^ 0x1021;
+			if ((i & 2) != 0) tmp = tmp ^ 0x2042;
+			if ((i & 4) != 0) tmp = tmp ^ 0x4084;
+			if ((i & 8) != 0) tmp = tmp ^ 0x8108;
+			if ((i & 16) != 0) tmp = tmp ^ 0x1231;
+			if ((i & 32) != 0) tmp = tmp ^ 0x2462;
+			if ((i & 64) != 0) tmp = tmp ^ 0x48c4;
+			if ((i & 128) != 0) tmp = tmp ^ 0x9188;
+			crcCalcValues[i] = tmp;
+		}
+
+		crcCalcValuesInitialized = 1;
+	}
+
+	while (length > 0)
+	{
+		crc = (((crc << 8) & 0xff00)
+			^ crcCalcValues[(((crc >> 8) ^ (*buffer)) & 0x00ff)]);
+		buffer++;
+		length--;
+	}
+
+	return crc;
+}
+
+static int	checkCRC()
+{
+	unsigned char	buffer[MAX_CHECK_LENGTH + MAX_CHECK_ALIGNMENT + 2];
+	int		errors = 0;
+	int		i;
+	int		align;
+	int		length;
+	unsigned short	expected;
+	unsigned short	computed;
+
+	computed = crc16_ccitt((unsigned char *) "123456789", 9,
+			CRC16_CCITT_INIT);
+	if (computed != 0x29b1)
+	{
+		printf("Check value is %04x, should be 29b1.\n", computed);
+		errors++;
+	}
+
+	srand(1);
+	for (i = 0; i < sizeof buffer; i++)
+	{
+		buffer[i] = rand() & 0xff;
+	}
+
+	for (align = 0; align < MAX_CHECK_ALIGNMENT; align++)
+	{
+		for (length = 0; length <= MAX_CHECK_LENGTH; length++)
+		{
+			expected = referenceCRC(buffer + align, length,
+					CRC16_CCITT_INIT);
+			computed = crc16_ccitt(buffer + align, length,
+					CRC16_CCITT_INIT);
+			if (computed != expected)
+			{
+				printf("Length %d, alignment %d: CRC is \
+%04x, should be %04x.\n", length, align, computed, expected);
+				errors++;
+				continue;
+			}
+
+			/*	Check in two pieces, and with the CRC
+			 *	itself appended.			*/
+
+			i = length / 3;
+			computed = crc16_ccitt(buffer + align, i,
+					CRC16_CCITT_INIT);
+			computed = crc16_ccitt(buffer + align + i, length - i,
+					computed);
+			if (computed != expected)
+			{
+				printf("Length %d, alignment %d: split CRC \
+is %04x, should be %04x.\n", length, align, computed, expected);
+				errors++;
+				continue;
+			}
+
+			buffer[align + length] = expected >> 8;
+			buffer[align + length + 1] = expected & 0xff;
+			computed = crc16_ccitt(buffer + align, length + 2,
+					CRC16_CCITT_INIT);
+			buffer[align + length] = rand() & 0xff;
+			buffer[align + length + 1] = rand() & 0xff;
+			if (computed != 0)
+			{
+				printf("Length %d, alignment %d: CRC with \
+CRC appended is %04x, should be 0.\n", length, align, computed);
+				errors++;
+			}
+		}
+	}
+
+	return errors;
+}
+
+static double	megabytesPerSecond(struct timeval *start, struct timeval *end,
+			long bytes)
+{
+	double	seconds;
+
+	seconds = (end->tv_sec - start->tv_sec)
+			+ ((end->tv_usec - start->tv_usec) / 1000000.0);
+	if (seconds <= 0.0)
+	{
+		return 0.0;
+	}
+
+	return (bytes / seconds) / 1000000.0;
+}
+
+static int	run_crcbench(int bufferLength, int iterations)
+{
+	unsigned char	*buffer;
+	int		errors;
+	int		i;
+	unsigned short	expected = 0;
+	unsigned short	computed = 0;
+	struct timeval	start;
+	struct timeval	end;
+
+	errors = checkCRC();
+	printf("%d CRC errors.\n", errors);
+	buffer = (unsigned char *) malloc(bufferLength);
+	if (buffer == NULL)
+	{
+		putSysErrmsg("Can't allocate benchmark buffer",
+				itoa(bufferLength));
+		return 1;
+	}
+
+	for (i = 0; i < bufferLength; i++)
+	{
+		buffer[i] = rand() & 0xff;
+	}
+
+	getCurrentTime(&start);
+	for (i = 0; i < iterations; i++)
+	{
+		expected = referenceCRC(buffer, bufferLength,
+				CRC16_CCITT_INIT);
+	}
+
+	getCurrentTime(&end);
+	printf("bytewise:   %10.1f MB/sec\n", megabytesPerSecond(&start,
+			&end, ((long) bufferLength) * iterations));
+	getCurrentTime(&start);
+	for (i = 0; i < iterations; i++)
+	{
+		computed = crc16_ccitt(buffer, bufferLength,
+				CRC16_CCITT_INIT);
+	}
+
+	getCurrentTime(&end);
+	printf("crc16_ccitt: %9.1f MB/sec\n", megabytesPerSecond(&start,
+			&end, ((long) bufferLength) * iterations));
+	if (computed != expected)
+	{
+		printf("Benchmark CRC is %04x, should be %04x.\n", computed,
+				expected);
+		errors++;
+	}
+
+	free(buffer);
+	return (errors == 0 ? 0 : 1);
+}
+
+#if defined (VXWORKS) || defined (RTEMS)
+int	crcbench(int a1, int a2, int a3, int a4, int a5,
+		int a6, int a7, int a8, int a9, int a10)
+{
+	int	bufferLength = a1 ? a1 : DEFAULT_BUFFER_LENGTH;
+	int	iterations = a2 ? a2 : DEFAULT_ITERATIONS;
+#else
+int	main(int argc, char **argv)
+{
+	int	bufferLength = DEFAULT_BUFFER_LENGTH;
+	int	iterations = DEFAULT_ITERATIONS;
+
+	if (argc > 1)
+	{
+		bufferLength = atoi(argv[1]);
+	}
+
+	if (argc > 2)
+	{
+		iterations = atoi(argv[2]);
+	}
+
+	if (bufferLength < 1 || iterations < 1)
+	{
+		PUTS("Usage:  crcbench [<buffer length> [<iterations>]]");
+		return 0;
+	}
+#endif
+	return run_crcbench(bufferLength, iterations);
+}
@@ -0,0 +1,413 @@
+/*
+	sdrrbtbench.c:	test of SDR red-black tree insertion,
+			deletion, and ordered traversal, plus a
+			benchmark comparing the cost of inserting
+			time-ordered events into a sorted SDR list
+			and into an SDR red-black tree.
+
+	Copyright (c) 2010, California Institute of Technology.
+	ALL RIGHTS RESERVED.  U.S. Government Sponsorship
+	acknowledged.
+
+									*/
+#include "platform.h"
+#include "sdr.h"
+#include "sdrrbt.h"
+
+#define	BENCH_SDR_NAME		"rbtbench"
+#define	BENCH_WM_SIZE		(1000000)
+#define	BENCH_PATH_NAME		"/usr/sdr"
+#define	DEFAULT_MAX_EVENTS	(16000)
+#define	FIRST_CHECKPOINT	(1000)
+#define	EVENT_TIME_WINDOW	(86400)
+#define	CHECK_EVENTS		(2000)
+#define	CHECK_TIME_WINDOW	(500)
+
+typedef struct
+{
+	time_t		time;
+	int		type;
+	Object		ref;
+} BenchEvent;
+
+static int	orderEvents(Sdr sdr, Address eventObj, void *argData)
+{
+	BenchEvent	*newEvent = (BenchEvent *) argData;
+			OBJ_POINTER(BenchEvent, event);
+
+	GET_OBJ_POINTER(sdr, BenchEvent, event, eventObj);
+	if (event->time < newEvent->time)
+	{
+		return -1;
+	}
+
+	if (event->time > newEvent->time)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static void	freeEvent(Sdr sdr, Address eventObj, void *arg)
+{
+	sdr_free(sdr, eventObj);
+}
+
+/*	Checks that the events in the tree are in time order and, for
+ *	equal times, in insertion order (recorded in the event type),
+ *	reading the tree both forward and backward.			*/
+
+static int	checkOrder(Sdr sdr, Object rbt, long expectedLength)
+{
+	int		errors = 0;
+	int		direction;
+	long		count;
+	Object		node;
+	BenchEvent	event;
+	BenchEvent	prevEvent;
+
+	for (direction = 1; direction >= -1; direction -= 2)
+	{
+		count = 0;
+		node = (direction > 0 ? sdr_rbt_first(sdr, rbt)
+				: sdr_rbt_last(sdr, rbt));
+		while (node)
+		{
+			sdr_read(sdr, (char *) &event, sdr_rbt_data(sdr, node),
+					sizeof(BenchEvent));
+			if (count > 0 && (direction * (event.time
+					- prevEvent.time) < 0
+			|| (event.time == prevEvent.time
+				&& direction * (event.type
+					- prevEvent.type) <= 0)))
+			{
+				printf("Event %ld of %ld (%s) is out of \
+order.\n", count, expectedLength, direction > 0 ? "forward"
+						: "backward");
+				errors++;
+			}
+
+			prevEvent = event;
+			count++;
+			node = (direction > 0 ? sdr_rbt_next(sdr, node)
+					: sdr_rbt_prev(sdr, node));
+		}
+
+		if (count != expectedLength)
+		{
+			printf("Traversal (%s) found %ld events, should be \
+%ld.\n", direction > 0 ? "forward" : "backward", count,
+					expectedLength);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+static int	checkRbt(Sdr sdr)
+{
+	int		errors = 0;
+	Object		rbt;
+	Object		nodes[CHECK_EVENTS];
+	time_t		times[CHECK_EVENTS];
+	BenchEvent	event;
+	Object		eventObj;
+	Object		node;
+	Object		successor;
+	long		eventCount;
+	long		i;
+	long		j;
+
+	sdr_begin_xn(sdr);
+	rbt = sdr_rbt_create(sdr);
+	if (sdr_end_xn(sdr) < 0 || rbt == 0)
+	{
+		putErrmsg("Can't create tree.", NULL);
+		writeErrmsgMemos();
+		return 1;
+	}
+
+	/*	Insert events whose times fall in a narrow window,
+	 *	so that many share a time, checking the tree's
+	 *	invariants after every insertion.			*/
+
+	srand(1);
+	memset((char *) &event, 0, sizeof(BenchEvent));
+	for (eventCount = 0; eventCount < CHECK_EVENTS; eventCount++)
+	{
+		event.time = rand() % CHECK_TIME_WINDOW;
+		event.type = eventCount;
+		times[eventCount] = event.time;
+		sdr_begin_xn(sdr);
+		eventObj = sdr_malloc(sdr, sizeof(BenchEvent));
+		if (eventObj)
+		{
+			sdr_write(sdr, eventObj, (char *) &event,
+					sizeof(BenchEvent));
+			nodes[eventCount] = sdr_rbt_insert(sdr, rbt, eventObj,
+					orderEvents, &event);
+		}
+
+		if (sdr_end_xn(sdr) < 0 || eventObj == 0
+		|| nodes[eventCount] == 0)
+		{
+			putErrmsg("Can't insert event.", NULL);
+			writeErrmsgMemos();
+			return errors + 1;
+		}
+
+		if (sdr_rbt_check(sdr, rbt) < 0)
+		{
+			printf("Tree is invalid after insertion %ld.\n",
+					eventCount);
+			writeErrmsgMemos();
+			errors++;
+		}
+	}
+
+	if (sdr_rbt_length(sdr, rbt) != CHECK_EVENTS)
+	{
+		printf("Tree length is %ld, should be %d.\n",
+				sdr_rbt_length(sdr, rbt), CHECK_EVENTS);
+		errors++;
+	}
+
+	errors += checkOrder(sdr, rbt, CHECK_EVENTS);
+
+	/*	Search must find the earliest-inserted event at each
+	 *	time, or else the successor of a time that is absent.	*/
+
+	for (event.time = -1; event.time <= CHECK_TIME_WINDOW; event.time++)
+	{
+		node = sdr_rbt_search(sdr, rbt, orderEvents, &event,
+				&successor);
+		if (node == 0)
+		{
+			node = successor;
+		}
+
+		for (i = 0, j = -1; i < CHECK_EVENTS; i++)
+		{
+			if (times[i] >= event.time
+			&& (j < 0 || times[i] < times[j]))
+			{
+				j = i;	/*	Earliest of least time.	*/
+			}
+		}
+
+		if (node != (j < 0 ? 0 : nodes[j]))
+		{
+			printf("Search for time %ld found the wrong node.\n",
+					(long) event.time);
+			errors++;
+		}
+	}
+
+	/*	Delete the events in random order, checking the tree's
+	 *	invariants after every deletion.			*/
+
+	for (i = CHECK_EVENTS - 1; i > 0; i--)
+	{
+		j = rand() % (i + 1);
+		node = nodes[i];
+		nodes[i] = nodes[j];
+		nodes[j] = node;
+	}
+
+	for (i = 0; i < CHECK_EVENTS; i++)
+	{
+		sdr_begin_xn(sdr);
+		sdr_rbt_delete(sdr, nodes[i], freeEvent, NULL);
+		if (sdr_end_xn(sdr) < 0)
+		{
+			putErrmsg("Can't delete event.", NULL);
+			writeErrmsgMemos();
+			return errors + 1;
+		}
+
+		if (sdr_rbt_check(sdr, rbt) < 0)
+		{
+			printf("Tree is invalid after deletion %ld.\n", i);
+			writeErrmsgMemos();
+			errors++;
+		}
+
+		if (i == CHECK_EVENTS / 2)
+		{
+			errors += checkOrder(sdr, rbt, CHECK_EVENTS - (i + 1));
+		}
+	}
+
+	if (sdr_rbt_length(sdr, rbt) != 0 || sdr_rbt_first(sdr, rbt) != 0
+	|| sdr_rbt_last(sdr, rbt) != 0)
+	{
+		printf("Tree is not empty after all deletions.\n");
+		errors++;
+	}
+
+	sdr_begin_xn(sdr);
+	sdr_rbt_destroy(sdr, rbt, NULL, NULL);
+	oK(sdr_end_xn(sdr));
+	return errors;
+}
+
+static long	elapsed(struct timeval *start, struct timeval *end)
+{
+	return ((end->tv_sec - start->tv_sec) * 1000000)
+			+ (end->tv_usec - start->tv_usec);
+}
+
+static int	run_sdrrbtbench(int configFlags, long maxEvents)
+{
+	char		sdrName[256];
+	Sdr		sdr;
+	Object		list;
+	Object		rbt;
+	BenchEvent	event;
+	Object		eventObj;
+	long		eventCount = 0;
+	long		checkpoint = FIRST_CHECKPOINT;
+	long		intervalCount = 0;
+	long		listUsec = 0;
+	long		rbtUsec = 0;
+	struct timeval	startTime;
+	struct timeval	endTime;
+	int		errors;
+
+	isprintf(sdrName, sizeof sdrName, "%s%d", BENCH_SDR_NAME,
+			configFlags);
+	sdr_initialize(BENCH_WM_SIZE, NULL, SM_NO_KEY, NULL);
+	if (sdr_load_profile(sdrName, configFlags, 100000 + (maxEvents * 32),
+			SM_NO_KEY, BENCH_PATH_NAME) < 0)
+	{
+		putErrmsg("Can't load SDR profile.", sdrName);
+		writeErrmsgMemos();
+		return 0;
+	}
+
+	sdr = sdr_start_using(sdrName);
+	if (sdr == NULL)
+	{
+		putErrmsg("Can't use sdr.", sdrName);
+		writeErrmsgMemos();
+		return 0;
+	}
+
+	errors = checkRbt(sdr);
+	printf("%d tree errors.\n", errors);
+	sdr_begin_xn(sdr);
+	list = sdr_list_create(sdr);
+	rbt = sdr_rbt_create(sdr);
+	if (sdr_end_xn(sdr) < 0 || list == 0 || rbt == 0)
+	{
+		putErrmsg("Can't create timelines.", NULL);
+		writeErrmsgMemos();
+		return 0;
+	}
+
+	PUTS("  events     list usec/insert      rbt usec/insert");
+	srand(1);
+	memset((char *) &event, 0, sizeof(BenchEvent));
+	while (eventCount < maxEvents)
+	{
+		/*	Event times are scattered across a day, as
+		 *	for a mix of TTL, custody, and retransmission
+		 *	deadlines.  The same event is inserted into
+		 *	both timelines, each in its own transaction.	*/
+
+		event.time = rand() % EVENT_TIME_WINDOW;
+		sdr_begin_xn(sdr);
+		eventObj = sdr_malloc(sdr, sizeof(BenchEvent));
+		if (eventObj)
+		{
+			sdr_write(sdr, eventObj, (char *) &event,
+					sizeof(BenchEvent));
+		}
+
+		if (sdr_end_xn(sdr) < 0 || eventObj == 0)
+		{
+			putErrmsg("Can't create event.", NULL);
+			writeErrmsgMemos();
+			break;
+		}
+
+		getCurrentTime(&startTime);
+		sdr_begin_xn(sdr);
+		oK(sdr_list_insert(sdr, list, eventObj, orderEvents, &event));
+		if (sdr_end_xn(sdr) < 0)
+		{
+			putErrmsg("Can't insert into list.", NULL);
+			writeErrmsgMemos();
+			break;
+		}
+
+		getCurrentTime(&endTime);
+		listUsec += elapsed(&startTime, &endTime);
+		getCurrentTime(&startTime);
+		sdr_begin_xn(sdr);
+		oK(sdr_rbt_insert(sdr, rbt, eventObj, orderEvents, &event));
+		if (sdr_end_xn(sdr) < 0)
+		{
+			putErrmsg("Can't insert into rbt.", NULL);
+			writeErrmsgMemos();
+			break;
+		}
+
+		getCurrentTime(&endTime);
+		rbtUsec += elapsed(&startTime, &endTime);
+		eventCount++;
+		intervalCount++;
+		if (eventCount == checkpoint || eventCount == maxEvents)
+		{
+			printf("%8ld %20.2f %20.2f\n", eventCount,
+					((double) listUsec) / intervalCount,
+					((double) rbtUsec) / intervalCount);
+			fflush(stdout);
+			checkpoint *= 2;
+			intervalCount = 0;
+			listUsec = 0;
+			rbtUsec = 0;
+		}
+	}
+
+	sdr_begin_xn(sdr);
+	sdr_list_destroy(sdr, list, NULL, NULL);
+	sdr_rbt_destroy(sdr, rbt, NULL, NULL);
+	oK(sdr_end_xn(sdr));
+	sdr_stop_using(sdr);
+	sdr_shutdown();
+	return (errors == 0 ? 0 : 1);
+}
+
+#if defined (VXWORKS) || defined (RTEMS)
+int	sdrrbtbench(int a1, int a2, int a3, int a4, int a5,
+		int a6, int a7, int a8, int a9, int a10)
+{
+	int	configFlags = a1 ? a1 : SDR_IN_DRAM;
+	long	maxEvents = a2 ? a2 : DEFAULT_MAX_EVENTS;
+#else
+int	main(int argc, char **argv)
+{
+	int	configFlags = SDR_IN_DRAM;
+	long	maxEvents = DEFAULT_MAX_EVENTS;
+
+	if (argc > 1)
+	{
+		configFlags = atoi(argv[1]);
+	}
+
+	if (argc > 2)
+	{
+		maxEvents = atol(argv[2]);
+	}
+
+	if (configFlags == 0 || maxEvents < 1)
+	{
+		PUTS("Usage:  sdrrbtbench [<config flags> [<max events>]]");
+		return 0;
+	}
+#endif
+	return run_sdrrbtbench(configFlags, maxEvents);
+}
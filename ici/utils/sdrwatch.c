@@ -39,12 +39,40 @@ static void	handleQuit()
 	oK(sdrwatch_count(&newCount));
 }
 
+static void	reportSyncs(Sdr sdr, unsigned long *priorCommits,
+			unsigned long *priorSyncs)
+{
+	unsigned long	commits;
+	unsigned long	syncs;
+	unsigned long	newCommits;
+	unsigned long	newSyncs;
+	char		buf[128];
+
+	sdr_sync_counts(sdr, &commits, &syncs);
+	if (commits == 0)	/*	Not SDR_SYNCED, or no commits.	*/
+	{
+		return;
+	}
+
+	newCommits = commits - *priorCommits;
+	newSyncs = syncs - *priorSyncs;
+	isprintf(buf, sizeof buf, "sync: %lu commits, %lu syncs, %.2f \
+commits per sync (total %lu commits, %lu syncs)", newCommits, newSyncs,
+			newSyncs ? ((double) newCommits / newSyncs) : 0.0,
+			commits, syncs);
+	writeMemo(buf);
+	*priorCommits = commits;
+	*priorSyncs = syncs;
+}
+
 static int	run_sdrwatch(char *sdrName, int interval, int verbose)
 {
 	Sdr		sdr;
 	SdrUsageSummary	sdrsummary;
 	int		secRemaining;
 	int		decrement = 0;
+	unsigned long	commits = 0;
+	unsigned long	syncs = 0;
 
 	sdr_initialize(0, NULL, SM_NO_KEY, NULL);
 	sdr = sdr_start_using(sdrName);
@@ -59,6 +87,7 @@ static int	run_sdrwatch(char *sdrName, int interval, int verbose)
 
 	sdr_usage(sdr, &sdrsummary);
 	sdr_report(&sdrsummary);
+	reportSyncs(sdr, &commits, &syncs);
 	if (interval == 0)	/*	One-time poll.			*/
 	{
 		return 0;
@@ -88,6 +117,7 @@ static int	run_sdrwatch(char *sdrName, int interval, int verbose)
 		}
 
 		sdr_print_trace(sdr, verbose);
+		reportSyncs(sdr, &commits, &syncs);
 		oK(sdrwatch_count(&decrement));
 	}
 
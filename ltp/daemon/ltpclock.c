@@ -9,6 +9,15 @@
 	
 									*/
 #include "ltpP.h"
+#include "timewheel.h"
+
+typedef struct
+{
+	Sdr		sdr;
+	Object		timeline;
+	TwTimer		*timelineTimer;
+	time_t		timelineDeadline;
+} LtpClock;
 
 static int	_running(int *newValue)
 {
@@ -35,6 +44,7 @@ static void	shutDown()	/*	Commands ltpclock termination.	*/
 	int	stop = 0;
 
 	oK(_running(&stop));	/*	Terminates ltpclock.		*/
+	sm_SemGive(getLtpVdb()->clockSemaphore);
 }
 
 static int	dispatchEvents(Sdr sdr, Object events, time_t currentTime)
@@ -47,14 +57,14 @@ static int	dispatchEvents(Sdr sdr, Object events, time_t currentTime)
 	while (1)
 	{
 		sdr_begin_xn(sdr);
-		elt = sdr_list_first(sdr, events);
+		elt = sdr_rbt_first(sdr, events);
 		if (elt == 0)	/*	No more events to dispatch.	*/
 		{
 			sdr_exit_xn(sdr);
 			return 0;
 		}
 
-		eventObj = sdr_list_data(sdr, elt);
+		eventObj = sdr_rbt_data(sdr, elt);
 		sdr_read(sdr, (char *) &event, eventObj, sizeof(LtpEvent));
 		if (event.scheduledTime > currentTime)
 		{
@@ -65,7 +75,7 @@ static int	dispatchEvents(Sdr sdr, Object events, time_t currentTime)
 		}
 
 		sdr_free(sdr, eventObj);
-		sdr_list_delete(sdr, elt, NULL, NULL);
+		sdr_rbt_delete(sdr, elt, NULL, NULL);
 		switch (event.type)
 		{
 		case LtpResendCheckpoint:
@@ -228,6 +238,107 @@ static int	manageLinks(Sdr sdr, time_t currentTime)
 	return 0;
 }
 
+/*	*	*	Timer functions		*	*	*	*/
+
+static void	dispatchTimeline(TimeWheel *wheel, void *arg)
+{
+	LtpClock	*clock = (LtpClock *) arg;
+	int		stop = 0;
+
+	clock->timelineTimer = NULL;
+	if (dispatchEvents(clock->sdr, clock->timeline, getUTCTime()) < 0)
+	{
+		putErrmsg("Can't dispatch events.", NULL);
+		oK(_running(&stop));
+	}
+}
+
+/*	Returns the local clock time at which the next whole second
+ *	of UTC begins, for events that are scheduled by UTC second.	*/
+
+static void	getSecondBoundary(time_t utcTime, struct timeval *deadline)
+{
+	getCurrentTime(deadline);
+	deadline->tv_sec = utcTime + (deadline->tv_sec - getUTCTime());
+	deadline->tv_usec = 0;
+}
+
+static void	manageLinksOnce(TimeWheel *wheel, void *arg)
+{
+	LtpClock	*clock = (LtpClock *) arg;
+	int		stop = 0;
+	time_t		currentTime;
+	struct timeval	deadline;
+
+	/*	Link management (including the aging of aggregated
+	 *	blocks) is performed once per second, at the start
+	 *	of each second.						*/
+
+	currentTime = getUTCTime();
+	if (manageLinks(clock->sdr, currentTime) < 0)
+	{
+		putErrmsg("Can't manage links.", NULL);
+		oK(_running(&stop));
+		return;
+	}
+
+	getSecondBoundary(currentTime + 1, &deadline);
+	if (tw_insert(wheel, &deadline, manageLinksOnce, clock) == NULL)
+	{
+		putErrmsg("Can't schedule link management.", NULL);
+		oK(_running(&stop));
+	}
+}
+
+/*	Makes sure the wheel holds a timer for the time of the first
+ *	event in the timeline.						*/
+
+static int	scheduleTimeline(TimeWheel *wheel, LtpClock *clock)
+{
+	Sdr		sdr = clock->sdr;
+	Object		elt;
+			OBJ_POINTER(LtpEvent, event);
+	time_t		eventTime = 0;
+	struct timeval	deadline;
+
+	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	elt = sdr_rbt_first(sdr, clock->timeline);
+	if (elt)
+	{
+		GET_OBJ_POINTER(sdr, LtpEvent, event, sdr_rbt_data(sdr, elt));
+		eventTime = event->scheduledTime;
+	}
+
+	sdr_exit_xn(sdr);
+	if (clock->timelineTimer)
+	{
+		if (elt && eventTime == clock->timelineDeadline)
+		{
+			return 0;	/*	Already scheduled.	*/
+		}
+
+		tw_cancel(wheel, clock->timelineTimer);
+		clock->timelineTimer = NULL;
+	}
+
+	if (elt == 0)
+	{
+		return 0;		/*	Nothing to schedule.	*/
+	}
+
+	getSecondBoundary(eventTime, &deadline);
+	clock->timelineTimer = tw_insert(wheel, &deadline, dispatchTimeline,
+			clock);
+	if (clock->timelineTimer == NULL)
+	{
+		putErrmsg("Can't schedule timeline dispatch.", NULL);
+		return -1;
+	}
+
+	clock->timelineDeadline = eventTime;
+	return 0;
+}
+
 #if defined (VXWORKS) || defined (RTEMS)
 int	ltpclock(int a1, int a2, int a3, int a4, int a5,
 		int a6, int a7, int a8, int a9, int a10)
@@ -236,10 +347,11 @@ int	ltpclock(int a1, int a2, int a3, int a4, int a5,
 int	main(int argc, char *argv[])
 {
 #endif
-	Sdr	sdr;
-	LtpDB	*ltpConstants;
-	int	state = 1;
-	time_t	currentTime;
+	LtpVdb		*ltpvdb;
+	int		state = 1;
+	LtpClock	clock;
+	TimeWheel	*wheel;
+	struct timeval	deadline;
 
 	if (ltpInit(0, 0) < 0)
 	{
@@ -247,47 +359,50 @@ int	main(int argc, char *argv[])
 		return 1;
 	}
 
-	sdr = getIonsdr();
-	ltpConstants = getLtpConstants();
+	ltpvdb = getLtpVdb();
+	memset((char *) &clock, 0, sizeof(LtpClock));
+	clock.sdr = getIonsdr();
+	clock.timeline = getLtpConstants()->timeline;
+	getSecondBoundary(getUTCTime() + 1, &deadline);
+	wheel = tw_create(ltpvdb->clockSemaphore);
+	if (wheel == NULL
+	|| tw_insert(wheel, &deadline, manageLinksOnce, &clock) == NULL)
+	{
+		putErrmsg("ltpclock can't start timer wheel.", NULL);
+		ionDetach();
+		return 1;
+	}
+
 	isignal(SIGTERM, shutDown);
 
-	/*	Main loop: wait for event occurrence time, then
-	 *	execute applicable events.				*/
+	/*	Main loop: sleep until the earliest of (a) the time
+	 *	of the first event in the timeline, (b) the start of
+	 *	the next second, when link state is managed, and (c)
+	 *	insertion of a new event at the front of the timeline;
+	 *	then dispatch all events whose execution times have
+	 *	now been reached.					*/
 
 	oK(_running(&state));
 	writeMemo("[i] ltpclock is running.");
 	while (_running(NULL))
 	{
-		/*	Sleep for 1 second, then dispatch all events
-		 *	whose executions times have now been reached.	*/
-
-		snooze(1);
-		currentTime = getUTCTime();
-
-		/*	Infer link state changes from rate changes
-		 *	noted in the shared ION database.		*/
-
-		if (manageLinks(sdr, currentTime) < 0)
+		if (scheduleTimeline(wheel, &clock) < 0
+		|| tw_wait(wheel) < 0)
 		{
-			putErrmsg("Can't manage links.", NULL);
+			putErrmsg("Can't manage timeline.", NULL);
 			state = 0;	/*	Terminate loop.		*/
 			oK(_running(&state));
 			continue;
 		}
 
-		/*	Then dispatch retransmission events, as
-		 *	constrained by the new link state.		*/
-
-		if (dispatchEvents(sdr, ltpConstants->timeline, currentTime)
-				< 0)
+		if (sm_SemEnded(ltpvdb->clockSemaphore))
 		{
-			putErrmsg("Can't dispatch events.", NULL);
 			state = 0;	/*	Terminate loop.		*/
 			oK(_running(&state));
-			continue;
 		}
 	}
 
+	tw_destroy(wheel);
 	writeErrmsgMemos();
 	writeMemo("[i] ltpclock has ended.");
 	ionDetach();
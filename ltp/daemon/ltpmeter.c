@@ -132,6 +132,14 @@ engine %lu is stopped.", remoteEngineId);
 		encodeSdnv(&(session.clientSvcIdSdnv), session.clientSvcId);
 		session.totalLength = span.lengthOfBufferedBlock;
 		session.redPartLength = span.redLengthOfBufferedBlock;
+		if (indexExportBlock(&session) < 0)
+		{
+			putErrmsg("Can't index block.", NULL);
+			sdr_cancel_xn(sdr);
+			returnCode = 1;
+			break;			/*	Outer loop.	*/
+		}
+
 		if ((extents = lyst_create_using(getIonMemoryMgr())) == NULL
 		|| (extent = (ExportExtent *) MTAKE(sizeof(ExportExtent)))
 				== NULL
@@ -317,6 +317,8 @@ static LtpVdb		*_ltpvdb(char **name)
 		memset((char *) vdb, 0, sizeof(LtpVdb));
 		vdb->sessionSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
 		sm_SemGive(vdb->sessionSemaphore);
+		vdb->clockSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+		sm_SemTake(vdb->clockSemaphore);
 		if ((vdb->spans = sm_list_create(wm)) == 0
 		|| psm_catlg(wm, *name, vdbAddress) < 0)
 		{
@@ -358,10 +360,23 @@ static char	*_ltpdbName()
 	return "ltpdb";
 }
 
+static int	checkLtpdbFormat(int format)
+{
+	if (format != LTP_DB_FORMAT)
+	{
+		putErrmsg("LTP database format is obsolete; must reinitialize.",
+				itoa(format));
+		return -1;
+	}
+
+	return 0;
+}
+
 int	ltpInit(int estMaxExportSessions, int bytesReserved)
 {
 	Sdr		ltpSdr;
 	Object		ltpdbObject;
+	int		ltpdbFormat;
 	IonDB		iondb;
 	long		avblForBP;
 	char		avbltyMsg[160];
@@ -381,7 +396,7 @@ int	ltpInit(int estMaxExportSessions, int bytesReserved)
 	/*	Recover the LTP database, creating it if necessary.	*/
 
 	sdr_begin_xn(ltpSdr);
-	ltpdbObject = sdr_find(ltpSdr, _ltpdbName(), NULL);
+	ltpdbObject = sdr_find(ltpSdr, _ltpdbName(), &ltpdbFormat);
 	switch (ltpdbObject)
 	{
 	case -1:		/*	SDR error.			*/
@@ -437,10 +452,10 @@ reservation size %d limits space available for bundles to %ld bytes.",
 				LTP_MEAN_SEARCH_LENGTH);
 		ltpdbBuf.deadExports = sdr_list_create(ltpSdr);
 		ltpdbBuf.spans = sdr_list_create(ltpSdr);
-		ltpdbBuf.timeline = sdr_list_create(ltpSdr);
+		ltpdbBuf.timeline = sdr_rbt_create(ltpSdr);
 		sdr_write(ltpSdr, ltpdbObject, (char *) &ltpdbBuf,
 				sizeof(LtpDB));
-		sdr_catlg(ltpSdr, _ltpdbName(), 0, ltpdbObject);
+		sdr_catlg(ltpSdr, _ltpdbName(), LTP_DB_FORMAT, ltpdbObject);
 		ionOccupy(bytesReserved);	/*	Reserve space.	*/
 		if (sdr_end_xn(ltpSdr))
 		{
@@ -452,6 +467,10 @@ reservation size %d limits space available for bundles to %ld bytes.",
 
 	default:		/*	Found DB in the SDR.		*/
 		sdr_exit_xn(ltpSdr);
+		if (checkLtpdbFormat(ltpdbFormat) < 0)
+		{
+			return -1;
+		}
 	}
 
 	oK(_ltpdbObject(&ltpdbObject));	/*	Save database location.	*/
@@ -563,6 +582,11 @@ void	ltpStop()		/*	Reverses ltpStart.		*/
 		stopSpan(vspan);
 	}
 
+	if (ltpvdb->clockSemaphore != SM_SEM_NONE)
+	{
+		sm_SemEnd(ltpvdb->clockSemaphore);
+	}
+
 	if (ltpvdb->clockPid > 0)
 	{
 		sm_TaskKill(ltpvdb->clockPid, SIGTERM);
@@ -599,6 +623,16 @@ void	ltpStop()		/*	Reverses ltpStart.		*/
 
 	sdr_begin_xn(ltpSdr);	/*	Just to lock memory.		*/
 	ltpvdb->clockPid = -1;
+	if (ltpvdb->clockSemaphore == SM_SEM_NONE)
+	{
+		ltpvdb->clockSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
+	}
+	else
+	{
+		sm_SemUnend(ltpvdb->clockSemaphore);
+	}
+
+	sm_SemTake(ltpvdb->clockSemaphore);		/*	Lock.	*/
 	if (ltpvdb->sessionSemaphore == SM_SEM_NONE)
 	{
 		ltpvdb->sessionSemaphore = sm_SemCreate(SM_NO_KEY, SM_SEM_FIFO);
@@ -631,6 +665,7 @@ int	ltpAttach()
 	Object		ltpdbObject = _ltpdbObject(NULL);
 	LtpVdb		*ltpvdb = _ltpvdb(NULL);
 	Sdr		ltpSdr;
+	int		ltpdbFormat;
 	char		*ltpvdbName = _ltpvdbName();
 
 	if (ltpdbObject && ltpvdb)
@@ -652,7 +687,7 @@ int	ltpAttach()
 	if (ltpdbObject == 0)
 	{
 		sdr_begin_xn(ltpSdr);
-		ltpdbObject = sdr_find(ltpSdr, _ltpdbName(), NULL);
+		ltpdbObject = sdr_find(ltpSdr, _ltpdbName(), &ltpdbFormat);
 		sdr_exit_xn(ltpSdr);
 		if (ltpdbObject == 0)
 		{
@@ -660,6 +695,11 @@ int	ltpAttach()
 			return -1;
 		}
 
+		if (checkLtpdbFormat(ltpdbFormat) < 0)
+		{
+			return -1;
+		}
+
 		oK(_ltpdbObject(&ltpdbObject));
 	}
 
@@ -687,7 +727,7 @@ void	findSpan(unsigned long engineId, LtpVspan **vspan,
 	PsmPartition	ltpwm = getIonwm();
 	PsmAddress	elt;
 
-	CHKVOID(ionLocked());
+	CHKVOID(sdr_in_read(getIonsdr()));
 	CHKVOID(vspan);
 	CHKVOID(vspanElt);
 	for (elt = sm_list_first(ltpwm, (_ltpvdb(NULL))->spans); elt;
@@ -1209,13 +1249,31 @@ int	startExportSession(Sdr sdr, Object spanObj, LtpVspan *vspan)
 
 /*	*	*	LTP event mgt and access functions	*	*/
 
+static int	orderLtpEvents(Sdr sdr, Address eventObj, void *argData)
+{
+	LtpEvent	*newEvent = (LtpEvent *) argData;
+		OBJ_POINTER(LtpEvent, event);
+
+	GET_OBJ_POINTER(sdr, LtpEvent, event, eventObj);
+	if (event->scheduledTime < newEvent->scheduledTime)
+	{
+		return -1;
+	}
+
+	if (event->scheduledTime > newEvent->scheduledTime)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
 static Object	insertLtpTimelineEvent(LtpEvent *newEvent)
 {
 	Sdr	ltpSdr = getIonsdr();
 	LtpDB	*ltpConstants = _ltpConstants();
 	Object	eventObj;
-	Object	elt;
-		OBJ_POINTER(LtpEvent, event);
+	Object	node;
 
 	CHKZERO(ionLocked());
 	eventObj = sdr_malloc(ltpSdr, sizeof(LtpEvent));
@@ -1225,23 +1283,22 @@ static Object	insertLtpTimelineEvent(LtpEvent *newEvent)
 		return 0;
 	}
 
-	/*	Search list from newest to oldest, insert after last
-		event with scheduled time less than or equal to that
-		of the new event.					*/
+	/*	Insert after every event with scheduled time less
+		than or equal to that of the new event.			*/
 
 	sdr_write(ltpSdr, eventObj, (char *) newEvent, sizeof(LtpEvent));
-	for (elt = sdr_list_first(ltpSdr, ltpConstants->timeline); elt;
-			elt = sdr_list_next(ltpSdr, elt))
+	node = sdr_rbt_insert(ltpSdr, ltpConstants->timeline, eventObj,
+			orderLtpEvents, newEvent);
+
+	/*	If the new event is now the earliest in the timeline,
+		ltpclock must reschedule its wakeup.			*/
+
+	if (node != 0 && node == sdr_rbt_first(ltpSdr, ltpConstants->timeline))
 	{
-		GET_OBJ_POINTER(ltpSdr, LtpEvent, event, sdr_list_data(ltpSdr,
-				elt));
-		if (event->scheduledTime <= newEvent->scheduledTime)
-		{
-			return sdr_list_insert_after(ltpSdr, elt, eventObj);
-		}
+		sm_SemGive((_ltpvdb(NULL))->clockSemaphore);
 	}
 
-	return sdr_list_insert_first(ltpSdr, ltpConstants->timeline, eventObj);
+	return node;
 }
 
 /*	*	*	LTP client mgt and access functions	*	*/
@@ -1409,16 +1466,16 @@ static void	cancelEvent(LtpEventType type, unsigned long refNbr1,
 	Object	elt;
 	Object	eventObj;
 		OBJ_POINTER(LtpEvent, event);
-	for (elt = sdr_list_first(ltpSdr, (_ltpConstants())->timeline); elt;
-			elt = sdr_list_next(ltpSdr, elt))
+	for (elt = sdr_rbt_first(ltpSdr, (_ltpConstants())->timeline); elt;
+			elt = sdr_rbt_next(ltpSdr, elt))
 	{
-		eventObj = sdr_list_data(ltpSdr, elt);
+		eventObj = sdr_rbt_data(ltpSdr, elt);
 		GET_OBJ_POINTER(ltpSdr, LtpEvent, event, eventObj);
 		if (event->type == type && event->refNbr1 == refNbr1
 		&& event->refNbr2 == refNbr2 && event->refNbr3 == refNbr3)
 		{
 			sdr_free(ltpSdr, eventObj);
-			sdr_list_delete(ltpSdr, elt, NULL, NULL);
+			sdr_rbt_delete(ltpSdr, elt, NULL, NULL);
 			return;
 		}
 	}
@@ -1472,6 +1529,13 @@ static void	clearExportSession(ExportSession *session)
 	Sdr	ltpSdr = getIonsdr();
 	Object	elt;
 
+	if (session->svcDataIndex)
+	{
+		sdr_free(ltpSdr, session->svcDataIndex);
+		session->svcDataIndex = 0;
+		session->svcDataCount = 0;
+	}
+
 	sdr_list_destroy(ltpSdr, session->redSegments, NULL, NULL);
 	session->redSegments = 0;
 	sdr_list_destroy(ltpSdr, session->greenSegments, NULL, NULL);
@@ -1640,6 +1704,42 @@ static void	destroyDataRecvSeg(Object dsElt, Object dsObj, LtpRecvSeg *ds)
 	sdr_list_delete(ltpSdr, dsElt, NULL, NULL);
 }
 
+static void	destroyRecvExtent(Sdr sdr, Address extentObj, void *arg)
+{
+	sdr_free(sdr, extentObj);
+}
+
+static void	destroyRecvExtents(ImportSession *session)
+{
+	Sdr	ltpSdr = getIonsdr();
+
+	if (session->redExtents)
+	{
+		sdr_rbt_destroy(ltpSdr, session->redExtents, destroyRecvExtent,
+				NULL);
+		session->redExtents = 0;
+	}
+}
+
+static int	orderRecvExtents(Sdr sdr, Address extentObj, void *argData)
+{
+	unsigned long	offset = *((unsigned long *) argData);
+		OBJ_POINTER(LtpRecvExtent, extent);
+
+	GET_OBJ_POINTER(sdr, LtpRecvExtent, extent, extentObj);
+	if (extent->offset < offset)
+	{
+		return -1;
+	}
+
+	if (extent->offset > offset)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
 static void	stopImportSession(ImportSession *session)
 {
 	Sdr	ltpSdr = getIonsdr();
@@ -1684,6 +1784,7 @@ static void	stopImportSession(ImportSession *session)
 		sdr_write(ltpSdr, dbobj, (char *) &db, sizeof(LtpDB));
 		sdr_list_destroy(ltpSdr, session->redSegments, NULL, NULL);
 		session->redSegments = 0;
+		destroyRecvExtents(session);
 	}
 
 	if (session->blockFileRef)
@@ -2046,66 +2147,166 @@ static int	setTimer(LtpTimer *timer, Address timerAddr, time_t currentSec,
 	return 0;
 }
 
-static int	readFromExportBlock(char *buffer, Object svcDataObjects,
-			unsigned long offset, unsigned long length)
+static int	findExportSdu(LtpVspan *vspan, Object index, int count,
+			unsigned long offset, ExportSdu *entry)
+{
+	Sdr		ltpSdr = getIonsdr();
+	int		low;
+	int		high;
+	int		mid;
+
+	/*	Segments are mostly extracted in block order, so first
+	 *	try the SDU that satisfied the span's last request and
+	 *	the one after it; otherwise binary-search the index.	*/
+
+	if (index == vspan->lastSduIndex)
+	{
+		for (mid = vspan->lastSduEntry;
+			mid < count && mid <= vspan->lastSduEntry + 1; mid++)
+		{
+			sdr_read(ltpSdr, (char *) entry, index
+				+ (mid * sizeof(ExportSdu)), sizeof(ExportSdu));
+			if (offset >= entry->offset
+			&& offset < entry->offset + entry->length)
+			{
+				vspan->lastSduEntry = mid;
+				return mid;
+			}
+		}
+	}
+
+	low = 0;
+	high = count - 1;
+	while (low <= high)
+	{
+		mid = (low + high) / 2;
+		sdr_read(ltpSdr, (char *) entry, index
+				+ (mid * sizeof(ExportSdu)), sizeof(ExportSdu));
+		if (offset < entry->offset)
+		{
+			high = mid - 1;
+		}
+		else if (offset >= entry->offset + entry->length)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			vspan->lastSduIndex = index;
+			vspan->lastSduEntry = mid;
+			return mid;
+		}
+	}
+
+	return -1;
+}
+
+static int	readFromSdu(char *buffer, Object sdu, unsigned int offset,
+			unsigned int length)
+{
+	Sdr		ltpSdr = getIonsdr();
+	ZcoReader	reader;
+	int		bytesRead;
+
+	/*	zco_read doesn't consume the SDU's ZCO reference, so
+	 *	the same data can be re-read for retransmission.	*/
+
+	zco_start_transmitting(ltpSdr, sdu, &reader);
+	bytesRead = zco_read(ltpSdr, &reader, offset, length, buffer);
+	zco_stop_transmitting(ltpSdr, &reader);
+	if (bytesRead != length)
+	{
+		putErrmsg("Failed reading SDU.", NULL);
+		return -1;
+	}
+
+	return bytesRead;
+}
+
+static int	readFromExportBlock(LtpVspan *vspan, char *buffer,
+			Object svcDataObjects, Object svcDataIndex,
+			int svcDataCount, unsigned long offset,
+			unsigned long length)
 {
 	Sdr		ltpSdr = getIonsdr();
 	Object		elt;
 	Object		sdu;	/*	Each member of list is a ZCO.	*/
 	unsigned int	sduLength;
-	Object		handle;
 	int		totalBytesRead = 0;
-	ZcoReader	reader;
+	ExportSdu	entry;
+	int		i;
 	unsigned int	bytesToRead;
-	int		bytesRead;
 
-	for (elt = sdr_list_first(ltpSdr, svcDataObjects); elt;
-			elt = sdr_list_next(ltpSdr, elt))
+	if (svcDataIndex)
 	{
-		sdu = sdr_list_data(ltpSdr, elt);
-		sduLength = zco_length(ltpSdr, sdu);
-		if (offset >= sduLength)
+		i = findExportSdu(vspan, svcDataIndex, svcDataCount, offset,
+				&entry);
+		if (i < 0)
 		{
-			offset -= sduLength;	/*	Skip over SDU.	*/
-			continue;
+			putErrmsg("Offset is beyond end of block.",
+					utoa(offset));
+			return -1;
 		}
 
-		/*	Reading from a ZCO reference precludes future
-		 *	re-reading of the same data from the same
-		 *	reference.  So we make an additional reference
-		 *	just for the purpose of this read request.	*/
-
-		handle = zco_add_reference(ltpSdr, sdu);
-		zco_start_transmitting(ltpSdr, handle, &reader);
-		if (offset > 0)
+		offset -= entry.offset;
+		while (1)
 		{
-			if (zco_transmit(ltpSdr, &reader, offset, NULL) < 0)
+			bytesToRead = entry.length - offset;
+			if (bytesToRead > length)
+			{
+				bytesToRead = length;
+			}
+
+			if (readFromSdu(buffer + totalBytesRead, entry.sdu,
+					offset, bytesToRead) < 0)
 			{
-				putErrmsg("Failed skipping offset.", NULL);
 				return -1;
 			}
 
-			sduLength -= offset;
+			totalBytesRead += bytesToRead;
+			length -= bytesToRead;
 			offset = 0;
+			i++;
+			if (length == 0 || i == svcDataCount)
+			{
+				break;
+			}
+
+			sdr_read(ltpSdr, (char *) &entry, svcDataIndex
+				+ (i * sizeof(ExportSdu)), sizeof(ExportSdu));
+		}
+
+		return totalBytesRead;
+	}
+
+	/*	Block wasn't indexed; walk the list of SDUs.		*/
+
+	for (elt = sdr_list_first(ltpSdr, svcDataObjects); elt;
+			elt = sdr_list_next(ltpSdr, elt))
+	{
+		sdu = sdr_list_data(ltpSdr, elt);
+		sduLength = zco_length(ltpSdr, sdu);
+		if (offset >= sduLength)
+		{
+			offset -= sduLength;	/*	Skip over SDU.	*/
+			continue;
 		}
 
-		bytesToRead = length;
-		if (bytesToRead > sduLength)
+		bytesToRead = sduLength - offset;
+		if (bytesToRead > length)
 		{
-			bytesToRead = sduLength;
+			bytesToRead = length;
 		}
 
-		bytesRead = zco_transmit(ltpSdr, &reader, bytesToRead,
-				buffer + totalBytesRead);
-		if (bytesRead != bytesToRead)
+		if (readFromSdu(buffer + totalBytesRead, sdu, offset,
+				bytesToRead) < 0)
 		{
-			putErrmsg("Failed reading SDU.", NULL);
 			return -1;
 		}
 
-		totalBytesRead += bytesRead;
-		length -= bytesRead;
-		zco_destroy_reference(ltpSdr, handle);
+		totalBytesRead += bytesToRead;
+		length -= bytesToRead;
+		offset = 0;
 		if (length == 0)	/*	Have read enough.	*/
 		{
 			break;
@@ -2115,34 +2316,17 @@ static int	readFromExportBlock(char *buffer, Object svcDataObjects,
 	return totalBytesRead;
 }
 
-int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
+static int	waitForOutboundSegment(LtpVspan *vspan, Object *spanObj,
+			LtpSpan *spanBuf, Object *elt)
 {
-	Sdr		ltpSdr = getIonsdr();
-	LtpVdb		*ltpvdb = _ltpvdb(NULL);
-	LtpDB		*ltpConstants = _ltpConstants();
-	Object		spanObj;
-	LtpSpan		spanBuf;
-	Object		elt;
-	char		memo[64];
-	Object		segAddr;
-	LtpXmitSeg	segment;
-	int		segmentLength;
-	Object		sessionObj;
-	Object		sessionElt;
-	ExportSession	xsessionBuf;
-	time_t		currentTime;
-	LtpEvent	event;
-	LtpTimer	*timer;
-	ImportSession	rsessionBuf;
+	Sdr	ltpSdr = getIonsdr();
+	char	memo[64];
 
-	CHKERR(vspan);
-	CHKERR(buf);
-	*buf = (char *) psp(getIonwm(), vspan->segmentBuffer);
 	sdr_begin_xn(ltpSdr);
-	spanObj = sdr_list_data(ltpSdr, vspan->spanElt);
-	sdr_stage(ltpSdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
-	elt = sdr_list_first(ltpSdr, spanBuf.segments);
-	while (elt == 0 || vspan->localXmitRate == 0)
+	*spanObj = sdr_list_data(ltpSdr, vspan->spanElt);
+	sdr_stage(ltpSdr, (char *) spanBuf, *spanObj, sizeof(LtpSpan));
+	*elt = sdr_list_first(ltpSdr, spanBuf->segments);
+	while (*elt == 0 || vspan->localXmitRate == 0)
 	{
 		sdr_exit_xn(ltpSdr);
 
@@ -2166,10 +2350,30 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 		}
 
 		sdr_begin_xn(ltpSdr);
-		sdr_stage(ltpSdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
-		elt = sdr_list_first(ltpSdr, spanBuf.segments);
+		sdr_stage(ltpSdr, (char *) spanBuf, *spanObj, sizeof(LtpSpan));
+		*elt = sdr_list_first(ltpSdr, spanBuf->segments);
 	}
 
+	return 1;	/*	Transaction is still open.		*/
+}
+
+static int	dequeueSegment(LtpVspan *vspan, Object spanObj,
+			LtpSpan *spanBuf, Object elt, char *buf)
+{
+	Sdr		ltpSdr = getIonsdr();
+	LtpVdb		*ltpvdb = _ltpvdb(NULL);
+	LtpDB		*ltpConstants = _ltpConstants();
+	Object		segAddr;
+	LtpXmitSeg	segment;
+	int		segmentLength;
+	Object		sessionObj;
+	Object		sessionElt;
+	ExportSession	xsessionBuf;
+	time_t		currentTime;
+	LtpEvent	event;
+	LtpTimer	*timer;
+	ImportSession	rsessionBuf;
+
 	/*	Got next outbound segment.  Remove it from the queue
 	 *	for this span.						*/
 
@@ -2202,8 +2406,9 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 		/*	Load client service data at the end of the
 		 *	segment first, before filling in the header.	*/
 
-		if (readFromExportBlock((*buf) + segment.ohdLength,
-				segment.pdu.block, segment.pdu.offset,
+		if (readFromExportBlock(vspan, buf + segment.ohdLength,
+				segment.pdu.block, segment.pdu.blockIndex,
+				segment.pdu.blockSduCount, segment.pdu.offset,
 				segment.pdu.length) < 0)
 		{
 			putErrmsg("Can't read data from export block.", NULL);
@@ -2356,7 +2561,7 @@ int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
 				return -1;
 			}
 
-			sdr_write(ltpSdr, spanObj, (char *) &spanBuf,
+			sdr_write(ltpSdr, spanObj, (char *) spanBuf,
 					sizeof(LtpSpan));
 		}
 
@@ -2402,28 +2607,28 @@ ExportSessionComplete notice.", NULL);
 
 	if (segment.pdu.segTypeCode < 8)
 	{
-		serializeDataSegment(&segment, *buf);
+		serializeDataSegment(&segment, buf);
 	}
 	else
 	{
 		switch (segment.pdu.segTypeCode)
 		{
 			case 8:		/*	Report.			*/
-				serializeReportSegment(&segment, *buf);
+				serializeReportSegment(&segment, buf);
 				break;
 
 			case 9:		/*	Report acknowledgment.	*/
-				serializeReportAckSegment(&segment, *buf);
+				serializeReportAckSegment(&segment, buf);
 				break;
 
 			case 12:	/*	Cancel by sender.	*/
 			case 14:	/*	Cancel by receiver.	*/
-				serializeCancelSegment(&segment, *buf);
+				serializeCancelSegment(&segment, buf);
 				break;
 
 			case 13:	/*	Cancel acknowledgment.	*/
 			case 15:	/*	Cancel acknowledgment.	*/
-				serializeCancelAckSegment(&segment, *buf);
+				serializeCancelAckSegment(&segment, buf);
 				break;
 
 			default:
@@ -2431,6 +2636,36 @@ ExportSessionComplete notice.", NULL);
 		}
 	}
 
+	return segmentLength;
+}
+
+int	ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf)
+{
+	Sdr		ltpSdr = getIonsdr();
+	LtpVdb		*ltpvdb = _ltpvdb(NULL);
+	Object		spanObj;
+	LtpSpan		spanBuf;
+	Object		elt;
+	int		segmentLength;
+
+	CHKERR(vspan);
+	CHKERR(buf);
+	*buf = (char *) psp(getIonwm(), vspan->segmentBuffer);
+	switch (waitForOutboundSegment(vspan, &spanObj, &spanBuf, &elt))
+	{
+	case -1:
+		return -1;
+
+	case 0:
+		return 0;		/*	Interrupted.		*/
+	}
+
+	segmentLength = dequeueSegment(vspan, spanObj, &spanBuf, elt, *buf);
+	if (segmentLength < 0)
+	{
+		return -1;		/*	Transaction canceled.	*/
+	}
+
 	if (sdr_end_xn(ltpSdr))
 	{
 		putErrmsg("Can't get outbound segment for span.", NULL);
@@ -2446,6 +2681,89 @@ ExportSessionComplete notice.", NULL);
 	return segmentLength;
 }
 
+int	ltpDequeueOutboundSegments(LtpVspan *vspan, char *buffer,
+		int bufferLength, int *segmentLengths, int maxSegments)
+{
+	Sdr		ltpSdr = getIonsdr();
+	LtpVdb		*ltpvdb = _ltpvdb(NULL);
+	Object		spanObj;
+	LtpSpan		spanBuf;
+	Object		elt;
+	int		segmentCount = 0;
+	int		segmentLength;
+	int		i;
+
+	CHKERR(vspan);
+	CHKERR(buffer);
+	CHKERR(bufferLength > 0);
+	CHKERR(segmentLengths);
+	CHKERR(maxSegments > 0);
+	switch (waitForOutboundSegment(vspan, &spanObj, &spanBuf, &elt))
+	{
+	case -1:
+		return -1;
+
+	case 0:
+		return 0;		/*	Interrupted.		*/
+	}
+
+	if ((unsigned int) bufferLength < spanBuf.maxSegmentSize)
+	{
+		sdr_exit_xn(ltpSdr);
+		putErrmsg("Segment buffer is smaller than max segment size.",
+				itoa(bufferLength));
+		return -1;
+	}
+
+	/*	Having waited for at least one segment, drain up to
+	 *	maxSegments queued segments in a single transaction,
+	 *	each into its own bufferLength-byte slot of the
+	 *	buffer.  Each slot must be able to hold a segment of
+	 *	the span's maximum size.				*/
+
+	while (1)
+	{
+		segmentLength = dequeueSegment(vspan, spanObj, &spanBuf, elt,
+				buffer + (segmentCount * bufferLength));
+		if (segmentLength < 0)
+		{
+			return -1;	/*	Transaction canceled.	*/
+		}
+
+		segmentLengths[segmentCount] = segmentLength;
+		segmentCount++;
+		if (segmentCount == maxSegments)
+		{
+			break;
+		}
+
+		sdr_stage(ltpSdr, (char *) &spanBuf, spanObj, sizeof(LtpSpan));
+		elt = sdr_list_first(ltpSdr, spanBuf.segments);
+		if (elt == 0)
+		{
+			break;		/*	Queue is now empty.	*/
+		}
+	}
+
+	if (sdr_end_xn(ltpSdr))
+	{
+		putErrmsg("Can't get outbound segments for span.", NULL);
+		return -1;
+	}
+
+	if (ltpvdb->watching & WATCH_g)
+	{
+		for (i = 0; i < segmentCount; i++)
+		{
+			putchar('g');
+		}
+
+		fflush(stdout);
+	}
+
+	return segmentCount;
+}
+
 /*	*	Control segment construction functions		*	*/
 
 static void	signalLso(unsigned int engineId)
@@ -2870,7 +3188,8 @@ static int	sendReport(ImportSession *session, Object sessionObj,
 	unsigned long	lowerBound;
 	unsigned long	upperBound;
 	int		claimCount;
-			OBJ_POINTER(LtpRecvSeg, ds);
+			OBJ_POINTER(LtpRecvExtent, extent);
+	unsigned long	extentUpperBound;
 #if LTPDEBUG
 int		shortfall;
 char		buf[256];
@@ -2929,19 +3248,25 @@ putErrmsg("Too many reports, canceling session.", itoa(session->sessionNbr));
 	}
 
 	claimCount = 0;
-	for (elt = sdr_list_first(ltpSdr, session->redSegments); elt;
-			elt = sdr_list_next(ltpSdr, elt))
+	for (elt = sdr_rbt_first(ltpSdr, session->redExtents); elt;
+			elt = sdr_rbt_next(ltpSdr, elt))
 	{
-		GET_OBJ_POINTER(ltpSdr, LtpRecvSeg, ds,
-				sdr_list_data(ltpSdr, elt));
-		if (ds->pdu.offset >= reportUpperBound)
+		GET_OBJ_POINTER(ltpSdr, LtpRecvExtent, extent,
+				sdr_rbt_data(ltpSdr, elt));
+		if (extent->offset >= reportUpperBound)
 		{
 			break;	/*	No need to check any further.	*/
 		}
 
-		if (ds->pdu.offset == upperBound)
+		extentUpperBound = extent->offset + extent->length;
+		if (extentUpperBound > reportUpperBound)
+		{
+			extentUpperBound = reportUpperBound;
+		}
+
+		if (extent->offset == upperBound)
 		{
-			upperBound += ds->pdu.length;
+			upperBound = extentUpperBound;
 			continue;	/*	Contiguous extents.	*/
 		}
 
@@ -2960,8 +3285,8 @@ putErrmsg("Too many reports, canceling session.", itoa(session->sessionNbr));
 			rsBuf.pdu.upperBound = upperBound;
 		}
 
-		lowerBound = ds->pdu.offset;
-		upperBound = lowerBound + ds->pdu.length;
+		lowerBound = extent->offset;
+		upperBound = extentUpperBound;
 		if (claimCount < MAX_CLAIMS_PER_RS)
 		{
 			continue;
@@ -3115,9 +3440,11 @@ putErrmsg("Opened import session.", utoa(sessionNbr));
 	encodeSdnv(&(sessionBuf->sessionNbrSdnv), sessionNbr);
 	sessionBuf->clientSvcId = clientSvcId;
 	sessionBuf->redSegments = sdr_list_create(ltpSdr);
+	sessionBuf->redExtents = sdr_rbt_create(ltpSdr);
 	sessionBuf->rsSegments = sdr_list_create(ltpSdr);
 	sessionBuf->span = spanObj;
 	if (sessionBuf->redSegments == 0
+	|| sessionBuf->redExtents == 0
 	|| sessionBuf->rsSegments == 0)
 	{
 		putErrmsg("Can't create import session.", NULL);
@@ -3167,9 +3494,12 @@ static long	insertDataSegment(ImportSession *session, LtpRecvSeg *segment,
 {
 	Sdr		ltpSdr = getIonsdr();
 	long		segUpperBound;
-	Object		elt;
-			OBJ_POINTER(LtpRecvSeg, ds);
-	unsigned long	redPartUpperBound;
+	Object		prevNode;
+	Object		nextNode;
+	Object		prevObj = 0;
+	Object		nextObj = 0;
+	LtpRecvExtent	prev;
+	LtpRecvExtent	next;
 
 	/*	If reception is already complete or the session has
 	 *	been canceled, discard the segment.			*/
@@ -3195,40 +3525,50 @@ putErrmsg("discarded segment", itoa(segment->pdu.offset));
 		}
 	}
 
-	for (elt = sdr_list_first(ltpSdr, session->redSegments); elt;
-			elt = sdr_list_next(ltpSdr, elt))
+	/*	Find the received extents immediately preceding and
+	 *	following the new segment; the segment is discarded
+	 *	if it overlaps either one.				*/
+
+	if (sdr_rbt_search(ltpSdr, session->redExtents, orderRecvExtents,
+			&(segment->pdu.offset), &nextNode))
 	{
-		GET_OBJ_POINTER(ltpSdr, LtpRecvSeg, ds,
-				sdr_list_data(ltpSdr, elt));
-		if (ds->pdu.offset < segment->pdu.offset)
-		{
-			redPartUpperBound = ds->pdu.offset + ds->pdu.length;
-			if (redPartUpperBound > segment->pdu.offset)
-			{
 #if LTPDEBUG
 putErrmsg("discarded segment", itoa(segment->pdu.offset));
 #endif
-				return 0;	/*	Overlapping.	*/
-			}
+		return 0;		/*	Overlapping.		*/
+	}
 
-			continue;
+	if (nextNode)
+	{
+		prevNode = sdr_rbt_prev(ltpSdr, nextNode);
+		nextObj = sdr_rbt_data(ltpSdr, nextNode);
+		sdr_stage(ltpSdr, (char *) &next, nextObj,
+				sizeof(LtpRecvExtent));
+		if (next.offset < segUpperBound)
+		{
+#if LTPDEBUG
+putErrmsg("discarded segment", itoa(segment->pdu.offset));
+#endif
+			return 0;	/*	Overlapping.		*/
 		}
+	}
+	else
+	{
+		prevNode = sdr_rbt_last(ltpSdr, session->redExtents);
+	}
 
-		/*	Previously received red segment does not start
-		 *	before start of this one.			*/
-
-		if (ds->pdu.offset < segUpperBound)
+	if (prevNode)
+	{
+		prevObj = sdr_rbt_data(ltpSdr, prevNode);
+		sdr_stage(ltpSdr, (char *) &prev, prevObj,
+				sizeof(LtpRecvExtent));
+		if (prev.offset + prev.length > segment->pdu.offset)
 		{
 #if LTPDEBUG
 putErrmsg("discarded segment", itoa(segment->pdu.offset));
 #endif
-			return 0;		/*	Overlapping.	*/
+			return 0;	/*	Overlapping.		*/
 		}
-
-		/*	Previously received red segment does not start
-		 *	before end of this one.				*/
-
-		break;
 	}
 
 	session->redPartReceived += segment->pdu.length;
@@ -3238,10 +3578,14 @@ putErrmsg("discarded segment", itoa(segment->pdu.offset));
 		return -1;
 	}
 
-	if (elt)
+	/*	No segment lies between the preceding and following
+	 *	extents, so the new segment's list position is just
+	 *	before the first segment of the following extent.	*/
+
+	if (nextNode)
 	{
-		segment->sessionListElt = sdr_list_insert_before(ltpSdr, elt,
-				*segmentObj);
+		segment->sessionListElt = sdr_list_insert_before(ltpSdr,
+				next.firstSegElt, *segmentObj);
 	}
 	else
 	{
@@ -3249,6 +3593,58 @@ putErrmsg("discarded segment", itoa(segment->pdu.offset));
 				session->redSegments, *segmentObj);
 	}
 
+	if (segment->sessionListElt == 0)
+	{
+		return -1;
+	}
+
+	/*	Record the new segment's data in the extents tree,
+	 *	coalescing with adjacent extents.			*/
+
+	if (prevNode && prev.offset + prev.length == segment->pdu.offset)
+	{
+		prev.length += segment->pdu.length;
+		if (nextNode && next.offset == segUpperBound)
+		{
+			prev.length += next.length;
+			sdr_rbt_delete(ltpSdr, nextNode, destroyRecvExtent,
+					NULL);
+		}
+
+		sdr_write(ltpSdr, prevObj, (char *) &prev,
+				sizeof(LtpRecvExtent));
+	}
+	else if (nextNode && next.offset == segUpperBound)
+	{
+		/*	Changing the offset of the following extent
+		 *	doesn't change its position in the tree.	*/
+
+		next.offset = segment->pdu.offset;
+		next.length += segment->pdu.length;
+		next.firstSegElt = segment->sessionListElt;
+		sdr_write(ltpSdr, nextObj, (char *) &next,
+				sizeof(LtpRecvExtent));
+	}
+	else
+	{
+		nextObj = sdr_malloc(ltpSdr, sizeof(LtpRecvExtent));
+		if (nextObj == 0)
+		{
+			return -1;
+		}
+
+		next.offset = segment->pdu.offset;
+		next.length = segment->pdu.length;
+		next.firstSegElt = segment->sessionListElt;
+		sdr_write(ltpSdr, nextObj, (char *) &next,
+				sizeof(LtpRecvExtent));
+		if (sdr_rbt_insert(ltpSdr, session->redExtents, nextObj,
+				orderRecvExtents, &(next.offset)) == 0)
+		{
+			return -1;
+		}
+	}
+
 	return segUpperBound;
 }
 
@@ -3353,6 +3749,7 @@ static int	deliverSvcData(LtpVclient *client, unsigned long sourceEngineId,
 	sdr_write(ltpSdr, dbobj, (char *) &db, sizeof(LtpDB));
 	sdr_list_destroy(ltpSdr, session->redSegments, NULL, NULL);
 	session->redSegments = 0;
+	destroyRecvExtents(session);
 
 	/*	Pass the block content ZCO to the client service.	*/
 
@@ -3505,7 +3902,7 @@ putErrmsg("Discarded data segment.", itoa(sessionNbr));
 		{
 			writeMemo("[?] Can't receive, would exceed LTP heap \
 space reservation.");
-			sdr_cancel_xn(ltpSdr);
+			sdr_exit_xn(ltpSdr);	/*	Nothing written.	*/
 			return 0;
 		}
 
@@ -3633,6 +4030,23 @@ putErrmsg("Discarded data segment.", itoa(sessionNbr));
 		}
 	}
 
+	/*	If the segment's data would have to be stored in the
+	 *	heap but the LTP heap space reservation would be
+	 *	exceeded, discard the segment.  Any newly started
+	 *	import session is retained, so the transaction is
+	 *	ended rather than canceled; this also leaves intact
+	 *	any enclosing transaction in which a batch of inbound
+	 *	segments is being handled.				*/
+
+	if (sessionBuf.blockFileRef == 0
+	&& db.heapSpaceBytesOccupied + pdu->length
+			> db.heapSpaceBytesReserved)
+	{
+		writeMemo("[?] Can't receive, would exceed LTP heap \
+space reservation.");
+		return sdr_end_xn(ltpSdr);
+	}
+
 	segment->sessionObj = sessionObj;
 	segUpperBound = insertDataSegment(&sessionBuf, segment, pdu,
 			&segmentObj);
@@ -3653,15 +4067,6 @@ putErrmsg("Discarded data segment.", itoa(sessionNbr));
 
 	if (sessionBuf.blockFileRef == 0)	/*	Store in heap.	*/
 	{
-		if (db.heapSpaceBytesOccupied + pdu->length
-				> db.heapSpaceBytesReserved)
-		{
-			writeMemo("[?] Can't receive, would exceed LTP heap \
-space reservation.");
-			sdr_cancel_xn(ltpSdr);
-			return 0;
-		}
-
 		segment->fileOffset = 0;
 		segment->heapAddress = sdr_insert(ltpSdr, *cursor, pdu->length);
 		if (segment->heapAddress == 0)
@@ -4078,6 +4483,8 @@ reduce mtusize in .ltprc file!", itoa(span->maxSegmentSize
 	encodeSdnv(&lengthSdnv, segment.pdu.length);
 	segment.ohdLength += lengthSdnv.length;
 	segment.pdu.block = session->svcDataObjects;
+	segment.pdu.blockIndex = session->svcDataIndex;
+	segment.pdu.blockSduCount = session->svcDataCount;
 	sdr_write(ltpSdr, segmentObj, (char *) &segment, sizeof(LtpXmitSeg));
 	signalLso(span->engineId);
 #if LTPDEBUG
@@ -4099,6 +4506,51 @@ putErrmsg(buf, itoa(session->sessionNbr));
 	return 0;
 }
 
+int	indexExportBlock(ExportSession *session)
+{
+	Sdr		ltpSdr = getIonsdr();
+	int		count;
+	Object		index;
+	Object		elt;
+	ExportSdu	entry;
+	int		i;
+
+	CHKERR(ionLocked());
+	CHKERR(session);
+	if (session->svcDataObjects == 0 || session->svcDataIndex != 0)
+	{
+		return 0;	/*	Canceled or already indexed.	*/
+	}
+
+	count = sdr_list_length(ltpSdr, session->svcDataObjects);
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	index = sdr_malloc(ltpSdr, count * sizeof(ExportSdu));
+	if (index == 0)
+	{
+		putErrmsg("Can't create export block index.", itoa(count));
+		return -1;
+	}
+
+	entry.offset = 0;
+	for (i = 0, elt = sdr_list_first(ltpSdr, session->svcDataObjects);
+			elt; i++, elt = sdr_list_next(ltpSdr, elt))
+	{
+		entry.sdu = sdr_list_data(ltpSdr, elt);
+		entry.length = zco_length(ltpSdr, entry.sdu);
+		sdr_write(ltpSdr, index + (i * sizeof(ExportSdu)),
+				(char *) &entry, sizeof(ExportSdu));
+		entry.offset += entry.length;
+	}
+
+	session->svcDataIndex = index;
+	session->svcDataCount = count;
+	return 0;
+}
+
 int	issueSegments(Sdr sdr, LtpSpan *span, LtpVspan *vspan,
 		ExportSession *session, Object sessionObj, Lyst extents,
 		unsigned long reportSerialNbr)
@@ -5177,6 +5629,41 @@ segment discarded", itoa(extensionLengths));
 	return 0;		/*	Ignore the segment.		*/
 }
 
+int	ltpHandleInboundSegments(char *buffer, int bufferLength,
+		int *segmentLengths, int segmentCount)
+{
+	Sdr	ltpSdr = getIonsdr();
+	int	i;
+
+	CHKERR(buffer);
+	CHKERR(bufferLength > 0);
+	CHKERR(segmentLengths);
+	CHKERR(segmentCount > 0);
+
+	/*	Handle all segments of the batch in a single
+	 *	transaction; the transactions of the individual
+	 *	segment handlers are nested within it.			*/
+
+	sdr_begin_xn(ltpSdr);
+	for (i = 0; i < segmentCount; i++)
+	{
+		if (ltpHandleInboundSegment(buffer + (i * bufferLength),
+				segmentLengths[i]) < 0)
+		{
+			sdr_cancel_xn(ltpSdr);
+			return -1;
+		}
+	}
+
+	if (sdr_end_xn(ltpSdr) < 0)
+	{
+		putErrmsg("Can't handle inbound segments.", NULL);
+		return -1;
+	}
+
+	return 0;
+}
+
 /*	*	*	Functions that respond to events	*	*/
 
 void	ltpStartXmit(LtpVspan *vspan)
@@ -15,6 +15,7 @@
 #include "zco.h"
 #include "ltp.h"
 #include "sdrhash.h"
+#include "sdrrbt.h"
 
 #ifndef _LTPP_H_
 #define _LTPP_H_
@@ -106,6 +107,8 @@ typedef struct
 	unsigned long		offset;		/*	Within block.	*/
 	unsigned long		length;
 	Object			block;	/*	Session svcDataObjects.	*/
+	Object			blockIndex;	/*	ExportSdu array	*/
+	int			blockSduCount;
 
 	/*	Fields for report segments.				*/
 
@@ -175,6 +178,21 @@ typedef struct
 	LtpPdu		pdu;
 } LtpXmitSeg;
 
+/*	An LtpRecvExtent is a maximal range of contiguous red-part
+ *	data received in an import session.  The extents of a session
+ *	are kept in a red-black tree ordered by offset, so that the
+ *	overlap check and insertion point for each arriving segment
+ *	are found in O(log n) time and each extent is exactly one
+ *	reception claim.  The redSegments list remains ordered by
+ *	offset, for delivery of the block.				*/
+
+typedef struct
+{
+	unsigned long	offset;
+	unsigned long	length;
+	Object		firstSegElt;	/*	In redSegments list.	*/
+} LtpRecvExtent;
+
 /* Session structures */
 
 typedef struct
@@ -188,6 +206,7 @@ typedef struct
 	LtpTimer	timer;		/*	For cancellation.	*/
 	int		reasonCode;	/*	For cancellation.	*/
 	Object		redSegments;	/*	SDR list of LtpRecvSegs	*/
+	Object		redExtents;	/*	SDR rbt: LtpRecvExtents	*/
 	Object		rsSegments;	/*	SDR list of LtpXmitSegs	*/
 	int		reportsCount;
 	Object		blockFileRef;	/*	A ZCO File Ref object.	*/
@@ -209,6 +228,8 @@ typedef struct
 	LtpTimer	timer;		/*	For cancellation.	*/
 	int		reasonCode;	/*	For cancellation.	*/
 	Object		svcDataObjects;	/*	SDR list of ZCO refs.	*/
+	Object		svcDataIndex;	/*	Array of ExportSdu.	*/
+	int		svcDataCount;	/*	Entries in index.	*/
 	Object		redSegments;	/*	SDR list of LtpXmitSegs	*/
 	Object		greenSegments;	/*	SDR list of LtpXmitSegs	*/
 	Object		claims;		/*	reception claims list	*/
@@ -221,6 +242,18 @@ typedef struct
 	unsigned int	length;
 } ExportExtent;
 
+/*	The export block offset index, built by ltpmeter when a block
+ *	is segmented, locates each service data unit within the block
+ *	so that the content of a data segment can be extracted without
+ *	walking the svcDataObjects list.				*/
+
+typedef struct
+{
+	Object		sdu;		/*	ZCO reference.		*/
+	unsigned int	offset;		/*	Within block.		*/
+	unsigned int	length;
+} ExportSdu;
+
 /* Timeline event structure */
 
 typedef enum
@@ -292,6 +325,8 @@ typedef struct
 	/*	*	*	Work area	*	*	*	*/
 
 	PsmAddress	segmentBuffer;	/*	Holds one max-size seg.	*/
+	Object		lastSduIndex;	/*	Export block index read.*/
+	int		lastSduEntry;	/*	Entry last read from it.*/
 
 	/*	The bufEmptySemaphore of an LtpVspan is given by
 	 *	the span's ltpmeter task upon construction of a new
@@ -368,6 +403,13 @@ typedef struct
 
 /* Database structure */
 
+/*	The LTP database is catalogued with the number of its format
+ *	as the type of its catalogue entry; a database of any other
+ *	format (e.g., type 0, with an SDR list as its timeline) must
+ *	be reinitialized.						*/
+
+#define	LTP_DB_FORMAT	(1)
+
 typedef struct
 {
 	unsigned long	ownEngineId;
@@ -396,7 +438,7 @@ typedef struct
 	Object		exportSessionsHash;
 	Object		deadExports;	/*	SDR list: ExportSession	*/
 	Object		spans;		/*	SDR list: LtpSpan	*/
-	Object		timeline;	/*	SDR list: LtpEvent	*/
+	Object		timeline;	/*	SDR rbt: LtpEvent	*/
 } LtpDB;
 
 /* The volatile database object encapsulates the current volatile state
@@ -422,6 +464,7 @@ typedef struct
 {
 	int		lsiPid;		/*	For stopping the LSI.	*/
 	int		clockPid;	/*	For stopping ltpclock.	*/
+	sm_SemId	clockSemaphore;	/*	For waking ltpclock.	*/
 	int		watching;	/*	Boolean activity watch.	*/
 	PsmAddress	spans;		/*	SM list: LtpVspan*	*/
 	LtpVclient	clients[LTP_MAX_NBR_OF_CLIENTS];
@@ -482,6 +525,7 @@ extern void		ltpStopSpan(unsigned long engineId);
 
 extern int		startExportSession(Sdr sdr, Object spanObj,
 				LtpVspan *vspan);
+extern int		indexExportBlock(ExportSession *session);
 extern int		issueSegments(Sdr sdr, LtpSpan *span, LtpVspan *vspan,
 				ExportSession *session, Object sessionObj,
 				Lyst extents, unsigned long reportSerialNbr);
@@ -502,6 +546,13 @@ extern int		enqueueNotice(LtpVclient *client,
 extern int		ltpDequeueOutboundSegment(LtpVspan *vspan, char **buf);
 extern int		ltpHandleInboundSegment(char *buf, int length);
 
+extern int		ltpDequeueOutboundSegments(LtpVspan *vspan,
+				char *buffer, int bufferLength,
+				int *segmentLengths, int maxSegments);
+extern int		ltpHandleInboundSegments(char *buffer,
+				int bufferLength, int *segmentLengths,
+				int segmentCount);
+
 extern void		ltpStartXmit(LtpVspan *vspan);
 extern void		ltpStopXmit(LtpVspan *vspan);
 extern int		ltpSuspendTimers(LtpVspan *vspan, PsmAddress vspanElt,
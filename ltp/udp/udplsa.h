@@ -11,6 +11,16 @@
 #ifndef _UDPLSA_H_
 #define _UDPLSA_H_
 
+/*	On Linux, segments are sent and received in batches by
+ *	sendmmsg() and recvmmsg().					*/
+
+#if defined (linux) && !defined (UDPLSA_NO_MMSG)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#define UDPLSA_MMSG
+#endif
+
 #include "ltpP.h"
 #include <pthread.h>
 
@@ -19,6 +29,8 @@ extern "C" {
 #endif
 
 #define UDPLSA_BUFSZ		((256 * 256) - 1)
+#define UDPLSA_BATCHSZ		(8)
+#define UDPLSA_RCVBUFSZ		(2 * 1024 * 1024)
 #define LtpUdpDefaultPortNbr	1113
 
 #ifdef __cplusplus
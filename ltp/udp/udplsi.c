@@ -24,6 +24,100 @@ typedef struct
 	int		running;
 } ReceiverThreadParms;
 
+#ifdef UDPLSA_MMSG
+static void	*handleDatagrams(void *parm)
+{
+	/*	Main loop for UDP datagram reception and handling,
+	 *	receiving and handling up to UDPLSA_BATCHSZ segments
+	 *	at a time.						*/
+
+	ReceiverThreadParms	*rtp = (ReceiverThreadParms *) parm;
+	char			*buffer;
+	int			segmentLengths[UDPLSA_BATCHSZ];
+	struct iovec		iovecs[UDPLSA_BATCHSZ];
+	struct mmsghdr		msgs[UDPLSA_BATCHSZ];
+	int			datagramCount;
+	int			segmentCount;
+	int			i;
+
+	buffer = MTAKE(UDPLSA_BUFSZ * UDPLSA_BATCHSZ);
+	if (buffer == NULL)
+	{
+		putErrmsg("udplsi can't get UDP buffer.", NULL);
+		pthread_kill(rtp->mainThread, SIGTERM);
+		return NULL;
+	}
+
+	memset((char *) msgs, 0, sizeof msgs);
+	for (i = 0; i < UDPLSA_BATCHSZ; i++)
+	{
+		iovecs[i].iov_base = buffer + (i * UDPLSA_BUFSZ);
+		iovecs[i].iov_len = UDPLSA_BUFSZ;
+		msgs[i].msg_hdr.msg_iov = iovecs + i;
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/*	Can now start receiving bundles.  On failure, take
+	 *	down the LSI.						*/
+
+	iblock(SIGTERM);
+	while (rtp->running)
+	{	
+		/*	Block until at least one datagram is received,
+		 *	then take whatever others are already queued.	*/
+
+		datagramCount = recvmmsg(rtp->linkSocket, msgs, UDPLSA_BATCHSZ,
+				MSG_WAITFORONE, NULL);
+		if (datagramCount < 0)
+		{
+			putSysErrmsg("Can't acquire segments", NULL);
+			pthread_kill(rtp->mainThread, SIGTERM);
+			rtp->running = 0;
+			continue;
+		}
+
+		/*	A 1-byte datagram is the signal to stop; only
+		 *	the segments received before it are handled.	*/
+
+		for (segmentCount = 0; segmentCount < datagramCount;
+				segmentCount++)
+		{
+			segmentLengths[segmentCount] =
+					msgs[segmentCount].msg_len;
+			if (segmentLengths[segmentCount] == 1)
+			{
+				rtp->running = 0;
+				break;
+			}
+		}
+
+		if (segmentCount > 0)
+		{
+			if (ltpHandleInboundSegments(buffer, UDPLSA_BUFSZ,
+					segmentLengths, segmentCount) < 0)
+			{
+				putErrmsg("Can't handle inbound segments.",
+						NULL);
+				pthread_kill(rtp->mainThread, SIGTERM);
+				rtp->running = 0;
+				continue;
+			}
+		}
+
+		/*	Make sure other tasks have a chance to run.	*/
+
+		sm_TaskYield();
+	}
+
+	writeErrmsgMemos();
+	writeMemo("[i] udplsi receiver thread has ended.");
+
+	/*	Free resources.						*/
+
+	MRELEASE(buffer);
+	return NULL;
+}
+#else
 static void	*handleDatagrams(void *parm)
 {
 	/*	Main loop for UDP datagram reception and handling.	*/
@@ -85,6 +179,7 @@ static void	*handleDatagrams(void *parm)
 	MRELEASE(buffer);
 	return NULL;
 }
+#endif
 
 /*	*	*	Main thread functions	*	*	*	*/
 
@@ -109,6 +204,9 @@ int	main(int argc, char *argv[])
 	pthread_t		receiverThread;
 	int			fd;
 	char			quit = '\0';
+#ifdef UDPLSA_MMSG
+	int			rcvBufSize;
+#endif
 
 	/*	Note that ltpadmin must be run before the first
 	 *	invocation of ltplsi, to initialize the LTP database
@@ -169,6 +267,19 @@ int	main(int argc, char *argv[])
 		return 1;
 	}
 
+#ifdef UDPLSA_MMSG
+	/*	Segments may arrive in bursts of a batch at a time, so
+	 *	ask for a receive buffer that can absorb several of
+	 *	them.  The kernel may grant less; that's not fatal.	*/
+
+	rcvBufSize = UDPLSA_RCVBUFSZ;
+	if (setsockopt(rtp.linkSocket, SOL_SOCKET, SO_RCVBUF,
+			(char *) &rcvBufSize, sizeof rcvBufSize) < 0)
+	{
+		writeMemo("[?] udplsi can't enlarge socket receive buffer.");
+	}
+#endif
+
 	/*	Set up signal handling; SIGTERM is shutdown signal.	*/
 
 	isignal(SIGTERM, interruptThread);
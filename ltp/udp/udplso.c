@@ -50,6 +50,35 @@ int	sendSegmentByUDP(int linkSocket, char *from, int length)
 	}
 }
 
+#ifdef UDPLSA_MMSG
+static int	sendSegmentsByUDP(int linkSocket, struct mmsghdr *msgs,
+			int segmentCount)
+{
+	int	segmentsSent = 0;
+	int	result;
+
+	while (segmentsSent < segmentCount)
+	{
+		result = sendmmsg(linkSocket, msgs + segmentsSent,
+				segmentCount - segmentsSent, 0);
+		if (result < 0)
+		{
+			if (errno == EINTR)	/*	Interrupted.	*/
+			{
+				continue;	/*	Retry.		*/
+			}
+
+			putSysErrmsg("LSO sendmmsg() error on socket", NULL);
+			return -1;
+		}
+
+		segmentsSent += result;
+	}
+
+	return segmentsSent;
+}
+#endif
+
 /*	*	*	Main thread functions	*	*	*	*/
 
 #if defined (VXWORKS) || defined (RTEMS)
@@ -73,12 +102,21 @@ int	main(int argc, char *argv[])
 	unsigned int		ipAddress = 0;
 	char			ownHostName[MAXHOSTNAMELEN];
 	int			running = 1;
-	int			segmentLength;
-	char			*segment;
 	struct sockaddr		socketName;
 	struct sockaddr_in	*inetName;
 	int			linkSocket;
+#ifdef UDPLSA_MMSG
+	char			*buffer;
+	int			segmentLengths[UDPLSA_BATCHSZ];
+	struct iovec		iovecs[UDPLSA_BATCHSZ];
+	struct mmsghdr		msgs[UDPLSA_BATCHSZ];
+	int			segmentCount;
+	int			i;
+#else
+	int			segmentLength;
+	char			*segment;
 	int			bytesSent;
+#endif
 
 	if (remoteEngineId == 0 || endpointSpec == NULL)
 	{
@@ -98,18 +136,18 @@ int	main(int argc, char *argv[])
 	}
 
 	sdr = getIonsdr();
-	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	sdr_begin_read(sdr);
 	findSpan(remoteEngineId, &vspan, &vspanElt);
 	if (vspanElt == 0)
 	{
-		sdr_exit_xn(sdr);
+		sdr_end_read(sdr);
 		putErrmsg("No such engine in database.", itoa(remoteEngineId));
 		return 1;
 	}
 
 	if (vspan->lsoPid > 0 && vspan->lsoPid != sm_TaskIdSelf())
 	{
-		sdr_exit_xn(sdr);
+		sdr_end_read(sdr);
 		putErrmsg("LSO task is already started for this span.",
 				itoa(vspan->lsoPid));
 		return 1;
@@ -117,7 +155,7 @@ int	main(int argc, char *argv[])
 
 	/*	All command-line arguments are now validated.		*/
 
-	sdr_exit_xn(sdr);
+	sdr_end_read(sdr);
 	parseSocketSpec(endpointSpec, &portNbr, &ipAddress);
 	if (portNbr == 0)
 	{
@@ -150,6 +188,30 @@ int	main(int argc, char *argv[])
 		return 1;
 	}
 
+#ifdef UDPLSA_MMSG
+	/*	Each batch of segments is dequeued into consecutive
+	 *	slots of a single buffer.  Each slot is as large as
+	 *	the largest segment that UDP can carry, rather than
+	 *	the span's current max segment size, because that
+	 *	size may be increased while udplso is running.		*/
+
+	buffer = MTAKE(UDPLSA_BUFSZ * UDPLSA_BATCHSZ);
+	if (buffer == NULL)
+	{
+		close(linkSocket);
+		putErrmsg("udplso can't get segment buffer.", NULL);
+		return 1;
+	}
+
+	memset((char *) msgs, 0, sizeof msgs);
+	for (i = 0; i < UDPLSA_BATCHSZ; i++)
+	{
+		iovecs[i].iov_base = buffer + (i * UDPLSA_BUFSZ);
+		msgs[i].msg_hdr.msg_iov = iovecs + i;
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+#endif
+
 	/*	Set up signal handling.  SIGTERM is shutdown signal.	*/
 
 	oK(udplsoSemaphore(&(vspan->segSemaphore)));
@@ -158,6 +220,39 @@ int	main(int argc, char *argv[])
 	/*	Can now begin transmitting to remote engine.		*/
 
 	writeMemo("[i] udplso is running.");
+#ifdef UDPLSA_MMSG
+	while (running && !(sm_SemEnded(vspan->segSemaphore)))
+	{
+		segmentCount = ltpDequeueOutboundSegments(vspan, buffer,
+				UDPLSA_BUFSZ, segmentLengths, UDPLSA_BATCHSZ);
+		if (segmentCount < 0)
+		{
+			running = 0;	/*	Terminate LSO.		*/
+			continue;
+		}
+
+		if (segmentCount == 0)	/*	Interrupted.		*/
+		{
+			continue;
+		}
+
+		for (i = 0; i < segmentCount; i++)
+		{
+			iovecs[i].iov_len = segmentLengths[i];
+		}
+
+		if (sendSegmentsByUDP(linkSocket, msgs, segmentCount) < 0)
+		{
+			running = 0;	/*	Terminate LSO.		*/
+		}
+
+		/*	Make sure other tasks have a chance to run.	*/
+
+		sm_TaskYield();
+	}
+
+	MRELEASE(buffer);
+#else
 	while (running && !(sm_SemEnded(vspan->segSemaphore)))
 	{
 		segmentLength = ltpDequeueOutboundSegment(vspan, &segment);
@@ -192,6 +287,7 @@ int	main(int argc, char *argv[])
 
 		sm_TaskYield();
 	}
+#endif
 
 	close(linkSocket);
 	writeErrmsgMemos();
@@ -302,9 +302,9 @@ static void	infoSpan(int tokenCount, char **tokens)
 	}
 
 	engineId = strtoul(tokens[2], NULL, 0);
-	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	sdr_begin_read(sdr);
 	findSpan(engineId, &vspan, &vspanElt);
-	sdr_exit_xn(sdr);
+	sdr_end_read(sdr);
 	if (vspanElt == 0)
 	{
 		printText("Unknown span.");
@@ -352,7 +352,7 @@ static void	listSpans(int tokenCount, char **tokens)
 	isprintf(buffer, sizeof buffer, "(Engine %lu  Queuing latency: %u \
 LSI pid: %d)", ltpdb->ownEngineId, ltpdb->ownQtime, vdb->lsiPid);
 	printText(buffer);
-	sdr_begin_xn(sdr);	/*	Just to lock memory.		*/
+	sdr_begin_read(sdr);
 	for (elt = sm_list_first(ionwm, vdb->spans); elt;
 			elt = sm_list_next(ionwm, elt))
 	{
@@ -360,7 +360,7 @@ LSI pid: %d)", ltpdb->ownEngineId, ltpdb->ownQtime, vdb->lsiPid);
 		printSpan(vspan);
 	}
 
-	sdr_exit_xn(sdr);
+	sdr_end_read(sdr);
 }
 
 static void	executeList(int tokenCount, char **tokens)